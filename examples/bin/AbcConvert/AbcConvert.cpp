@@ -40,7 +40,7 @@
 #include <Alembic/AbcCoreOgawa/All.h>
 
 void copyProps(Alembic::Abc::ICompoundProperty & iRead,
-    Alembic::Abc::OCompoundProperty & iWrite)
+    Alembic::Abc::OCompoundProperty & iWrite, bool iRawCopy)
 {
     std::size_t numChildren = iRead.getNumProperties();
     for (std::size_t i = 0; i < numChildren; ++i)
@@ -61,6 +61,13 @@ void copyProps(Alembic::Abc::ICompoundProperty & iRead,
                 Alembic::AbcCoreAbstract::ArraySamplePtr samp;
                 Alembic::Abc::ISampleSelector sel(
                     (Alembic::Abc::index_t) j);
+
+                // copy the sample as it is stored if we can
+                if (iRawCopy && outProp.copySample(inProp, sel))
+                {
+                    continue;
+                }
+
                 inProp.get(samp, sel);
                 outProp.set(*samp);
             }
@@ -117,26 +124,26 @@ void copyProps(Alembic::Abc::ICompoundProperty & iRead,
             Alembic::Abc::OCompoundProperty outProp(iWrite,
                 header.getName(), header.getMetaData());
             Alembic::Abc::ICompoundProperty inProp(iRead, header.getName());
-            copyProps(inProp, outProp);
+            copyProps(inProp, outProp, iRawCopy);
         }
     }
 }
 
 void copyObject(Alembic::Abc::IObject & iIn,
-    Alembic::Abc::OObject & iOut)
+    Alembic::Abc::OObject & iOut, bool iRawCopy)
 {
     std::size_t numChildren = iIn.getNumChildren();
 
     Alembic::Abc::ICompoundProperty inProps = iIn.getProperties();
     Alembic::Abc::OCompoundProperty outProps = iOut.getProperties();
-    copyProps(inProps, outProps);
+    copyProps(inProps, outProps, iRawCopy);
 
     for (std::size_t i = 0; i < numChildren; ++i)
     {
         Alembic::Abc::IObject childIn(iIn.getChild(i));
         Alembic::Abc::OObject childOut(iOut, childIn.getName(),
                                        childIn.getMetaData());
-        copyObject(childIn, childOut);
+        copyObject(childIn, childOut, iRawCopy);
     }
 }
 
@@ -147,22 +154,36 @@ int main(int argc, char *argv[])
     std::string inFile;
     std::string outFile;
     std::string forceStr;
+    bool rawCopy = false;
+    bool validOptions = true;
 
-    if (argc == 4)
+    // -force and -raw may come in any order before OPTION
+    int argIndex = 1;
+    for (; argIndex < argc - 3; ++argIndex)
     {
-        toType = argv[1];
-        inFile = argv[2];
-        outFile = argv[3];
+        std::string option = argv[argIndex];
+        if (option == "-force")
+        {
+            forceStr = option;
+        }
+        else if (option == "-raw")
+        {
+            rawCopy = true;
+        }
+        else
+        {
+            validOptions = false;
+        }
     }
-    else if (argc == 5)
+
+    if (argc - argIndex == 3)
     {
-        forceStr = argv[1];
-        toType = argv[2];
-        inFile = argv[3];
-        outFile = argv[4];
+        toType = argv[argIndex];
+        inFile = argv[argIndex + 1];
+        outFile = argv[argIndex + 2];
     }
 
-    if ((argc == 4 || argc == 5) && (forceStr.empty() || forceStr == "-force"))
+    if (argc - argIndex == 3 && validOptions)
     {
         if (inFile == outFile)
         {
@@ -224,15 +245,18 @@ int main(int argc, char *argv[])
         }
 
         Alembic::Abc::OObject outTop = outArchive.getTop();
-        copyObject(inTop, outTop);
+        copyObject(inTop, outTop, rawCopy);
         return 0;
     }
 
-    printf ("Usage: abcconvert [-force] OPTION inFile outFile\n");
+    printf ("Usage: abcconvert [-force] [-raw] OPTION inFile outFile\n");
     printf ("Used to convert an Alembic file from one type to another.\n\n");
     printf ("If -force is not provided and inFile happens to be the same\n");
     printf ("type as OPTION no conversion will be done and a message will\n");
     printf ("be printed out.\n");
+    printf ("If -raw is provided array samples are copied as they are\n");
+    printf ("stored instead of being decoded and written again, where the\n");
+    printf ("input and output both support it (Ogawa to Ogawa).\n");
     printf ("OPTION has to be one of these:\n\n");
     printf ("  -toHDF   Convert to HDF.\n");
     printf ("  -toOgawa Convert to Ogawa.\n");
@@ -0,0 +1,163 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreAbstract/All.h>
+#include <Alembic/AbcCoreOgawa/All.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace AO = Alembic::AbcCoreOgawa;
+
+//-*****************************************************************************
+void usage( const char * iName )
+{
+    std::cerr << "USAGE: " << iName
+              << " [-frame | -object | -hot name,name,...] [-report]"
+              << " <in.abc> <out.abc>" << std::endl << std::endl
+              << "Rewrites an Ogawa archive so the samples are laid out in"
+              << " the order they are read." << std::endl
+              << "  -frame   all the samples of a frame are next to each"
+              << " other (the default)" << std::endl
+              << "  -object  all the samples of a property are next to each"
+              << " other" << std::endl
+              << "  -hot     samples of the named properties go first, in"
+              << " frame order" << std::endl
+              << "  -report  print the seek distance of reading each frame,"
+              << " before and after" << std::endl;
+    exit( -1 );
+}
+
+//-*****************************************************************************
+void splitNames( const std::string & iNames, std::vector< std::string > & oNames )
+{
+    std::size_t start = 0;
+    while ( start <= iNames.size() )
+    {
+        std::size_t end = iNames.find( ',', start );
+        if ( end == std::string::npos )
+        {
+            end = iNames.size();
+        }
+
+        if ( end > start )
+        {
+            oNames.push_back( iNames.substr( start, end - start ) );
+        }
+        start = end + 1;
+    }
+}
+
+//-*****************************************************************************
+//-*****************************************************************************
+// DO IT.
+//-*****************************************************************************
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    AO::RepackLayout layout = AO::kFrameMajorLayout;
+    std::vector< std::string > hotProperties;
+    bool printReport = false;
+    std::vector< std::string > files;
+
+    for ( int i = 1; i < argc; ++i )
+    {
+        if ( strcmp( argv[i], "-frame" ) == 0 )
+        {
+            layout = AO::kFrameMajorLayout;
+        }
+        else if ( strcmp( argv[i], "-object" ) == 0 )
+        {
+            layout = AO::kObjectMajorLayout;
+        }
+        else if ( strcmp( argv[i], "-hot" ) == 0 && i + 1 < argc )
+        {
+            layout = AO::kHotPropertiesFirstLayout;
+            splitNames( argv[++i], hotProperties );
+        }
+        else if ( strcmp( argv[i], "-report" ) == 0 )
+        {
+            printReport = true;
+        }
+        else if ( argv[i][0] == '-' )
+        {
+            usage( argv[0] );
+        }
+        else
+        {
+            files.push_back( argv[i] );
+        }
+    }
+
+    if ( files.size() != 2 )
+    {
+        usage( argv[0] );
+    }
+
+    std::vector< AO::RepackFrameStats > report;
+    try
+    {
+        AO::RepackArchive( files[0], files[1], layout, hotProperties,
+                           printReport ? &report : NULL );
+    }
+    catch ( std::exception & e )
+    {
+        std::cerr << "abcrepack: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if ( printReport )
+    {
+        Alembic::Util::uint64_t before = 0;
+        Alembic::Util::uint64_t after = 0;
+        std::cout << "time reads bytes seek_before seek_after" << std::endl;
+        for ( std::size_t i = 0; i < report.size(); ++i )
+        {
+            std::cout << report[i].time << " " << report[i].numReads << " "
+                      << report[i].numBytes << " " << report[i].seekBefore
+                      << " " << report[i].seekAfter << std::endl;
+            before += report[i].seekBefore;
+            after += report[i].seekAfter;
+        }
+        std::cout << "total seek before: " << before << " after: " << after
+                  << std::endl;
+    }
+
+    return 0;
+}
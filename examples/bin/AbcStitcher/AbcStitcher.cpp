@@ -45,6 +45,8 @@
 
 #include "util.h"
 
+#include <cfloat>
+#include <cstdlib>
 #include <iostream>
 #include <sstream>
 #include <vector>
@@ -56,6 +58,34 @@ using namespace Alembic::AbcCoreAbstract;
 
 namespace{
 
+typedef Alembic::Util::shared_ptr< Prefetcher > PrefetcherPtr;
+typedef std::vector< PrefetcherPtr > PrefetcherVec;
+
+// how much the inputs read ahead altogether when stitching with more than
+// one thread, it is split evenly between them
+const size_t kPrefetchBytes = 256 * 1024 * 1024;
+
+//-*****************************************************************************
+// reads the samples of the children of iObjects ahead of time on the threads
+// of iPrefetchers (one per input) while the samples before them are written
+void prefetchChildren(std::vector< IObject > & iObjects,
+                      const PrefetcherVec & iPrefetchers)
+{
+    for (size_t i = 0; i < iPrefetchers.size() && i < iObjects.size(); ++i)
+    {
+        if (!iObjects[i].valid())
+        {
+            continue;
+        }
+
+        for (size_t j = 0; j < iObjects[i].getNumChildren(); ++j)
+        {
+            iPrefetchers[i]->prefetch(iObjects[i].getChild(j).getPtr(),
+                                      -DBL_MAX, DBL_MAX, false);
+        }
+    }
+}
+
 inline void stitchVisible(ICompoundPropertyVec & iCompoundProps,
                           OCompoundProperty & oCompoundProp,
                           const TimeAndSamplesMap & iTimeMap)
@@ -87,7 +117,7 @@ void getOGeomParamSamp(IPARAM & iGeomParam, IPARAMSAMP & iGeomSamp,
 template< class IData, class IDataSchema, class OData, class ODataSchema >
 void init(std::vector< IObject > & iObjects, OObject & oParentObj,
           ODataSchema & oSchema, const TimeAndSamplesMap & iTimeMap,
-          std::size_t & oTotalSamples)
+          std::size_t & oTotalSamples, bool iRawCopy)
 {
 
     // find the first valid IObject
@@ -235,13 +265,15 @@ void init(std::vector< IObject > & iObjects, OObject & oParentObj,
     if (iArbGeomCompoundProps.size() == iObjects.size())
     {
         OCompoundProperty oArbGeomCompoundProp = oSchema.getArbGeomParams();
-        stitchCompoundProp(iArbGeomCompoundProps, oArbGeomCompoundProp, iTimeMap);
+        stitchCompoundProp(iArbGeomCompoundProps, oArbGeomCompoundProp,
+                           iTimeMap, iRawCopy);
     }
 
     if (iUserCompoundProps.size() == iObjects.size())
     {
         OCompoundProperty oUserCompoundProp = oSchema.getUserProperties();
-        stitchCompoundProp(iUserCompoundProps, oUserCompoundProp, iTimeMap);
+        stitchCompoundProp(iUserCompoundProps, oUserCompoundProp, iTimeMap,
+                           iRawCopy);
     }
 
     if (!iSchemaProps.empty())
@@ -250,6 +282,43 @@ void init(std::vector< IObject > & iObjects, OObject & oParentObj,
     }
 }
 
+//-*****************************************************************************
+// creates the output object for iObjects, if needed, and stitches all of
+// their properties together
+OObject stitchObjectProps(std::vector< IObject > & iObjects,
+                          OObject & oParentObj,
+                          const AbcA::ObjectHeader & header,
+                          const TimeAndSamplesMap & iTimeMap,
+                          bool iRawCopy)
+{
+    OObject outObj;
+    if (oParentObj.getParent().valid())
+    {
+        outObj = OObject(oParentObj, header.getName(), header.getMetaData());
+    }
+    else
+    {
+        // for stitching properties of the top level objects
+        outObj = oParentObj;
+    }
+
+    // collect the top level compound property
+    ICompoundPropertyVec iCompoundProps(iObjects.size());
+    for (size_t i = 0; i < iObjects.size(); ++i)
+    {
+        if (!iObjects[i].valid())
+        {
+            continue;
+        }
+
+        iCompoundProps[i] = iObjects[i].getProperties();
+    }
+
+    OCompoundProperty oCompoundProperty = outObj.getProperties();
+    stitchCompoundProp(iCompoundProps, oCompoundProperty, iTimeMap, iRawCopy);
+    return outObj;
+}
+
 };
 
 //-*****************************************************************************
@@ -257,7 +326,8 @@ void init(std::vector< IObject > & iObjects, OObject & oParentObj,
 // node if there's no gap in the frame range for animated nodes
 //
 void visitObjects(std::vector< IObject > & iObjects, OObject & oParentObj,
-                  const TimeAndSamplesMap & iTimeMap)
+                  const TimeAndSamplesMap & iTimeMap, bool iRawCopy,
+                  const PrefetcherVec & iPrefetchers)
 {
     OObject outObj;
 
@@ -287,11 +357,14 @@ void visitObjects(std::vector< IObject > & iObjects, OObject & oParentObj,
     //      if sampled, timesampling type should match
     //      if sampled, no frame gaps
     //
+    // with -raw only the array properties stitched property by property
+    // (arbGeomParams, user properties and other compounds) are copied as
+    // they are stored, the schemas still write their own samples
     if (IXform::matches(header))
     {
         OXformSchema oSchema;
         init< IXform, IXformSchema, OXform, OXformSchema >(
-            iObjects, oParentObj, oSchema, iTimeMap, totalSamples);
+            iObjects, oParentObj, oSchema, iTimeMap, totalSamples, iRawCopy);
 
         outObj = oSchema.getObject();
 
@@ -370,7 +443,7 @@ void visitObjects(std::vector< IObject > & iObjects, OObject & oParentObj,
     {
         OSubDSchema oSchema;
         init< ISubD, ISubDSchema, OSubD, OSubDSchema >(
-            iObjects, oParentObj, oSchema, iTimeMap, totalSamples);
+            iObjects, oParentObj, oSchema, iTimeMap, totalSamples, iRawCopy);
         outObj = oSchema.getObject();
 
         OSubDSchema::Sample emptySample(P3fArraySample::emptySample(),
@@ -479,7 +552,7 @@ void visitObjects(std::vector< IObject > & iObjects, OObject & oParentObj,
 
         OPolyMeshSchema oSchema;
         init< IPolyMesh, IPolyMeshSchema, OPolyMesh, OPolyMeshSchema >(
-            iObjects, oParentObj, oSchema, iTimeMap, totalSamples);
+            iObjects, oParentObj, oSchema, iTimeMap, totalSamples, iRawCopy);
         outObj = oSchema.getObject();
 
         OPolyMeshSchema::Sample emptySample(P3fArraySample::emptySample(),
@@ -572,7 +645,7 @@ void visitObjects(std::vector< IObject > & iObjects, OObject & oParentObj,
     {
         OCameraSchema oSchema;
         init< ICamera, ICameraSchema, OCamera, OCameraSchema >(
-            iObjects, oParentObj, oSchema, iTimeMap, totalSamples);
+            iObjects, oParentObj, oSchema, iTimeMap, totalSamples, iRawCopy);
 
         outObj = oSchema.getObject();
 
@@ -618,7 +691,7 @@ void visitObjects(std::vector< IObject > & iObjects, OObject & oParentObj,
     {
         OCurvesSchema oSchema;
         init< ICurves, ICurvesSchema, OCurves, OCurvesSchema >(
-            iObjects, oParentObj, oSchema, iTimeMap, totalSamples);
+            iObjects, oParentObj, oSchema, iTimeMap, totalSamples, iRawCopy);
         outObj = oSchema.getObject();
         OCurvesSchema::Sample emptySample(P3fArraySample::emptySample(),
             Int32ArraySample::emptySample());
@@ -725,7 +798,7 @@ void visitObjects(std::vector< IObject > & iObjects, OObject & oParentObj,
     {
         OPointsSchema oSchema;
         init< IPoints, IPointsSchema, OPoints, OPointsSchema >(
-            iObjects, oParentObj, oSchema, iTimeMap, totalSamples);
+            iObjects, oParentObj, oSchema, iTimeMap, totalSamples, iRawCopy);
         outObj = oSchema.getObject();
         OPointsSchema::Sample emptySample(P3fArraySample::emptySample(),
             UInt64ArraySample::emptySample());
@@ -789,7 +862,7 @@ void visitObjects(std::vector< IObject > & iObjects, OObject & oParentObj,
     {
         ONuPatchSchema oSchema;
         init< INuPatch, INuPatchSchema, ONuPatch, ONuPatchSchema >(
-            iObjects, oParentObj, oSchema, iTimeMap, totalSamples);
+            iObjects, oParentObj, oSchema, iTimeMap, totalSamples, iRawCopy);
         outObj = oSchema.getObject();
 
         Alembic::Util::int32_t zeroVal = 0;
@@ -893,32 +966,12 @@ void visitObjects(std::vector< IObject > & iObjects, OObject & oParentObj,
     }
     else
     {
-        if (oParentObj.getParent().valid())
-        {
-            outObj = OObject(oParentObj, header.getName(), header.getMetaData());
-        }
-        else
-        {
-            // for stitching properties of the top level objects
-            outObj = oParentObj;
-        }
-
-        // collect the top level compound property
-        ICompoundPropertyVec iCompoundProps(iObjects.size());
-        for (size_t i = 0; i < iObjects.size(); ++i)
-        {
-            if (!iObjects[i].valid())
-            {
-                continue;
-            }
-
-            iCompoundProps[i] = iObjects[i].getProperties();
-        }
-
-        OCompoundProperty oCompoundProperty = outObj.getProperties();
-        stitchCompoundProp(iCompoundProps, oCompoundProperty, iTimeMap);
+        outObj = stitchObjectProps(iObjects, oParentObj, header, iTimeMap,
+                                   iRawCopy);
     }
 
+    prefetchChildren(iObjects, iPrefetchers);
+
     // After done writing THIS OObject node, if input nodes have children,
     // go deeper, otherwise we are done here
     for (size_t i = 0 ; i < iObjects.size(); i++ )
@@ -943,7 +996,16 @@ void visitObjects(std::vector< IObject > & iObjects, OObject & oParentObj,
                 childObjects.push_back(iObjects[k].getChild(childName));
             }
 
-            visitObjects(childObjects, outObj, iTimeMap);
+            // childObjects starts at input i, so the prefetchers must too
+            PrefetcherVec childPrefetchers;
+            if (i < iPrefetchers.size())
+            {
+                childPrefetchers.assign(iPrefetchers.begin() + i,
+                                        iPrefetchers.end());
+            }
+
+            visitObjects(childObjects, outObj, iTimeMap, iRawCopy,
+                         childPrefetchers);
         }
     }
 
@@ -956,10 +1018,49 @@ void visitObjects(std::vector< IObject > & iObjects, OObject & oParentObj,
 //-*****************************************************************************
 int main( int argc, char *argv[] )
 {
+    std::string progName = argv[0];
+
+    // -raw copies the samples of the array properties which aren't part of
+    // a schema as they are stored, rather than decoding and writing them
+    // again, when the inputs and output are all Ogawa
+    bool rawCopy = false;
+
+    // -j N reads the inputs ahead on N threads, the output is still written
+    // in the same order so it is the same as with one thread
+    size_t numThreads = 1;
+
+    int argIndex = 1;
+    for (; argIndex < argc; ++argIndex)
+    {
+        std::string option = argv[argIndex];
+        if (option == "-raw")
+        {
+            rawCopy = true;
+        }
+        else if (option == "-j" && argIndex + 1 < argc)
+        {
+            int n = atoi(argv[++argIndex]);
+            numThreads = n > 1 ? (size_t) n : 1;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    argv += argIndex - 1;
+    argc -= argIndex - 1;
+
     if (argc < 4)
     {
-        std::cerr << "USAGE: " << argv[0] << " outFile.abc inFile1.abc"
-            << " inFile2.abc (inFile3.abc ...)" << std::endl;
+        std::cerr << "USAGE: " << progName << " [-raw] [-j N] outFile.abc"
+            << " inFile1.abc inFile2.abc (inFile3.abc ...)" << std::endl;
+        std::cerr << "  -raw  copy the samples of arbGeomParams, user and"
+            << " other non schema array properties as they are stored when"
+            << " stitching Ogawa files" << std::endl;
+        std::cerr << "  -j N  read the inputs ahead on N threads split"
+            << " between them (at least one each), ignored with -raw"
+            << std::endl;
         return -1;
     }
 
@@ -979,8 +1080,28 @@ int main( int argc, char *argv[] )
         Alembic::AbcCoreFactory::IFactory::CoreType coreType;
         TimeAndSamplesMap timeMap;
 
+        // the threads and kPrefetchBytes are split between the inputs, so
+        // stitching more files doesn't use more memory
+        bool prefetch = numThreads > 1 && !rawCopy;
+        size_t inputThreads = std::max(numThreads / numInputs, (size_t) 1);
+        size_t inputPrefetchBytes = kPrefetchBytes / numInputs;
+
+        // the prefetching threads each need their own stream, plus the one
+        // we stitch with
+        if (prefetch)
+        {
+            factory.setOgawaNumStreams(inputThreads + 1);
+        }
+
         for (int i = 2; i < argc; ++i)
         {
+            // each input gets its own cache to prefetch into
+            if (prefetch)
+            {
+                factory.setSampleCache(
+                    Alembic::AbcCoreOgawa::CreateCache(
+                        2 * inputPrefetchBytes));
+            }
 
             IArchive archive = factory.getArchive(argv[i], coreType);
             if (!archive.valid())
@@ -1088,7 +1209,28 @@ int main( int argc, char *argv[] )
             iRoots[e] = iOrderedArchives[e].getTop();
         }
 
-        visitObjects(iRoots, oRoot, timeMap);
+        PrefetcherVec prefetchers;
+        for (size_t e = 0; prefetch && e < numInputs; ++e)
+        {
+            ArchiveReaderPtr ar = iOrderedArchives[e].getPtr();
+            if (!ar->getReadArraySampleCachePtr())
+            {
+                // not an Ogawa input, don't prefetch any of them
+                prefetchers.clear();
+                break;
+            }
+
+            prefetchers.push_back(PrefetcherPtr(
+                new Prefetcher(ar, inputThreads, inputPrefetchBytes)));
+        }
+
+        for (size_t e = 0; e < prefetchers.size(); ++e)
+        {
+            prefetchers[e]->prefetch(iRoots[e].getPtr(), -DBL_MAX, DBL_MAX,
+                                     false);
+        }
+
+        visitObjects(iRoots, oRoot, timeMap, rawCopy, prefetchers);
     }
 
     return 0;
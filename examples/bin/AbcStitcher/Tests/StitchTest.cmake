@@ -0,0 +1,57 @@
+##-*****************************************************************************
+##
+## Copyright (c) 2009-2015,
+##  Sony Pictures Imageworks Inc. and
+##  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+##
+## All rights reserved.
+##
+## Redistribution and use in source and binary forms, with or without
+## modification, are permitted provided that the following conditions are
+## met:
+## *       Redistributions of source code must retain the above copyright
+## notice, this list of conditions and the following disclaimer.
+## *       Redistributions in binary form must reproduce the above
+## copyright notice, this list of conditions and the following disclaimer
+## in the documentation and/or other materials provided with the
+## distribution.
+## *       Neither the name of Industrial Light & Magic nor the names of
+## its contributors may be used to endorse or promote products derived
+## from this software without specific prior written permission.
+##
+## THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+## "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+## LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+## A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+## OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+## SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+## LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+## DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+## THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+## (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+## OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+##
+
+# Stitches the inputs written by AbcStitcher_StitchTest serially and with
+# -j 4 (and with -j 2, which gives each input fewer than one thread) and
+# fails if the results aren't the same.  STITCHER and STITCH_TEST are the
+# paths to abcstitcher and AbcStitcher_StitchTest.
+
+FUNCTION(RUN_STEP)
+    EXECUTE_PROCESS(COMMAND ${ARGN} RESULT_VARIABLE result)
+    IF (NOT result EQUAL 0)
+        MESSAGE(FATAL_ERROR "${ARGN} failed: ${result}")
+    ENDIF()
+ENDFUNCTION()
+
+RUN_STEP(${STITCH_TEST} write 4)
+
+SET(INPUTS stitchInput0.abc stitchInput1.abc stitchInput2.abc
+           stitchInput3.abc)
+
+RUN_STEP(${STITCHER} stitchSerial.abc ${INPUTS})
+RUN_STEP(${STITCHER} -j 4 stitchThreads.abc ${INPUTS})
+RUN_STEP(${STITCHER} -j 2 stitchFewerThreads.abc ${INPUTS})
+
+RUN_STEP(${STITCH_TEST} compare stitchSerial.abc stitchThreads.abc)
+RUN_STEP(${STITCH_TEST} compare stitchSerial.abc stitchFewerThreads.abc)
@@ -0,0 +1,250 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcGeom/All.h>
+#include <Alembic/AbcCoreOgawa/All.h>
+#include <Alembic/AbcCoreAbstract/Tests/Assert.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//-*****************************************************************************
+// Helper for StitchTest.cmake, which stitches the same inputs with and
+// without -j and checks that the results match.
+//
+//   AbcStitcher_StitchTest write N        writes stitchInput0..N-1.abc
+//   AbcStitcher_StitchTest compare a b    fails if a and b differ
+//
+// The files can't just be compared byte for byte since the date they were
+// written is stored in them.
+
+using namespace Alembic::AbcGeom;
+
+namespace AbcA = Alembic::AbcCoreAbstract;
+
+//-*****************************************************************************
+// each input has 10 frames of an animated xform with two meshes under it,
+// starting where the input before it left off
+void writeInput( std::size_t iInput )
+{
+    std::stringstream name;
+    name << "stitchInput" << iInput << ".abc";
+
+    OArchive archive( Alembic::AbcCoreOgawa::WriteArchive(), name.str() );
+
+    const std::size_t numFrames = 10;
+    TimeSampling ts( 1.0 / 24.0, ( iInput * numFrames ) / 24.0 );
+    Alembic::Util::uint32_t tsIndex = archive.addTimeSampling( ts );
+
+    OXform xform( OObject( archive, kTop ), "xform", tsIndex );
+    OPolyMesh meshA( xform, "meshA", tsIndex );
+    OPolyMesh meshB( xform, "meshB", tsIndex );
+
+    // a strip of quads
+    const std::size_t numQuads = 1000;
+    std::vector< Alembic::Util::int32_t > counts( numQuads, 4 );
+    std::vector< Alembic::Util::int32_t > indices;
+    for ( std::size_t i = 0; i < numQuads; ++i )
+    {
+        Alembic::Util::int32_t base = ( Alembic::Util::int32_t ) i * 2;
+        indices.push_back( base );
+        indices.push_back( base + 1 );
+        indices.push_back( base + 3 );
+        indices.push_back( base + 2 );
+    }
+
+    for ( std::size_t f = 0; f < numFrames; ++f )
+    {
+        float frame = ( float )( iInput * numFrames + f );
+
+        XformSample xsamp;
+        xsamp.setTranslation( V3d( frame, 0.0, 0.0 ) );
+        xform.getSchema().set( xsamp );
+
+        std::vector< V3f > points;
+        for ( std::size_t i = 0; i <= numQuads; ++i )
+        {
+            points.push_back( V3f( ( float ) i, frame, 0.0f ) );
+            points.push_back( V3f( ( float ) i, frame, 1.0f ) );
+        }
+
+        OPolyMeshSchema::Sample samp( V3fArraySample( points ),
+            Int32ArraySample( indices ), Int32ArraySample( counts ) );
+        meshA.getSchema().set( samp );
+
+        // meshB doesn't move, so its samples are shared (samp points at
+        // the same memory)
+        for ( std::size_t i = 0; i < points.size(); ++i )
+        {
+            points[i].y = 0.0f;
+        }
+        meshB.getSchema().set( samp );
+    }
+}
+
+//-*****************************************************************************
+void compareProperties( AbcA::CompoundPropertyReaderPtr iA,
+                        AbcA::CompoundPropertyReaderPtr iB )
+{
+    TESTING_ASSERT( iA->getNumProperties() == iB->getNumProperties() );
+
+    for ( std::size_t i = 0; i < iA->getNumProperties(); ++i )
+    {
+        const AbcA::PropertyHeader & header = iA->getPropertyHeader( i );
+        const AbcA::PropertyHeader & bHeader = iB->getPropertyHeader( i );
+        TESTING_ASSERT( header.getName() == bHeader.getName() );
+        TESTING_ASSERT( header.getPropertyType() ==
+                        bHeader.getPropertyType() );
+        TESTING_ASSERT( header.getMetaData().serialize() ==
+                        bHeader.getMetaData().serialize() );
+
+        if ( header.isCompound() )
+        {
+            compareProperties( iA->getCompoundProperty( i ),
+                               iB->getCompoundProperty( i ) );
+            continue;
+        }
+
+        TESTING_ASSERT( header.getDataType() == bHeader.getDataType() );
+        TESTING_ASSERT( *header.getTimeSampling() ==
+                        *bHeader.getTimeSampling() );
+
+        if ( header.isArray() )
+        {
+            AbcA::ArrayPropertyReaderPtr a = iA->getArrayProperty( i );
+            AbcA::ArrayPropertyReaderPtr b = iB->getArrayProperty( i );
+            TESTING_ASSERT( a->getNumSamples() == b->getNumSamples() );
+
+            // the keys hold the digests of the samples
+            for ( std::size_t j = 0; j < a->getNumSamples(); ++j )
+            {
+                AbcA::ArraySampleKey aKey, bKey;
+                TESTING_ASSERT( a->getKey( j, aKey ) );
+                TESTING_ASSERT( b->getKey( j, bKey ) );
+                TESTING_ASSERT( aKey == bKey );
+
+                AbcA::Dimensions aDims, bDims;
+                a->getDimensions( j, aDims );
+                b->getDimensions( j, bDims );
+                TESTING_ASSERT( aDims == bDims );
+            }
+            continue;
+        }
+
+        AbcA::ScalarPropertyReaderPtr a = iA->getScalarProperty( i );
+        AbcA::ScalarPropertyReaderPtr b = iB->getScalarProperty( i );
+        TESTING_ASSERT( a->getNumSamples() == b->getNumSamples() );
+
+        // our inputs don't have any string scalars
+        const AbcA::DataType & dataType = header.getDataType();
+        TESTING_ASSERT( dataType.getPod() != Alembic::Util::kStringPOD &&
+                        dataType.getPod() != Alembic::Util::kWstringPOD );
+
+        std::vector< char > aBuf( dataType.getNumBytes() );
+        std::vector< char > bBuf( dataType.getNumBytes() );
+        for ( std::size_t j = 0; j < a->getNumSamples(); ++j )
+        {
+            a->getSample( j, &aBuf.front() );
+            b->getSample( j, &bBuf.front() );
+            TESTING_ASSERT( aBuf == bBuf );
+        }
+    }
+}
+
+//-*****************************************************************************
+void compareObjects( AbcA::ObjectReaderPtr iA, AbcA::ObjectReaderPtr iB )
+{
+    TESTING_ASSERT( iA->getFullName() == iB->getFullName() );
+
+    // the meta data of the top object is that of the archive, which has
+    // the date, so it is only compared for the children
+    compareProperties( iA->getProperties(), iB->getProperties() );
+
+    TESTING_ASSERT( iA->getNumChildren() == iB->getNumChildren() );
+    for ( std::size_t i = 0; i < iA->getNumChildren(); ++i )
+    {
+        TESTING_ASSERT( iA->getChildHeader( i ).getMetaData().serialize() ==
+                        iB->getChildHeader( i ).getMetaData().serialize() );
+        compareObjects( iA->getChild( i ), iB->getChild( i ) );
+    }
+}
+
+//-*****************************************************************************
+void compareArchives( const std::string & iA, const std::string & iB )
+{
+    IArchive a( Alembic::AbcCoreOgawa::ReadArchive(), iA );
+    IArchive b( Alembic::AbcCoreOgawa::ReadArchive(), iB );
+
+    TESTING_ASSERT( a.getNumTimeSamplings() == b.getNumTimeSamplings() );
+    for ( Alembic::Util::uint32_t i = 0; i < a.getNumTimeSamplings(); ++i )
+    {
+        TESTING_ASSERT( *a.getTimeSampling( i ) == *b.getTimeSampling( i ) );
+        TESTING_ASSERT( a.getMaxNumSamplesForTimeSamplingIndex( i ) ==
+                        b.getMaxNumSamplesForTimeSamplingIndex( i ) );
+    }
+
+    compareObjects( a.getTop().getPtr(), b.getTop().getPtr() );
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    std::string mode = argc > 1 ? argv[1] : "";
+    if ( mode == "write" && argc == 3 )
+    {
+        std::size_t numInputs = ( std::size_t ) atoi( argv[2] );
+        for ( std::size_t i = 0; i < numInputs; ++i )
+        {
+            writeInput( i );
+        }
+    }
+    else if ( mode == "compare" && argc == 4 )
+    {
+        compareArchives( argv[2], argv[3] );
+    }
+    else
+    {
+        std::cerr << "USAGE: " << argv[0] << " write numInputs" << std::endl;
+        std::cerr << "       " << argv[0] << " compare a.abc b.abc"
+                  << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -150,7 +150,8 @@ void checkAcyclic(const TimeSamplingType & tsType,
 void stitchArrayProp(const PropertyHeader & propHeader,
                      const ICompoundPropertyVec & iCompoundProps,
                      OCompoundProperty & oCompoundProp,
-                     const TimeAndSamplesMap & iTimeMap)
+                     const TimeAndSamplesMap & iTimeMap,
+                     bool iRawCopy)
 {
 
     size_t totalSamples = 0;
@@ -200,6 +201,12 @@ void stitchArrayProp(const PropertyHeader & propHeader,
 
         for (; k < numSamples; k++)
         {
+            // copy the sample as it is stored if we can
+            if (iRawCopy && writer.copySample(reader, k))
+            {
+                continue;
+            }
+
             reader.get(dataPtr, k);
             writer.set(*dataPtr);
         }
@@ -349,7 +356,8 @@ void stitchScalarProp(const PropertyHeader & propHeader,
 
 void stitchCompoundProp(ICompoundPropertyVec & iCompoundProps,
                         OCompoundProperty & oCompoundProp,
-                        const TimeAndSamplesMap & iTimeMap)
+                        const TimeAndSamplesMap & iTimeMap,
+                        bool iRawCopy)
 {
     size_t numCompounds = iCompoundProps.size();
     for (size_t i = 0; i < numCompounds; ++i)
@@ -387,7 +395,7 @@ void stitchCompoundProp(ICompoundPropertyVec & iCompoundProps,
                 }
                 OCompoundProperty child(oCompoundProp, propHeader.getName(),
                     propHeader.getMetaData());
-                stitchCompoundProp(childProps, child, iTimeMap);
+                stitchCompoundProp(childProps, child, iTimeMap, iRawCopy);
             }
             else if (propHeader.isScalar())
             {
@@ -397,7 +405,7 @@ void stitchCompoundProp(ICompoundPropertyVec & iCompoundProps,
             else if (propHeader.isArray())
             {
                 stitchArrayProp(propHeader, iCompoundProps,
-                                oCompoundProp, iTimeMap);
+                                oCompoundProp, iTimeMap, iRawCopy);
             }
         }
     }
@@ -74,7 +74,8 @@ void checkAcyclic(const Alembic::AbcCoreAbstract::TimeSamplingType & tsType,
 void stitchArrayProp(const Alembic::AbcCoreAbstract::PropertyHeader & propHeader,
                      const ICompoundPropertyVec & iCompoundProps,
                      Alembic::Abc::OCompoundProperty & oCompoundProp,
-                     const TimeAndSamplesMap & iTimeMap);
+                     const TimeAndSamplesMap & iTimeMap,
+                     bool iRawCopy = false);
 
 void stitchScalarProp(const Alembic::AbcCoreAbstract::PropertyHeader & propHeader,
                       const ICompoundPropertyVec & iCompoundProps,
@@ -83,7 +84,8 @@ void stitchScalarProp(const Alembic::AbcCoreAbstract::PropertyHeader & propHeade
 
 void stitchCompoundProp(ICompoundPropertyVec & iCompoundProps,
                         Alembic::Abc::OCompoundProperty & oCompoundProp,
-                        const TimeAndSamplesMap & iTimeMap);
+                        const TimeAndSamplesMap & iTimeMap,
+                        bool iRawCopy = false);
 
 
 #endif // _ABC_STITCHER_UTIL_H_
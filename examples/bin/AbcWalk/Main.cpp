@@ -228,6 +228,7 @@ int main(int argc, char ** argv)
     if (argc < 4)
     {
         printf ("sceneWalk maxNumThreads ogawaStreams fileName [fileName ...]\n");
+        printf ("  ogawaStreams of 0 memory maps the files instead\n");
         return 0;
     }
 
@@ -238,7 +239,15 @@ int main(int argc, char ** argv)
 
     Alembic::AbcCoreFactory::IFactory factory;
     Alembic::AbcCoreFactory::IFactory::CoreType coreType;
-    factory.setOgawaNumStreams(ogawaStreams);
+    if (ogawaStreams > 0)
+    {
+        factory.setOgawaNumStreams(ogawaStreams);
+    }
+    else
+    {
+        factory.setOgawaReadStrategy(
+            Alembic::AbcCoreFactory::IFactory::kMemoryMappedFiles);
+    }
     double time_start = getTimeSec();
     for (int i = 3; i < argc; ++i)
     {
@@ -75,6 +75,45 @@ IObject IArchive::getTop()
     return IObject();
 }
 
+//-*****************************************************************************
+IObject IArchive::findObject( const std::string &iFullName )
+{
+    ALEMBIC_ABC_SAFE_CALL_BEGIN( "IArchive::findObject()" );
+
+    AbcA::ObjectReaderPtr obj = m_archive->findObject( iFullName );
+    if ( obj )
+    {
+        return IObject( obj, kWrapExisting );
+    }
+
+    // the path may go through an instance, which only IObject knows how
+    // to follow
+    IObject found = getTop();
+    std::size_t start = 0;
+    while ( found.valid() && start < iFullName.size() )
+    {
+        std::size_t end = iFullName.find( '/', start );
+        if ( end == std::string::npos )
+        {
+            end = iFullName.size();
+        }
+
+        if ( end > start )
+        {
+            found = found.getChild( iFullName.substr( start, end - start ) );
+        }
+
+        start = end + 1;
+    }
+
+    return found;
+
+    ALEMBIC_ABC_SAFE_CALL_END();
+
+    // Not all error handlers throw, so here is a default behavior.
+    return IObject();
+}
+
 //-*****************************************************************************
 AbcA::ReadArraySampleCachePtr IArchive::getReadArraySampleCachePtr()
 {
@@ -142,6 +181,75 @@ int32_t IArchive::getArchiveVersion( )
     return 0;
 }
 
+//-*****************************************************************************
+bool IArchive::refresh()
+{
+    ALEMBIC_ABC_SAFE_CALL_BEGIN( "IArchive::refresh" );
+
+    return m_archive->refresh();
+
+    ALEMBIC_ABC_SAFE_CALL_END();
+
+    // Not all error handlers throw, so here is a default behavior.
+    return false;
+}
+
+//-*****************************************************************************
+void IArchive::setStatsEnabled( bool iEnabled )
+{
+    ALEMBIC_ABC_SAFE_CALL_BEGIN( "IArchive::setStatsEnabled" );
+
+    m_archive->setStatsEnabled( iEnabled );
+
+    ALEMBIC_ABC_SAFE_CALL_END();
+}
+
+//-*****************************************************************************
+bool IArchive::getStats( AbcA::ReadStats & oStats )
+{
+    ALEMBIC_ABC_SAFE_CALL_BEGIN( "IArchive::getStats" );
+
+    return m_archive->getStats( oStats );
+
+    ALEMBIC_ABC_SAFE_CALL_END();
+
+    // Not all error handlers throw, so here is a default behavior.
+    return false;
+}
+
+//-*****************************************************************************
+void IArchive::resetStats()
+{
+    ALEMBIC_ABC_SAFE_CALL_BEGIN( "IArchive::resetStats" );
+
+    m_archive->resetStats();
+
+    ALEMBIC_ABC_SAFE_CALL_END();
+}
+
+//-*****************************************************************************
+void IArchive::setTraceEnabled( bool iEnabled )
+{
+    ALEMBIC_ABC_SAFE_CALL_BEGIN( "IArchive::setTraceEnabled" );
+
+    m_archive->setTraceEnabled( iEnabled );
+
+    ALEMBIC_ABC_SAFE_CALL_END();
+}
+
+//-*****************************************************************************
+bool IArchive::writeTrace( std::ostream & oStream )
+{
+    ALEMBIC_ABC_SAFE_CALL_BEGIN( "IArchive::writeTrace" );
+
+    return m_archive->writeTrace( oStream );
+
+    ALEMBIC_ABC_SAFE_CALL_END();
+
+    // Not all error handlers throw, so here is a default behavior.
+    return false;
+}
+
 //-*****************************************************************************
 void IArchive::setReadArraySampleCachePtr( AbcA::ReadArraySampleCachePtr iPtr )
 {
@@ -122,6 +122,11 @@ public:
     //! automatically as part of the archive.
     IObject getTop();
 
+    //! Returns the object with the given full name, like "/a/b/c", or an
+    //! invalid IObject if there isn't one.  Archives written with a path
+    //! index find the object without reading the headers of its ancestors.
+    IObject findObject( const std::string &iFullName );
+
     //! Get the read array sample cache. It may be a NULL pointer.
     //! Caches can be shared amongst separate archives, and caching
     //! will is disabled if a NULL cache is returned here.
@@ -171,6 +176,36 @@ public:
     //! of this archive file.
     int32_t getArchiveVersion();
 
+    //! For archives that were still being written when they were opened,
+    //! picks up what has been committed to them since (see
+    //! OArchive::commit).  Returns true if there was anything new, call
+    //! getTop again to see it, IObjects and properties that were already
+    //! gotten keep what they had, so this can be called while the archive
+    //! is being read on other threads.
+    bool refresh();
+
+    //! Turns on (or off) counting what is read, see AbcA::ReadStats.  It is
+    //! off by default, and can be changed while the archive is being read on
+    //! other threads.
+    void setStatsEnabled( bool iEnabled );
+
+    //! Fills in what was read since the stats were turned on or reset,
+    //! returns false if the archive doesn't count what it reads.
+    bool getStats( AbcA::ReadStats & oStats );
+
+    //! Starts the stats, and the trace, over.
+    void resetStats();
+
+    //! Turns on (or off) tracing every read, this takes memory for every
+    //! read until the stats are reset, up to a limit after which only the
+    //! latest reads are kept.  It can be changed while the archive is being
+    //! read on other threads.
+    void setTraceEnabled( bool iEnabled );
+
+    //! Writes the traced reads as Chrome trace event JSON, returns false if
+    //! the archive doesn't trace its reads.
+    bool writeTrace( std::ostream & oStream );
+
     //! The unspecified-bool-type operator casts the object to "true"
     //! if it is valid, and "false" otherwise.
     ALEMBIC_OPERATOR_BOOL( valid() );
@@ -113,6 +113,18 @@ void IArrayProperty::get( AbcA::ArraySamplePtr& oSamp,
     ALEMBIC_ABC_SAFE_CALL_END();
 }
 
+//-*****************************************************************************
+void IArrayProperty::getSamples( index_t iFirstIndex, size_t iNumSamples,
+                                 std::vector< AbcA::ArraySamplePtr > &oSamples
+                               ) const
+{
+    ALEMBIC_ABC_SAFE_CALL_BEGIN( "IArrayProperty::getSamples()" );
+
+    m_property->getSamples( iFirstIndex, iNumSamples, oSamples );
+
+    ALEMBIC_ABC_SAFE_CALL_END();
+}
+
 //-*****************************************************************************
 void IArrayProperty::getAs( void * oSample,
                             AbcA::PlainOldDataType iPod,
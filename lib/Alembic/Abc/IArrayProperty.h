@@ -130,6 +130,11 @@ public:
     void get( AbcA::ArraySamplePtr& oSample,
               const ISampleSelector &iSS = ISampleSelector() ) const;
 
+    //! Get the iNumSamples samples starting at iFirstIndex all at once,
+    //! which is cheaper than calling get for each of them.
+    void getSamples( index_t iFirstIndex, size_t iNumSamples,
+                     std::vector< AbcA::ArraySamplePtr > &oSamples ) const;
+
     //! Get a sample into the address of a datum as a particular POD type.
     void getAs( void *oSample, AbcA::PlainOldDataType iPod,
                 const ISampleSelector &iSS = ISampleSelector() );
@@ -133,6 +133,20 @@ uint32_t OArchive::getNumTimeSamplings()
     return 0;
 }
 
+//-*****************************************************************************
+bool OArchive::commit()
+{
+    ALEMBIC_ABC_SAFE_CALL_BEGIN( "OArchive::commit" );
+
+    return m_archive->commit();
+
+    ALEMBIC_ABC_SAFE_CALL_END();
+
+    // Not all error handlers throw,
+    // so return a NO-OP value
+    return false;
+}
+
 //-*****************************************************************************
 OObject OArchive::getTop()
 {
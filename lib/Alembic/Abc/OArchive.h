@@ -150,6 +150,13 @@ public:
     //! TimeSampling pool.
     uint32_t getNumTimeSamplings();
 
+    //! Makes everything written so far readable, before the archive is
+    //! closed, by readers that open the archive now or refresh it
+    //! (see IArchive::refresh).  Objects and properties that are still
+    //! open are included with the samples they have so far.  Returns false
+    //! if the archive type doesn't support this.
+    bool commit();
+
     //-*************************************************************************
     // ABC BASE MECHANISMS
     // These functions are used by Abc to deal with errors, rewrapping,
@@ -79,6 +79,22 @@ void OArrayProperty::setFromPrevious()
     ALEMBIC_ABC_SAFE_CALL_END();
 }
 
+//-*****************************************************************************
+bool OArrayProperty::copySample( IArrayProperty iSource,
+                                 const ISampleSelector &iSS )
+{
+    ALEMBIC_ABC_SAFE_CALL_BEGIN( "OArrayProperty::copySample()" );
+
+    AbcA::index_t index = iSS.getIndex( iSource.getTimeSampling(),
+                                        iSource.getNumSamples() );
+
+    return m_property->copySample( iSource.getPtr(), index );
+
+    ALEMBIC_ABC_SAFE_CALL_END();
+
+    return false;
+}
+
 //-*****************************************************************************
 void OArrayProperty::setTimeSampling( uint32_t iIndex )
 {
@@ -42,6 +42,7 @@
 #include <Alembic/Abc/Argument.h>
 #include <Alembic/Abc/OBaseProperty.h>
 #include <Alembic/Abc/OCompoundProperty.h>
+#include <Alembic/Abc/IArrayProperty.h>
 
 namespace Alembic {
 namespace Abc {
@@ -122,6 +123,13 @@ public:
     //! ...
     void setFromPrevious( );
 
+    //! Set a sample by copying it from iSource as it is stored, without
+    //! decoding it.  Returns false, without setting a sample, if the
+    //! underlying archives can't do this, in which case the sample should
+    //! be read from iSource and set normally.
+    bool copySample( IArrayProperty iSource,
+                     const ISampleSelector &iSS = ISampleSelector() );
+
     //! Changes the TimeSampling used by this property.
     //! If the TimeSampling is changed to Acyclic and the number of samples
     //! currently set is more than the number of times provided in the Acyclic
@@ -55,7 +55,9 @@
 #include <Alembic/AbcCoreAbstract/ObjectHeader.h>
 #include <Alembic/AbcCoreAbstract/ObjectReader.h>
 #include <Alembic/AbcCoreAbstract/ObjectWriter.h>
+#include <Alembic/AbcCoreAbstract/Prefetcher.h>
 #include <Alembic/AbcCoreAbstract/PropertyHeader.h>
+#include <Alembic/AbcCoreAbstract/ReadStats.h>
 #include <Alembic/AbcCoreAbstract/ScalarPropertyReader.h>
 #include <Alembic/AbcCoreAbstract/ScalarPropertyWriter.h>
 #include <Alembic/AbcCoreAbstract/ScalarSample.h>
@@ -35,6 +35,7 @@
 //-*****************************************************************************
 
 #include <Alembic/AbcCoreAbstract/ArchiveReader.h>
+#include <Alembic/AbcCoreAbstract/ObjectReader.h>
 
 namespace Alembic {
 namespace AbcCoreAbstract {
@@ -46,6 +47,65 @@ ArchiveReader::~ArchiveReader()
     // Nothing
 }
 
+//-*****************************************************************************
+ObjectReaderPtr ArchiveReader::findObject( const std::string &iFullName )
+{
+    ObjectReaderPtr obj = getTop();
+
+    // find the object one name at a time
+    std::size_t start = 0;
+    while ( obj && start < iFullName.size() )
+    {
+        std::size_t end = iFullName.find( '/', start );
+        if ( end == std::string::npos )
+        {
+            end = iFullName.size();
+        }
+
+        if ( end > start )
+        {
+            obj = obj->getChild( iFullName.substr( start, end - start ) );
+        }
+
+        start = end + 1;
+    }
+
+    return obj;
+}
+
+//-*****************************************************************************
+bool ArchiveReader::refresh()
+{
+    return false;
+}
+
+//-*****************************************************************************
+void ArchiveReader::setStatsEnabled( bool iEnabled )
+{
+}
+
+//-*****************************************************************************
+bool ArchiveReader::getStats( ReadStats & oStats )
+{
+    return false;
+}
+
+//-*****************************************************************************
+void ArchiveReader::resetStats()
+{
+}
+
+//-*****************************************************************************
+void ArchiveReader::setTraceEnabled( bool iEnabled )
+{
+}
+
+//-*****************************************************************************
+bool ArchiveReader::writeTrace( std::ostream & oStream )
+{
+    return false;
+}
+
 } // End namespace ALEMBIC_VERSION_NS
 } // End namespace AbcCoreAbstract
 } // End namespace Alembic
@@ -41,6 +41,9 @@
 #include <Alembic/AbcCoreAbstract/Foundation.h>
 #include <Alembic/AbcCoreAbstract/ForwardDeclarations.h>
 #include <Alembic/AbcCoreAbstract/ReadArraySampleCache.h>
+#include <Alembic/AbcCoreAbstract/ReadStats.h>
+
+#include <ostream>
 
 namespace Alembic {
 namespace AbcCoreAbstract {
@@ -96,6 +99,13 @@ public:
     //! corresponding to this archive.
     virtual ObjectReaderPtr getTop() = 0;
 
+    //! Find the object with the given full name, like "/a/b/c".  Returns
+    //! a NULL pointer if there is no such object.
+    //! By default this walks down from the top object one child at a time,
+    //! but implementations may be able to go straight to the object.
+    //! Instances are not followed.
+    virtual ObjectReaderPtr findObject( const std::string &iFullName );
+
     //! Get the read array sample cache. It may be a NULL pointer.
     //! Caches can be shared amongst separate archives, and caching
     //! will is disabled if a NULL cache is returned here.
@@ -123,6 +133,46 @@ public:
     //! of this archive file.
     virtual int32_t getArchiveVersion() = 0;
 
+    //! For archives that were still being written when they were opened,
+    //! picks up what has been committed since (see ArchiveWriter::commit).
+    //! Returns true if there was anything new, in which case getTop and
+    //! findObject return objects that have it.  Objects and properties
+    //! that were already gotten keep what they had, so this may be called
+    //! while the archive is being read on other threads.
+    //! Returns false if the implementation doesn't support this, which is
+    //! the default.
+    virtual bool refresh();
+
+    //! Turns on (or off) counting what is read, see ReadStats.  Counting is
+    //! off by default, and turning it on costs a little on every read.
+    //! What was read while the archive was being opened isn't counted.
+    //! This may be called while the archive is being read on other threads,
+    //! reads already under way may or may not be counted.  By default this
+    //! does nothing.
+    virtual void setStatsEnabled( bool iEnabled );
+
+    //! Fills in what was read since the stats were turned on or last
+    //! reset.  This may be called while the archive is being read on other
+    //! threads.  Returns false if the implementation doesn't count what it
+    //! reads, which is the default.
+    virtual bool getStats( ReadStats & oStats );
+
+    //! Starts the stats, and the trace, over.
+    virtual void resetStats();
+
+    //! Turns on (or off) keeping a trace of every read, its position, size
+    //! and how long it took.  The trace takes memory for every read until it
+    //! is reset, up to a limit after which only the latest reads are kept,
+    //! so this is meant for diagnosing problems, not to be left on.  Like
+    //! setStatsEnabled this may be called while the archive is being read on
+    //! other threads.  By default this does nothing.
+    virtual void setTraceEnabled( bool iEnabled );
+
+    //! Writes the reads that were traced as Chrome trace event JSON, which
+    //! can be viewed with chrome://tracing or Perfetto.  Returns false if
+    //! the implementation doesn't trace its reads, which is the default.
+    virtual bool writeTrace( std::ostream & oStream );
+
     //! Return self
     //! ...
     virtual ArchiveReaderPtr asArchivePtr() = 0;
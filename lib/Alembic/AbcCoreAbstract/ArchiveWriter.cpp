@@ -46,6 +46,12 @@ ArchiveWriter::~ArchiveWriter()
     // Nothing
 }
 
+//-*****************************************************************************
+bool ArchiveWriter::commit()
+{
+    return false;
+}
+
 } // End namespace ALEMBIC_VERSION_NS
 } // End namespace AbcCoreAbstract
 } // End namespace Alembic
@@ -139,6 +139,14 @@ public:
     virtual void setMaxNumSamplesForTimeSamplingIndex( uint32_t iIndex,
                                                        index_t iMaxIndex ) = 0;
 
+    //! Makes everything written so far readable, so that readers can open
+    //! the archive, or pick up what was written since they opened it
+    //! (see ArchiveReader::refresh), before it is done being written.
+    //! Objects and properties that are still open are included with the
+    //! samples they have so far.  Returns false if the implementation
+    //! doesn't support this, which is the default.
+    virtual bool commit();
+
 private:
     int8_t m_compressionHint;
 };
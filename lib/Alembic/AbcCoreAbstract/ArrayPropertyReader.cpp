@@ -46,6 +46,17 @@ ArrayPropertyReader::~ArrayPropertyReader()
     // Nothing
 }
 
+//-*****************************************************************************
+void ArrayPropertyReader::getSamples( index_t iFirstIndex, size_t iNumSamples,
+                                      std::vector< ArraySamplePtr > &oSamples )
+{
+    oSamples.resize( iNumSamples );
+    for ( size_t i = 0; i < iNumSamples; ++i )
+    {
+        getSample( iFirstIndex + ( index_t ) i, oSamples[i] );
+    }
+}
+
 } // End namespace ALEMBIC_VERSION_NS
 } // End namespace AbcCoreAbstract
 } // End namespace Alembic
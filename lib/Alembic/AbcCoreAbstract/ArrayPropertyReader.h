@@ -93,6 +93,14 @@ public:
     virtual void getSample( index_t iSampleIndex,
                             ArraySamplePtr &oSample ) = 0;
 
+    //! Fills oSamples with the iNumSamples samples starting at iFirstIndex,
+    //! the same as calling getSample for each of them.  Implementations
+    //! may (and should) read them more efficiently all at once, and return
+    //! the same ArraySamplePtr for identical samples.
+    //! It will throw an exception if any of the samples are out of range.
+    virtual void getSamples( index_t iFirstIndex, size_t iNumSamples,
+                             std::vector< ArraySamplePtr > &oSamples );
+
     //! Find the largest valid index that has a time less than or equal
     //! to the given time. Invalid to call this with zero samples.
     //! If the minimum sample time is greater than iTime, index
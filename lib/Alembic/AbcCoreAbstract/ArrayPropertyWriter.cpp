@@ -46,6 +46,13 @@ ArrayPropertyWriter::~ArrayPropertyWriter()
     // Nothing
 }
 
+//-*****************************************************************************
+bool ArrayPropertyWriter::copySample( ArrayPropertyReaderPtr iReader,
+                                      index_t iIndex )
+{
+    return false;
+}
+
 } // End namespace ALEMBIC_VERSION_NS
 } // End namespace AbcCoreAbstract
 } // End namespace Alembic
@@ -79,6 +79,18 @@ public:
     //! An important feature!
     virtual void setFromPreviousSample() = 0;
 
+    //! Sets the next sample to sample iIndex of iReader, copying it as it
+    //! is stored rather than decoding and re-encoding it.  This is only
+    //! possible when the reader and writer come from the same kind of
+    //! archive and store their samples the same way.  If it isn't, false
+    //! is returned and no sample is set, and the caller should fall back to
+    //! getting the sample from iReader and passing it to setSample.
+    //! A copied sample reads the same as one that was decoded and set, but
+    //! it isn't necessarily stored byte for byte the same, for instance it
+    //! keeps the compression level it was originally written with.
+    virtual bool copySample( ArrayPropertyReaderPtr iReader,
+                             index_t iIndex );
+
     //! Return the number of samples that have been written so far.
     //! This changes as samples are written.
     virtual size_t getNumSamples() = 0;
@@ -36,13 +36,34 @@
 
 #include <Alembic/AbcCoreAbstract/ArraySample.h>
 #include <Alembic/Util/Murmur3.h>
+#include <Alembic/Util/ChunkedHash.h>
 
 namespace Alembic {
 namespace AbcCoreAbstract {
 namespace ALEMBIC_VERSION_NS {
 
+//-*****************************************************************************
+static void HashData( const void * iData, size_t iNumBytes, size_t iPodSize,
+                      SampleHashID iHashID, Digest & oDigest )
+{
+    if ( iHashID == kChunkedSpookySampleHash )
+    {
+        ChunkedSpookyHash_128( iData, iNumBytes, oDigest.words );
+    }
+    else
+    {
+        MurmurHash3_x64_128( iData, iNumBytes, iPodSize, oDigest.words );
+    }
+}
+
 //-*****************************************************************************
 ArraySample::Key ArraySample::getKey() const
+{
+    return getKey( kMurmur3SampleHash );
+}
+
+//-*****************************************************************************
+ArraySample::Key ArraySample::getKey( SampleHashID iHashID ) const
 {
 
     // Depending on data type, loop over everything.
@@ -54,6 +75,7 @@ ArraySample::Key ArraySample::getKey() const
     k.numBytes = numBytes;
     k.origPOD = m_dataType.getPod();
     k.readPOD = k.origPOD;
+    k.hashID = iHashID;
 
     switch ( m_dataType.getPod() )
     {
@@ -70,60 +92,85 @@ ArraySample::Key ArraySample::getKey() const
     case kFloat32POD:
     case kFloat64POD:
     {
-        MurmurHash3_x64_128( m_data, numBytes, PODNumBytes(m_dataType.getPod()),
-            k.digest.words );
+        HashData( m_data, numBytes, PODNumBytes( m_dataType.getPod() ),
+                  iHashID, k.digest );
     }
     break;
 
     case kStringPOD:
     {
-        std::vector <int8_t> v;
+        const std::string * strs = static_cast<const std::string*>( m_data );
+
+        // each string plus a 0 for the NULL seperator character
+        size_t totalSize = numPods;
         for ( size_t j = 0; j < numPods; ++j )
         {
-            const std::string &str =
-                static_cast<const std::string*>( m_data )[j];
+            totalSize += strs[j].size();
+        }
 
-            size_t strLen = str.length();
-            for ( size_t k = 0; k < strLen; ++k )
+        std::vector <int8_t> v( totalSize );
+        size_t pos = 0;
+        for ( size_t j = 0; j < numPods; ++j )
+        {
+            size_t strLen = strs[j].size();
+            if ( strLen > 0 )
             {
-                v.push_back(str[k]);
+                memcpy( &v[pos], strs[j].data(), strLen );
             }
 
-            // append a 0 for the NULL seperator character
-            v.push_back(0);
+            // the NULL seperator is already there
+            pos += strLen + 1;
         }
 
         int8_t * vptr = NULL;
         if ( !v.empty() )
             vptr = &(v.front());
 
-        MurmurHash3_x64_128( vptr, v.size(), sizeof(int8_t), k.digest.words );
+        HashData( vptr, v.size(), sizeof(int8_t), iHashID, k.digest );
     }
     break;
 
     case kWstringPOD:
     {
-        std::vector <int32_t> v;
+        const std::wstring * wstrs =
+            static_cast<const std::wstring*>( m_data );
+
+        // each string plus a 0 for the NULL seperator character
+        size_t totalSize = numPods;
         for ( size_t j = 0; j < numPods; ++j )
         {
-            const std::wstring &wstr =
-                static_cast<const std::wstring*>( m_data )[j];
+            totalSize += wstrs[j].size();
+        }
 
-            size_t wlen = wstr.length();
-            for (size_t k = 0; k < wlen; ++k)
+        // wchar_t isn't the same size everywhere, so always hash 32 bits
+        std::vector <int32_t> v( totalSize );
+        size_t pos = 0;
+        for ( size_t j = 0; j < numPods; ++j )
+        {
+            const std::wstring &wstr = wstrs[j];
+            size_t wlen = wstr.size();
+            for ( size_t k = 0; k < wlen; ++k )
             {
-                v.push_back(wstr[k]);
+                v[pos + k] = wstr[k];
             }
 
-            // append a 0 for the NULL seperator character
-            v.push_back(0);
+            // the NULL seperator is already there
+            pos += wlen + 1;
         }
 
         int32_t * vptr = NULL;
         if ( !v.empty() )
             vptr = &(v.front());
 
-        MurmurHash3_x64_128( vptr, v.size(), sizeof(int32_t), k.digest.words );
+        // Murmur3 keys have always only hashed the first v.size() bytes
+        // and need to stay that way to match what is already written
+        size_t hashSize = v.size() * sizeof(int32_t);
+        if ( iHashID == kMurmur3SampleHash )
+        {
+            hashSize = v.size();
+        }
+
+        HashData( vptr, hashSize, sizeof(int32_t), iHashID, k.digest );
     }
     break;
 
@@ -102,6 +102,9 @@ public:
     //! This is a calculation.
     Key getKey() const;
 
+    //! Compute the Key, using the given hash function for the digest.
+    Key getKey( SampleHashID iHashID ) const;
+
     //! Return if it is valid.
     //! An empty ArraySample is valid.
     //! however, an ArraySample that is empty and has a scalar
@@ -44,8 +44,27 @@ namespace Alembic {
 namespace AbcCoreAbstract {
 namespace ALEMBIC_VERSION_NS {
 
+//-*****************************************************************************
+//! Identifies the function used to compute the digest of an ArraySampleKey.
+//! Keys with different hash ids are never equal.
+enum SampleHashID
+{
+    //! Util::MurmurHash3_x64_128, the only hash used before hash ids existed
+    kMurmur3SampleHash = 0,
+
+    //! Util::ChunkedSpookyHash_128, a good deal faster on large samples
+    kChunkedSpookySampleHash = 1
+};
+
+//-*****************************************************************************
 struct ArraySampleKey : public Alembic::Util::totally_ordered<ArraySampleKey>
 {
+    ArraySampleKey()
+      : numBytes( 0 )
+      , origPOD( kUnknownPOD )
+      , readPOD( kUnknownPOD )
+      , hashID( kMurmur3SampleHash ) {}
+
     //! total number of bytes of the sample as originally stored
     uint64_t numBytes;
 
@@ -55,6 +74,9 @@ struct ArraySampleKey : public Alembic::Util::totally_ordered<ArraySampleKey>
     //! POD used at read time
     PlainOldDataType readPOD;
 
+    //! How the digest was computed
+    SampleHashID hashID;
+
     Digest digest;
 
     bool operator==( const ArraySampleKey &iRhs ) const
@@ -62,6 +84,7 @@ struct ArraySampleKey : public Alembic::Util::totally_ordered<ArraySampleKey>
         return ( ( numBytes == iRhs.numBytes ) &&
                  ( origPOD  == iRhs.origPOD  ) &&
                  ( readPOD  == iRhs.readPOD  ) &&
+                 ( hashID   == iRhs.hashID   ) &&
                  ( digest ==   iRhs.digest ) );
     };
 
@@ -76,7 +99,10 @@ struct ArraySampleKey : public Alembic::Util::totally_ordered<ArraySampleKey>
                        ( readPOD < iRhs.readPOD ? true :
                          ( readPOD > iRhs.readPOD ? false :
 
-                           ( digest < iRhs.digest ) ) ) ) ) ) );
+                           ( hashID < iRhs.hashID ? true :
+                             ( hashID > iRhs.hashID ? false :
+
+                               ( digest < iRhs.digest ) ) ) ) ) ) ) ) );
     };
 
 };
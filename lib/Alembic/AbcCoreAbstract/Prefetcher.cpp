@@ -0,0 +1,564 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreAbstract/Prefetcher.h>
+#include <Alembic/AbcCoreAbstract/ArchiveReader.h>
+#include <Alembic/AbcCoreAbstract/ObjectReader.h>
+#include <Alembic/AbcCoreAbstract/CompoundPropertyReader.h>
+#include <Alembic/AbcCoreAbstract/ArrayPropertyReader.h>
+
+#include <algorithm>
+#include <deque>
+
+#if ( defined( _MSC_VER ) && _MSC_VER > 1600 ) || \
+    ( !defined( _MSC_VER ) && \
+      ( defined( __GXX_EXPERIMENTAL_CXX0X__ ) || __cplusplus >= 201103L ) )
+#define ALEMBIC_ASYNC_PREFETCH
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace Alembic {
+namespace AbcCoreAbstract {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+// how many samples of an array property are read at a time
+static const size_t kPrefetchBatchSize = 16;
+
+//-*****************************************************************************
+namespace {
+
+struct Request
+{
+    Request()
+        : startTime( 0.0 )
+        , endTime( 0.0 )
+        , children( false )
+        , firstIndex( 0 )
+        , numSamples( 0 )
+    {}
+
+    // only one of these is set
+    std::string path;
+    ObjectReaderPtr object;
+    BasePropertyReaderPtr property;
+
+    chrono_t startTime;
+    chrono_t endTime;
+    bool children;
+
+    // which samples of an array property to read, figured out from the
+    // times the first time the property is visited
+    index_t firstIndex;
+    size_t numSamples;
+};
+
+} // End anonymous namespace
+
+//-*****************************************************************************
+class Prefetcher::PrivateData
+{
+public:
+    PrivateData( size_t iMaxBytes )
+        : maxBytes( iMaxBytes )
+        , numBytes( 0 )
+        , numActive( 0 )
+        , generation( 0 )
+        , stop( false )
+    {}
+
+    // takes the next request off the queue and carries it out
+    void work();
+
+    // carries out iRequest, new requests it makes are pushed onto the front
+    // of the queue unless it was canceled in the meantime
+    void run( Request &iRequest, size_t iGeneration );
+
+    // pushes iRequest onto the back of the queue, the lock must already be
+    // held
+    void push( const Request &iRequest );
+
+    // whether requests from iGeneration should still be carried out
+    bool isCanceled( size_t iGeneration );
+
+    // adds iNumBytes to what has been prefetched, and drops the remaining
+    // requests if we have gone over our budget
+    void addBytes( size_t iNumBytes );
+
+    void cancel();
+
+    // drops the remaining requests, the lock must already be held
+    void dropRequests();
+
+    std::deque< std::pair< Request, size_t > > requests;
+
+    size_t maxBytes;
+    size_t numBytes;
+
+    // how many requests are being carried out right now
+    size_t numActive;
+
+    // bumped whenever the requests are canceled
+    size_t generation;
+
+    bool stop;
+
+#ifdef ALEMBIC_ASYNC_PREFETCH
+    std::mutex mutex;
+
+    // signaled when there are new requests, or when stopping
+    std::condition_variable workCond;
+
+    // signaled when there is nothing left to do
+    std::condition_variable doneCond;
+
+    std::vector< std::thread > threads;
+#endif
+
+    ArchiveReaderPtr archive;
+    ObjectReaderPtr top;
+};
+
+//-*****************************************************************************
+void Prefetcher::PrivateData::push( const Request &iRequest )
+{
+    // nothing left to do, so start counting again
+    if ( requests.empty() && numActive == 0 )
+    {
+        numBytes = 0;
+    }
+
+    requests.push_back( std::make_pair( iRequest, generation ) );
+
+#ifdef ALEMBIC_ASYNC_PREFETCH
+    workCond.notify_one();
+#endif
+}
+
+//-*****************************************************************************
+bool Prefetcher::PrivateData::isCanceled( size_t iGeneration )
+{
+#ifdef ALEMBIC_ASYNC_PREFETCH
+    std::unique_lock< std::mutex > lock( mutex );
+#endif
+    return stop || iGeneration != generation;
+}
+
+//-*****************************************************************************
+void Prefetcher::PrivateData::addBytes( size_t iNumBytes )
+{
+#ifdef ALEMBIC_ASYNC_PREFETCH
+    std::unique_lock< std::mutex > lock( mutex );
+#endif
+    numBytes += iNumBytes;
+
+    if ( numBytes >= maxBytes )
+    {
+        dropRequests();
+    }
+}
+
+//-*****************************************************************************
+void Prefetcher::PrivateData::cancel()
+{
+#ifdef ALEMBIC_ASYNC_PREFETCH
+    std::unique_lock< std::mutex > lock( mutex );
+#endif
+    dropRequests();
+}
+
+//-*****************************************************************************
+void Prefetcher::PrivateData::dropRequests()
+{
+    requests.clear();
+    ++generation;
+
+#ifdef ALEMBIC_ASYNC_PREFETCH
+    // if none of the requests were picked up, no worker is going to tell
+    // anyone waiting that we are done
+    if ( numActive == 0 )
+    {
+        doneCond.notify_all();
+    }
+#endif
+}
+
+//-*****************************************************************************
+void Prefetcher::PrivateData::run( Request &iRequest, size_t iGeneration )
+{
+    std::vector< Request > newRequests;
+
+    if ( !iRequest.path.empty() )
+    {
+        ObjectReaderPtr obj = archive->findObject( iRequest.path );
+        if ( obj )
+        {
+            Request r = iRequest;
+            r.path.clear();
+            r.object = obj;
+            newRequests.push_back( r );
+        }
+    }
+    else if ( iRequest.object )
+    {
+        Request r = iRequest;
+        r.object.reset();
+        r.property = iRequest.object->getProperties();
+        newRequests.push_back( r );
+
+        if ( iRequest.children )
+        {
+            size_t numChildren = iRequest.object->getNumChildren();
+            for ( size_t i = 0; i < numChildren; ++i )
+            {
+                r.property.reset();
+                r.object = iRequest.object->getChild( i );
+                newRequests.push_back( r );
+            }
+        }
+    }
+    else if ( iRequest.property && iRequest.property->isCompound() )
+    {
+        CompoundPropertyReaderPtr cpr = iRequest.property->asCompoundPtr();
+        size_t numProps = cpr->getNumProperties();
+        for ( size_t i = 0; i < numProps; ++i )
+        {
+            const PropertyHeader &header = cpr->getPropertyHeader( i );
+            if ( header.isScalar() )
+            {
+                continue;
+            }
+
+            Request r = iRequest;
+            r.property = cpr->getProperty( header.getName() );
+            newRequests.push_back( r );
+        }
+    }
+    else if ( iRequest.property && iRequest.property->isArray() )
+    {
+        ArrayPropertyReaderPtr apr = iRequest.property->asArrayPtr();
+
+        // figure out which samples we need the first time around
+        if ( iRequest.numSamples == 0 )
+        {
+            if ( apr->getNumSamples() == 0 )
+            {
+                return;
+            }
+
+            index_t first = apr->getFloorIndex( iRequest.startTime ).first;
+            index_t last = apr->getCeilIndex( iRequest.endTime ).first;
+            iRequest.firstIndex = first;
+            iRequest.numSamples = last >= first ? last - first + 1 : 0;
+        }
+
+        size_t numSamples = std::min( iRequest.numSamples,
+                                      kPrefetchBatchSize );
+
+        std::vector< ArraySamplePtr > samps;
+        apr->getSamples( iRequest.firstIndex, numSamples, samps );
+
+        size_t numBytes = 0;
+        for ( size_t i = 0; i < samps.size(); ++i )
+        {
+            // identical samples are shared
+            if ( i > 0 && samps[i] == samps[i - 1] )
+            {
+                continue;
+            }
+
+            numBytes += samps[i]->getDimensions().numPoints() *
+                samps[i]->getDataType().getNumBytes();
+        }
+
+        addBytes( numBytes );
+
+        // come back for the rest
+        if ( numSamples < iRequest.numSamples )
+        {
+            Request r = iRequest;
+            r.firstIndex += numSamples;
+            r.numSamples -= numSamples;
+            newRequests.push_back( r );
+        }
+    }
+
+#ifdef ALEMBIC_ASYNC_PREFETCH
+    std::unique_lock< std::mutex > lock( mutex );
+#endif
+
+    if ( stop || iGeneration != generation )
+    {
+        return;
+    }
+
+    // push them onto the front in reverse, so they are done in order, and
+    // before starting on anything else
+    for ( size_t i = newRequests.size(); i > 0; --i )
+    {
+        requests.push_front( std::make_pair( newRequests[i - 1],
+                                             iGeneration ) );
+    }
+
+#ifdef ALEMBIC_ASYNC_PREFETCH
+    workCond.notify_all();
+#endif
+}
+
+//-*****************************************************************************
+void Prefetcher::PrivateData::work()
+{
+#ifdef ALEMBIC_ASYNC_PREFETCH
+    std::unique_lock< std::mutex > lock( mutex );
+#endif
+
+    while ( !stop )
+    {
+#ifdef ALEMBIC_ASYNC_PREFETCH
+        if ( requests.empty() )
+        {
+            workCond.wait( lock );
+            continue;
+        }
+#else
+        if ( requests.empty() )
+        {
+            return;
+        }
+#endif
+
+        std::pair< Request, size_t > request = requests.front();
+        requests.pop_front();
+        ++numActive;
+
+#ifdef ALEMBIC_ASYNC_PREFETCH
+        lock.unlock();
+#endif
+
+        if ( !isCanceled( request.second ) )
+        {
+            try
+            {
+                run( request.first, request.second );
+            }
+            catch ( ... )
+            {
+                // we'll see it again if it is read for real
+            }
+        }
+
+#ifdef ALEMBIC_ASYNC_PREFETCH
+        lock.lock();
+#endif
+
+        --numActive;
+
+#ifdef ALEMBIC_ASYNC_PREFETCH
+        if ( requests.empty() && numActive == 0 )
+        {
+            doneCond.notify_all();
+        }
+#endif
+    }
+}
+
+//-*****************************************************************************
+Prefetcher::Prefetcher( ArchiveReaderPtr iArchive, size_t iNumThreads,
+                        size_t iMaxBytes )
+    : m_archive( iArchive )
+    , m_data( new PrivateData( iMaxBytes ) )
+{
+    ABCA_ASSERT( m_archive, "Invalid archive" );
+    ABCA_ASSERT( m_archive->getReadArraySampleCachePtr(),
+                 "Can not prefetch samples without an array sample cache" );
+
+    m_data->archive = m_archive;
+    m_data->top = m_archive->getTop();
+
+#ifdef ALEMBIC_ASYNC_PREFETCH
+    if ( iNumThreads < 1 )
+    {
+        iNumThreads = 1;
+    }
+
+    for ( size_t i = 0; i < iNumThreads; ++i )
+    {
+        m_data->threads.push_back(
+            std::thread( &PrivateData::work, m_data.get() ) );
+    }
+#endif
+}
+
+//-*****************************************************************************
+Prefetcher::~Prefetcher()
+{
+#ifdef ALEMBIC_ASYNC_PREFETCH
+    {
+        std::unique_lock< std::mutex > lock( m_data->mutex );
+        m_data->requests.clear();
+        m_data->stop = true;
+        m_data->workCond.notify_all();
+    }
+
+    for ( size_t i = 0; i < m_data->threads.size(); ++i )
+    {
+        m_data->threads[i].join();
+    }
+#endif
+}
+
+//-*****************************************************************************
+void Prefetcher::prefetch( const std::string &iObjectPath,
+                           chrono_t iStartTime, chrono_t iEndTime,
+                           bool iChildren )
+{
+    prefetch( std::vector< std::string >( 1, iObjectPath ), iStartTime,
+              iEndTime, iChildren );
+}
+
+//-*****************************************************************************
+void Prefetcher::prefetch( const std::vector< std::string > &iObjectPaths,
+                           chrono_t iStartTime, chrono_t iEndTime,
+                           bool iChildren )
+{
+    {
+#ifdef ALEMBIC_ASYNC_PREFETCH
+        std::unique_lock< std::mutex > lock( m_data->mutex );
+#endif
+        for ( size_t i = 0; i < iObjectPaths.size(); ++i )
+        {
+            Request r;
+            r.path = iObjectPaths[i];
+
+            // the top object
+            if ( r.path.find_first_not_of( '/' ) == std::string::npos )
+            {
+                r.path.clear();
+                r.object = m_data->top;
+            }
+
+            r.startTime = iStartTime;
+            r.endTime = iEndTime;
+            r.children = iChildren;
+            m_data->push( r );
+        }
+    }
+
+#ifndef ALEMBIC_ASYNC_PREFETCH
+    m_data->work();
+#endif
+}
+
+//-*****************************************************************************
+void Prefetcher::prefetch( ObjectReaderPtr iObject,
+                           chrono_t iStartTime, chrono_t iEndTime,
+                           bool iChildren )
+{
+    ABCA_ASSERT( iObject, "Invalid object" );
+
+    Request r;
+    r.object = iObject;
+    r.startTime = iStartTime;
+    r.endTime = iEndTime;
+    r.children = iChildren;
+
+    {
+#ifdef ALEMBIC_ASYNC_PREFETCH
+        std::unique_lock< std::mutex > lock( m_data->mutex );
+#endif
+        m_data->push( r );
+    }
+
+#ifndef ALEMBIC_ASYNC_PREFETCH
+    m_data->work();
+#endif
+}
+
+//-*****************************************************************************
+void Prefetcher::prefetch( BasePropertyReaderPtr iProperty,
+                           chrono_t iStartTime, chrono_t iEndTime )
+{
+    ABCA_ASSERT( iProperty, "Invalid property" );
+
+    Request r;
+    r.property = iProperty;
+    r.startTime = iStartTime;
+    r.endTime = iEndTime;
+
+    {
+#ifdef ALEMBIC_ASYNC_PREFETCH
+        std::unique_lock< std::mutex > lock( m_data->mutex );
+#endif
+        m_data->push( r );
+    }
+
+#ifndef ALEMBIC_ASYNC_PREFETCH
+    m_data->work();
+#endif
+}
+
+//-*****************************************************************************
+void Prefetcher::cancel()
+{
+    m_data->cancel();
+}
+
+//-*****************************************************************************
+void Prefetcher::wait()
+{
+#ifdef ALEMBIC_ASYNC_PREFETCH
+    std::unique_lock< std::mutex > lock( m_data->mutex );
+    while ( !m_data->requests.empty() || m_data->numActive != 0 )
+    {
+        m_data->doneCond.wait( lock );
+    }
+#endif
+}
+
+//-*****************************************************************************
+size_t Prefetcher::getNumBytes()
+{
+#ifdef ALEMBIC_ASYNC_PREFETCH
+    std::unique_lock< std::mutex > lock( m_data->mutex );
+#endif
+    return m_data->numBytes;
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcCoreAbstract
+} // End namespace Alembic
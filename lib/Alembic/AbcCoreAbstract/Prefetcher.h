@@ -0,0 +1,130 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcCoreAbstract_Prefetcher_h_
+#define _Alembic_AbcCoreAbstract_Prefetcher_h_
+
+#include <Alembic/Util/Export.h>
+#include <Alembic/AbcCoreAbstract/Foundation.h>
+#include <Alembic/AbcCoreAbstract/ForwardDeclarations.h>
+
+namespace Alembic {
+namespace AbcCoreAbstract {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+//! Reads array samples ahead of time on a pool of background threads, so
+//! that when they are asked for later they are found in the
+//! ReadArraySampleCache of the archive instead of being read from the file.
+//! For example, during playback the samples for the next few frames can be
+//! prefetched while the current frame is being drawn.
+//!
+//! Only array samples are prefetched, since those are the ones the cache
+//! holds on to.  Errors while prefetching are ignored, they will show up
+//! again when the sample is read for real.
+//!
+//! Once iMaxBytes worth of samples have been prefetched, the remaining
+//! requests are dropped.  This count starts over when the prefetcher has
+//! nothing left to do.  The cache of the archive should be able to hold at
+//! least this much, or prefetched samples will be pushed out of it by other
+//! prefetched samples.
+//!
+//! If Alembic was built without C++11 support the requests are carried out
+//! right away on the calling thread.
+//! This class is multithread safe.
+class ALEMBIC_EXPORT Prefetcher : Alembic::Util::noncopyable
+{
+public:
+    //! iArchive must have a ReadArraySampleCache.
+    Prefetcher( ArchiveReaderPtr iArchive,
+                size_t iNumThreads = 2,
+                size_t iMaxBytes = 256 * 1024 * 1024 );
+
+    //! Cancels whatever hasn't been prefetched yet.
+    ~Prefetcher();
+
+    //! Prefetch the samples of the array properties of the object at
+    //! iObjectPath (like "/a/b") that are needed between iStartTime and
+    //! iEndTime, and if iChildren is true, the samples of all of its
+    //! descendants as well.
+    void prefetch( const std::string &iObjectPath,
+                   chrono_t iStartTime, chrono_t iEndTime,
+                   bool iChildren = true );
+
+    //! Same as above for each of the paths in iObjectPaths.
+    void prefetch( const std::vector< std::string > &iObjectPaths,
+                   chrono_t iStartTime, chrono_t iEndTime,
+                   bool iChildren = true );
+
+    //! Same as above, starting from iObject.
+    void prefetch( ObjectReaderPtr iObject,
+                   chrono_t iStartTime, chrono_t iEndTime,
+                   bool iChildren = true );
+
+    //! Prefetch the samples of iProperty between iStartTime and iEndTime,
+    //! or if it is a compound property, of all the array properties under
+    //! it.
+    void prefetch( BasePropertyReaderPtr iProperty,
+                   chrono_t iStartTime, chrono_t iEndTime );
+
+    //! Drops all of the requests that haven't been carried out yet, and
+    //! stops the ones that are in progress as soon as possible.
+    void cancel();
+
+    //! Blocks until there is nothing left to prefetch.
+    void wait();
+
+    //! How many bytes worth of samples have been prefetched since the
+    //! prefetcher last had nothing to do.
+    size_t getNumBytes();
+
+    ArchiveReaderPtr getArchive() const { return m_archive; }
+
+private:
+    ArchiveReaderPtr m_archive;
+
+    class PrivateData;
+    Alembic::Util::auto_ptr< PrivateData > m_data;
+};
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcCoreAbstract
+} // End namespace Alembic
+
+#endif
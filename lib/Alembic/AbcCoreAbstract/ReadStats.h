@@ -0,0 +1,148 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcCoreAbstract_ReadStats_h_
+#define _Alembic_AbcCoreAbstract_ReadStats_h_
+
+#include <Alembic/AbcCoreAbstract/Foundation.h>
+#include <Alembic/AbcCoreAbstract/PropertyHeader.h>
+
+namespace Alembic {
+namespace AbcCoreAbstract {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+//! How many buckets ReadStreamStats::lockWaitHistogram has.
+static const size_t kNumLockWaitBuckets = 16;
+
+//-*****************************************************************************
+//! What was read through one of the streams of an archive, see
+//! ArchiveReader::setStatsEnabled.
+struct ReadStreamStats
+{
+    ReadStreamStats()
+      : numReads( 0 )
+      , numBytes( 0 )
+      , numSeeks( 0 )
+      , seekDistance( 0 )
+      , numContended( 0 )
+      , lockWaitNanoseconds( 0 )
+    {
+        for ( size_t i = 0; i < kNumLockWaitBuckets; ++i )
+        {
+            lockWaitHistogram[i] = 0;
+        }
+    }
+
+    uint64_t numReads;
+    uint64_t numBytes;
+
+    //! Reads that didn't start where the read before them ended, and how
+    //! far away from there they started, all together.
+    uint64_t numSeeks;
+    uint64_t seekDistance;
+
+    //! Reads that had to wait for another read to be done with the stream,
+    //! and how long all of the reads waited for it.
+    uint64_t numContended;
+    uint64_t lockWaitNanoseconds;
+
+    //! The first bucket counts the reads that waited less than a
+    //! microsecond (which is most of them, when there is no contention),
+    //! bucket i counts the ones that waited at least 2^(i-1) but less than
+    //! 2^i microseconds, and the last bucket also counts everything longer.
+    uint64_t lockWaitHistogram[kNumLockWaitBuckets];
+};
+
+//-*****************************************************************************
+//! What an archive has read since its stats were turned on or reset, see
+//! ArchiveReader::setStatsEnabled.
+struct ReadStats
+{
+    ReadStats()
+      : numReads( 0 )
+      , numBytes( 0 )
+      , numSeeks( 0 )
+      , seekDistance( 0 )
+      , numMappedReads( 0 )
+      , numMappedBytes( 0 )
+      , objectHeaderBytes( 0 )
+      , numStreamRequests( 0 )
+      , numSharedStreams( 0 )
+    {
+        propertyBytes[kCompoundProperty] = 0;
+        propertyBytes[kScalarProperty] = 0;
+        propertyBytes[kArrayProperty] = 0;
+    }
+
+    //! Everything that was read, both through the streams and from memory
+    //! mapped files.
+    uint64_t numReads;
+    uint64_t numBytes;
+    uint64_t numSeeks;
+    uint64_t seekDistance;
+
+    //! What was read from memory mapped files, which don't use the streams.
+    uint64_t numMappedReads;
+    uint64_t numMappedBytes;
+
+    //! The bytes of the samples read, by the PropertyType of the property
+    //! they belong to.  For kCompoundProperty these are the bytes of the
+    //! headers of the properties in compounds.
+    uint64_t propertyBytes[3];
+
+    //! The bytes of the headers of the children of objects.
+    uint64_t objectHeaderBytes;
+
+    //! How many times a stream was handed out to read something, and how
+    //! many of those had to share a stream with other reads, because every
+    //! stream was already in use.  If many streams are shared, opening the
+    //! archive with more streams may help.
+    uint64_t numStreamRequests;
+    uint64_t numSharedStreams;
+
+    //! By the id of the stream.
+    std::vector< ReadStreamStats > streams;
+};
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcCoreAbstract
+} // End namespace Alembic
+
+#endif
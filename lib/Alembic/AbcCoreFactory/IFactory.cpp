@@ -49,6 +49,10 @@ IFactory::IFactory()
 {
     m_cacheHierarchy = true;
     m_numStreams = 1;
+    m_readStrategy = kFileStreams;
+    m_preloadHierarchy = false;
+    m_statsEnabled = false;
+    m_traceEnabled = false;
     m_policy = Alembic::Abc::ErrorHandler::kThrowPolicy;
 }
 
@@ -61,7 +65,8 @@ Alembic::Abc::IArchive IFactory::getArchive( const std::string & iFileName,
 {
 
     // try Ogawa first, use kQuietNoop at first in case we fail
-    Alembic::AbcCoreOgawa::ReadArchive ogawa( m_numStreams );
+    Alembic::AbcCoreOgawa::ReadArchive ogawa( m_numStreams,
+        m_readStrategy == kMemoryMappedFiles, m_preloadHierarchy );
     Alembic::Abc::IArchive archive( ogawa, iFileName,
         Alembic::Abc::ErrorHandler::kQuietNoopPolicy, m_cachePtr );
 
@@ -69,6 +74,8 @@ Alembic::Abc::IArchive IFactory::getArchive( const std::string & iFileName,
     {
         oType = kOgawa;
         archive.getErrorHandler().setPolicy( m_policy );
+        archive.setStatsEnabled( m_statsEnabled );
+        archive.setTraceEnabled( m_traceEnabled );
         return archive;
     }
 
@@ -117,11 +124,13 @@ Alembic::Abc::IArchive IFactory::getArchive(
     const std::vector< std::istream * > & iStreams, CoreType & oType)
 {
     // Ogawa is the only one which can do this
-    Alembic::AbcCoreOgawa::ReadArchive ogawa( iStreams );
+    Alembic::AbcCoreOgawa::ReadArchive ogawa( iStreams, m_preloadHierarchy );
     Alembic::Abc::IArchive archive( ogawa, "", m_policy, m_cachePtr );
     if ( archive.valid() )
     {
         oType = kOgawa;
+        archive.setStatsEnabled( m_statsEnabled );
+        archive.setTraceEnabled( m_traceEnabled );
         return archive;
     }
 
@@ -84,7 +84,8 @@ public:
     //! Gets whether an HDF5 file will use the cached hierarchy
     bool getHDF5CacheHierarchy() const { return m_cacheHierarchy; }
 
-    //! Set the array sample cache, the HDF5 implementation optionally uses this
+    //! Set the array sample cache, both the HDF5 and Ogawa implementations
+    //! optionally use this.  For Ogawa see AbcCoreOgawa::CreateCache
     void setSampleCache(
         Alembic::AbcCoreAbstract::ReadArraySampleCachePtr iCachePtr )
     {
@@ -108,6 +109,58 @@ public:
         m_numStreams = iNumStreams;
     }
 
+    //! How the data in an Ogawa file is read
+    enum OgawaReadStrategy
+    {
+        kFileStreams,
+        kMemoryMappedFiles
+    };
+
+    //! Sets how an Ogawa file will be read, the default is kFileStreams.
+    //! kMemoryMappedFiles maps the whole file into memory and services reads
+    //! without locking, so the number of Ogawa streams is ignored.  If the
+    //! file can not be mapped, file streams will be used instead.
+    void setOgawaReadStrategy( OgawaReadStrategy iStrategy )
+    {
+        m_readStrategy = iStrategy;
+    }
+
+    //! Gets how an Ogawa file will be read
+    OgawaReadStrategy getOgawaReadStrategy() const { return m_readStrategy; }
+
+    //! If opening an Ogawa file, sets whether to read the headers of the
+    //! whole hierarchy up front, in parallel across the Ogawa streams, the
+    //! default is false.  See AbcCoreOgawa::ReadArchive.
+    void setOgawaPreloadHierarchy( bool iPreloadHierarchy )
+    {
+        m_preloadHierarchy = iPreloadHierarchy;
+    }
+
+    //! Gets whether the headers of an Ogawa file will be read up front
+    bool getOgawaPreloadHierarchy() const { return m_preloadHierarchy; }
+
+    //! If opening an Ogawa file, sets whether to count what it reads as
+    //! soon as it is opened, the default is false.  See
+    //! IArchive::setStatsEnabled and IArchive::getStats.
+    void setOgawaStatsEnabled( bool iStatsEnabled )
+    {
+        m_statsEnabled = iStatsEnabled;
+    }
+
+    //! Gets whether what an Ogawa file reads will be counted
+    bool getOgawaStatsEnabled() const { return m_statsEnabled; }
+
+    //! If opening an Ogawa file, sets whether to trace every read it makes
+    //! as soon as it is opened, the default is false.  See
+    //! IArchive::setTraceEnabled and IArchive::writeTrace.
+    void setOgawaTraceEnabled( bool iTraceEnabled )
+    {
+        m_traceEnabled = iTraceEnabled;
+    }
+
+    //! Gets whether the reads of an Ogawa file will be traced
+    bool getOgawaTraceEnabled() const { return m_traceEnabled; }
+
     //! Gets the error handler policy
     Alembic::Abc::ErrorHandler::Policy getPolicy() { return m_policy; }
 
@@ -120,6 +173,10 @@ public:
 private:
     bool m_cacheHierarchy;
     size_t m_numStreams;
+    OgawaReadStrategy m_readStrategy;
+    bool m_preloadHierarchy;
+    bool m_statsEnabled;
+    bool m_traceEnabled;
     Alembic::AbcCoreAbstract::ReadArraySampleCachePtr m_cachePtr;
     Alembic::Abc::ErrorHandler::Policy m_policy;
 
@@ -36,6 +36,7 @@
 
 #include <Alembic/AbcCoreOgawa/AprImpl.h>
 #include <Alembic/AbcCoreOgawa/ReadUtil.h>
+#include <Alembic/AbcCoreOgawa/CompressUtil.h>
 #include <Alembic/AbcCoreOgawa/StreamManager.h>
 #include <Alembic/AbcCoreOgawa/OrImpl.h>
 
@@ -43,6 +44,28 @@ namespace Alembic {
 namespace AbcCoreOgawa {
 namespace ALEMBIC_VERSION_NS {
 
+//-*****************************************************************************
+// fills in the digest and size of the data for the sample key
+static void ReadKey( Ogawa::IDataPtr iData,
+                     std::size_t iThreadId,
+                     bool iCompressed,
+                     AbcA::ArraySampleKey & oKey )
+{
+    if ( iData->getSize() >= 16 )
+    {
+        if ( iCompressed )
+        {
+            oKey.numBytes = ReadUncompressedSize( iData, iThreadId );
+        }
+        else
+        {
+            oKey.numBytes = iData->getSize() - 16;
+        }
+
+        iData->read( 16, oKey.digest.d, 0, iThreadId );
+    }
+}
+
 //-*****************************************************************************
 AprImpl::AprImpl( AbcA::CompoundPropertyReaderPtr iParent,
                   Ogawa::IGroupPtr iGroup,
@@ -104,14 +127,136 @@ void AprImpl::getSample( index_t iSampleIndex, AbcA::ArraySamplePtr &oSample )
 {
     size_t index = m_header->verifyIndex( iSampleIndex ) * 2;
 
-    StreamIDPtr streamId = Alembic::Util::dynamic_pointer_cast< ArImpl,
-        AbcA::ArchiveReader > ( getObject()->getArchive() )->getStreamID();
+    Util::shared_ptr< ArImpl > ar = Alembic::Util::dynamic_pointer_cast<
+        ArImpl, AbcA::ArchiveReader > ( getObject()->getArchive() );
+    StreamIDPtr streamId = ar->getStreamID();
 
     std::size_t id = streamId->getID();
     Ogawa::IDataPtr dims = m_group->getData(index + 1, id);
     Ogawa::IDataPtr data = m_group->getData(index, id);
 
-    ReadArraySample( dims, data, id, m_header->header.getDataType(), oSample );
+    readSample( dims, data, id, *ar, oSample );
+}
+
+//-*****************************************************************************
+void AprImpl::getSamples( index_t iFirstIndex, size_t iNumSamples,
+                          std::vector< AbcA::ArraySamplePtr > &oSamples )
+{
+    oSamples.clear();
+    oSamples.resize( iNumSamples );
+
+    if ( iNumSamples == 0 )
+    {
+        return;
+    }
+
+    // the group index of each sample, samples that are the same as the one
+    // before them aren't written, so several may share the same index
+    std::vector< size_t > sampleIndices( iNumSamples );
+    std::vector< Util::uint64_t > groupIndices;
+    for ( size_t i = 0; i < iNumSamples; ++i )
+    {
+        sampleIndices[i] =
+            m_header->verifyIndex( iFirstIndex + ( index_t ) i ) * 2;
+
+        if ( i == 0 || sampleIndices[i] != sampleIndices[i - 1] )
+        {
+            groupIndices.push_back( sampleIndices[i] );
+            groupIndices.push_back( sampleIndices[i] + 1 );
+        }
+    }
+
+    Util::shared_ptr< ArImpl > ar = Alembic::Util::dynamic_pointer_cast<
+        ArImpl, AbcA::ArchiveReader > ( getObject()->getArchive() );
+    StreamIDPtr streamId = ar->getStreamID();
+    std::size_t id = streamId->getID();
+
+    std::vector< Ogawa::IDataPtr > groupData;
+    m_group->getData( groupIndices, id, groupData );
+
+    // identical samples that weren't next to each other when they were
+    // written point at the same data and dimensions
+    typedef std::pair< Util::uint64_t, Util::uint64_t > PosPair;
+    std::map< PosPair, size_t > readSamples;
+
+    size_t dataIndex = 0;
+    for ( size_t i = 0; i < iNumSamples; ++i )
+    {
+        if ( i > 0 && sampleIndices[i] == sampleIndices[i - 1] )
+        {
+            oSamples[i] = oSamples[i - 1];
+            continue;
+        }
+
+        Ogawa::IDataPtr data = groupData[dataIndex];
+        Ogawa::IDataPtr dims = groupData[dataIndex + 1];
+        dataIndex += 2;
+
+        PosPair pos( data ? data->getPos() : 0, dims ? dims->getPos() : 0 );
+        std::map< PosPair, size_t >::iterator it = readSamples.find( pos );
+        if ( it != readSamples.end() )
+        {
+            oSamples[i] = oSamples[it->second];
+            continue;
+        }
+
+        readSample( dims, data, id, *ar, oSamples[i] );
+        readSamples[pos] = i;
+    }
+}
+
+//-*****************************************************************************
+void AprImpl::readSample( Ogawa::IDataPtr iDims, Ogawa::IDataPtr iData,
+                          std::size_t iThreadId, ArImpl & iArchive,
+                          AbcA::ArraySamplePtr &oSample )
+{
+    const AbcA::DataType & dataType = m_header->header.getDataType();
+
+    AbcA::ReadArraySampleCachePtr cache =
+        iArchive.getReadArraySampleCachePtr();
+
+    // the key doesn't know about the dimensions or extent, so make sure
+    // whatever we find in the cache matches what we'd read ourselves
+    AbcA::ArraySampleKey key;
+    Util::Dimensions sampleDims;
+    if ( cache && iData->getSize() >= 16 )
+    {
+        key.readPOD = dataType.getPod();
+        key.origPOD = key.readPOD;
+        key.hashID = iArchive.getSampleHashID();
+        ReadKey( iData, iThreadId, m_header->isCompressed, key );
+
+        ReadDimensions( iDims, iData, iThreadId, dataType,
+                        m_header->isCompressed, sampleDims );
+
+        AbcA::ReadArraySampleID found = cache->find( key );
+        if ( found && found.getSample()->getDataType() == dataType &&
+             found.getSample()->getDimensions() == sampleDims )
+        {
+            oSample = found.getSample();
+            return;
+        }
+    }
+    else
+    {
+        cache.reset();
+    }
+
+    ReadArraySample( iDims, iData, iThreadId, dataType,
+                     m_header->isCompressed, oSample );
+
+    iArchive.countPropertyBytes( AbcA::kArrayProperty,
+        ( iData ? iData->getSize() : 0 ) + ( iDims ? iDims->getSize() : 0 ) );
+
+    if ( cache )
+    {
+        AbcA::ReadArraySampleID stored = cache->store( key, oSample );
+        if ( stored && stored.getSample()->getDataType() == dataType &&
+             stored.getSample()->getDimensions() == sampleDims )
+        {
+            oSample = stored.getSample();
+        }
+    }
 }
 
 //-*****************************************************************************
@@ -145,20 +290,17 @@ bool AprImpl::getKey( index_t iSampleIndex, AbcA::ArraySampleKey & oKey )
     // * 2 for Array properties (since we also write the dimensions)
     size_t index = m_header->verifyIndex( iSampleIndex ) * 2;
 
-    StreamIDPtr streamId = Alembic::Util::dynamic_pointer_cast< ArImpl,
-        AbcA::ArchiveReader > ( getObject()->getArchive() )->getStreamID();
+    Util::shared_ptr< ArImpl > ar = Alembic::Util::dynamic_pointer_cast<
+        ArImpl, AbcA::ArchiveReader > ( getObject()->getArchive() );
+    oKey.hashID = ar->getSampleHashID();
+    StreamIDPtr streamId = ar->getStreamID();
 
     std::size_t id = streamId->getID();
     Ogawa::IDataPtr data = m_group->getData( index, id );
 
     if ( data )
     {
-        if ( data->getSize() >= 16 )
-        {
-            oKey.numBytes = data->getSize() - 16;
-            data->read( 16, oKey.digest.d, 0, id );
-        }
-
+        ReadKey( data, id, m_header->isCompressed, oKey );
         return true;
     }
 
@@ -177,14 +319,16 @@ void AprImpl::getDimensions( index_t iSampleIndex,
 {
     size_t index = m_header->verifyIndex( iSampleIndex ) * 2;
 
-    StreamIDPtr streamId = Alembic::Util::dynamic_pointer_cast< ArImpl,
-        AbcA::ArchiveReader > ( getObject()->getArchive() )->getStreamID();
+    Util::shared_ptr< ArImpl > ar = Alembic::Util::dynamic_pointer_cast<
+        ArImpl, AbcA::ArchiveReader > ( getObject()->getArchive() );
+    StreamIDPtr streamId = ar->getStreamID();
 
     std::size_t id = streamId->getID();
     Ogawa::IDataPtr dims = m_group->getData(index + 1, id);
     Ogawa::IDataPtr data = m_group->getData(index, id);
 
-    ReadDimensions( dims, data, id, m_header->header.getDataType(), oDim );
+    ReadDimensions( dims, data, id, m_header->header.getDataType(),
+                    m_header->isCompressed, oDim );
 
 }
 
@@ -194,12 +338,61 @@ void AprImpl::getAs( index_t iSampleIndex, void *iIntoLocation,
 {
     size_t index = m_header->verifyIndex( iSampleIndex ) * 2;
 
-    StreamIDPtr streamId = Alembic::Util::dynamic_pointer_cast< ArImpl,
-        AbcA::ArchiveReader > ( getObject()->getArchive() )->getStreamID();
+    Util::shared_ptr< ArImpl > ar = Alembic::Util::dynamic_pointer_cast<
+        ArImpl, AbcA::ArchiveReader > ( getObject()->getArchive() );
+    StreamIDPtr streamId = ar->getStreamID();
 
     std::size_t id = streamId->getID();
     Ogawa::IDataPtr data = m_group->getData( index, id );
-    ReadData( iIntoLocation, data, id, m_header->header.getDataType(), iPod );
+    ReadData( iIntoLocation, data, id, m_header->header.getDataType(), iPod,
+              m_header->isCompressed );
+
+    if ( data )
+    {
+        ar->countPropertyBytes( AbcA::kArrayProperty, data->getSize() );
+    }
+}
+
+//-*****************************************************************************
+void AprImpl::readRawSample( index_t iSampleIndex,
+                             std::vector< Util::uint8_t > & oBytes )
+{
+    size_t index = m_header->verifyIndex( iSampleIndex ) * 2;
+
+    Util::shared_ptr< ArImpl > ar = Alembic::Util::dynamic_pointer_cast<
+        ArImpl, AbcA::ArchiveReader > ( getObject()->getArchive() );
+    StreamIDPtr streamId = ar->getStreamID();
+
+    std::size_t id = streamId->getID();
+    Ogawa::IDataPtr data = m_group->getData( index, id );
+
+    oBytes.clear();
+    if ( data && data->getSize() > 0 )
+    {
+        oBytes.resize( data->getSize() );
+        data->read( data->getSize(), &oBytes.front(), 0, id );
+        ar->countPropertyBytes( AbcA::kArrayProperty, data->getSize() );
+    }
+}
+
+//-*****************************************************************************
+Util::uint8_t AprImpl::getStoredCodec( index_t iSampleIndex )
+{
+    size_t index = m_header->verifyIndex( iSampleIndex ) * 2;
+
+    Util::shared_ptr< ArImpl > ar = Alembic::Util::dynamic_pointer_cast<
+        ArImpl, AbcA::ArchiveReader > ( getObject()->getArchive() );
+    StreamIDPtr streamId = ar->getStreamID();
+
+    std::size_t id = streamId->getID();
+    Ogawa::IDataPtr data = m_group->getData( index, id );
+
+    if ( !data || !m_header->isCompressed )
+    {
+        return kStoredCodec;
+    }
+
+    return ReadCompressionCodec( data, id );
 }
 
 } // End namespace ALEMBIC_VERSION_NS
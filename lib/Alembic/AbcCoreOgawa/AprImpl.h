@@ -43,6 +43,8 @@ namespace Alembic {
 namespace AbcCoreOgawa {
 namespace ALEMBIC_VERSION_NS {
 
+class ArImpl;
+
 //-*****************************************************************************
 class AprImpl :
     public AbcA::ArrayPropertyReader,
@@ -64,6 +66,8 @@ public:
     virtual bool isConstant();
     virtual void getSample( index_t iSampleIndex,
                             AbcA::ArraySamplePtr &oSample );
+    virtual void getSamples( index_t iFirstIndex, size_t iNumSamples,
+                             std::vector< AbcA::ArraySamplePtr > &oSamples );
     virtual std::pair<index_t, chrono_t> getFloorIndex( chrono_t iTime );
     virtual std::pair<index_t, chrono_t> getCeilIndex( chrono_t iTime );
     virtual std::pair<index_t, chrono_t> getNearIndex( chrono_t iTime );
@@ -74,8 +78,25 @@ public:
     virtual void getAs( index_t iSample, void *iIntoLocation,
                         Alembic::Util::PlainOldDataType iPod );
 
+    // whether our samples are stored compressed
+    bool isCompressed() const { return m_header->isCompressed; }
+
+    // reads the sample at iSampleIndex exactly as it is stored, starting
+    // with its 16 byte key, so that it can be copied to another archive
+    void readRawSample( index_t iSampleIndex,
+                        std::vector< Util::uint8_t > & oBytes );
+
+    // the codec the sample at iSampleIndex was compressed with, see
+    // CompressUtil.h, only meaningful if we are compressed
+    Util::uint8_t getStoredCodec( index_t iSampleIndex );
+
 private:
 
+    // reads the sample from iDims and iData, or finds it in the cache
+    void readSample( Ogawa::IDataPtr iDims, Ogawa::IDataPtr iData,
+                     std::size_t iThreadId, ArImpl & iArchive,
+                     AbcA::ArraySamplePtr &oSample );
+
     // Parent compound property writer. It must exist.
     AbcA::CompoundPropertyReaderPtr m_parent;
 
@@ -37,18 +37,52 @@
 #include <Alembic/AbcCoreOgawa/ApwImpl.h>
 #include <Alembic/AbcCoreOgawa/CpwImpl.h>
 #include <Alembic/AbcCoreOgawa/WriteUtil.h>
+#include <Alembic/AbcCoreOgawa/AwImpl.h>
+#include <Alembic/AbcCoreOgawa/AprImpl.h>
+#include <Alembic/AbcCoreOgawa/ArImpl.h>
+#include <Alembic/AbcCoreOgawa/ReadUtil.h>
+#include <Alembic/AbcCoreOgawa/CompressUtil.h>
 
 namespace Alembic {
 namespace AbcCoreOgawa {
 namespace ALEMBIC_VERSION_NS {
 
+//-*****************************************************************************
+// Holds onto a copy of a sample given to the ApwImpl until the archives write
+// queue gets around to writing it.
+class ApwWriteTask : public SampleWriteTask
+{
+public:
+    ApwWriteTask( ApwImpl * iWriter, const AbcA::ArraySample * iSamp,
+                  Util::uint32_t iIndex, AbcA::SampleHashID iHashID )
+        : SampleWriteTask( iSamp, iHashID ), m_writer( iWriter )
+        , m_index( iIndex ) {}
+
+    virtual void write()
+    {
+        if ( getSample() )
+        {
+            m_writer->writeSample( *getSample(), getKey(), m_index );
+        }
+        else
+        {
+            m_writer->writePreviousSample();
+        }
+    }
+
+private:
+    // the writer waits for the queue before it is destroyed
+    ApwImpl * m_writer;
+    Util::uint32_t m_index;
+};
+
 //-*****************************************************************************
 ApwImpl::ApwImpl( AbcA::CompoundPropertyWriterPtr iParent,
                   Ogawa::OGroupPtr iGroup,
                   PropertyHeaderPtr iHeader,
                   size_t iIndex ) :
     m_parent( iParent ), m_header( iHeader ), m_group( iGroup ), m_dims( 1 ),
-    m_index( iIndex )
+    m_index( iIndex ), m_compressionHint( -1 )
 {
     ABCA_ASSERT( m_parent, "Invalid parent" );
     ABCA_ASSERT( m_header, "Invalid property header" );
@@ -67,6 +101,13 @@ ApwImpl::~ApwImpl()
 {
     AbcA::ArchiveWriterPtr archive = m_parent->getObject()->getArchive();
 
+    // our samples may still be waiting to be written
+    AwImpl * aw = dynamic_cast< AwImpl * >( archive.get() );
+    if ( aw )
+    {
+        aw->waitForWritesNoThrow();
+    }
+
     index_t maxSamples = archive->getMaxNumSamplesForTimeSamplingIndex(
             m_header->timeSamplingIndex );
 
@@ -118,12 +159,31 @@ void ApwImpl::setFromPreviousSample()
     ABCA_ASSERT( m_header->nextSampleIndex > 0,
         "Can't set from previous sample before any samples have been written" );
 
+    AwImpl * aw = dynamic_cast< AwImpl * >( getObject()->getArchive().get() );
+    ABCA_ASSERT( aw, "NULL Impl Ptr" );
+
+    WriteQueue * queue = aw->getWriteQueue();
+    if ( queue )
+    {
+        queue->push( new ApwWriteTask( this, NULL,
+                                       m_header->nextSampleIndex,
+                                       aw->getSampleHashID() ) );
+    }
+    else
+    {
+        writePreviousSample();
+    }
+
+    m_header->nextSampleIndex ++;
+}
+
+//-*****************************************************************************
+void ApwImpl::writePreviousSample()
+{
     Util::Digest digest = m_previousWrittenSampleID->getKey().digest;
     HashDimensions( m_dims, digest );
     Util::SpookyHash::ShortEnd(m_hash.words[0], m_hash.words[1],
                               digest.words[0], digest.words[1]);
-
-    m_header->nextSampleIndex ++;
 }
 
 //-*****************************************************************************
@@ -143,86 +203,328 @@ void ApwImpl::setSample( const AbcA::ArraySample & iSamp )
         ", does not match the DataType of the Array property: " <<
         m_header->header.getDataType() );
 
-    // The Key helps us analyze the sample.
-     AbcA::ArraySample::Key key = iSamp.getKey();
+    AbcA::ArchiveWriterPtr awp = this->getObject()->getArchive();
 
-     // mask out the non-string POD since Ogawa can safely share the same data
-     // even if it originated from a different POD
-     // the non-fixed sizes of our strings (plus added null characters) makes
-     // determing the sie harder so strings are handled seperately
-    if ( key.origPOD != Alembic::Util::kStringPOD &&
-         key.origPOD != Alembic::Util::kWstringPOD )
+    AwImpl * aw = dynamic_cast< AwImpl * >( awp.get() );
+    ABCA_ASSERT( aw, "NULL Impl Ptr" );
+
+    // whether or not we compress is decided by our first sample
+    if ( m_header->nextSampleIndex == 0 )
     {
-        key.origPOD = Alembic::Util::kInt8POD;
-        key.readPOD = Alembic::Util::kInt8POD;
+        m_compressionHint = awp->getCompressionHint() >= 0 ?
+            awp->getCompressionHint() : -1;
     }
 
-    // We need to write the sample
-    if ( m_header->nextSampleIndex == 0  ||
-         !( m_previousWrittenSampleID &&
-            key == m_previousWrittenSampleID->getKey() ) )
+    WriteQueue * queue = aw->getWriteQueue();
+    if ( queue )
     {
+        queue->push( new ApwWriteTask( this, &iSamp,
+                                       m_header->nextSampleIndex,
+                                       aw->getSampleHashID() ) );
+    }
+    else
+    {
+        // The Key helps us analyze the sample.
+        writeSample( iSamp,
+                     GetWrittenSampleKey( iSamp, aw->getSampleHashID() ),
+                     m_header->nextSampleIndex );
+    }
+
+    m_header->nextSampleIndex ++;
+}
+
+//-*****************************************************************************
+bool ApwImpl::needsWrite( const AbcA::ArraySample::Key & iKey,
+                          Util::uint32_t iIndex ) const
+{
+    return iIndex == 0 || !( m_previousWrittenSampleID &&
+                             iKey == m_previousWrittenSampleID->getKey() );
+}
 
-        // we only need to repeat samples if this is not the first change
-        if (m_header->firstChangedIndex != 0)
+//-*****************************************************************************
+void ApwImpl::repeatPreviousSample( Util::uint32_t iIndex,
+                                    Util::PlainOldDataType iPod )
+{
+    // we only need to repeat samples if this is not the first change
+    if (m_header->firstChangedIndex != 0)
+    {
+        // copy the samples from after the last change to the latest index
+        for ( index_t smpI = m_header->lastChangedIndex + 1;
+            smpI < iIndex; ++smpI )
         {
-            // copy the samples from after the last change to the latest index
-            for ( index_t smpI = m_header->lastChangedIndex + 1;
-                smpI < m_header->nextSampleIndex; ++smpI )
-            {
-                assert( smpI > 0 );
-                CopyWrittenData( m_group, m_previousWrittenSampleID );
-                WriteDimensions( m_group, m_dims,
-                                 iSamp.getDataType().getPod() );
-            }
+            assert( smpI > 0 );
+            CopyWrittenData( m_group, m_previousWrittenSampleID );
+            WriteDimensions( m_group, m_dims, iPod );
         }
+    }
+}
+
+//-*****************************************************************************
+void ApwImpl::sampleWritten( Util::uint32_t iIndex )
+{
+    // if we haven't written this already, isScalarLike will be true
+    if ( m_header->isScalarLike && m_dims.numPoints() != 1 )
+    {
+        m_header->isScalarLike = false;
+    }
+
+    if ( m_header->isHomogenous && m_previousWrittenSampleID &&
+         m_dims.numPoints() !=
+         m_previousWrittenSampleID->getNumPoints() )
+    {
+        m_header->isHomogenous = false;
+    }
+
+    if (m_header->firstChangedIndex == 0)
+    {
+        m_header->firstChangedIndex = iIndex;
+    }
+
+    // this index is now the last change
+    m_header->lastChangedIndex = iIndex;
+}
+
+//-*****************************************************************************
+void ApwImpl::accumulateHash( Util::uint32_t iIndex )
+{
+    Util::Digest digest = m_previousWrittenSampleID->getKey().digest;
+    HashDimensions( m_dims, digest );
+    if ( iIndex == 0 )
+    {
+        m_hash = digest;
+    }
+    else
+    {
+        Util::SpookyHash::ShortEnd(m_hash.words[0], m_hash.words[1],
+                                   digest.words[0], digest.words[1]);
+    }
+}
+
+//-*****************************************************************************
+void ApwImpl::writeSample( const AbcA::ArraySample & iSamp,
+                           const AbcA::ArraySample::Key & iKey,
+                           Util::uint32_t iIndex )
+{
+    // We need to write the sample
+    if ( needsWrite( iKey, iIndex ) )
+    {
+        repeatPreviousSample( iIndex, iSamp.getDataType().getPod() );
 
         // Write this sample, which will update its internal
         // cache of what the previously written sample was.
-        AbcA::ArchiveWriterPtr awp = this->getObject()->getArchive();
+        AwImpl * aw = dynamic_cast< AwImpl * >(
+            this->getObject()->getArchive().get() );
+        ABCA_ASSERT( aw, "NULL Impl Ptr" );
+
+        if ( iIndex == 0 && m_compressionHint >= 0 )
+        {
+            m_header->isCompressed = true;
+            aw->setHasCompressedSamples();
+        }
 
         // Write the sample.
         // This distinguishes between string, wstring, and regular arrays.
-        m_previousWrittenSampleID =
-            WriteData( GetWrittenSampleMap( awp ), m_group, iSamp, key );
+        if ( m_header->isCompressed )
+        {
+            m_previousWrittenSampleID =
+                WriteData( aw->getCompressedSampleMap(), m_group, iSamp, iKey,
+                           m_compressionHint, aw->getCompressionCodec() );
+        }
+        else
+        {
+            m_previousWrittenSampleID =
+                WriteData( aw->getWrittenSampleMap(), m_group, iSamp, iKey );
+        }
 
         m_dims = iSamp.getDimensions();
         WriteDimensions( m_group, m_dims, iSamp.getDataType().getPod() );
 
-        // if we haven't written this already, isScalarLike will be true
-        if ( m_header->isScalarLike && m_dims.numPoints() != 1 )
+        sampleWritten( iIndex );
+    }
+
+    accumulateHash( iIndex );
+}
+
+//-*****************************************************************************
+bool ApwImpl::copySample( AbcA::ArrayPropertyReaderPtr iReader,
+                          index_t iIndex )
+{
+    // we can only copy what an Ogawa archive has stored the same way we'd
+    // store it ourselves
+    AprImpl * apr = dynamic_cast< AprImpl * >( iReader.get() );
+    if ( !apr || apr->getHeader().getDataType() !=
+         m_header->header.getDataType() )
+    {
+        return false;
+    }
+
+    AbcA::ArchiveWriterPtr awp = this->getObject()->getArchive();
+    AwImpl * aw = dynamic_cast< AwImpl * >( awp.get() );
+    ABCA_ASSERT( aw, "NULL Impl Ptr" );
+
+    // the stored keys are only good to us if they were hashed the same way
+    AbcA::ArchiveReaderPtr arp = apr->getObject()->getArchive();
+    ArImpl * ar = dynamic_cast< ArImpl * >( arp.get() );
+    if ( !ar || ar->getSampleHashID() != aw->getSampleHashID() )
+    {
+        return false;
+    }
+
+    // whether or not we compress is decided by our first sample
+    Util::int8_t compressionHint = m_compressionHint;
+    if ( m_header->nextSampleIndex == 0 )
+    {
+        compressionHint = awp->getCompressionHint() >= 0 ?
+            awp->getCompressionHint() : -1;
+    }
+
+    if ( apr->isCompressed() != ( compressionHint >= 0 ) )
+    {
+        return false;
+    }
+
+    // a sample compressed with another codec is decoded and compressed
+    // again with ours.  The level isn't stored so it can't be compared, a
+    // sample compressed with our codec is copied at whatever level it was
+    // compressed with, as is one that was stored because it didn't get
+    // any smaller.
+    if ( apr->isCompressed() )
+    {
+        Util::uint8_t codec = apr->getStoredCodec( iIndex );
+        if ( codec != kStoredCodec && codec != aw->getCompressionCodec() )
         {
-            m_header->isScalarLike = false;
+            AbcA::ArraySamplePtr sample;
+            apr->getSample( iIndex, sample );
+            setSample( *sample );
+            return true;
         }
+    }
+
+    ABCA_ASSERT(
+        !m_header->header.getTimeSampling()->getTimeSamplingType().isAcyclic()
+        || m_header->header.getTimeSampling()->getNumStoredTimes() >
+        m_header->nextSampleIndex,
+        "Can not write more samples than we have times for when using "
+        "Acyclic sampling." );
 
-        if ( m_header->isHomogenous && m_previousWrittenSampleID &&
-             m_dims.numPoints() !=
-             m_previousWrittenSampleID->getNumPoints() )
+    m_compressionHint = compressionHint;
+
+    // anything we've queued up has to be written before this sample
+    if ( aw->getWriteQueue() )
+    {
+        aw->waitForWrites();
+    }
+
+    const AbcA::DataType & dataType = m_header->header.getDataType();
+    Util::PlainOldDataType pod = dataType.getPod();
+
+    AbcA::Dimensions dims;
+    apr->getDimensions( iIndex, dims );
+
+    // build the same key that GetWrittenSampleKey would have given us for
+    // the decoded sample
+    AbcA::ArraySample::Key key;
+    apr->getKey( iIndex, key );
+    key.numBytes = dataType.getNumBytes() * dims.numPoints();
+    key.hashID = aw->getSampleHashID();
+    if ( pod != Alembic::Util::kStringPOD &&
+         pod != Alembic::Util::kWstringPOD )
+    {
+        key.origPOD = Alembic::Util::kInt8POD;
+        key.readPOD = Alembic::Util::kInt8POD;
+    }
+
+    Util::uint32_t index = m_header->nextSampleIndex;
+    if ( needsWrite( key, index ) )
+    {
+        repeatPreviousSample( index, pod );
+
+        if ( index == 0 && m_compressionHint >= 0 )
         {
-            m_header->isHomogenous = false;
+            m_header->isCompressed = true;
+            aw->setHasCompressedSamples();
         }
 
-        if (m_header->firstChangedIndex == 0)
+        WrittenSampleMap & sampleMap = m_header->isCompressed ?
+            aw->getCompressedSampleMap() : aw->getWrittenSampleMap();
+
+        // only read the sample if we haven't already written it
+        m_previousWrittenSampleID = sampleMap.find( key );
+        if ( m_previousWrittenSampleID )
+        {
+            CopyWrittenData( m_group, m_previousWrittenSampleID );
+        }
+        else
         {
-            m_header->firstChangedIndex = m_header->nextSampleIndex;
+            std::vector< Util::uint8_t > bytes;
+            apr->readRawSample( iIndex, bytes );
+
+            Ogawa::ODataPtr dataPtr = m_group->addData( bytes.size(),
+                bytes.empty() ? NULL : &bytes.front() );
+
+            m_previousWrittenSampleID.reset( new WrittenSampleID( key,
+                dataPtr, dataType.getExtent() * dims.numPoints() ) );
+            sampleMap.store( m_previousWrittenSampleID );
         }
 
-        // this index is now the last change
-        m_header->lastChangedIndex = m_header->nextSampleIndex;
+        m_dims = dims;
+        WriteDimensions( m_group, m_dims, pod );
+
+        sampleWritten( index );
     }
 
-    Util::Digest digest = m_previousWrittenSampleID->getKey().digest;
-    HashDimensions( m_dims, digest );
-    if ( m_header->nextSampleIndex == 0 )
+    accumulateHash( index );
+
+    m_header->nextSampleIndex ++;
+    return true;
+}
+
+//-*****************************************************************************
+void ApwImpl::reopen( Ogawa::IGroupPtr iExisting )
+{
+    // the data and dimensions of each sample
+    Util::uint64_t numStored = iExisting->getNumChildren() / 2;
+    if ( m_header->nextSampleIndex == 0 || numStored == 0 )
     {
-        m_hash = digest;
+        return;
     }
-    else
+
+    AbcA::ArchiveWriterPtr awp = this->getObject()->getArchive();
+    AwImpl * aw = dynamic_cast< AwImpl * >( awp.get() );
+    ABCA_ASSERT( aw, "NULL Impl Ptr" );
+
+    // the samples we add have to be compressed too, even if the archive
+    // doesn't say how much
+    if ( m_header->isCompressed )
     {
-        Util::SpookyHash::ShortEnd(m_hash.words[0], m_hash.words[1],
-                                   digest.words[0], digest.words[1]);
+        m_compressionHint = awp->getCompressionHint() >= 0 ?
+            awp->getCompressionHint() : 1;
     }
-    m_header->nextSampleIndex ++;
+
+    for ( Util::uint64_t i = 0; i + 2 < numStored * 2; ++i )
+    {
+        m_group->addChild( iExisting, i );
+    }
+
+    // the last sample may need to be repeated, so we need its key
+    Ogawa::IDataPtr data = iExisting->getData( numStored * 2 - 2, 0 );
+    Ogawa::IDataPtr dims = iExisting->getData( numStored * 2 - 1, 0 );
+    Ogawa::ODataPtr lastData = m_group->addData( data );
+    m_group->addChild( iExisting, numStored * 2 - 1 );
+
+    const AbcA::DataType & dataType = m_header->header.getDataType();
+    AbcA::ArraySamplePtr samp;
+    ReadArraySample( dims, data, 0, dataType, m_header->isCompressed, samp );
+
+    m_dims = samp->getDimensions();
+    m_previousWrittenSampleID.reset( new WrittenSampleID(
+        GetWrittenSampleKey( *samp, aw->getSampleHashID() ),
+        lastData, dataType.getExtent() * m_dims.numPoints() ) );
+
+    // like properties that aren't reopened (see CpwData) the existing
+    // samples are hashed by where they are in the file
+    Util::uint64_t pos = iExisting->getPos();
+    Util::SpookyHash::Hash128( &pos, 8, &m_hash.words[0], &m_hash.words[1] );
 }
 
 //-*****************************************************************************
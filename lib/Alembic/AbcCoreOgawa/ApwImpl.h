@@ -51,6 +51,7 @@ class ApwImpl
 {
 protected:
     friend class CpwData;
+    friend class ApwWriteTask;
 
     //-*************************************************************************
     ApwImpl( AbcA::CompoundPropertyWriterPtr iParent,
@@ -66,6 +67,8 @@ public:
     // ArrayPropertyWriter overrides
     virtual void setSample( const AbcA::ArraySample & iSamp );
     virtual void setFromPreviousSample();
+    virtual bool copySample( AbcA::ArrayPropertyReaderPtr iReader,
+                             index_t iIndex );
     virtual size_t getNumSamples();
     virtual void setTimeSamplingIndex( Util::uint32_t iIndex );
 
@@ -79,6 +82,36 @@ protected:
     WrittenSampleIDPtr m_previousWrittenSampleID;
 
 private:
+    // Writes the sample set at iIndex, either right away or later from the
+    // archives write queue.
+    void writeSample( const AbcA::ArraySample & iSamp,
+                      const AbcA::ArraySample::Key & iKey,
+                      Util::uint32_t iIndex );
+
+    // Same as above but for setFromPreviousSample.
+    void writePreviousSample();
+
+    // Whether the sample with iKey set at iIndex needs to be written, or if
+    // it is the same as the previously written sample.
+    bool needsWrite( const AbcA::ArraySample::Key & iKey,
+                     Util::uint32_t iIndex ) const;
+
+    // Repeats the last written sample up to iIndex, since a change is about
+    // to be written there.
+    void repeatPreviousSample( Util::uint32_t iIndex,
+                               Util::PlainOldDataType iPod );
+
+    // Updates the header once the sample at iIndex and its dimensions have
+    // been written.
+    void sampleWritten( Util::uint32_t iIndex );
+
+    // Mixes the previously written sample into our hierarchical hash.
+    void accumulateHash( Util::uint32_t iIndex );
+
+    // For CpwData when appending, continues after the samples of the
+    // existing property in iExisting, which are referenced as they are.
+    void reopen( Ogawa::IGroupPtr iExisting );
+
     // The parent compound property writer.
     AbcA::CompoundPropertyWriterPtr m_parent;
 
@@ -94,6 +127,10 @@ private:
     AbcA::Dimensions m_dims;
 
     size_t m_index;
+
+    // the archives compression hint when our first sample was written
+    // -1 if our samples aren't compressed
+    Util::int8_t m_compressionHint;
 };
 
 } // End namespace ALEMBIC_VERSION_NS
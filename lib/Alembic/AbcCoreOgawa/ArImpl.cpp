@@ -35,6 +35,7 @@
 //-*****************************************************************************
 
 #include <Alembic/AbcCoreOgawa/ArImpl.h>
+#include <Alembic/AbcCoreOgawa/HierarchyLoader.h>
 #include <Alembic/AbcCoreOgawa/OrData.h>
 #include <Alembic/AbcCoreOgawa/OrImpl.h>
 #include <Alembic/AbcCoreOgawa/ReadUtil.h>
@@ -45,38 +46,69 @@ namespace ALEMBIC_VERSION_NS {
 
 //-*****************************************************************************
 ArImpl::ArImpl( const std::string &iFileName,
-                std::size_t iNumStreams )
+                std::size_t iNumStreams,
+                bool iUseMMap,
+                bool iPreloadHierarchy )
   : m_fileName( iFileName )
-  , m_archive( iFileName, iNumStreams )
+  , m_archive( iFileName, iNumStreams, iUseMMap )
   , m_header( new AbcA::ObjectHeader() )
-  , m_manager( iNumStreams )
+  , m_manager( m_archive.isMapped() ? 1 : iNumStreams )
+  , m_pathIndexLoaded( false )
+  , m_statsEnabled( false )
+  , m_objectHeaderBytes( 0 )
 {
+    m_propertyBytes[AbcA::kCompoundProperty] = 0;
+    m_propertyBytes[AbcA::kScalarProperty] = 0;
+    m_propertyBytes[AbcA::kArrayProperty] = 0;
+
     ABCA_ASSERT( m_archive.isValid(),
                  "Could not open as Ogawa file: " << m_fileName );
 
-    ABCA_ASSERT( m_archive.isFrozen(),
+    // archives that are still being written can be read once something
+    // has been committed to them
+    ABCA_ASSERT( m_archive.isFrozen() ||
+                 m_archive.getGroup()->getNumChildren() > 0,
         "Ogawa file not cleanly closed while being written: " << m_fileName );
 
     init();
+
+    if ( iPreloadHierarchy )
+    {
+        PreloadHierarchy( m_data, *this, iNumStreams );
+    }
 }
 
 //-*****************************************************************************
-ArImpl::ArImpl( const std::vector< std::istream * > & iStreams )
+ArImpl::ArImpl( const std::vector< std::istream * > & iStreams,
+                bool iPreloadHierarchy )
   : m_archive( iStreams )
   , m_header( new AbcA::ObjectHeader() )
   , m_manager( iStreams.size() )
+  , m_pathIndexLoaded( false )
+  , m_statsEnabled( false )
+  , m_objectHeaderBytes( 0 )
 {
+    m_propertyBytes[AbcA::kCompoundProperty] = 0;
+    m_propertyBytes[AbcA::kScalarProperty] = 0;
+    m_propertyBytes[AbcA::kArrayProperty] = 0;
+
     ABCA_ASSERT( m_archive.isValid(),
                  "Could not open as Ogawa file from provided streams." );
 
-    ABCA_ASSERT( m_archive.isFrozen(),
+    ABCA_ASSERT( m_archive.isFrozen() ||
+                 m_archive.getGroup()->getNumChildren() > 0,
         "Ogawa streams not cleanly closed while being written. " );
 
     init();
+
+    if ( iPreloadHierarchy )
+    {
+        PreloadHierarchy( m_data, *this, iStreams.size() );
+    }
 }
 
 //-*****************************************************************************
-void ArImpl::init()
+ArchiveSnapshotPtr ArImpl::readSnapshot()
 {
     Ogawa::IGroupPtr group = m_archive.getGroup();
 
@@ -116,19 +148,31 @@ void ArImpl::init()
 
     m_archiveVersion = fileVersion;
 
+    Alembic::Util::shared_ptr< ArchiveSnapshot > snapshot(
+        new ArchiveSnapshot() );
+
     ReadTimeSamplesAndMax( group->getData( 4, 0 ),
-                           m_timeSamples, m_maxSamples );
+                           snapshot->timeSamples, snapshot->maxSamples );
+
+    ReadIndexedMetaData( group->getData( 5, 0 ), snapshot->indexedMetaData );
+
+    return snapshot;
+}
 
-    ReadIndexedMetaData( group->getData( 5, 0 ), m_indexMetaData );
+//-*****************************************************************************
+void ArImpl::init()
+{
+    m_snapshot = readSnapshot();
 
+    Ogawa::IGroupPtr group = m_archive.getGroup();
     m_data.reset( new OrData( group->getGroup( 2, false, 0 ), "", 0, *this,
-                              m_indexMetaData ) );
+                              m_snapshot->indexedMetaData ) );
 
     m_header->setName( "ABC" );
     m_header->setFullName( "/" );
 
     // read archive metadata
-    data = group->getData( 3, 0 );
+    Ogawa::IDataPtr data = group->getData( 3, 0 );
     if ( data->getSize() > 0 )
     {
         char * buf = new char[ data->getSize() ];
@@ -138,6 +182,46 @@ void ArImpl::init()
         delete [] buf;
     }
 
+    // archives written before the hash could be chosen don't say
+    m_sampleHashID = AbcA::kMurmur3SampleHash;
+    std::string hashID = m_header->getMetaData().get( "_ai_SampleHashID" );
+    if ( hashID == "1" )
+    {
+        m_sampleHashID = AbcA::kChunkedSpookySampleHash;
+    }
+
+}
+
+//-*****************************************************************************
+bool ArImpl::refresh()
+{
+    Alembic::Util::scoped_lock l( m_orlock );
+
+    // the path index is read from the top group, which is replaced
+    Alembic::Util::scoped_lock pl( m_pathIndexLock );
+
+    if ( !m_archive.refresh() )
+    {
+        return false;
+    }
+
+    // Objects, properties and readers that were already gotten hold on to
+    // their own data and snapshot, so nothing they use is changed, only
+    // replaced.  The meta data of the archive is written before anything
+    // can be committed, so the header stays as it is.
+    ArchiveSnapshotPtr snapshot = readSnapshot();
+    m_data.reset( new OrData( m_archive.getGroup()->getGroup( 2, false, 0 ),
+                              "", 0, *this, snapshot->indexedMetaData ) );
+    m_top.reset();
+
+    {
+        Alembic::Util::scoped_lock sl( m_snapshotLock );
+        m_snapshot = snapshot;
+    }
+
+    m_pathIndex.reset();
+    m_pathIndexLoaded = false;
+    return true;
 }
 
 //-*****************************************************************************
@@ -169,13 +253,155 @@ AbcA::ObjectReaderPtr ArImpl::getTop()
     return ret;
 }
 
+//-*****************************************************************************
+ArImpl::PathIndexPtr ArImpl::loadPathIndex()
+{
+    Alembic::Util::scoped_lock l( m_pathIndexLock );
+
+    if ( m_pathIndexLoaded )
+    {
+        return m_pathIndex;
+    }
+
+    m_pathIndexLoaded = true;
+
+    // the path index is the optional 7th child of the archive
+    Ogawa::IGroupPtr group = m_archive.getGroup();
+    if ( group->getNumChildren() < 7 || !group->isChildData( 6 ) )
+    {
+        return m_pathIndex;
+    }
+
+    Ogawa::IDataPtr data = group->getData( 6, 0 );
+    if ( data->getSize() < 8 )
+    {
+        return m_pathIndex;
+    }
+
+    Util::uint64_t numEntries = 0;
+    data->read( 8, &numEntries, 0, 0 );
+
+    ABCA_ASSERT( numEntries <= ( data->getSize() - 8 ) / 24,
+                 "Read invalid: Path index is too small." );
+
+    Alembic::Util::shared_ptr< PathIndex > pathIndex( new PathIndex() );
+
+    // 3 uint64_t per entry
+    pathIndex->entries.resize( numEntries * 3 );
+    if ( numEntries > 0 )
+    {
+        data->read( numEntries * 24, &pathIndex->entries.front(), 8, 0 );
+    }
+
+    pathIndex->recordsPos = 8 + numEntries * 24;
+    pathIndex->data = data;
+    m_pathIndex = pathIndex;
+    return m_pathIndex;
+}
+
+//-*****************************************************************************
+AbcA::ObjectReaderPtr ArImpl::findObject( const std::string &iFullName )
+{
+    std::string fullName = iFullName;
+    if ( fullName.empty() || fullName[0] != '/' )
+    {
+        fullName = "/" + fullName;
+    }
+
+    if ( fullName.size() > 1 && fullName[fullName.size() - 1] == '/' )
+    {
+        fullName.resize( fullName.size() - 1 );
+    }
+
+    PathIndexPtr pathIndex;
+    if ( fullName != "/" && fullName.find( "//" ) == std::string::npos )
+    {
+        pathIndex = loadPathIndex();
+    }
+
+    if ( !pathIndex )
+    {
+        return AbcA::ArchiveReader::findObject( iFullName );
+    }
+
+    const std::vector< Util::uint64_t > & entries = pathIndex->entries;
+
+    Util::uint64_t hash = Util::SpookyHash::Hash64( fullName.c_str(),
+                                                    fullName.size(), 0 );
+
+    // find the first entry with our hash
+    std::size_t first = 0;
+    std::size_t last = entries.size() / 3;
+    while ( first < last )
+    {
+        std::size_t mid = first + ( last - first ) / 2;
+        if ( entries[mid * 3] < hash )
+        {
+            first = mid + 1;
+        }
+        else
+        {
+            last = mid;
+        }
+    }
+
+    StreamIDPtr streamId = getStreamID();
+    std::size_t id = streamId->getID();
+
+    // different names could have the same hash, so check the name
+    for ( ; first < entries.size() / 3 &&
+          entries[first * 3] == hash; ++first )
+    {
+        Util::uint64_t recordOffset =
+            entries[first * 3 + 2] & 0xffffffff;
+        Util::uint64_t recordSize = entries[first * 3 + 2] >> 32;
+
+        ABCA_ASSERT( pathIndex->recordsPos + recordOffset + recordSize <=
+                     pathIndex->data->getSize(),
+                     "Read invalid: Path index record is out of bounds." );
+
+        std::vector< char > buf( recordSize );
+        if ( recordSize > 0 )
+        {
+            pathIndex->data->read( recordSize, &buf.front(),
+                               pathIndex->recordsPos + recordOffset, id );
+        }
+
+        std::size_t pos = 0;
+        ObjectHeaderPtr header = ReadObjectHeader( buf, pos, "",
+            getSnapshot()->indexedMetaData );
+
+        // the name in the record is the full name
+        if ( header->getName() != fullName )
+        {
+            continue;
+        }
+
+        header->setFullName( fullName );
+        header->setName( fullName.substr( fullName.rfind( '/' ) + 1 ) );
+
+        Ogawa::IGroupPtr objGroup = m_archive.getGroup(
+            entries[first * 3 + 1], false, id );
+
+        ABCA_ASSERT( objGroup,
+                     "Read invalid: Path index has an invalid group for: "
+                     << fullName );
+
+        return Alembic::Util::shared_ptr<OrImpl>(
+            new OrImpl( shared_from_this(), objGroup, header ) );
+    }
+
+    return AbcA::ObjectReaderPtr();
+}
+
 //-*****************************************************************************
 AbcA::TimeSamplingPtr ArImpl::getTimeSampling( Util::uint32_t iIndex )
 {
-    ABCA_ASSERT( iIndex < m_timeSamples.size(),
+    ArchiveSnapshotPtr snapshot = getSnapshot();
+    ABCA_ASSERT( iIndex < snapshot->timeSamples.size(),
         "Invalid index provided to getTimeSampling." );
 
-    return m_timeSamples[iIndex];
+    return snapshot->timeSamples[iIndex];
 }
 
 //-*****************************************************************************
@@ -188,9 +414,10 @@ AbcA::ArchiveReaderPtr ArImpl::asArchivePtr()
 AbcA::index_t
 ArImpl::getMaxNumSamplesForTimeSamplingIndex( Util::uint32_t iIndex )
 {
-    if ( iIndex < m_maxSamples.size() )
+    ArchiveSnapshotPtr snapshot = getSnapshot();
+    if ( iIndex < snapshot->maxSamples.size() )
     {
-        return m_maxSamples[iIndex];
+        return snapshot->maxSamples[iIndex];
     }
 
     return INDEX_UNKNOWN;
@@ -202,15 +429,107 @@ StreamIDPtr ArImpl::getStreamID()
     return m_manager.get();
 }
 
+//-*****************************************************************************
+void ArImpl::setStatsEnabled( bool iEnabled )
+{
+    m_archive.setStatsEnabled( iEnabled );
+    m_manager.setStatsEnabled( iEnabled );
+
+#ifndef ALEMBIC_READ_STATS_ATOMIC
+    Alembic::Util::scoped_lock l( m_statsLock );
+#endif
+    m_statsEnabled = iEnabled;
+}
+
+//-*****************************************************************************
+bool ArImpl::getStats( AbcA::ReadStats & oStats )
+{
+    Ogawa::ReadStats stats;
+    m_archive.getStats( stats );
+
+    oStats = AbcA::ReadStats();
+    oStats.numReads = stats.numMappedReads;
+    oStats.numBytes = stats.numMappedBytes;
+    oStats.numMappedReads = stats.numMappedReads;
+    oStats.numMappedBytes = stats.numMappedBytes;
+
+    oStats.streams.resize( stats.streams.size() );
+    for ( std::size_t i = 0; i < stats.streams.size(); ++i )
+    {
+        const Ogawa::StreamStats & from = stats.streams[i];
+        AbcA::ReadStreamStats & to = oStats.streams[i];
+        to.numReads = from.numReads;
+        to.numBytes = from.numBytes;
+        to.numSeeks = from.numSeeks;
+        to.seekDistance = from.seekDistance;
+        to.numContended = from.numContended;
+        to.lockWaitNanoseconds = from.lockWaitNanoseconds;
+        for ( std::size_t j = 0; j < AbcA::kNumLockWaitBuckets &&
+              j < Ogawa::LOCK_WAIT_BUCKETS; ++j )
+        {
+            to.lockWaitHistogram[j] = from.lockWaitHistogram[j];
+        }
+
+        oStats.numReads += from.numReads;
+        oStats.numBytes += from.numBytes;
+        oStats.numSeeks += from.numSeeks;
+        oStats.seekDistance += from.seekDistance;
+    }
+
+    oStats.numStreamRequests = m_manager.getNumRequests();
+    oStats.numSharedStreams = m_manager.getNumShared();
+
+#ifndef ALEMBIC_READ_STATS_ATOMIC
+    Alembic::Util::scoped_lock l( m_statsLock );
+#endif
+    oStats.propertyBytes[AbcA::kCompoundProperty] =
+        m_propertyBytes[AbcA::kCompoundProperty];
+    oStats.propertyBytes[AbcA::kScalarProperty] =
+        m_propertyBytes[AbcA::kScalarProperty];
+    oStats.propertyBytes[AbcA::kArrayProperty] =
+        m_propertyBytes[AbcA::kArrayProperty];
+    oStats.objectHeaderBytes = m_objectHeaderBytes;
+    return true;
+}
+
+//-*****************************************************************************
+void ArImpl::resetStats()
+{
+    m_archive.resetStats();
+    m_manager.resetStats();
+
+#ifndef ALEMBIC_READ_STATS_ATOMIC
+    Alembic::Util::scoped_lock l( m_statsLock );
+#endif
+    m_propertyBytes[AbcA::kCompoundProperty] = 0;
+    m_propertyBytes[AbcA::kScalarProperty] = 0;
+    m_propertyBytes[AbcA::kArrayProperty] = 0;
+    m_objectHeaderBytes = 0;
+}
+
+//-*****************************************************************************
+void ArImpl::setTraceEnabled( bool iEnabled )
+{
+    m_archive.setTraceEnabled( iEnabled );
+}
+
+//-*****************************************************************************
+bool ArImpl::writeTrace( std::ostream & oStream )
+{
+    m_archive.writeTrace( oStream );
+    return true;
+}
+
 //-*****************************************************************************
 ArImpl::~ArImpl()
 {
 }
 
 //-*****************************************************************************
-const std::vector< AbcA::MetaData > & ArImpl::getIndexedMetaData()
+ArchiveSnapshotPtr ArImpl::getSnapshot()
 {
-    return m_indexMetaData;
+    Alembic::Util::scoped_lock l( m_snapshotLock );
+    return m_snapshot;
 }
 
 } // End namespace ALEMBIC_VERSION_NS
@@ -40,6 +40,13 @@
 #include <Alembic/AbcCoreOgawa/Foundation.h>
 #include <Alembic/AbcCoreOgawa/StreamManager.h>
 
+#if ( defined( _MSC_VER ) && _MSC_VER > 1600 ) || \
+    ( !defined( _MSC_VER ) && \
+      ( defined( __GXX_EXPERIMENTAL_CXX0X__ ) || __cplusplus >= 201103L ) )
+#define ALEMBIC_READ_STATS_ATOMIC
+#include <atomic>
+#endif
+
 namespace Alembic {
 namespace AbcCoreOgawa {
 namespace ALEMBIC_VERSION_NS {
@@ -47,6 +54,21 @@ namespace ALEMBIC_VERSION_NS {
 //-*****************************************************************************
 class OrData;
 
+//-*****************************************************************************
+// What is read again by ArImpl::refresh, readers hold on to the snapshot they
+// got so it can't change while they are using it.
+struct ArchiveSnapshot
+{
+    std::vector< AbcA::TimeSamplingPtr > timeSamples;
+    std::vector< AbcA::index_t > maxSamples;
+
+    // this only ever grows as the archive is written, so the indices read
+    // with an older snapshot are still valid in a newer one
+    std::vector< AbcA::MetaData > indexedMetaData;
+};
+
+typedef Alembic::Util::shared_ptr< const ArchiveSnapshot > ArchiveSnapshotPtr;
+
 //-*****************************************************************************
 class ArImpl
     : public AbcA::ArchiveReader
@@ -55,10 +77,22 @@ class ArImpl
 private:
     friend class ReadArchive;
 
+    // for the groups of an archive that is being appended to
+    friend class AwImpl;
+
+    // for the groups of the shards of a sharded archive
+    friend class ShardManifestWriter;
+
+    // for the groups of an archive that is being repacked
+    friend class ArchiveRepacker;
+
     ArImpl( const std::string &iFileName,
-            size_t iNumStreams=1 );
+            size_t iNumStreams=1,
+            bool iUseMMap=false,
+            bool iPreloadHierarchy=false );
 
-    ArImpl( const std::vector< std::istream * > & iStreams );
+    ArImpl( const std::vector< std::istream * > & iStreams,
+            bool iPreloadHierarchy=false );
 
 public:
 
@@ -73,18 +107,21 @@ public:
 
     virtual AbcA::ObjectReaderPtr getTop();
 
+    virtual AbcA::ObjectReaderPtr findObject( const std::string &iFullName );
+
     virtual AbcA::TimeSamplingPtr getTimeSampling( Util::uint32_t iIndex );
 
     virtual AbcA::ArchiveReaderPtr asArchivePtr();
 
     virtual AbcA::ReadArraySampleCachePtr getReadArraySampleCachePtr()
     {
-        return AbcA::ReadArraySampleCachePtr();
+        return m_readArraySampleCache;
     }
 
     virtual void
     setReadArraySampleCachePtr( AbcA::ReadArraySampleCachePtr iPtr )
     {
+        m_readArraySampleCache = iPtr;
     }
 
     virtual AbcA::index_t getMaxNumSamplesForTimeSamplingIndex(
@@ -92,7 +129,7 @@ public:
 
     virtual Util::uint32_t getNumTimeSamplings()
     {
-        return m_timeSamples.size();
+        return getSnapshot()->timeSamples.size();
     }
 
     virtual Util::int32_t getArchiveVersion()
@@ -102,11 +139,73 @@ public:
 
     StreamIDPtr getStreamID();
 
-    const std::vector< AbcA::MetaData > & getIndexedMetaData();
+    // the hash used for the keys of the samples in this archive
+    AbcA::SampleHashID getSampleHashID() const
+    {
+        return m_sampleHashID;
+    }
+
+    // the time samplings and indexed meta data as of the last refresh
+    ArchiveSnapshotPtr getSnapshot();
+
+    // for archives that were opened while they were still being written,
+    // reads the archive again if anything was committed since
+    virtual bool refresh();
+
+    // what the archive read, see AbcA::ReadStats
+    virtual void setStatsEnabled( bool iEnabled );
+    virtual bool getStats( AbcA::ReadStats & oStats );
+    virtual void resetStats();
+    virtual void setTraceEnabled( bool iEnabled );
+    virtual bool writeTrace( std::ostream & oStream );
+
+    // the readers count the bytes of the samples and headers they read
+    // through these, which do nothing unless the stats are enabled
+    void countPropertyBytes( AbcA::PropertyType iType, Util::uint64_t iBytes )
+    {
+#ifndef ALEMBIC_READ_STATS_ATOMIC
+        Alembic::Util::scoped_lock l( m_statsLock );
+#endif
+        if ( m_statsEnabled )
+        {
+            m_propertyBytes[iType] += iBytes;
+        }
+    }
+
+    void countObjectHeaderBytes( Util::uint64_t iBytes )
+    {
+#ifndef ALEMBIC_READ_STATS_ATOMIC
+        Alembic::Util::scoped_lock l( m_statsLock );
+#endif
+        if ( m_statsEnabled )
+        {
+            m_objectHeaderBytes += iBytes;
+        }
+    }
 
 private:
     void init();
 
+    // checks that the top group of m_archive is an Alembic archive, and
+    // reads the time samplings and indexed meta data from it
+    ArchiveSnapshotPtr readSnapshot();
+
+    // the hash of the full name, the position of the group, and the offset
+    // and size of the record of each object in the path index, sorted by
+    // the hash
+    struct PathIndex
+    {
+        Ogawa::IDataPtr data;
+        std::vector< Util::uint64_t > entries;
+        Util::uint64_t recordsPos;
+    };
+
+    typedef Alembic::Util::shared_ptr< const PathIndex > PathIndexPtr;
+
+    // reads the path index the first time it is needed, returns NULL if the
+    // archive doesn't have one
+    PathIndexPtr loadPathIndex();
+
     std::string m_fileName;
     size_t m_numStreams;
 
@@ -118,14 +217,33 @@ private:
 
     Util::int32_t m_archiveVersion;
 
-    std::vector <  AbcA::TimeSamplingPtr > m_timeSamples;
-    std::vector <  AbcA::index_t > m_maxSamples;
+    AbcA::SampleHashID m_sampleHashID;
+
+    // replaced, never changed, by refresh
+    ArchiveSnapshotPtr m_snapshot;
+    Alembic::Util::mutex m_snapshotLock;
 
     ObjectHeaderPtr m_header;
 
     StreamManager m_manager;
 
-    std::vector< AbcA::MetaData > m_indexMetaData;
+    AbcA::ReadArraySampleCachePtr m_readArraySampleCache;
+
+    PathIndexPtr m_pathIndex;
+    bool m_pathIndexLoaded;
+    Alembic::Util::mutex m_pathIndexLock;
+
+    // the bytes the readers read, by what they read them for
+#ifdef ALEMBIC_READ_STATS_ATOMIC
+    std::atomic< bool > m_statsEnabled;
+    std::atomic< Util::uint64_t > m_propertyBytes[3];
+    std::atomic< Util::uint64_t > m_objectHeaderBytes;
+#else
+    bool m_statsEnabled;
+    Util::uint64_t m_propertyBytes[3];
+    Util::uint64_t m_objectHeaderBytes;
+    Alembic::Util::mutex m_statsLock;
+#endif
 };
 
 } // End namespace ALEMBIC_VERSION_NS
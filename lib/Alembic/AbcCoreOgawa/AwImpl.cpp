@@ -35,21 +35,36 @@
 //-*****************************************************************************
 
 #include <Alembic/AbcCoreOgawa/AwImpl.h>
+#include <Alembic/AbcCoreOgawa/ArImpl.h>
 #include <Alembic/AbcCoreOgawa/OwData.h>
 #include <Alembic/AbcCoreOgawa/OwImpl.h>
 #include <Alembic/AbcCoreOgawa/WriteUtil.h>
 
+#include <algorithm>
+
 namespace Alembic {
 namespace AbcCoreOgawa {
 namespace ALEMBIC_VERSION_NS {
 
 //-*****************************************************************************
 AwImpl::AwImpl( const std::string &iFileName,
-                const AbcA::MetaData &iMetaData )
+                const AbcA::MetaData &iMetaData,
+                size_t iBufferSize,
+                Util::uint8_t iCodec,
+                size_t iNumThreads,
+                AbcA::SampleHashID iHashID,
+                bool iWritePathIndex,
+                bool iExtendedMetaDataMap,
+                bool iPackScalarSamples )
   : m_fileName( iFileName )
   , m_metaData( iMetaData )
-  , m_archive( iFileName )
-  , m_metaDataMap( new MetaDataMap() )
+  , m_archive( iFileName, iBufferSize )
+  , m_metaDataMap( new MetaDataMap( iExtendedMetaDataMap ) )
+  , m_codec( iCodec )
+  , m_fileVersion( 0 )
+  , m_packScalarSamples( iPackScalarSamples )
+  , m_hashID( iHashID )
+  , m_writePathIndex( iWritePathIndex )
 {
 
     // add default time sampling
@@ -63,14 +78,31 @@ AwImpl::AwImpl( const std::string &iFileName,
     }
 
     init();
+
+    if ( iNumThreads > 0 )
+    {
+        m_writeQueue.reset( new WriteQueue( iNumThreads ) );
+    }
 }
 
 //-*****************************************************************************
 AwImpl::AwImpl( std::ostream * iStream,
-                const AbcA::MetaData &iMetaData )
+                const AbcA::MetaData &iMetaData,
+                size_t iBufferSize,
+                Util::uint8_t iCodec,
+                size_t iNumThreads,
+                AbcA::SampleHashID iHashID,
+                bool iWritePathIndex,
+                bool iExtendedMetaDataMap,
+                bool iPackScalarSamples )
   : m_metaData( iMetaData )
-  , m_archive( iStream )
-  , m_metaDataMap( new MetaDataMap() )
+  , m_archive( iStream, iBufferSize )
+  , m_metaDataMap( new MetaDataMap( iExtendedMetaDataMap ) )
+  , m_codec( iCodec )
+  , m_fileVersion( 0 )
+  , m_packScalarSamples( iPackScalarSamples )
+  , m_hashID( iHashID )
+  , m_writePathIndex( iWritePathIndex )
 {
     // add default time sampling
     AbcA::TimeSamplingPtr ts( new AbcA::TimeSampling() );
@@ -83,6 +115,61 @@ AwImpl::AwImpl( std::ostream * iStream,
     }
 
     init();
+
+    if ( iNumThreads > 0 )
+    {
+        m_writeQueue.reset( new WriteQueue( iNumThreads ) );
+    }
+}
+
+//-*****************************************************************************
+AwImpl::AwImpl( Alembic::Util::shared_ptr< ArImpl > iExisting,
+                size_t iBufferSize,
+                Util::uint8_t iCodec,
+                size_t iNumThreads,
+                bool iExtendedMetaDataMap,
+                bool iPackScalarSamples )
+  : m_fileName( iExisting->getName() )
+  , m_metaData( iExisting->getMetaData() )
+  , m_archive( iExisting->getName(), iBufferSize, true )
+  , m_metaDataMap( new MetaDataMap( iExtendedMetaDataMap ) )
+  , m_codec( iCodec )
+  , m_fileVersion( 0 )
+  , m_packScalarSamples( iPackScalarSamples )
+  , m_hashID( iExisting->getSampleHashID() )
+  , m_writePathIndex( false )
+  , m_existing( iExisting )
+{
+    if ( !m_archive.isValid() )
+    {
+        ABCA_THROW( "Could not open file: " << m_fileName );
+    }
+
+    // the existing properties refer to the time samplings and the indexed
+    // meta data by index, so they have to stay where they are
+    for ( Util::uint32_t i = 0; i < m_existing->getNumTimeSamplings(); ++i )
+    {
+        AbcA::TimeSamplingPtr ts( new AbcA::TimeSampling(
+            *( m_existing->getTimeSampling( i ) ) ) );
+        m_timeSamples.push_back( ts );
+
+        index_t maxSamples =
+            m_existing->getMaxNumSamplesForTimeSamplingIndex( i );
+        m_maxSamples.push_back( maxSamples > 0 ? maxSamples : 0 );
+    }
+
+    m_metaDataMap->load( m_existing->getSnapshot()->indexedMetaData );
+
+    // we can't go back to an older version than what is already written
+    m_existing->m_archive.getGroup()->getData( 0, 0 )->read(
+        4, &m_fileVersion, 0, 0 );
+
+    init();
+
+    if ( iNumThreads > 0 )
+    {
+        m_writeQueue.reset( new WriteQueue( iNumThreads ) );
+    }
 }
 
 //-*****************************************************************************
@@ -91,8 +178,10 @@ void AwImpl::init()
     // set the version using Ogawa native calls
     // This expresses the AbcCoreOgawa version - how properties,
     // are stored within Ogawa, etc.
-    Util::int32_t version = ALEMBIC_OGAWA_FILE_VERSION;
-    m_archive.getGroup()->addData( 4, &version );
+    // We start with the original version (or the version of the archive we
+    // are appending to), and only bump it if we write something that older
+    // readers don't know about.
+    m_version = m_archive.getGroup()->addData( 4, &m_fileVersion );
 
     // This is the Alembic library version XXYYZZ
     // Where XX is the major version, YY is the minor version
@@ -102,27 +191,74 @@ void AwImpl::init()
 
     m_metaData.set("_ai_AlembicVersion", AbcA::GetLibraryVersion());
 
-    m_data.reset( new OwData( m_archive.getGroup()->addGroup() ) );
+    // the chunked hash depends on the byte order, so only use it where it
+    // gives the same digests as everywhere else
+    if ( m_hashID != AbcA::kMurmur3SampleHash && !Util::IsLittleEndian() )
+    {
+        m_hashID = AbcA::kMurmur3SampleHash;
+    }
+
+    // let readers know which hash our sample keys use, archives without
+    // this use kMurmur3SampleHash
+    if ( m_hashID != AbcA::kMurmur3SampleHash )
+    {
+        std::ostringstream hashID;
+        hashID << ( int ) m_hashID;
+        m_metaData.set( "_ai_SampleHashID", hashID.str() );
+    }
+
+    if ( m_existing )
+    {
+        m_data.reset( new OwData( m_archive.getGroup()->addGroup(),
+            m_existing->m_archive.getGroup()->getGroup( 2, false, 0 ), "",
+            *m_existing ) );
+    }
+    else
+    {
+        m_data.reset( new OwData( m_archive.getGroup()->addGroup() ) );
+    }
 
     // seed with the common empty keys
     AbcA::ArraySampleKey emptyKey;
     emptyKey.numBytes = 0;
+    emptyKey.hashID = m_hashID;
     Ogawa::ODataPtr emptyData( new Ogawa::OData() );
 
     emptyKey.origPOD = Alembic::Util::kInt8POD;
     emptyKey.readPOD = Alembic::Util::kInt8POD;
     WrittenSampleIDPtr wsid( new WrittenSampleID( emptyKey, emptyData, 0 ) );
     m_writtenSampleMap.store( wsid );
+    m_compressedSampleMap.store( wsid );
 
     emptyKey.origPOD = Alembic::Util::kStringPOD;
     emptyKey.readPOD = Alembic::Util::kStringPOD;
     wsid.reset( new WrittenSampleID( emptyKey, emptyData, 0 ) );
     m_writtenSampleMap.store( wsid );
+    m_compressedSampleMap.store( wsid );
 
     emptyKey.origPOD = Alembic::Util::kWstringPOD;
     emptyKey.readPOD = Alembic::Util::kWstringPOD;
     wsid.reset( new WrittenSampleID( emptyKey, emptyData, 0 ) );
     m_writtenSampleMap.store( wsid );
+    m_compressedSampleMap.store( wsid );
+}
+
+//-*****************************************************************************
+void AwImpl::setHasCompressedSamples()
+{
+    // readers that don't know about compressed samples need to reject
+    // this archive
+    requireFileVersion( 1 );
+}
+
+//-*****************************************************************************
+void AwImpl::requireFileVersion( Util::int32_t iVersion )
+{
+    if ( iVersion > m_fileVersion )
+    {
+        m_fileVersion = iVersion;
+        m_version->rewrite( 4, &m_fileVersion );
+    }
 }
 
 //-*****************************************************************************
@@ -212,12 +348,163 @@ void AwImpl::setMaxNumSamplesForTimeSamplingIndex( Util::uint32_t iIndex,
     }
 }
 
+//-*****************************************************************************
+void AwImpl::waitForWrites()
+{
+    if ( !m_writeQueue )
+    {
+        return;
+    }
+
+    try
+    {
+        m_writeQueue->wait();
+    }
+    catch ( std::exception & )
+    {
+        m_archive.abandon();
+        throw;
+    }
+}
+
+//-*****************************************************************************
+void AwImpl::waitForWritesNoThrow()
+{
+    try
+    {
+        waitForWrites();
+    }
+    catch ( std::exception & )
+    {
+    }
+}
+
+//-*****************************************************************************
+void AwImpl::addToPathIndex( const AbcA::ObjectHeader & iHeader,
+                             Util::uint64_t iPos )
+{
+    const std::string & fullName = iHeader.getFullName();
+
+    PathIndexEntry entry;
+    entry.hash = Util::SpookyHash::Hash64( fullName.c_str(),
+                                           fullName.size(), 0 );
+    entry.pos = iPos;
+    entry.recordOffset = ( Util::uint32_t ) m_pathIndexRecords.size();
+
+    // the record is the same as an object header, with the full name
+    // instead of just the name
+    AbcA::ObjectHeader record( fullName, iHeader.getMetaData() );
+    WriteObjectHeader( m_pathIndexRecords, record, m_metaDataMap );
+
+    entry.recordSize = ( Util::uint32_t ) m_pathIndexRecords.size() -
+        entry.recordOffset;
+
+    m_pathIndexEntries.push_back( entry );
+}
+
+//-*****************************************************************************
+void AwImpl::writePathIndex()
+{
+    // the number of entries, the entries sorted by hash so readers can
+    // search them, and then the records the entries point at
+    std::sort( m_pathIndexEntries.begin(), m_pathIndexEntries.end() );
+
+    Util::uint64_t numEntries = m_pathIndexEntries.size();
+
+    std::vector< Util::uint8_t > data;
+    data.reserve( 8 + numEntries * 24 + m_pathIndexRecords.size() );
+
+    const Util::uint8_t * numData = ( const Util::uint8_t * ) &numEntries;
+    data.insert( data.end(), numData, numData + 8 );
+
+    for ( std::size_t i = 0; i < m_pathIndexEntries.size(); ++i )
+    {
+        const PathIndexEntry & entry = m_pathIndexEntries[i];
+        const Util::uint8_t * hashData = ( const Util::uint8_t * ) &entry.hash;
+        const Util::uint8_t * posData = ( const Util::uint8_t * ) &entry.pos;
+        const Util::uint8_t * offsetData =
+            ( const Util::uint8_t * ) &entry.recordOffset;
+        const Util::uint8_t * sizeData =
+            ( const Util::uint8_t * ) &entry.recordSize;
+
+        data.insert( data.end(), hashData, hashData + 8 );
+        data.insert( data.end(), posData, posData + 8 );
+        data.insert( data.end(), offsetData, offsetData + 4 );
+        data.insert( data.end(), sizeData, sizeData + 4 );
+    }
+
+    data.insert( data.end(), m_pathIndexRecords.begin(),
+                 m_pathIndexRecords.end() );
+
+    m_archive.getGroup()->addData( data.size(), &( data.front() ) );
+}
+
+//-*****************************************************************************
+void AwImpl::packTimeSamplings(
+    const std::vector< AbcA::index_t > & iMaxSamples,
+    std::vector< Util::uint8_t > & oData )
+{
+    Util::uint32_t numSamplings = getNumTimeSamplings();
+    for ( Util::uint32_t i = 0; i < numSamplings; ++i )
+    {
+        Util::uint32_t maxSample = iMaxSamples[i];
+        AbcA::TimeSamplingPtr timePtr = getTimeSampling( i );
+        WriteTimeSampling( oData, maxSample, *timePtr );
+    }
+}
+
+//-*****************************************************************************
+bool AwImpl::commit()
+{
+    if ( !m_archive.isValid() || !m_data )
+    {
+        return false;
+    }
+
+    // samples given to the write queue need to be in the file first, if
+    // any of them failed this throws before anything is written, and the
+    // archive is abandoned so readers keep seeing the last commit
+    waitForWrites();
+
+    // the properties that are still being written haven't set their max
+    // samples yet
+    std::vector< AbcA::index_t > maxSamples = m_maxSamples;
+    Ogawa::SnapshotExtras extras;
+    m_data->writeSnapshot( m_metaDataMap, extras, maxSamples );
+
+    // the rest of what we write when we are closed, in the same order
+    Ogawa::OGroupPtr group = m_archive.getGroup();
+    std::vector< Ogawa::ODataPtr > & topExtras = extras[group.get()];
+
+    std::string metaData = m_metaData.serialize();
+    topExtras.push_back( group->createData( metaData.size(),
+                                            metaData.c_str() ) );
+
+    std::vector< Util::uint8_t > data;
+    packTimeSamplings( maxSamples, data );
+    topExtras.push_back( group->createData( data.size(), &( data.front() ) ) );
+
+    topExtras.push_back( m_metaDataMap->createData( group ) );
+
+    if ( m_metaDataMap->usesExtendedIndices() )
+    {
+        requireFileVersion( 2 );
+    }
+
+    m_archive.commit( extras );
+    return true;
+}
+
 //-*****************************************************************************
 AwImpl::~AwImpl()
 {
+    // everything should have been written by now, but make sure
+    waitForWritesNoThrow();
+    m_writeQueue.reset();
 
     // empty out the map so any dataset IDs will be freed up
     m_writtenSampleMap.clear();
+    m_compressedSampleMap.clear();
 
     // write out our child headers
     if ( m_data )
@@ -239,16 +526,24 @@ AwImpl::~AwImpl()
         m_archive.getGroup()->addData( metaData.size(), metaData.c_str() );
 
         std::vector< Util::uint8_t > data;
-        Util::uint32_t numSamplings = getNumTimeSamplings();
-        for ( Util::uint32_t i = 0; i < numSamplings; ++i )
-        {
-            Util::uint32_t maxSample = m_maxSamples[i];
-            AbcA::TimeSamplingPtr timePtr = getTimeSampling( i );
-            WriteTimeSampling( data, maxSample, *timePtr );
-        }
+        packTimeSamplings( m_maxSamples, data );
 
         m_archive.getGroup()->addData( data.size(), &( data.front() ) );
         m_metaDataMap->write( m_archive.getGroup() );
+
+        // readers that only know about 254 indexed meta data need to reject
+        // this archive
+        if ( m_metaDataMap->usesExtendedIndices() )
+        {
+            requireFileVersion( 2 );
+        }
+
+        // older readers only look at the first 6 children, so they
+        // don't see this
+        if ( m_writePathIndex )
+        {
+            writePathIndex();
+        }
     }
 
 }
@@ -40,6 +40,7 @@
 #include <Alembic/AbcCoreOgawa/Foundation.h>
 #include <Alembic/AbcCoreOgawa/WrittenSampleMap.h>
 #include <Alembic/AbcCoreOgawa/WriteUtil.h>
+#include <Alembic/AbcCoreOgawa/WriteQueue.h>
 
 namespace Alembic {
 namespace AbcCoreOgawa {
@@ -48,6 +49,7 @@ namespace ALEMBIC_VERSION_NS {
 //-*****************************************************************************
 class OwData;
 class OwImpl;
+class ArImpl;
 
 //-*****************************************************************************
 class AwImpl : public AbcA::ArchiveWriter
@@ -57,10 +59,32 @@ private:
     friend class WriteArchive;
 
     AwImpl( const std::string &iFileName,
-            const AbcA::MetaData &iMetaData );
+            const AbcA::MetaData &iMetaData,
+            size_t iBufferSize,
+            Util::uint8_t iCodec,
+            size_t iNumThreads,
+            AbcA::SampleHashID iHashID,
+            bool iWritePathIndex,
+            bool iExtendedMetaDataMap,
+            bool iPackScalarSamples );
 
     AwImpl( std::ostream * iStream,
-            const AbcA::MetaData & iMetaData );
+            const AbcA::MetaData & iMetaData,
+            size_t iBufferSize,
+            Util::uint8_t iCodec,
+            size_t iNumThreads,
+            AbcA::SampleHashID iHashID,
+            bool iWritePathIndex,
+            bool iExtendedMetaDataMap,
+            bool iPackScalarSamples );
+
+    // adds to the archive iExisting was read from, see WriteArchive::append
+    AwImpl( Alembic::Util::shared_ptr< ArImpl > iExisting,
+            size_t iBufferSize,
+            Util::uint8_t iCodec,
+            size_t iNumThreads,
+            bool iExtendedMetaDataMap,
+            bool iPackScalarSamples );
 
 public:
     virtual ~AwImpl();
@@ -84,11 +108,77 @@ public:
         return m_writtenSampleMap;
     }
 
+    // compressed samples are kept separate so they are only ever shared
+    // with other compressed array properties
+    WrittenSampleMap &getCompressedSampleMap()
+    {
+        return m_compressedSampleMap;
+    }
+
+    // the codec to use for array properties with compressed samples
+    Util::uint8_t getCompressionCodec() const
+    {
+        return m_codec;
+    }
+
+    // called when an array property decides to compress its samples
+    void setHasCompressedSamples();
+
+    // whether scalar properties with more than one sample to write should
+    // pack them into one data
+    bool packsScalarSamples() const
+    {
+        return m_packScalarSamples;
+    }
+
+    // called when something is written that readers older than the
+    // AbcCoreOgawa version iVersion don't know about, see Foundation.h
+    void requireFileVersion( Util::int32_t iVersion );
+
+    // the hash used for the keys of written samples
+    AbcA::SampleHashID getSampleHashID() const
+    {
+        return m_hashID;
+    }
+
+    // NULL unless samples are written on other threads
+    WriteQueue * getWriteQueue()
+    {
+        return m_writeQueue.get();
+    }
+
+    // blocks until every sample given to the write queue has been written,
+    // this needs to be called before writing anything on the calling thread.
+    // If any of them failed the archive is abandoned, so it is never
+    // finished as though it were valid, and the error is thrown.
+    void waitForWrites();
+
+    // the same as waitForWrites for destructors, which can't throw, the
+    // archive is still abandoned but the error is dropped
+    void waitForWritesNoThrow();
+
+    // whether objects need to be added to the path index
+    bool writesPathIndex() const
+    {
+        return m_writePathIndex;
+    }
+
+    // called once the group of an object has been written, iPos is where
+    void addToPathIndex( const AbcA::ObjectHeader & iHeader,
+                         Util::uint64_t iPos );
+
     MetaDataMapPtr getMetaDataMap()
     {
         return m_metaDataMap;
     }
 
+    // the archive being appended to, NULL unless we were made by
+    // WriteArchive::append
+    ArImpl * getExisting()
+    {
+        return m_existing.get();
+    }
+
     virtual Util::uint32_t addTimeSampling( const AbcA::TimeSampling & iTs );
 
     virtual AbcA::TimeSamplingPtr getTimeSampling( Util::uint32_t iIndex );
@@ -102,8 +192,22 @@ public:
     virtual void setMaxNumSamplesForTimeSamplingIndex( Util::uint32_t iIndex,
                                                       AbcA::index_t iMaxIndex );
 
+    // Writes the headers of everything that is still being written, as
+    // they are now, and points the file at them along with everything
+    // else written so far (see Ogawa::OArchive::commit).  Each commit
+    // copies the headers, so committing after every sample of a large
+    // hierarchy grows the file quickly.  The path index is only written
+    // when the archive is closed.
+    // Throws without committing anything if a sample given to the write
+    // queue failed, returns false once the archive has been abandoned.
+    virtual bool commit();
+
 private:
     void init();
+    void writePathIndex();
+    void packTimeSamplings( const std::vector< AbcA::index_t > & iMaxSamples,
+                            std::vector< Util::uint8_t > & oData );
+
     std::string m_fileName;
     AbcA::MetaData m_metaData;
     Alembic::Ogawa::OArchive m_archive;
@@ -116,7 +220,41 @@ private:
     std::vector < AbcA::index_t > m_maxSamples;
 
     WrittenSampleMap m_writtenSampleMap;
+    WrittenSampleMap m_compressedSampleMap;
     MetaDataMapPtr m_metaDataMap;
+
+    Util::uint8_t m_codec;
+    Ogawa::ODataPtr m_version;
+    Util::int32_t m_fileVersion;
+    bool m_packScalarSamples;
+
+    WriteQueuePtr m_writeQueue;
+
+    AbcA::SampleHashID m_hashID;
+
+    // where to find the group of each object, sorted by the hash of the
+    // full name before it is written out
+    struct PathIndexEntry
+    {
+        Util::uint64_t hash;
+        Util::uint64_t pos;
+        Util::uint32_t recordOffset;
+        Util::uint32_t recordSize;
+
+        bool operator<( const PathIndexEntry & iRhs ) const
+        {
+            return hash < iRhs.hash;
+        }
+    };
+
+    bool m_writePathIndex;
+    std::vector< PathIndexEntry > m_pathIndexEntries;
+
+    // the full name and meta data of each object in the path index
+    std::vector< Util::uint8_t > m_pathIndexRecords;
+
+    // what is already in the file, when appending
+    Alembic::Util::shared_ptr< ArImpl > m_existing;
 };
 
 } // End namespace ALEMBIC_VERSION_NS
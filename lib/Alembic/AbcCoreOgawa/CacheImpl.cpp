@@ -0,0 +1,141 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreOgawa/CacheImpl.h>
+
+namespace Alembic {
+namespace AbcCoreOgawa {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+CacheImpl::CacheImpl( std::size_t iMaxBytes )
+  : m_maxBytes( iMaxBytes )
+  , m_numBytes( 0 )
+{
+}
+
+//-*****************************************************************************
+CacheImpl::~CacheImpl()
+{
+}
+
+//-*****************************************************************************
+AbcA::ReadArraySampleID
+CacheImpl::find( const AbcA::ArraySample::Key &iKey )
+{
+    Alembic::Util::scoped_lock l( m_lock );
+
+    Map::iterator foundIter = m_map.find( iKey );
+    if ( foundIter == m_map.end() )
+    {
+        return AbcA::ReadArraySampleID();
+    }
+
+    // move it to the front since it was just used
+    m_lru.splice( m_lru.begin(), m_lru, foundIter->second.lruIter );
+
+    return AbcA::ReadArraySampleID( iKey, foundIter->second.sample );
+}
+
+//-*****************************************************************************
+AbcA::ReadArraySampleID
+CacheImpl::store( const AbcA::ArraySample::Key &iKey,
+                  AbcA::ArraySamplePtr iSamp )
+{
+    ABCA_ASSERT( iSamp, "Cannot store a null sample" );
+
+    // strings live outside of the sample, so use whichever is bigger
+    // between what the sample takes up in memory and on disk
+    std::size_t numBytes = iSamp->getDimensions().numPoints() *
+        iSamp->getDataType().getNumBytes();
+    if ( numBytes < iKey.numBytes )
+    {
+        numBytes = iKey.numBytes;
+    }
+
+    Alembic::Util::scoped_lock l( m_lock );
+
+    // someone else might have already stored it, if so use theirs
+    Map::iterator foundIter = m_map.find( iKey );
+    if ( foundIter != m_map.end() )
+    {
+        m_lru.splice( m_lru.begin(), m_lru, foundIter->second.lruIter );
+        return AbcA::ReadArraySampleID( iKey, foundIter->second.sample );
+    }
+
+    // too big to ever fit, don't hold onto it
+    if ( numBytes > m_maxBytes )
+    {
+        return AbcA::ReadArraySampleID( iKey, iSamp );
+    }
+
+    // make room by releasing the least recently used samples
+    while ( !m_lru.empty() && m_numBytes + numBytes > m_maxBytes )
+    {
+        Map::iterator lastIter = m_map.find( m_lru.back() );
+        m_numBytes -= lastIter->second.numBytes;
+        m_map.erase( lastIter );
+        m_lru.pop_back();
+    }
+
+    m_lru.push_front( iKey );
+
+    Record & record = m_map[iKey];
+    record.sample = iSamp;
+    record.numBytes = numBytes;
+    record.lruIter = m_lru.begin();
+    m_numBytes += numBytes;
+
+    return AbcA::ReadArraySampleID( iKey, iSamp );
+}
+
+//-*****************************************************************************
+std::size_t CacheImpl::getNumBytes()
+{
+    Alembic::Util::scoped_lock l( m_lock );
+    return m_numBytes;
+}
+
+//-*****************************************************************************
+std::size_t CacheImpl::getNumSamples()
+{
+    Alembic::Util::scoped_lock l( m_lock );
+    return m_map.size();
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcCoreOgawa
+} // End namespace Alembic
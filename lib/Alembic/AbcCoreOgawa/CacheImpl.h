@@ -0,0 +1,105 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcCoreOgawa_CacheImpl_h_
+#define _Alembic_AbcCoreOgawa_CacheImpl_h_
+
+#include <Alembic/AbcCoreOgawa/Foundation.h>
+#include <list>
+
+namespace Alembic {
+namespace AbcCoreOgawa {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+//! Array sample cache keyed on the digest that is stored with every Ogawa
+//! array sample.  The cache holds on to at most iMaxBytes worth of samples,
+//! once it goes over that the least recently used samples are released.
+//! Samples that are still referenced elsewhere stay valid after being
+//! released by the cache, they just won't be found anymore.
+//! This class is multithread safe.
+class CacheImpl : public AbcA::ReadArraySampleCache
+{
+public:
+    CacheImpl( std::size_t iMaxBytes );
+
+    virtual ~CacheImpl();
+
+    virtual AbcA::ReadArraySampleID
+    find( const AbcA::ArraySample::Key &iKey );
+
+    virtual AbcA::ReadArraySampleID
+    store( const AbcA::ArraySample::Key &iKey,
+           AbcA::ArraySamplePtr iSamp );
+
+    std::size_t getMaxBytes() const { return m_maxBytes; }
+
+    std::size_t getNumBytes();
+
+    std::size_t getNumSamples();
+
+private:
+    typedef std::list< AbcA::ArraySample::Key > LRUList;
+
+    struct Record
+    {
+        AbcA::ArraySamplePtr sample;
+        std::size_t numBytes;
+
+        // where we are in m_lru
+        LRUList::iterator lruIter;
+    };
+
+    typedef AbcA::UnorderedMapUtil< Record >::umap_type Map;
+
+    // the most recently used key is at the front
+    LRUList m_lru;
+    Map m_map;
+
+    std::size_t m_maxBytes;
+    std::size_t m_numBytes;
+
+    Alembic::Util::mutex m_lock;
+};
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcCoreOgawa
+} // End namespace Alembic
+
+#endif
@@ -0,0 +1,206 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreOgawa/CompressUtil.h>
+
+#include <zlib.h>
+
+#ifdef ALEMBIC_WITH_LZ4
+#include <lz4.h>
+#endif
+
+namespace Alembic {
+namespace AbcCoreOgawa {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+static const Util::uint64_t kSizeMask = 0x00ffffffffffffffULL;
+
+//-*****************************************************************************
+bool IsCodecAvailable( Util::uint8_t iCodec )
+{
+#ifdef ALEMBIC_WITH_LZ4
+    if ( iCodec == kLZ4Codec )
+    {
+        return true;
+    }
+#endif
+
+    return iCodec == kStoredCodec || iCodec == kZlibCodec;
+}
+
+//-*****************************************************************************
+void CompressData( const void * iData,
+                   std::size_t iSize,
+                   Util::uint8_t iCodec,
+                   Util::int8_t iLevel,
+                   std::vector< Util::uint8_t > & oData )
+{
+    ABCA_ASSERT( IsCodecAvailable( iCodec ),
+                 "Unsupported compression codec: " << ( int ) iCodec );
+
+    ABCA_ASSERT( ( Util::uint64_t ) iSize <= kSizeMask,
+                 "Data is too big to compress: " << iSize );
+
+    std::size_t compressedSize = 0;
+
+    if ( iCodec == kZlibCodec )
+    {
+        uLongf destLen = compressBound( iSize );
+        oData.resize( 8 + destLen );
+
+        if ( compress2( &oData[8], &destLen, ( const Bytef * ) iData,
+                        iSize, iLevel ) == Z_OK )
+        {
+            compressedSize = destLen;
+        }
+    }
+#ifdef ALEMBIC_WITH_LZ4
+    else if ( iCodec == kLZ4Codec && iSize <= LZ4_MAX_INPUT_SIZE )
+    {
+        int destLen = LZ4_compressBound( ( int ) iSize );
+        oData.resize( 8 + destLen );
+
+        // higher levels mean more compression, so less acceleration
+        compressedSize = LZ4_compress_fast( ( const char * ) iData,
+            ( char * ) &oData[8], ( int ) iSize, destLen, 10 - iLevel );
+    }
+#endif
+
+    // didn't get any smaller (or failed) so just store it
+    if ( compressedSize == 0 || compressedSize >= iSize )
+    {
+        iCodec = kStoredCodec;
+        compressedSize = iSize;
+        oData.resize( 8 + iSize );
+        if ( iSize > 0 )
+        {
+            memcpy( &oData[8], iData, iSize );
+        }
+    }
+
+    oData.resize( 8 + compressedSize );
+
+    Util::uint64_t header = ( Util::uint64_t ) iSize |
+        ( ( Util::uint64_t ) iCodec << 56 );
+    memcpy( &oData[0], &header, 8 );
+}
+
+//-*****************************************************************************
+static Util::uint64_t ReadHeader( Ogawa::IDataPtr iData,
+                                  std::size_t iThreadId )
+{
+    if ( iData->getSize() == 0 )
+    {
+        return 0;
+    }
+
+    ABCA_ASSERT( iData->getSize() >= kCompressedDataOffset,
+        "Incorrect compressed data, expected a key and compression header" );
+
+    Util::uint64_t header = 0;
+    iData->read( 8, &header, 16, iThreadId );
+    return header;
+}
+
+//-*****************************************************************************
+std::size_t ReadUncompressedSize( Ogawa::IDataPtr iData,
+                                  std::size_t iThreadId )
+{
+    return ( std::size_t )( ReadHeader( iData, iThreadId ) & kSizeMask );
+}
+
+//-*****************************************************************************
+Util::uint8_t ReadCompressionCodec( Ogawa::IDataPtr iData,
+                                    std::size_t iThreadId )
+{
+    return ( Util::uint8_t )( ReadHeader( iData, iThreadId ) >> 56 );
+}
+
+//-*****************************************************************************
+void DecompressData( Ogawa::IDataPtr iData,
+                     std::size_t iThreadId,
+                     void * oData )
+{
+    Util::uint64_t header = ReadHeader( iData, iThreadId );
+    std::size_t size = ( std::size_t )( header & kSizeMask );
+    Util::uint8_t codec = ( Util::uint8_t )( header >> 56 );
+
+    if ( size == 0 )
+    {
+        return;
+    }
+
+    ABCA_ASSERT( IsCodecAvailable( codec ),
+                 "Unsupported compression codec: " << ( int ) codec );
+
+    std::size_t compressedSize = iData->getSize() - kCompressedDataOffset;
+
+    if ( codec == kStoredCodec )
+    {
+        ABCA_ASSERT( compressedSize == size,
+                     "Incorrect size of stored data" );
+        iData->read( size, oData, kCompressedDataOffset, iThreadId );
+        return;
+    }
+
+    std::vector< char > buf( compressedSize );
+    iData->read( compressedSize, &buf.front(), kCompressedDataOffset,
+                 iThreadId );
+
+    bool valid = false;
+
+    if ( codec == kZlibCodec )
+    {
+        uLongf destLen = size;
+        valid = uncompress( ( Bytef * ) oData, &destLen,
+            ( const Bytef * ) &buf.front(), compressedSize ) == Z_OK &&
+            destLen == size;
+    }
+#ifdef ALEMBIC_WITH_LZ4
+    else if ( codec == kLZ4Codec )
+    {
+        valid = LZ4_decompress_safe( &buf.front(), ( char * ) oData,
+            ( int ) compressedSize, ( int ) size ) == ( int ) size;
+    }
+#endif
+
+    ABCA_ASSERT( valid, "Could not decompress the data" );
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcCoreOgawa
+} // End namespace Alembic
@@ -0,0 +1,102 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcCoreOgawa_CompressUtil_h_
+#define _Alembic_AbcCoreOgawa_CompressUtil_h_
+
+#include <Alembic/AbcCoreOgawa/Foundation.h>
+
+namespace Alembic {
+namespace AbcCoreOgawa {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+// Array samples of compressed properties are written as the 16 byte key,
+// followed by an 8 byte header and then the (possibly) compressed data.
+// The lower 56 bits of the header hold the uncompressed size of the data,
+// and the top 8 bits hold the codec that was used.
+//-*****************************************************************************
+
+// the data isn't actually compressed, because it wouldn't have gotten smaller
+static const Util::uint8_t kStoredCodec = 0;
+static const Util::uint8_t kZlibCodec = 1;
+static const Util::uint8_t kLZ4Codec = 2;
+
+// size of the key plus the compression header
+static const std::size_t kCompressedDataOffset = 24;
+
+//-*****************************************************************************
+// Returns whether the library was built with support for iCodec.
+bool IsCodecAvailable( Util::uint8_t iCodec );
+
+//-*****************************************************************************
+// Compresses iSize bytes from iData using iCodec at iLevel (0-9), and
+// fills oData with the compression header and the compressed data.
+// If the data doesn't get any smaller it is stored instead.
+void CompressData( const void * iData,
+                   std::size_t iSize,
+                   Util::uint8_t iCodec,
+                   Util::int8_t iLevel,
+                   std::vector< Util::uint8_t > & oData );
+
+//-*****************************************************************************
+// Reads the compression header of a compressed array sample, and returns the
+// uncompressed size of the data, 0 if the sample is empty.
+std::size_t ReadUncompressedSize( Ogawa::IDataPtr iData,
+                                  std::size_t iThreadId );
+
+//-*****************************************************************************
+// Reads the compression header of a compressed array sample, and returns the
+// codec it was written with, kStoredCodec if the sample is empty.
+// The level isn't stored, so there is no way to know what it was.
+Util::uint8_t ReadCompressionCodec( Ogawa::IDataPtr iData,
+                                    std::size_t iThreadId );
+
+//-*****************************************************************************
+// Uncompresses a compressed array sample into oData, which needs to be able
+// to hold the uncompressed size of the data.
+void DecompressData( Ogawa::IDataPtr iData,
+                     std::size_t iThreadId,
+                     void * oData );
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcCoreOgawa
+} // End namespace Alembic
+
+#endif
@@ -62,8 +62,14 @@ CprData::CprData( Ogawa::IGroupPtr iGroup,
     if ( numChildren > 0 && m_group->isChildData( numChildren - 1 ) )
     {
         PropertyHeaderPtrs headers;
-        ReadPropertyHeaders( m_group, numChildren - 1, iThreadId,
-                             iArchive, iIndexedMetaData, headers );
+        Util::uint64_t numBytes = ReadPropertyHeaders( m_group,
+            numChildren - 1, iThreadId, iArchive, iIndexedMetaData, headers );
+
+        ArImpl * ar = dynamic_cast< ArImpl * >( &iArchive );
+        if ( ar )
+        {
+            ar->countPropertyBytes( AbcA::kCompoundProperty, numBytes );
+        }
 
         m_propertyHeaders = new SubProperty[ headers.size() ];
         for ( std::size_t i = 0; i < headers.size(); ++i )
@@ -237,7 +243,14 @@ CprData::getCompoundProperty( AbcA::CompoundPropertyReaderPtr iParent,
 
     Alembic::Util::scoped_lock l( sub.lock );
     AbcA::BasePropertyReaderPtr bptr = sub.made.lock();
-    if ( ! bptr )
+    if ( ! bptr && sub.data )
+    {
+        bptr = Alembic::Util::shared_ptr<CprImpl>(
+            new CprImpl( iParent, sub.data, sub.header ) );
+
+        sub.made = bptr;
+    }
+    else if ( ! bptr )
     {
         Alembic::Util::shared_ptr<  ArImpl > implPtr =
             Alembic::Util::dynamic_pointer_cast< ArImpl, AbcA::ArchiveReader > (
@@ -253,7 +266,7 @@ CprData::getCompoundProperty( AbcA::CompoundPropertyReaderPtr iParent,
         // Make a new one.
         bptr = Alembic::Util::shared_ptr<CprImpl>(
             new CprImpl( iParent, group, sub.header, streamId->getID(),
-                         implPtr->getIndexedMetaData() ) );
+                         implPtr->getSnapshot()->indexedMetaData ) );
 
         sub.made = bptr;
     }
@@ -264,6 +277,34 @@ CprData::getCompoundProperty( AbcA::CompoundPropertyReaderPtr iParent,
     return ret;
 }
 
+//-*****************************************************************************
+CprDataPtr
+CprData::preloadCompound( size_t i,
+                          size_t iThreadId,
+                          AbcA::ArchiveReader & iArchive,
+                          const std::vector< AbcA::MetaData > & iIndexedMetaData )
+{
+    ABCA_ASSERT( i < m_subProperties.size(),
+        "Out of range index in CprData::preloadCompound: " << i );
+
+    SubProperty & sub = m_propertyHeaders[i];
+    if ( !( sub.header->header.isCompound() ) )
+    {
+        return CprDataPtr();
+    }
+
+    Ogawa::IGroupPtr group = m_group->getGroup( i, false, iThreadId );
+
+    ABCA_ASSERT( group, "Compound Property not backed by a valid group.");
+
+    CprDataPtr data( new CprData( group, iThreadId, iArchive,
+                                  iIndexedMetaData ) );
+
+    Alembic::Util::scoped_lock l( sub.lock );
+    sub.data = data;
+    return data;
+}
+
 } // End namespace ALEMBIC_VERSION_NS
 } // End namespace AbcCoreOgawa
 } // End namespace Alembic
@@ -77,6 +77,15 @@ public:
     getCompoundProperty( AbcA::CompoundPropertyReaderPtr iParent,
                          const std::string &iName );
 
+    // reads the headers of the compound property i and keeps them, so
+    // getCompoundProperty doesn't need to read them again, returns NULL if
+    // property i isn't a compound
+    Alembic::Util::shared_ptr< CprData >
+    preloadCompound( size_t i,
+                     size_t iThreadId,
+                     AbcA::ArchiveReader & iArchive,
+                     const std::vector< AbcA::MetaData > & iIndexedMetaData );
+
 private:
     Ogawa::IGroupPtr m_group;
 
@@ -85,6 +94,9 @@ private:
     {
         PropertyHeaderPtr header;
         WeakBprPtr made;
+
+        // set for compounds when the hierarchy is preloaded
+        Alembic::Util::shared_ptr< CprData > data;
         Alembic::Util::mutex lock;
     };
 
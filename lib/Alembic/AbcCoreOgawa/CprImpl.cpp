@@ -74,6 +74,24 @@ CprImpl::CprImpl( AbcA::CompoundPropertyReaderPtr iParent,
                                iIndexedMetaData ) );
 }
 
+//-*****************************************************************************
+CprImpl::CprImpl( AbcA::CompoundPropertyReaderPtr iParent,
+                  CprDataPtr iData,
+                  PropertyHeaderPtr iHeader )
+    : m_parent( iParent )
+    , m_header( iHeader )
+    , m_data( iData )
+{
+    ABCA_ASSERT( m_parent, "Invalid parent in CprImpl(Compound)" );
+    ABCA_ASSERT( m_header, "invalid header in CprImpl(Compound)" );
+    ABCA_ASSERT( m_data, "Invalid data in CprImpl(Compound)" );
+
+    // Set object.
+    AbcA::ObjectReaderPtr optr = m_parent->getObject();
+    ABCA_ASSERT( optr, "Invalid object in CprImpl::CprImpl(Compound)" );
+    m_object = optr;
+}
+
 //-*****************************************************************************
 CprImpl::CprImpl( AbcA::ObjectReaderPtr iObject,
                   CprDataPtr iData )
@@ -58,6 +58,12 @@ public:
              std::size_t iThreadId,
              const std::vector< AbcA::MetaData > & iIndexedMetaData );
 
+    // For construction from a compound property reader, which already
+    // has our data
+    CprImpl( AbcA::CompoundPropertyReaderPtr iParent,
+             CprDataPtr iData,
+             PropertyHeaderPtr iHeader );
+
     CprImpl( AbcA::ObjectReaderPtr iParent,
              CprDataPtr iData );
 
@@ -40,17 +40,75 @@
 #include <Alembic/AbcCoreOgawa/ApwImpl.h>
 #include <Alembic/AbcCoreOgawa/CpwImpl.h>
 #include <Alembic/AbcCoreOgawa/AwImpl.h>
+#include <Alembic/AbcCoreOgawa/ArImpl.h>
+#include <Alembic/AbcCoreOgawa/ReadUtil.h>
 
 namespace Alembic {
 namespace AbcCoreOgawa {
 namespace ALEMBIC_VERSION_NS {
 
+//-*****************************************************************************
+static void WriteInfo( std::vector< Util::uint8_t > & ioData,
+                       const PropertyHeaderAndFriends & iProp,
+                       MetaDataMapPtr iMetaDataMap )
+{
+    WritePropertyInfo( ioData,
+                       iProp.header,
+                       iProp.isScalarLike,
+                       iProp.isHomogenous,
+                       iProp.isCompressed,
+                       iProp.isPacked,
+                       iProp.timeSamplingIndex,
+                       iProp.nextSampleIndex,
+                       iProp.firstChangedIndex,
+                       iProp.lastChangedIndex,
+                       iMetaDataMap );
+}
+
 //-*****************************************************************************
 CpwData::CpwData( Ogawa::OGroupPtr iGroup )
     : m_group( iGroup )
 {
 }
 
+//-*****************************************************************************
+CpwData::CpwData( Ogawa::OGroupPtr iGroup,
+                  Ogawa::IGroupPtr iExisting,
+                  ArImpl & iArchive )
+    : m_group( iGroup )
+    , m_existing( iExisting )
+{
+    ABCA_ASSERT( m_existing, "Invalid existing group" );
+
+    std::size_t numChildren = m_existing->getNumChildren();
+    if ( numChildren > 0 && m_existing->isChildData( numChildren - 1 ) )
+    {
+        ReadPropertyHeaders( m_existing, numChildren - 1, 0, iArchive,
+                             iArchive.getSnapshot()->indexedMetaData,
+                             m_propertyHeaders );
+    }
+
+    for ( size_t i = 0; i < m_propertyHeaders.size(); ++i )
+    {
+        const AbcA::PropertyHeader & header = m_propertyHeaders[i]->header;
+        m_group->addChild( m_existing, i );
+        m_existingProperties[ header.getName() ] = i;
+
+        // like the children of objects (see OwData) properties that aren't
+        // reopened are hashed by where they are in the file
+        Util::uint64_t entry = m_existing->getChildEntry( i, 0 );
+        Util::SpookyHash hash;
+        hash.Init( 0, 0 );
+        HashPropertyHeader( header, hash );
+        hash.Update( &entry, 8 );
+
+        Util::uint64_t hash0, hash1;
+        hash.Final( &hash0, &hash1 );
+        m_hashes.push_back( hash0 );
+        m_hashes.push_back( hash1 );
+    }
+}
+
 //-*****************************************************************************
 CpwData::~CpwData()
 {
@@ -108,6 +166,56 @@ CpwData::getProperty( const std::string &iName )
     return wptr.lock();
 }
 
+//-*****************************************************************************
+AbcA::BasePropertyWriterPtr
+CpwData::getProperty( AbcA::CompoundPropertyWriterPtr iParent,
+                      const std::string &iName )
+{
+    std::map< std::string, size_t >::iterator eiter =
+        m_existingProperties.find( iName );
+    if ( m_madeProperties.count( iName ) ||
+         eiter == m_existingProperties.end() )
+    {
+        return getProperty( iName );
+    }
+
+    // reopen the property so that it can be added to
+    size_t index = eiter->second;
+    PropertyHeaderPtr header = m_propertyHeaders[index];
+    Ogawa::OGroupPtr group = m_group->replaceWithNewGroup( index );
+    Ogawa::IGroupPtr existing = m_existing->getGroup( index, false, 0 );
+
+    AbcA::BasePropertyWriterPtr ret;
+    if ( header->header.isCompound() )
+    {
+        AwImpl * aw = dynamic_cast< AwImpl * >(
+            iParent->getObject()->getArchive().get() );
+        ABCA_ASSERT( aw && aw->getExisting(), "Invalid archive" );
+
+        CpwDataPtr data( new CpwData( group, existing,
+                                      *( aw->getExisting() ) ) );
+        ret.reset( new CpwImpl( iParent, data, header, index ) );
+    }
+    else if ( header->header.isScalar() )
+    {
+        Alembic::Util::shared_ptr<SpwImpl>
+            spw( new SpwImpl( iParent, group, header, index ) );
+        spw->reopen( existing );
+        ret = spw;
+    }
+    else
+    {
+        Alembic::Util::shared_ptr<ApwImpl>
+            apw( new ApwImpl( iParent, group, header, index ) );
+        apw->reopen( existing );
+        ret = apw;
+    }
+
+    m_madeProperties[iName] = WeakBpwPtr( ret );
+
+    return ret;
+}
+
 //-*****************************************************************************
 AbcA::ScalarPropertyWriterPtr
 CpwData::createScalarProperty( AbcA::CompoundPropertyWriterPtr iParent,
@@ -116,7 +224,8 @@ CpwData::createScalarProperty( AbcA::CompoundPropertyWriterPtr iParent,
                                const AbcA::DataType & iDataType,
                                Util::uint32_t iTimeSamplingIndex )
 {
-    if ( m_madeProperties.count( iName ) )
+    if ( m_madeProperties.count( iName ) ||
+         m_existingProperties.count( iName ) )
     {
         ABCA_THROW( "Already have a property named: " << iName );
     }
@@ -155,7 +264,8 @@ CpwData::createArrayProperty( AbcA::CompoundPropertyWriterPtr iParent,
                               const AbcA::DataType & iDataType,
                               Util::uint32_t iTimeSamplingIndex )
 {
-    if ( m_madeProperties.count( iName ) )
+    if ( m_madeProperties.count( iName ) ||
+         m_existingProperties.count( iName ) )
     {
         ABCA_THROW( "Already have a property named: " << iName );
     }
@@ -192,7 +302,8 @@ CpwData::createCompoundProperty( AbcA::CompoundPropertyWriterPtr iParent,
                                  const std::string & iName,
                                  const AbcA::MetaData & iMetaData )
 {
-    if ( m_madeProperties.count( iName ) )
+    if ( m_madeProperties.count( iName ) ||
+         m_existingProperties.count( iName ) )
     {
         ABCA_THROW( "Already have a property named: " << iName );
     }
@@ -220,16 +331,7 @@ void CpwData::writePropertyHeaders( MetaDataMapPtr iMetaDataMap )
     std::vector< Util::uint8_t > data;
     for ( size_t i = 0; i < getNumProperties(); ++i )
     {
-        PropertyHeaderPtr prop = m_propertyHeaders[i];
-        WritePropertyInfo( data,
-                           prop->header,
-                           prop->isScalarLike,
-                           prop->isHomogenous,
-                           prop->timeSamplingIndex,
-                           prop->nextSampleIndex,
-                           prop->firstChangedIndex,
-                           prop->lastChangedIndex,
-                           iMetaDataMap );
+        WriteInfo( data, *m_propertyHeaders[i], iMetaDataMap );
     }
 
     if ( !data.empty() )
@@ -238,6 +340,59 @@ void CpwData::writePropertyHeaders( MetaDataMapPtr iMetaDataMap )
     }
 }
 
+//-*****************************************************************************
+void CpwData::writeSnapshot( MetaDataMapPtr iMetaDataMap,
+                             Ogawa::SnapshotExtras & oExtras,
+                             std::vector< AbcA::index_t > & ioMaxSamples )
+{
+    std::vector< Util::uint8_t > data;
+    for ( size_t i = 0; i < getNumProperties(); ++i )
+    {
+        // what gets written for properties that are still open can differ
+        // from what they'll have once they are closed
+        PropertyHeaderAndFriends prop = *m_propertyHeaders[i];
+        AbcA::BasePropertyWriterPtr writer =
+            getProperty( prop.header.getName() );
+
+        if ( writer && prop.header.isCompound() )
+        {
+            Alembic::Util::dynamic_pointer_cast< CpwImpl,
+                AbcA::BasePropertyWriter >( writer )->writeSnapshot(
+                    iMetaDataMap, oExtras, ioMaxSamples );
+        }
+        else if ( writer )
+        {
+            if ( prop.header.isScalar() )
+            {
+                Alembic::Util::dynamic_pointer_cast< SpwImpl,
+                    AbcA::BasePropertyWriter >( writer )->writeSnapshot(
+                        prop, oExtras );
+            }
+
+            // the same as what the property does when it is closed
+            Util::uint32_t numSamples = prop.nextSampleIndex;
+            if ( prop.lastChangedIndex == 0 && numSamples > 0 )
+            {
+                numSamples = 1;
+            }
+
+            if ( prop.timeSamplingIndex < ioMaxSamples.size() &&
+                 ioMaxSamples[prop.timeSamplingIndex] < numSamples )
+            {
+                ioMaxSamples[prop.timeSamplingIndex] = numSamples;
+            }
+        }
+
+        WriteInfo( data, prop, iMetaDataMap );
+    }
+
+    if ( !data.empty() )
+    {
+        oExtras[m_group.get()].push_back(
+            m_group->createData( data.size(), &( data.front() ) ) );
+    }
+}
+
 //-*****************************************************************************
 void CpwData::fillHash( size_t iIndex, Util::uint64_t iHash0,
     Util::uint64_t iHash1 )
@@ -44,6 +44,8 @@ namespace Alembic {
 namespace AbcCoreOgawa {
 namespace ALEMBIC_VERSION_NS {
 
+class ArImpl;
+
 // data class owned by CpwImpl, or OwImpl if it is a "top" object
 // it owns and makes child properties as well as the group hid_t
 // when necessary
@@ -53,6 +55,13 @@ public:
 
     CpwData( Ogawa::OGroupPtr iGroup );
 
+    // for appending, continues the compound property iArchive has in
+    // iExisting.  Its properties are referenced as they are, until they
+    // are reopened.
+    CpwData( Ogawa::OGroupPtr iGroup,
+             Ogawa::IGroupPtr iExisting,
+             ArImpl & iArchive );
+
     ~CpwData();
 
     size_t getNumProperties();
@@ -63,6 +72,12 @@ public:
 
     AbcA::BasePropertyWriterPtr getProperty( const std::string & iName );
 
+    // same as above, but properties that were already in the archive being
+    // appended to are reopened as children of iParent
+    AbcA::BasePropertyWriterPtr
+    getProperty( AbcA::CompoundPropertyWriterPtr iParent,
+                 const std::string & iName );
+
     AbcA::ScalarPropertyWriterPtr
     createScalarProperty( AbcA::CompoundPropertyWriterPtr iParent,
         const std::string & iName,
@@ -89,6 +104,14 @@ public:
 
     void computeHash( Util::SpookyHash & ioHash );
 
+    // Adds the property headers, as they would be written if we were
+    // closed now, to oExtras for AwImpl::commit, along with what the
+    // properties that are still being written need.  ioMaxSamples is
+    // updated with the number of samples of those properties.
+    void writeSnapshot( MetaDataMapPtr iMetaDataMap,
+                        Ogawa::SnapshotExtras & oExtras,
+                        std::vector< AbcA::index_t > & ioMaxSamples );
+
 private:
 
     // The group corresponding to this property.
@@ -101,6 +124,11 @@ private:
 
     // child hashes
     std::vector< Util::uint64_t > m_hashes;
+
+    // when appending, our group in the existing archive and the index of
+    // each of the properties that were already in it
+    Ogawa::IGroupPtr m_existing;
+    std::map< std::string, size_t > m_existingProperties;
 };
 
 typedef Alembic::Util::shared_ptr<CpwData> CpwDataPtr;
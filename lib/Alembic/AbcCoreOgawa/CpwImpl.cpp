@@ -82,6 +82,23 @@ CpwImpl::CpwImpl( AbcA::CompoundPropertyWriterPtr iParent,
     m_data.reset( new CpwData( iGroup ) );
 }
 
+//-*****************************************************************************
+CpwImpl::CpwImpl( AbcA::CompoundPropertyWriterPtr iParent,
+                  CpwDataPtr iData,
+                  PropertyHeaderPtr iHeader,
+                  size_t iIndex )
+  : m_parent( iParent )
+  , m_header( iHeader )
+  , m_data( iData )
+  , m_index( iIndex )
+{
+    ABCA_ASSERT( m_parent, "Invalid parent" );
+    ABCA_ASSERT( m_header, "Invalid header" );
+    ABCA_ASSERT( m_data, "Invalid compound data" );
+
+    m_object = iParent->getObject();
+}
+
 //-*****************************************************************************
 CpwImpl::~CpwImpl()
 {
@@ -89,9 +106,14 @@ CpwImpl::~CpwImpl()
     // as part of their "top" compound
     if ( m_parent )
     {
-        MetaDataMapPtr mdMap = Alembic::Util::dynamic_pointer_cast<
-            AwImpl, AbcA::ArchiveWriter >(
-                getObject()->getArchive() )->getMetaDataMap();
+        Util::shared_ptr< AwImpl > aw = Alembic::Util::dynamic_pointer_cast<
+            AwImpl, AbcA::ArchiveWriter >( getObject()->getArchive() );
+
+        // make sure samples written by other threads are done before we
+        // write our headers
+        aw->waitForWritesNoThrow();
+
+        MetaDataMapPtr mdMap = aw->getMetaDataMap();
         m_data->writePropertyHeaders( mdMap );
 
         Util::SpookyHash hash;
@@ -155,7 +177,7 @@ CpwImpl::getPropertyHeader( const std::string &iName )
 //-*****************************************************************************
 AbcA::BasePropertyWriterPtr CpwImpl::getProperty( const std::string & iName )
 {
-    return m_data->getProperty( iName );
+    return m_data->getProperty( asCompoundPtr(), iName );
 }
 
 //-*****************************************************************************
@@ -203,6 +225,14 @@ void CpwImpl::fillHash( std::size_t iIndex, Util::uint64_t iHash0,
     m_data->fillHash( iIndex, iHash0, iHash1 );
 }
 
+//-*****************************************************************************
+void CpwImpl::writeSnapshot( MetaDataMapPtr iMetaDataMap,
+                             Ogawa::SnapshotExtras & oExtras,
+                             std::vector< AbcA::index_t > & ioMaxSamples )
+{
+    m_data->writeSnapshot( iMetaDataMap, oExtras, ioMaxSamples );
+}
+
 } // End namespace ALEMBIC_VERSION_NS
 } // End namespace AbcCoreOgawa
 } // End namespace Alembic
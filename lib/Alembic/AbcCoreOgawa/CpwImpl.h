@@ -62,6 +62,13 @@ public:
              PropertyHeaderPtr iHeader,
              size_t iIndex );
 
+    // for a compound that was already in the archive being appended to,
+    // iData is what it has so far
+    CpwImpl( AbcA::CompoundPropertyWriterPtr iParent,
+             CpwDataPtr iData,
+             PropertyHeaderPtr iHeader,
+             size_t iIndex );
+
     virtual ~CpwImpl();
 
     //-*************************************************************************
@@ -109,6 +116,11 @@ public:
     void fillHash( size_t iIndex, Util::uint64_t iHash0,
                    Util::uint64_t iHash1 );
 
+    // see CpwData::writeSnapshot
+    void writeSnapshot( MetaDataMapPtr iMetaDataMap,
+                        Ogawa::SnapshotExtras & oExtras,
+                        std::vector< AbcA::index_t > & ioMaxSamples );
+
 private:
 
     // The object we belong to.
@@ -54,7 +54,14 @@
 #include <assert.h>
 #include <string.h>
 
-#define ALEMBIC_OGAWA_FILE_VERSION 0
+// The newest version of how AbcCoreOgawa lays out its data within Ogawa that
+// we can read.  Archives are written with the oldest version that is able to
+// describe what was written.
+// 0 - the original layout
+// 1 - array properties may have compressed samples
+// 2 - headers may refer to meta data past the first 254 in the meta data map
+// 3 - scalar properties may have all of their samples packed into one data
+#define ALEMBIC_OGAWA_FILE_VERSION 3
 
 //-*****************************************************************************
 
@@ -82,6 +89,8 @@ struct PropertyHeaderAndFriends
     {
         isScalarLike = true;
         isHomogenous = true;
+        isCompressed = false;
+        isPacked = false;
         nextSampleIndex = 0;
         firstChangedIndex = 0;
         lastChangedIndex = 0;
@@ -95,6 +104,8 @@ struct PropertyHeaderAndFriends
     {
         isScalarLike = true;
         isHomogenous = true;
+        isCompressed = false;
+        isPacked = false;
         nextSampleIndex = 0;
         firstChangedIndex = 0;
         lastChangedIndex = 0;
@@ -113,6 +124,8 @@ struct PropertyHeaderAndFriends
     {
         isScalarLike = true;
         isHomogenous = true;
+        isCompressed = false;
+        isPacked = false;
         nextSampleIndex = 0;
         firstChangedIndex = 0;
         lastChangedIndex = 0;
@@ -154,6 +167,13 @@ struct PropertyHeaderAndFriends
 
     bool isHomogenous;
 
+    // whether the samples of this array property are compressed
+    bool isCompressed;
+
+    // whether the samples of this scalar property are packed one after
+    // another into a single data, without keys
+    bool isPacked;
+
     // Index of the next sample to write
     Util::uint32_t nextSampleIndex;
 
@@ -0,0 +1,292 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreOgawa/HierarchyLoader.h>
+#include <Alembic/AbcCoreOgawa/ArImpl.h>
+#include <Alembic/AbcCoreOgawa/CprData.h>
+
+#include <deque>
+
+#if ( defined( _MSC_VER ) && _MSC_VER > 1600 ) || \
+    ( !defined( _MSC_VER ) && \
+      ( defined( __GXX_EXPERIMENTAL_CXX0X__ ) || __cplusplus >= 201103L ) )
+#define ALEMBIC_PARALLEL_PRELOAD
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace Alembic {
+namespace AbcCoreOgawa {
+namespace ALEMBIC_VERSION_NS {
+
+namespace {
+
+//-*****************************************************************************
+// Either child iIndex of an object, or compound property iIndex of a
+// compound property.  The parents are kept alive by the loader's top object.
+struct PreloadTask
+{
+    PreloadTask( OrData * iObject, CprData * iCompound, std::size_t iIndex )
+        : object( iObject ), compound( iCompound ), index( iIndex ) {}
+
+    OrData * object;
+    CprData * compound;
+    std::size_t index;
+};
+
+//-*****************************************************************************
+class HierarchyLoader
+{
+public:
+    HierarchyLoader( ArImpl & iArchive ) : m_archive( iArchive )
+#ifdef ALEMBIC_PARALLEL_PRELOAD
+        , m_numRunning( 0 )
+#endif
+    {}
+
+    void addObject( OrData * iObject );
+    void addCompound( CprData * iCompound );
+
+    void run( std::size_t iNumThreads );
+
+private:
+    void push( const PreloadTask & iTask );
+    void runTask( const PreloadTask & iTask, std::size_t iThreadId );
+    void runTasks();
+
+    ArImpl & m_archive;
+    std::deque< PreloadTask > m_tasks;
+
+#ifdef ALEMBIC_PARALLEL_PRELOAD
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+
+    // how many tasks are running, they may still add more tasks
+    std::size_t m_numRunning;
+    std::string m_error;
+#endif
+};
+
+//-*****************************************************************************
+void HierarchyLoader::addObject( OrData * iObject )
+{
+    std::size_t numChildren = iObject->getNumChildren();
+    for ( std::size_t i = 0; i < numChildren; ++i )
+    {
+        push( PreloadTask( iObject, NULL, i ) );
+    }
+
+    CprDataPtr props = iObject->getPropertyData();
+    if ( props )
+    {
+        addCompound( props.get() );
+    }
+}
+
+//-*****************************************************************************
+void HierarchyLoader::addCompound( CprData * iCompound )
+{
+    std::size_t numProps = iCompound->getNumProperties();
+    for ( std::size_t i = 0; i < numProps; ++i )
+    {
+        const AbcA::PropertyHeader & header = iCompound->getPropertyHeader(
+            AbcA::CompoundPropertyReaderPtr(), i );
+
+        if ( header.isCompound() )
+        {
+            push( PreloadTask( NULL, iCompound, i ) );
+        }
+    }
+}
+
+//-*****************************************************************************
+void HierarchyLoader::runTask( const PreloadTask & iTask,
+                               std::size_t iThreadId )
+{
+    // the new data is owned by its parent, which outlives the loader
+    if ( iTask.object )
+    {
+        OrDataPtr child = iTask.object->preloadChild( iTask.index, iThreadId,
+            m_archive, m_archive.getSnapshot()->indexedMetaData );
+        addObject( child.get() );
+    }
+    else
+    {
+        CprDataPtr child = iTask.compound->preloadCompound( iTask.index,
+            iThreadId, m_archive, m_archive.getSnapshot()->indexedMetaData );
+        if ( child )
+        {
+            addCompound( child.get() );
+        }
+    }
+}
+
+#ifdef ALEMBIC_PARALLEL_PRELOAD
+
+//-*****************************************************************************
+void HierarchyLoader::push( const PreloadTask & iTask )
+{
+    {
+        std::unique_lock< std::mutex > lock( m_mutex );
+        m_tasks.push_back( iTask );
+    }
+    m_cond.notify_one();
+}
+
+//-*****************************************************************************
+void HierarchyLoader::runTasks()
+{
+    StreamIDPtr streamId = m_archive.getStreamID();
+    std::size_t id = streamId->getID();
+
+    std::unique_lock< std::mutex > lock( m_mutex );
+    for ( ;; )
+    {
+        while ( m_tasks.empty() && m_numRunning > 0 && m_error.empty() )
+        {
+            m_cond.wait( lock );
+        }
+
+        // nothing left to do, and nothing running which could add more
+        if ( m_tasks.empty() || !m_error.empty() )
+        {
+            m_cond.notify_all();
+            return;
+        }
+
+        // the most recently added task is the deepest one, taking it first
+        // keeps the queue small
+        PreloadTask task = m_tasks.back();
+        m_tasks.pop_back();
+        m_numRunning ++;
+        lock.unlock();
+
+        std::string error;
+        try
+        {
+            runTask( task, id );
+        }
+        catch ( std::exception & e )
+        {
+            error = e.what();
+        }
+        catch ( ... )
+        {
+            error = "Unknown error while preloading the hierarchy";
+        }
+
+        lock.lock();
+        m_numRunning --;
+        if ( !error.empty() && m_error.empty() )
+        {
+            m_error = error;
+        }
+
+        if ( m_numRunning == 0 || !m_error.empty() )
+        {
+            m_cond.notify_all();
+        }
+    }
+}
+
+//-*****************************************************************************
+void HierarchyLoader::run( std::size_t iNumThreads )
+{
+    std::vector< std::thread > threads;
+    for ( std::size_t i = 1; i < iNumThreads; ++i )
+    {
+        threads.push_back( std::thread( &HierarchyLoader::runTasks, this ) );
+    }
+
+    runTasks();
+
+    for ( std::size_t i = 0; i < threads.size(); ++i )
+    {
+        threads[i].join();
+    }
+
+    if ( !m_error.empty() )
+    {
+        ABCA_THROW( m_error );
+    }
+}
+
+#else
+
+//-*****************************************************************************
+void HierarchyLoader::push( const PreloadTask & iTask )
+{
+    m_tasks.push_back( iTask );
+}
+
+//-*****************************************************************************
+void HierarchyLoader::runTasks()
+{
+    StreamIDPtr streamId = m_archive.getStreamID();
+    std::size_t id = streamId->getID();
+
+    while ( !m_tasks.empty() )
+    {
+        PreloadTask task = m_tasks.back();
+        m_tasks.pop_back();
+        runTask( task, id );
+    }
+}
+
+//-*****************************************************************************
+void HierarchyLoader::run( std::size_t iNumThreads )
+{
+    runTasks();
+}
+
+#endif
+
+} // End anonymous namespace
+
+//-*****************************************************************************
+void PreloadHierarchy( OrDataPtr iTop,
+                       ArImpl & iArchive,
+                       std::size_t iNumThreads )
+{
+    HierarchyLoader loader( iArchive );
+    loader.addObject( iTop.get() );
+    loader.run( iNumThreads );
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcCoreOgawa
+} // End namespace Alembic
@@ -40,6 +40,10 @@ namespace Alembic {
 namespace AbcCoreOgawa {
 namespace ALEMBIC_VERSION_NS {
 
+//-*****************************************************************************
+// the most strings an extended map will hold
+static const Util::uint32_t kMaxExtendedMetaData = 1024 * 1024;
+
 //-*****************************************************************************
 Util::uint32_t MetaDataMap::getIndex( const std::string & iStr )
 {
@@ -54,18 +58,32 @@ Util::uint32_t MetaDataMap::getIndex( const std::string & iStr )
         std::map< std::string, Util::uint32_t >::iterator it =
             m_map.find( iStr );
 
+        Util::uint32_t index = 0;
         if ( it != m_map.end() )
         {
-            return it->second + 1;
+            index = it->second;
         }
         // 255 is reserved for meta data which we need to
         // explicitly write (and 0 means empty metadata)
-        else if ( it == m_map.end() && m_map.size() < 254 )
+        else if ( m_map.size() < 254 ||
+                  ( m_extended && m_map.size() < kMaxExtendedMetaData ) )
         {
-            Util::uint32_t index = m_map.size();
+            index = m_map.size();
             m_map[iStr] = index;
+        }
+        else
+        {
+            return 255;
+        }
+
+        if ( index < 254 )
+        {
             return index + 1;
         }
+
+        // skip over 255
+        m_usesExtendedIndices = true;
+        return index + 2;
     }
 
     // too long, or no room left for this entry
@@ -74,12 +92,17 @@ Util::uint32_t MetaDataMap::getIndex( const std::string & iStr )
 
 //-*****************************************************************************
 void MetaDataMap::write( Ogawa::OGroupPtr iParent )
+{
+    iParent->addData( createData( iParent ) );
+}
+
+//-*****************************************************************************
+Ogawa::ODataPtr MetaDataMap::createData( Ogawa::OGroupPtr iParent )
 {
 
     if ( m_map.empty() )
     {
-        iParent->addEmptyData();
-        return;
+        return Ogawa::ODataPtr( new Ogawa::OData() );
     }
 
     std::vector< std::string > mdVec;
@@ -104,7 +127,24 @@ void MetaDataMap::write( Ogawa::OGroupPtr iParent )
         buf.insert( buf.end(), jt->begin(), jt->end() );
     }
 
-    iParent->addData( buf.size(), ( const void * )&buf.front() );
+    return iParent->createData( buf.size(), ( const void * )&buf.front() );
+}
+
+//-*****************************************************************************
+void MetaDataMap::load( const std::vector< AbcA::MetaData > & iMetaDataVec )
+{
+    // the first is the default empty meta data, which isn't in the map
+    for ( std::size_t i = 1; i < iMetaDataVec.size(); ++i )
+    {
+        m_map[ iMetaDataVec[i].serialize() ] = ( Util::uint32_t ) i - 1;
+    }
+
+    // only an extended map could have written this many
+    if ( m_map.size() > 254 )
+    {
+        m_extended = true;
+        m_usesExtendedIndices = true;
+    }
 }
 
 } // End namespace ALEMBIC_VERSION_NS
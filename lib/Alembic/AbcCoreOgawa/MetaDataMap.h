@@ -46,18 +46,39 @@ namespace ALEMBIC_VERSION_NS {
 //-*****************************************************************************
 // convenience class which is meant to map serialized meta data to an index
 // It will only hold 254 strings, and won't hold any that are over 256 bytes
+// unless it is extended, in which case it holds up to kMaxExtendedMetaData
+// strings.
 class MetaDataMap
 {
 public:
-    MetaDataMap() {};
+    MetaDataMap( bool iExtended = false )
+        : m_extended( iExtended ), m_usesExtendedIndices( false ) {};
     ~MetaDataMap() {};
 
     // will return 0xff if iStr is too long, or we've run out of indices
     // 0 will be returned if iStr is empty
+    // Extended maps return indices past 0xff for the strings past the
+    // first 254, these are 1 more than where the string ends up in the
+    // meta data read back by ReadIndexedMetaData.
     Util::uint32_t getIndex( const std::string & iStr );
+
+    // whether getIndex has returned any index past 0xff, if so only readers
+    // of file version 2 or newer can read the headers
+    bool usesExtendedIndices() const { return m_usesExtendedIndices; }
+
     void write( Ogawa::OGroupPtr iParent );
+
+    // writes the map like write does, but doesn't add it to iParent
+    Ogawa::ODataPtr createData( Ogawa::OGroupPtr iParent );
+
+    // fills an empty map with the meta data read by ReadIndexedMetaData
+    // from an archive that is being appended to, so that the headers
+    // already in it keep their indices.
+    void load( const std::vector< AbcA::MetaData > & iMetaDataVec );
 private:
     std::map< std::string, Util::uint32_t > m_map;
+    bool m_extended;
+    bool m_usesExtendedIndices;
 };
 
 typedef Alembic::Util::shared_ptr<MetaDataMap> MetaDataMapPtr;
@@ -61,8 +61,15 @@ OrData::OrData( Ogawa::IGroupPtr iGroup,
     if ( numChildren > 0 && m_group->isChildData( numChildren - 1 ) )
     {
         std::vector< ObjectHeaderPtr > headers;
-        ReadObjectHeaders( m_group, numChildren - 1, iThreadId,
-                           iParentName, iIndexedMetaData, headers );
+        Util::uint64_t numBytes = ReadObjectHeaders( m_group,
+            numChildren - 1, iThreadId, iParentName, iIndexedMetaData,
+            headers );
+
+        ArImpl * ar = dynamic_cast< ArImpl * >( &iArchive );
+        if ( ar )
+        {
+            ar->countObjectHeaderBytes( numBytes );
+        }
 
         if ( !headers.empty() )
         {
@@ -164,7 +171,13 @@ OrData::getChild( AbcA::ObjectReaderPtr iParent, size_t i )
     Alembic::Util::scoped_lock l( m_children[i].lock );
     AbcA::ObjectReaderPtr optr = m_children[i].made.lock();
 
-    if ( ! optr )
+    if ( ! optr && m_children[i].data )
+    {
+        optr = Alembic::Util::shared_ptr<OrImpl>(
+            new OrImpl( iParent, m_children[i].data, m_children[i].header ) );
+        m_children[i].made = optr;
+    }
+    else if ( ! optr )
     {
         // Make a new one.
         optr = Alembic::Util::shared_ptr<OrImpl>(
@@ -175,6 +188,32 @@ OrData::getChild( AbcA::ObjectReaderPtr iParent, size_t i )
     return optr;
 }
 
+//-*****************************************************************************
+OrDataPtr
+OrData::preloadChild( size_t i,
+                      size_t iThreadId,
+                      AbcA::ArchiveReader & iArchive,
+                      const std::vector< AbcA::MetaData > & iIndexedMetaData )
+{
+    ABCA_ASSERT( i < m_childrenMap.size(),
+        "Out of range index in OrData::preloadChild: " << i );
+
+    Ogawa::IGroupPtr group = m_group->getGroup( i + 1, false, iThreadId );
+    OrDataPtr data( new OrData( group, m_children[i].header->getFullName(),
+                                iThreadId, iArchive, iIndexedMetaData ) );
+
+    Alembic::Util::scoped_lock l( m_children[i].lock );
+    m_children[i].data = data;
+    return data;
+}
+
+//-*****************************************************************************
+CprDataPtr OrData::getPropertyData()
+{
+    return m_data;
+}
+
+//-*****************************************************************************
 void OrData::getPropertiesHash( Util::Digest & oDigest, size_t iThreadId )
 {
     std::size_t numChildren = m_group->getNumChildren();
@@ -80,6 +80,17 @@ public:
 
     void getChildrenHash( Util::Digest & oDigest, size_t iThreadId );
 
+    // reads the headers of child i and keeps them, so getChild doesn't
+    // need to read them again
+    Alembic::Util::shared_ptr< OrData >
+    preloadChild( size_t i,
+                  size_t iThreadId,
+                  AbcA::ArchiveReader & iArchive,
+                  const std::vector< AbcA::MetaData > & iIndexedMetaData );
+
+    // the data of our "top" property, may be NULL
+    Alembic::Util::shared_ptr< CprData > getPropertyData();
+
 private:
 
     Ogawa::IGroupPtr m_group;
@@ -88,6 +99,9 @@ private:
     {
         ObjectHeaderPtr header;
         WeakOrPtr made;
+
+        // set when the hierarchy is preloaded
+        Alembic::Util::shared_ptr< OrData > data;
         Alembic::Util::mutex lock;
     };
 
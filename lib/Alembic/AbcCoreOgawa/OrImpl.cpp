@@ -54,6 +54,7 @@ OrImpl::OrImpl( AbcA::ObjectReaderPtr iParent,
                 std::size_t iGroupIndex,
                 ObjectHeaderPtr iHeader )
     : m_header( iHeader )
+    , m_findParent( false )
 {
     m_parent = Alembic::Util::dynamic_pointer_cast< OrImpl,
         AbcA::ObjectReader > (iParent);
@@ -69,7 +70,28 @@ OrImpl::OrImpl( AbcA::ObjectReaderPtr iParent,
     std::size_t id = streamId->getID();
     Ogawa::IGroupPtr group = iParentGroup->getGroup( iGroupIndex, false, id );
     m_data.reset( new OrData( group, iHeader->getFullName(), id,
-        *m_archive, m_archive->getIndexedMetaData() ) );
+        *m_archive, m_archive->getSnapshot()->indexedMetaData ) );
+}
+
+//-*****************************************************************************
+// Reading as a child of a parent, which already has our data.
+OrImpl::OrImpl( AbcA::ObjectReaderPtr iParent,
+                OrDataPtr iData,
+                ObjectHeaderPtr iHeader )
+    : m_data( iData )
+    , m_header( iHeader )
+    , m_findParent( false )
+{
+    m_parent = Alembic::Util::dynamic_pointer_cast< OrImpl,
+        AbcA::ObjectReader > (iParent);
+
+    // Check validity of all inputs.
+    ABCA_ASSERT( m_parent, "Invalid parent in OrImpl(Object)" );
+    ABCA_ASSERT( m_data, "Invalid data in OrImpl(Object)" );
+    ABCA_ASSERT( m_header, "Invalid header in OrImpl(Object)" );
+
+    m_archive = m_parent->getArchiveImpl();
+    ABCA_ASSERT( m_archive, "Invalid archive in OrImpl(Object)" );
 }
 
 //-*****************************************************************************
@@ -79,6 +101,7 @@ OrImpl::OrImpl( Alembic::Util::shared_ptr< ArImpl > iArchive,
     : m_archive( iArchive )
     , m_data( iData )
     , m_header( iHeader )
+    , m_findParent( false )
 {
 
     ABCA_ASSERT( m_archive, "Invalid archive in OrImpl(Archive)" );
@@ -86,6 +109,23 @@ OrImpl::OrImpl( Alembic::Util::shared_ptr< ArImpl > iArchive,
     ABCA_ASSERT( m_header, "Invalid header in OrImpl(Archive)" );
 }
 
+//-*****************************************************************************
+OrImpl::OrImpl( Alembic::Util::shared_ptr< ArImpl > iArchive,
+                Ogawa::IGroupPtr iGroup,
+                ObjectHeaderPtr iHeader )
+    : m_archive( iArchive )
+    , m_header( iHeader )
+    , m_findParent( true )
+{
+    ABCA_ASSERT( m_archive, "Invalid archive in OrImpl(Found)" );
+    ABCA_ASSERT( m_header, "Invalid header in OrImpl(Found)" );
+
+    StreamIDPtr streamId = m_archive->getStreamID();
+    std::size_t id = streamId->getID();
+    m_data.reset( new OrData( iGroup, iHeader->getFullName(), id,
+        *m_archive, m_archive->getSnapshot()->indexedMetaData ) );
+}
+
 //-*****************************************************************************
 OrImpl::~OrImpl()
 {
@@ -107,6 +147,30 @@ AbcA::ArchiveReaderPtr OrImpl::getArchive()
 //-*****************************************************************************
 AbcA::ObjectReaderPtr OrImpl::getParent()
 {
+    Alembic::Util::scoped_lock l( m_parentLock );
+
+    if ( m_findParent )
+    {
+        const std::string & fullName = m_header->getFullName();
+        std::size_t slash = fullName.rfind( '/' );
+
+        AbcA::ObjectReaderPtr parent;
+        if ( slash == 0 || slash == std::string::npos )
+        {
+            parent = m_archive->getTop();
+        }
+        else
+        {
+            parent = m_archive->findObject( fullName.substr( 0, slash ) );
+        }
+
+        m_parent = Alembic::Util::dynamic_pointer_cast< OrImpl,
+            AbcA::ObjectReader > ( parent );
+        ABCA_ASSERT( m_parent, "Could not find the parent of: " << fullName );
+
+        m_findParent = false;
+    }
+
     return m_parent;
 }
 
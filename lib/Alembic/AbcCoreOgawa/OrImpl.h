@@ -62,6 +62,17 @@ public:
             std::size_t iIndex,
             ObjectHeaderPtr iHeader );
 
+    // Reading a child whose data was preloaded.
+    OrImpl( AbcA::ObjectReaderPtr iParent,
+            OrDataPtr iData,
+            ObjectHeaderPtr iHeader );
+
+    // Reading an object found without its parent, the parent is found
+    // when it is asked for.
+    OrImpl( Alembic::Util::shared_ptr< ArImpl > iArchive,
+            Ogawa::IGroupPtr iGroup,
+            ObjectHeaderPtr iHeader );
+
     virtual ~OrImpl();
 
     //-*************************************************************************
@@ -105,6 +116,10 @@ private:
 
     ObjectHeaderPtr m_header;
 
+    // whether m_parent still needs to be found
+    bool m_findParent;
+    Alembic::Util::mutex m_parentLock;
+
 };
 
 } // End namespace ALEMBIC_VERSION_NS
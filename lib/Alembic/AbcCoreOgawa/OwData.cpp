@@ -40,6 +40,8 @@
 #include <Alembic/AbcCoreOgawa/OwImpl.h>
 #include <Alembic/AbcCoreOgawa/AwImpl.h>
 #include <Alembic/AbcCoreOgawa/WriteUtil.h>
+#include <Alembic/AbcCoreOgawa/ReadUtil.h>
+#include <Alembic/AbcCoreOgawa/ArImpl.h>
 
 namespace Alembic {
 namespace AbcCoreOgawa {
@@ -55,6 +57,49 @@ OwData::OwData( Ogawa::OGroupPtr iGroup ) : m_group( iGroup )
         new CpwData( m_group->addGroup() ) );
 }
 
+//-*****************************************************************************
+OwData::OwData( Ogawa::OGroupPtr iGroup,
+                Ogawa::IGroupPtr iExisting,
+                const std::string & iFullName,
+                ArImpl & iArchive )
+    : m_group( iGroup )
+    , m_existing( iExisting )
+{
+    ABCA_ASSERT( m_group, "Invalid parent group" );
+    ABCA_ASSERT( m_existing, "Invalid existing group" );
+
+    // writing our headers means writing those of our properties, so they
+    // are reopened right away
+    Ogawa::IGroupPtr existingProps = m_existing->getGroup( 0, false, 0 );
+    ABCA_ASSERT( existingProps, "Invalid existing properties group" );
+    m_data = Alembic::Util::shared_ptr<CpwData>(
+        new CpwData( m_group->addGroup(), existingProps, iArchive ) );
+
+    std::size_t numChildren = m_existing->getNumChildren();
+    if ( numChildren > 1 && m_existing->isChildData( numChildren - 1 ) )
+    {
+        ReadObjectHeaders( m_existing, numChildren - 1, 0, iFullName,
+                           iArchive.getSnapshot()->indexedMetaData,
+                           m_childHeaders );
+    }
+
+    for ( size_t i = 0; i < m_childHeaders.size(); ++i )
+    {
+        m_group->addChild( m_existing, i + 1 );
+        m_existingChildren[ m_childHeaders[i]->getName() ] = i;
+
+        // children that aren't reopened are hashed by where they are in the
+        // file, which identifies them as well as hashing them would,
+        // without reading them
+        Util::uint64_t entry = m_existing->getChildEntry( i + 1, 0 );
+        Util::uint64_t hash0 = 0;
+        Util::uint64_t hash1 = 0;
+        Util::SpookyHash::Hash128( &entry, 8, &hash0, &hash1 );
+        m_hashes.push_back( hash0 );
+        m_hashes.push_back( hash1 );
+    }
+}
+
 //-*****************************************************************************
 OwData::~OwData()
 {
@@ -112,16 +157,40 @@ const AbcA::ObjectHeader * OwData::getChildHeader( const std::string &iName )
 }
 
 //-*****************************************************************************
-AbcA::ObjectWriterPtr OwData::getChild( const std::string &iName )
+AbcA::ObjectWriterPtr OwData::getChild( AbcA::ObjectWriterPtr iParent,
+                                        const std::string &iName )
 {
     MadeChildren::iterator fiter = m_madeChildren.find( iName );
-    if ( fiter == m_madeChildren.end() )
+    if ( fiter != m_madeChildren.end() )
+    {
+        WeakOwPtr wptr = (*fiter).second;
+        return wptr.lock();
+    }
+
+    std::map< std::string, size_t >::iterator eiter =
+        m_existingChildren.find( iName );
+    if ( eiter == m_existingChildren.end() )
     {
         return AbcA::ObjectWriterPtr();
     }
 
-    WeakOwPtr wptr = (*fiter).second;
-    return wptr.lock();
+    // reopen the child so that it can be added to
+    AwImpl * aw = dynamic_cast< AwImpl * >( iParent->getArchive().get() );
+    ABCA_ASSERT( aw && aw->getExisting(), "Invalid archive" );
+
+    size_t index = eiter->second;
+    ObjectHeaderPtr header = m_childHeaders[index];
+
+    OwDataPtr data( new OwData( m_group->replaceWithNewGroup( index + 1 ),
+                                m_existing->getGroup( index + 1, false, 0 ),
+                                header->getFullName(),
+                                *( aw->getExisting() ) ) );
+
+    Alembic::Util::shared_ptr<OwImpl> ret( new OwImpl( iParent, data,
+                                                       header, index ) );
+    m_madeChildren[iName] = WeakOwPtr( ret );
+
+    return ret;
 }
 
 //-*****************************************************************************
@@ -131,7 +200,7 @@ AbcA::ObjectWriterPtr OwData::createChild( AbcA::ObjectWriterPtr iParent,
 {
     std::string name = iHeader.getName();
 
-    if ( m_madeChildren.count( name ) )
+    if ( m_madeChildren.count( name ) || m_existingChildren.count( name ) )
     {
         ABCA_THROW( "Already have an Object named: "
                      << name );
@@ -177,11 +246,57 @@ void OwData::writeHeaders( MetaDataMapPtr iMetaDataMap,
                            Util::SpookyHash & ioHash )
 {
     std::vector< Util::uint8_t > data;
+    packHeaders( iMetaDataMap, ioHash, data );
 
+    if ( !data.empty() )
+    {
+        m_group->addData( data.size(), &( data.front() ) );
+    }
+
+    m_data->writePropertyHeaders( iMetaDataMap );
+}
+
+//-*****************************************************************************
+void OwData::writeSnapshot( MetaDataMapPtr iMetaDataMap,
+                            Ogawa::SnapshotExtras & oExtras,
+                            std::vector< AbcA::index_t > & ioMaxSamples )
+{
+    m_data->writeSnapshot( iMetaDataMap, oExtras, ioMaxSamples );
+
+    for ( MadeChildren::iterator it = m_madeChildren.begin();
+          it != m_madeChildren.end(); ++it )
+    {
+        AbcA::ObjectWriterPtr child = it->second.lock();
+        if ( child )
+        {
+            Alembic::Util::dynamic_pointer_cast< OwImpl,
+                AbcA::ObjectWriter >( child )->writeSnapshot(
+                    iMetaDataMap, oExtras, ioMaxSamples );
+        }
+    }
+
+    // the hashes of the children that are still being written aren't
+    // known yet, so they are left as 0
+    std::vector< Util::uint8_t > data;
+    Util::SpookyHash hash;
+    packHeaders( iMetaDataMap, hash, data );
+
+    if ( !data.empty() )
+    {
+        oExtras[m_group.get()].push_back(
+            m_group->createData( data.size(), &( data.front() ) ) );
+    }
+}
+
+//-*****************************************************************************
+void OwData::packHeaders( MetaDataMapPtr iMetaDataMap,
+                          Util::SpookyHash & ioHash,
+                          std::vector< Util::uint8_t > & oData )
+{
     // pack all object header into data here
     for ( size_t i = 0; i < m_childHeaders.size(); ++i )
     {
-        WriteObjectHeader( data, *m_childHeaders[i], iMetaDataMap );
+        WriteObjectHeader( oData, *m_childHeaders[i], iMetaDataMap );
     }
 
     Util::SpookyHash dataHash;
@@ -208,21 +323,22 @@ void OwData::writeHeaders( MetaDataMapPtr iMetaDataMap,
     Util::uint8_t * hashData = ( Util::uint8_t * ) hashes;
     for ( size_t i = 0; i < 32; ++i )
     {
-        data.push_back( hashData[i] );
+        oData.push_back( hashData[i] );
     }
 
     // now update childHash with dataHash
     // SpookyHash has the nice property that Final doesn't invalidate the hash
     ioHash.Update( hashes, 16 );
+}
 
-    if ( !data.empty() )
-    {
-        m_group->addData( data.size(), &( data.front() ) );
-    }
-
-    m_data->writePropertyHeaders( iMetaDataMap );
+//-*****************************************************************************
+Util::uint64_t OwData::freezeGroup()
+{
+    m_group->freeze();
+    return m_group->getPos();
 }
 
+//-*****************************************************************************
 void OwData::fillHash( std::size_t iIndex, Util::uint64_t iHash0,
                        Util::uint64_t iHash1 )
 {
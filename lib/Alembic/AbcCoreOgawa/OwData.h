@@ -47,6 +47,7 @@ namespace ALEMBIC_VERSION_NS {
 //-*****************************************************************************
 // Forwards
 class CpwData;
+class ArImpl;
 
 // data class owned by OwImpl, or AwImpl if it is a "top" object.
 // it owns and makes child properties
@@ -55,6 +56,14 @@ class OwData : public Alembic::Util::enable_shared_from_this<OwData>
 public:
     OwData( Ogawa::OGroupPtr iGroup );
 
+    // for appending, continues the object iArchive has in iExisting, whose
+    // full name is iFullName ("" for the top object).  Its children and
+    // properties are referenced as they are, until they are reopened.
+    OwData( Ogawa::OGroupPtr iGroup,
+            Ogawa::IGroupPtr iExisting,
+            const std::string & iFullName,
+            ArImpl & iArchive );
+
     ~OwData();
 
     AbcA::CompoundPropertyWriterPtr getProperties(
@@ -67,7 +76,10 @@ public:
     const AbcA::ObjectHeader *
     getChildHeader( const std::string &iName );
 
-    AbcA::ObjectWriterPtr getChild( const std::string &iName );
+    // iParent is the object we belong to, children that were already in
+    // the archive being appended to are reopened as its children
+    AbcA::ObjectWriterPtr getChild( AbcA::ObjectWriterPtr iParent,
+                                    const std::string &iName );
 
     AbcA::ObjectWriterPtr createChild( AbcA::ObjectWriterPtr iParent,
                                        const std::string & iFullName,
@@ -77,11 +89,28 @@ public:
 
     void writeHeaders( MetaDataMapPtr iMetaDataMap, Util::SpookyHash & ioHash );
 
+    // Adds the child headers, as they would be written if we were closed
+    // now, to oExtras for AwImpl::commit, along with what our properties
+    // and the children that are still being written need.  ioMaxSamples
+    // is updated with the number of samples of the properties that are
+    // still being written.
+    void writeSnapshot( MetaDataMapPtr iMetaDataMap,
+                        Ogawa::SnapshotExtras & oExtras,
+                        std::vector< AbcA::index_t > & ioMaxSamples );
+
+    // writes out the group now, instead of when we are destroyed, and
+    // returns where it was written
+    Util::uint64_t freezeGroup();
+
     void fillHash( std::size_t iIndex, Util::uint64_t iHash0,
                    Util::uint64_t iHash1 );
 
 private:
 
+    // packs the child headers and hashes that go at the end of our group
+    void packHeaders( MetaDataMapPtr iMetaDataMap, Util::SpookyHash & ioHash,
+                      std::vector< Util::uint8_t > & oData );
+
     // The group corresponding to the object
     Ogawa::OGroupPtr m_group;
 
@@ -99,6 +128,11 @@ private:
 
     // child hashes
     std::vector< Util::uint64_t > m_hashes;
+
+    // when appending, our group in the existing archive and the index of
+    // each of the children that were already in it
+    Ogawa::IGroupPtr m_existing;
+    std::map< std::string, size_t > m_existingChildren;
 };
 
 typedef Alembic::Util::shared_ptr<OwData> OwDataPtr;
@@ -73,19 +73,50 @@ OwImpl::OwImpl( AbcA::ObjectWriterPtr iParent,
     m_data.reset( new OwData( iGroup ) );
 }
 
+//-*****************************************************************************
+OwImpl::OwImpl( AbcA::ObjectWriterPtr iParent,
+                OwDataPtr iData,
+                ObjectHeaderPtr iHeader,
+                size_t iIndex )
+  : m_parent( iParent )
+  , m_header( iHeader )
+  , m_data( iData )
+  , m_index( iIndex )
+{
+    ABCA_ASSERT( m_parent, "Invalid parent" );
+    ABCA_ASSERT( m_header, "Invalid header" );
+    ABCA_ASSERT( m_data, "Invalid data" );
+
+    m_archive = m_parent->getArchive();
+    ABCA_ASSERT( m_archive, "Invalid archive" );
+}
+
 //-*****************************************************************************
 OwImpl::~OwImpl()
 {
     // The archive is responsible for writing the MetaData
     if ( m_parent )
     {
-        MetaDataMapPtr mdMap = Alembic::Util::dynamic_pointer_cast<
-            AwImpl, AbcA::ArchiveWriter >( m_archive )->getMetaDataMap();
+        Util::shared_ptr< AwImpl > aw = Alembic::Util::dynamic_pointer_cast<
+            AwImpl, AbcA::ArchiveWriter >( m_archive );
+
+        // make sure samples written by other threads are done before we
+        // write our headers
+        aw->waitForWritesNoThrow();
+
+        MetaDataMapPtr mdMap = aw->getMetaDataMap();
 
         Util::SpookyHash hash;
         hash.Init(0, 0);
         m_data->writeHeaders( mdMap, hash );
 
+        // nothing else gets added to our group, so write it out now to find
+        // out where it is
+        if ( aw->writesPathIndex() )
+        {
+            aw->addToPathIndex( *m_header, m_data->freezeGroup() );
+        }
+
         // writeHeaders bakes in the child hashes and the data hash
         // but we still need to bake in the name and MetaData
         std::string metaDataStr = m_header->getMetaData().serialize();
@@ -150,7 +181,7 @@ const AbcA::ObjectHeader * OwImpl::getChildHeader( const std::string &iName )
 //-*****************************************************************************
 AbcA::ObjectWriterPtr OwImpl::getChild( const std::string &iName )
 {
-    return m_data->getChild( iName );
+    return m_data->getChild( asObjectPtr(), iName );
 }
 
 //-*****************************************************************************
@@ -172,6 +203,14 @@ void OwImpl::fillHash( size_t iIndex, Util::uint64_t iHash0,
     m_data->fillHash( iIndex, iHash0, iHash1 );
 }
 
+//-*****************************************************************************
+void OwImpl::writeSnapshot( MetaDataMapPtr iMetaDataMap,
+                            Ogawa::SnapshotExtras & oExtras,
+                            std::vector< AbcA::index_t > & ioMaxSamples )
+{
+    m_data->writeSnapshot( iMetaDataMap, oExtras, ioMaxSamples );
+}
+
 } // End namespace ALEMBIC_VERSION_NS
 } // End namespace AbcCoreOgawa
 } // End namespace Alembic
@@ -61,6 +61,13 @@ public:
             ObjectHeaderPtr iHeader,
             size_t iIndex );
 
+    // for an object that was already in the archive being appended to,
+    // iData is what it has so far
+    OwImpl( AbcA::ObjectWriterPtr iParent,
+            OwDataPtr iData,
+            ObjectHeaderPtr iHeader,
+            size_t iIndex );
+
     virtual ~OwImpl();
 
     //-*************************************************************************
@@ -92,6 +99,11 @@ public:
     void fillHash( size_t iIndex, Util::uint64_t iHash0,
                    Util::uint64_t iHash1 );
 
+    // see OwData::writeSnapshot
+    void writeSnapshot( MetaDataMapPtr iMetaDataMap,
+                        Ogawa::SnapshotExtras & oExtras,
+                        std::vector< AbcA::index_t > & ioMaxSamples );
+
 private:
     // The parent object, NULL if it is the "top" object
     AbcA::ObjectWriterPtr m_parent;
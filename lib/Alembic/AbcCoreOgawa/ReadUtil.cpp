@@ -35,6 +35,7 @@
 //-*****************************************************************************
 
 #include <Alembic/AbcCoreOgawa/ReadUtil.h>
+#include <Alembic/AbcCoreOgawa/CompressUtil.h>
 
 #if defined(_MSC_VER)
 #  if defined(max)
@@ -57,12 +58,18 @@ ReadDimensions( Ogawa::IDataPtr iDims,
                 Ogawa::IDataPtr iData,
                 size_t iThreadId,
                 const AbcA::DataType &iDataType,
+                bool iCompressed,
                 Util::Dimensions & oDim )
 {
     // find it based on of the size of the data
     if ( iDims->getSize() == 0 )
     {
-        if ( iData->getSize() == 0 )
+        if ( iCompressed )
+        {
+            oDim = Util::Dimensions( ReadUncompressedSize( iData, iThreadId ) /
+                                     iDataType.getNumBytes() );
+        }
+        else if ( iData->getSize() == 0 )
         {
             oDim = Util::Dimensions( 0 );
         }
@@ -1302,13 +1309,37 @@ ConvertData( Alembic::Util::PlainOldDataType fromPod,
     }
 }
 
+//-*****************************************************************************
+// reads iSize bytes of the data after the key, either directly or from the
+// already decompressed data
+static void ReadAfterKey( Ogawa::IDataPtr iData,
+                          size_t iThreadId,
+                          const std::vector< char > & iDecompressed,
+                          bool iCompressed,
+                          std::size_t iSize,
+                          void * oData )
+{
+    if ( iCompressed )
+    {
+        if ( iSize > 0 )
+        {
+            memcpy( oData, &iDecompressed.front(), iSize );
+        }
+    }
+    else
+    {
+        iData->read( iSize, oData, 16, iThreadId );
+    }
+}
+
 //-*****************************************************************************
 void
 ReadData( void * iIntoLocation,
           Ogawa::IDataPtr iData,
           size_t iThreadId,
           const AbcA::DataType &iDataType,
-          Util::PlainOldDataType iAsPod )
+          Util::PlainOldDataType iAsPod,
+          bool iCompressed )
 {
     Alembic::Util::PlainOldDataType curPod = iDataType.getPod();
     ABCA_ASSERT( ( iAsPod == curPod ) || (
@@ -1327,9 +1358,34 @@ ReadData( void * iIntoLocation,
         return;
     }
 
+    // the size of the data after the key
+    std::size_t numBytes = dataSize - 16;
+
+    // compressed data gets uncompressed up front, directly into
+    // iIntoLocation if we can
+    std::vector< char > decompressed;
+    if ( iCompressed )
+    {
+        numBytes = ReadUncompressedSize( iData, iThreadId );
+
+        if ( iAsPod == curPod &&
+             curPod != Alembic::Util::kStringPOD &&
+             curPod != Alembic::Util::kWstringPOD )
+        {
+            DecompressData( iData, iThreadId, iIntoLocation );
+            return;
+        }
+
+        decompressed.resize( numBytes );
+        if ( numBytes > 0 )
+        {
+            DecompressData( iData, iThreadId, &decompressed.front() );
+        }
+    }
+
     if ( curPod == Alembic::Util::kStringPOD )
     {
-        if ( dataSize <= 16 )
+        if ( numBytes == 0 )
         {
             return;
         }
@@ -1337,9 +1393,10 @@ ReadData( void * iIntoLocation,
         std::string * strPtr =
             reinterpret_cast< std::string * > ( iIntoLocation );
 
-        std::size_t numChars = dataSize - 16;
+        std::size_t numChars = numBytes;
         char * buf = new char[ numChars ];
-        iData->read( numChars, buf, 16, iThreadId );
+        ReadAfterKey( iData, iThreadId, decompressed, iCompressed, numChars,
+                      buf );
 
         std::size_t startStr = 0;
         std::size_t strPos = 0;
@@ -1358,7 +1415,7 @@ ReadData( void * iIntoLocation,
     }
     else if ( curPod == Alembic::Util::kWstringPOD )
     {
-        if ( dataSize <= 16 )
+        if ( numBytes == 0 )
         {
             return;
         }
@@ -1366,9 +1423,10 @@ ReadData( void * iIntoLocation,
         std::wstring * wstrPtr =
             reinterpret_cast< std::wstring * > ( iIntoLocation );
 
-        std::size_t numChars = ( dataSize - 16 ) / 4;
+        std::size_t numChars = numBytes / 4;
         Util::uint32_t * buf = new Util::uint32_t[ numChars ];
-        iData->read( dataSize - 16, buf, 16, iThreadId );
+        ReadAfterKey( iData, iThreadId, decompressed, iCompressed, numBytes,
+                      buf );
 
         std::size_t strPos = 0;
 
@@ -1392,13 +1450,12 @@ ReadData( void * iIntoLocation,
     else if ( iAsPod == curPod )
     {
         // don't read the key
-        iData->read( dataSize - 16, iIntoLocation, 16, iThreadId );
+        iData->read( numBytes, iIntoLocation, 16, iThreadId );
     }
     else if ( PODNumBytes( curPod ) <= PODNumBytes( iAsPod ) )
     {
-        // - 16 to skip key
-        std::size_t numBytes = dataSize - 16;
-        iData->read( numBytes, iIntoLocation, 16, iThreadId );
+        ReadAfterKey( iData, iThreadId, decompressed, iCompressed, numBytes,
+                      iIntoLocation );
 
         char * buf = static_cast< char * >( iIntoLocation );
         ConvertData( curPod, iAsPod, buf, iIntoLocation, numBytes );
@@ -1406,12 +1463,10 @@ ReadData( void * iIntoLocation,
     }
     else if ( PODNumBytes( curPod ) > PODNumBytes( iAsPod ) )
     {
-        // - 16 to skip key
-        std::size_t numBytes = dataSize - 16;
-
         // read into a temporary buffer and cast them one at a time
         char * buf = new char[ numBytes ];
-        iData->read( numBytes, buf, 16, iThreadId );
+        ReadAfterKey( iData, iThreadId, decompressed, iCompressed, numBytes,
+                      buf );
 
         ConvertData( curPod, iAsPod, buf, iIntoLocation, numBytes );
 
@@ -1420,22 +1475,62 @@ ReadData( void * iIntoLocation,
 
 }
 
+//-*****************************************************************************
+// Owns an ArraySample which references memory mapped data, the data is kept
+// alive by holding onto the IData until the sample goes away.
+class MappedArraySampleDeleter
+{
+public:
+    MappedArraySampleDeleter( Ogawa::IDataPtr iData ) : m_data( iData ) {}
+
+    void operator()( AbcA::ArraySample * iSample ) const
+    {
+        delete iSample;
+    }
+
+private:
+    Ogawa::IDataPtr m_data;
+};
+
 //-*****************************************************************************
 void
 ReadArraySample( Ogawa::IDataPtr iDims,
                  Ogawa::IDataPtr iData,
                  size_t iThreadId,
                  const AbcA::DataType &iDataType,
+                 bool iCompressed,
                  AbcA::ArraySamplePtr &oSample )
 {
     // get our dimensions
     Util::Dimensions dims;
-    ReadDimensions( iDims, iData, iThreadId, iDataType, dims );
+    ReadDimensions( iDims, iData, iThreadId, iDataType, iCompressed, dims );
+
+    // if the archive is memory mapped we may be able to reference the data
+    // directly instead of allocating and copying it
+    Alembic::Util::PlainOldDataType pod = iDataType.getPod();
+    std::size_t numBytes = dims.numPoints() * iDataType.getNumBytes();
+    if ( !iCompressed &&
+         pod != Alembic::Util::kStringPOD &&
+         pod != Alembic::Util::kWstringPOD &&
+         numBytes > 0 && iData->getSize() == numBytes + 16 )
+    {
+        // skip the key
+        const void * mapped = iData->getMappedData( numBytes, 16 );
+
+        if ( mapped != NULL &&
+             ( ( std::size_t ) mapped ) % PODNumBytes( pod ) == 0 )
+        {
+            oSample = AbcA::ArraySamplePtr(
+                new AbcA::ArraySample( mapped, iDataType, dims ),
+                MappedArraySampleDeleter( iData ) );
+            return;
+        }
+    }
 
     oSample = AbcA::AllocateArraySample( iDataType, dims );
 
     ReadData( const_cast<void*>( oSample->getData() ), iData,
-        iThreadId, iDataType, iDataType.getPod() );
+        iThreadId, iDataType, iDataType.getPod(), iCompressed );
 
 }
 
@@ -1483,7 +1578,7 @@ ReadTimeSamplesAndMax( Ogawa::IDataPtr iData,
 }
 
 //-*****************************************************************************
-void
+Util::uint64_t
 ReadObjectHeaders( Ogawa::IGroupPtr iGroup,
                    size_t iIndex,
                    size_t iThreadId,
@@ -1496,7 +1591,7 @@ ReadObjectHeaders( Ogawa::IGroupPtr iGroup,
 
     if ( data->getSize() <= 32 )
     {
-        return;
+        return 0;
     }
 
     // skip the last 32 bytes which contains the hashes
@@ -1505,35 +1600,99 @@ ReadObjectHeaders( Ogawa::IGroupPtr iGroup,
     std::size_t pos = 0;
     while ( pos < buf.size() )
     {
-        Util::uint32_t nameSize = *( (Util::uint32_t *)( &buf[pos] ) );
-        pos += 4;
-
-        std::string name( &buf[pos], nameSize );
-        pos += nameSize;
+        oHeaders.push_back( ReadObjectHeader( buf, pos, iParentName,
+                                              iMetaDataVec ) );
+    }
 
-        Util::uint8_t metaDataIndex = buf[pos++];
+    return buf.size();
+}
 
-        ObjectHeaderPtr objPtr( new AbcA::ObjectHeader() );
-        objPtr->setName( name );
-        objPtr->setFullName( iParentName + "/" + name );
+//-*****************************************************************************
+// reads the index of meta data past the first 254 in the meta data map, see
+// pushVarint in WriteUtil.cpp
+static Util::uint32_t GetVarint( const std::vector< char > & iBuf,
+                                 std::size_t & ioPos )
+{
+    Util::uint32_t retVal = 0;
+    for ( Util::uint32_t shift = 0; shift < 32; shift += 7 )
+    {
+        ABCA_ASSERT( ioPos < iBuf.size(),
+                     "Read invalid: Meta data index is too small." );
 
-        if ( metaDataIndex == 0xff )
+        Util::uint8_t byte = ( Util::uint8_t ) iBuf[ioPos++];
+        retVal |= ( Util::uint32_t )( byte & 0x7f ) << shift;
+        if ( ( byte & 0x80 ) == 0 )
         {
-            Util::uint32_t metaDataSize = *( (Util::uint32_t *)( &buf[pos] ) );
-            pos += 4;
+            return retVal;
+        }
+    }
 
-            std::string metaData( &buf[pos], metaDataSize );
-            pos += metaDataSize;
+    ABCA_THROW( "Read invalid: Meta data index is too big." );
+    return 0;
+}
 
-            objPtr->getMetaData().deserialize( metaData );
-        }
-        else
+//-*****************************************************************************
+ObjectHeaderPtr
+ReadObjectHeader( const std::vector< char > & iBuf,
+                  std::size_t & ioPos,
+                  const std::string & iParentName,
+                  const std::vector< AbcA::MetaData > & iMetaDataVec )
+{
+    ABCA_ASSERT( ioPos + 5 <= iBuf.size(),
+                 "Read invalid: Object header is too small." );
+
+    Util::uint32_t nameSize = *( (Util::uint32_t *)( &iBuf[ioPos] ) );
+    ioPos += 4;
+
+    ABCA_ASSERT( nameSize < iBuf.size() - ioPos,
+                 "Read invalid: Object header name is too big." );
+
+    std::string name( &iBuf[ioPos], nameSize );
+    ioPos += nameSize;
+
+    Util::uint8_t metaDataIndex = iBuf[ioPos++];
+
+    ObjectHeaderPtr objPtr( new AbcA::ObjectHeader() );
+    objPtr->setName( name );
+    objPtr->setFullName( iParentName + "/" + name );
+
+    if ( metaDataIndex == 0xff )
+    {
+        ABCA_ASSERT( ioPos + 4 <= iBuf.size(),
+                     "Read invalid: Object header is too small." );
+
+        Util::uint32_t metaDataSize =
+            *( (Util::uint32_t *)( &iBuf[ioPos] ) );
+        ioPos += 4;
+
+        // written meta data is never empty, so this is an index past 254
+        if ( metaDataSize == 0 )
         {
-            objPtr->getMetaData() = iMetaDataVec[metaDataIndex];
+            Util::uint32_t index = GetVarint( iBuf, ioPos );
+            ABCA_ASSERT( index < iMetaDataVec.size(),
+                         "Read invalid: Object header meta data index." );
+
+            objPtr->getMetaData() = iMetaDataVec[index];
+            return objPtr;
         }
 
-        oHeaders.push_back( objPtr );
+        ABCA_ASSERT( metaDataSize <= iBuf.size() - ioPos,
+                     "Read invalid: Object header meta data is too big." );
+
+        std::string metaData( &iBuf[ioPos], metaDataSize );
+        ioPos += metaDataSize;
+
+        objPtr->getMetaData().deserialize( metaData );
+    }
+    else
+    {
+        ABCA_ASSERT( metaDataIndex < iMetaDataVec.size(),
+                     "Read invalid: Object header meta data index." );
+
+        objPtr->getMetaData() = iMetaDataVec[metaDataIndex];
     }
+
+    return objPtr;
 }
 
 //-*****************************************************************************
@@ -1562,7 +1721,7 @@ Util::uint32_t GetUint32WithHint(const std::vector< char > & iBuf,
 }
 
 //-*****************************************************************************
-void
+Util::uint64_t
 ReadPropertyHeaders( Ogawa::IGroupPtr iGroup,
                      size_t iIndex,
                      size_t iThreadId,
@@ -1597,16 +1756,25 @@ ReadPropertyHeaders( Ogawa::IGroupPtr iGroup,
     // 0000 1111 1111 0000 0000 0000 0000 0000
     static const Util::uint32_t metaDataIndexMask = 0xff00000;
 
+    // 0001 0000 0000 0000 0000 0000 0000 0000
+    static const Util::uint32_t compressedMask = 0x10000000;
+
+    // 0010 0000 0000 0000 0000 0000 0000 0000
+    static const Util::uint32_t packedMask = 0x20000000;
+
     Ogawa::IDataPtr data = iGroup->getData( iIndex, iThreadId );
     ABCA_ASSERT( data, "ReadObjectHeaders Invalid data at index " << iIndex );
 
     if ( data->getSize() == 0 )
     {
-        return;
+        return 0;
     }
 
     std::vector< char > buf( data->getSize() );
     data->read( data->getSize(), &( buf.front() ), 0, iThreadId );
+
+    std::map< std::string, AbcA::MetaData > parsedMetaData;
+
     std::size_t pos = 0;
     while ( pos < buf.size() )
     {
@@ -1663,6 +1831,12 @@ ReadPropertyHeaders( Ogawa::IGroupPtr iGroup,
 
             header->isHomogenous = ( info & homogenousMask ) != 0;
 
+            header->isCompressed = ( info & compressedMask ) != 0 &&
+                header->header.isArray();
+
+            header->isPacked = ( info & packedMask ) != 0 &&
+                header->header.isScalar();
+
             header->nextSampleIndex = GetUint32WithHint( buf, sizeHint, pos );
 
             if ( ( info & needsFirstLastMask ) != 0 )
@@ -1711,21 +1885,46 @@ ReadPropertyHeaders( Ogawa::IGroupPtr iGroup,
             Util::uint32_t metaDataSize =
                 GetUint32WithHint( buf, sizeHint, pos );
 
-            std::string metaData( &buf[pos], metaDataSize );
-            pos += metaDataSize;
+            // written meta data is never empty, so this is an index past 254
+            if ( metaDataSize == 0 )
+            {
+                metaDataIndex = GetVarint( buf, pos );
+                ABCA_ASSERT( metaDataIndex < iMetaDataVec.size(),
+                    "Read invalid: Property header meta data index." );
+
+                header->header.setMetaData( iMetaDataVec[metaDataIndex] );
+            }
+            else
+            {
+                std::string metaData( &buf[pos], metaDataSize );
+                pos += metaDataSize;
 
-            AbcA::MetaData md;
-            md.deserialize( metaData );
-            header->header.setMetaData( md );
+                // siblings often share meta data too long for the map,
+                // only parse it once
+                std::map< std::string, AbcA::MetaData >::iterator it =
+                    parsedMetaData.find( metaData );
+                if ( it == parsedMetaData.end() )
+                {
+                    it = parsedMetaData.insert( std::make_pair( metaData,
+                        AbcA::MetaData() ) ).first;
+                    it->second.deserialize( metaData );
+                }
+                header->header.setMetaData( it->second );
+            }
         }
         else
         {
+            ABCA_ASSERT( metaDataIndex < iMetaDataVec.size(),
+                "Read invalid: Property header meta data index." );
+
             header->header.setMetaData( iMetaDataVec[metaDataIndex] );
         }
 
         oHeaders.push_back( header );
 
     }
+
+    return buf.size();
 }
 
 void
@@ -49,11 +49,13 @@ namespace ALEMBIC_VERSION_NS {
 //-*****************************************************************************
 
 //-*****************************************************************************
+// iCompressed is whether iData holds a compressed array sample
 void
 ReadDimensions( Ogawa::IDataPtr iDims,
                 Ogawa::IDataPtr iData,
                 size_t iThreadId,
                 const AbcA::DataType &iDataType,
+                bool iCompressed,
                 Util::Dimensions & oDim );
 
 //-*****************************************************************************
@@ -62,7 +64,8 @@ ReadData( void * iIntoLocation,
           Ogawa::IDataPtr iData,
           size_t iThreadId,
           const AbcA::DataType &iDataType,
-          Util::PlainOldDataType iAsPod );
+          Util::PlainOldDataType iAsPod,
+          bool iCompressed );
 
 //-*****************************************************************************
 void
@@ -70,6 +73,7 @@ ReadArraySample( Ogawa::IDataPtr iDims,
                  Ogawa::IDataPtr iData,
                  size_t iThreadId,
                  const AbcA::DataType &iDataType,
+                 bool iCompressed,
                  AbcA::ArraySamplePtr &oSample );
 
 //-*****************************************************************************
@@ -79,7 +83,8 @@ ReadTimeSamplesAndMax( Ogawa::IDataPtr iData,
                        std::vector <  AbcA::index_t > & oMaxSamples );
 
 //-*****************************************************************************
-void
+// returns how many bytes were read
+Util::uint64_t
 ReadObjectHeaders( Ogawa::IGroupPtr iGroup,
                    size_t iIndex,
                    size_t iThreadId,
@@ -88,7 +93,17 @@ ReadObjectHeaders( Ogawa::IGroupPtr iGroup,
                    std::vector< ObjectHeaderPtr > & oHeaders );
 
 //-*****************************************************************************
-void
+// reads one object header, as packed by WriteObjectHeader, from iBuf at
+// ioPos and moves ioPos past it
+ObjectHeaderPtr
+ReadObjectHeader( const std::vector< char > & iBuf,
+                  std::size_t & ioPos,
+                  const std::string & iParentName,
+                  const std::vector< AbcA::MetaData > & iMetaDataVec );
+
+//-*****************************************************************************
+// returns how many bytes were read
+Util::uint64_t
 ReadPropertyHeaders( Ogawa::IGroupPtr iGroup,
                      size_t iIndex,
                      size_t iThreadId,
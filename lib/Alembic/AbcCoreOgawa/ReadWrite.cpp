@@ -38,6 +38,8 @@
 #include <Alembic/AbcCoreOgawa/Foundation.h>
 #include <Alembic/AbcCoreOgawa/AwImpl.h>
 #include <Alembic/AbcCoreOgawa/ArImpl.h>
+#include <Alembic/AbcCoreOgawa/CacheImpl.h>
+#include <Alembic/AbcCoreOgawa/CompressUtil.h>
 
 namespace Alembic {
 namespace AbcCoreOgawa {
@@ -46,6 +48,64 @@ namespace ALEMBIC_VERSION_NS {
 //-*****************************************************************************
 WriteArchive::WriteArchive()
 {
+    m_bufferSize = 0;
+    m_codec = kZlibCompression;
+    m_numThreads = 0;
+    m_hashID = AbcA::kMurmur3SampleHash;
+    m_writePathIndex = false;
+    m_extendedMetaDataMap = false;
+    m_packScalarSamples = false;
+}
+
+//-*****************************************************************************
+WriteArchive::WriteArchive( size_t iBufferSize )
+{
+    m_bufferSize = iBufferSize;
+    m_codec = kZlibCompression;
+    m_numThreads = 0;
+    m_hashID = AbcA::kMurmur3SampleHash;
+    m_writePathIndex = false;
+    m_extendedMetaDataMap = false;
+    m_packScalarSamples = false;
+}
+
+//-*****************************************************************************
+WriteArchive::WriteArchive( size_t iBufferSize, CompressionCodec iCodec )
+{
+    m_bufferSize = iBufferSize;
+    m_codec = iCodec;
+    m_numThreads = 0;
+    m_hashID = AbcA::kMurmur3SampleHash;
+    m_writePathIndex = false;
+    m_extendedMetaDataMap = false;
+    m_packScalarSamples = false;
+}
+
+//-*****************************************************************************
+WriteArchive::WriteArchive( size_t iBufferSize, CompressionCodec iCodec,
+                            size_t iNumThreads, AbcA::SampleHashID iHashID,
+                            bool iWritePathIndex,
+                            bool iExtendedMetaDataMap,
+                            bool iPackScalarSamples )
+{
+    m_bufferSize = iBufferSize;
+    m_codec = iCodec;
+    m_numThreads = iNumThreads;
+    m_hashID = iHashID;
+    m_writePathIndex = iWritePathIndex;
+    m_extendedMetaDataMap = iExtendedMetaDataMap;
+    m_packScalarSamples = iPackScalarSamples;
+}
+
+//-*****************************************************************************
+static Util::uint8_t GetCodec( CompressionCodec iCodec )
+{
+    if ( iCodec == kLZ4Compression && IsCodecAvailable( kLZ4Codec ) )
+    {
+        return kLZ4Codec;
+    }
+
+    return kZlibCodec;
 }
 
 //-*****************************************************************************
@@ -54,7 +114,10 @@ WriteArchive::operator()( const std::string &iFileName,
                           const AbcA::MetaData &iMetaData ) const
 {
     Alembic::Util::shared_ptr<AwImpl> archivePtr(
-        new AwImpl( iFileName, iMetaData ) );
+        new AwImpl( iFileName, iMetaData, m_bufferSize,
+                    GetCodec( m_codec ), m_numThreads, m_hashID,
+                    m_writePathIndex, m_extendedMetaDataMap,
+                    m_packScalarSamples ) );
     return archivePtr;
 }
 
@@ -64,25 +127,83 @@ WriteArchive::operator()( std::ostream * iStream,
                           const AbcA::MetaData &iMetaData ) const
 {
     Alembic::Util::shared_ptr<AwImpl> archivePtr(
-        new AwImpl( iStream, iMetaData ) );
+        new AwImpl( iStream, iMetaData, m_bufferSize,
+                    GetCodec( m_codec ), m_numThreads, m_hashID,
+                    m_writePathIndex, m_extendedMetaDataMap,
+                    m_packScalarSamples ) );
+    return archivePtr;
+}
+
+//-*****************************************************************************
+AbcA::ArchiveWriterPtr
+WriteArchive::append( const std::string &iFileName ) const
+{
+    // what is already there is only read as it is reopened, so one stream
+    // is plenty
+    Alembic::Util::shared_ptr<ArImpl> existing =
+        Alembic::Util::dynamic_pointer_cast< ArImpl, AbcA::ArchiveReader >(
+            ReadArchive( 1, false )( iFileName ) );
+
+    Alembic::Util::shared_ptr<AwImpl> archivePtr(
+        new AwImpl( existing, m_bufferSize, GetCodec( m_codec ),
+                    m_numThreads, m_extendedMetaDataMap,
+                    m_packScalarSamples ) );
     return archivePtr;
 }
 
+//-*****************************************************************************
+AbcA::ReadArraySampleCachePtr
+CreateCache( size_t iMaxBytes )
+{
+    AbcA::ReadArraySampleCachePtr cachePtr( new CacheImpl( iMaxBytes ) );
+    return cachePtr;
+}
+
 //-*****************************************************************************
 ReadArchive::ReadArchive()
 {
     m_numStreams = 1;
+    m_useMMap = false;
+    m_preloadHierarchy = false;
 }
 
 //-*****************************************************************************
 ReadArchive::ReadArchive( size_t iNumStreams )
 {
     m_numStreams = iNumStreams;
+    m_useMMap = false;
+    m_preloadHierarchy = false;
+}
+
+//-*****************************************************************************
+ReadArchive::ReadArchive( size_t iNumStreams, bool iUseMMap )
+{
+    m_numStreams = iNumStreams;
+    m_useMMap = iUseMMap;
+    m_preloadHierarchy = false;
+}
+
+//-*****************************************************************************
+ReadArchive::ReadArchive( size_t iNumStreams, bool iUseMMap,
+                          bool iPreloadHierarchy )
+{
+    m_numStreams = iNumStreams;
+    m_useMMap = iUseMMap;
+    m_preloadHierarchy = iPreloadHierarchy;
 }
 
 //-*****************************************************************************
 ReadArchive::ReadArchive( const std::vector< std::istream * > & iStreams )
-    : m_numStreams( 1 ), m_streams( iStreams )
+    : m_numStreams( 1 ), m_useMMap( false ), m_preloadHierarchy( false )
+    , m_streams( iStreams )
+{
+}
+
+//-*****************************************************************************
+ReadArchive::ReadArchive( const std::vector< std::istream * > & iStreams,
+                          bool iPreloadHierarchy )
+    : m_numStreams( 1 ), m_useMMap( false )
+    , m_preloadHierarchy( iPreloadHierarchy ), m_streams( iStreams )
 {
 }
 
@@ -95,18 +216,18 @@ ReadArchive::operator()( const std::string &iFileName ) const
     if ( m_streams.empty() )
     {
         archivePtr = Alembic::Util::shared_ptr<ArImpl>(
-            new ArImpl( iFileName, m_numStreams ) );
+            new ArImpl( iFileName, m_numStreams, m_useMMap,
+                        m_preloadHierarchy ) );
     }
     else
     {
         archivePtr = Alembic::Util::shared_ptr<ArImpl>(
-            new ArImpl( m_streams ) );
+            new ArImpl( m_streams, m_preloadHierarchy ) );
     }
     return archivePtr;
 }
 
 //-*****************************************************************************
-// The given cache is ignored.
 AbcA::ArchiveReaderPtr
 ReadArchive::operator()( const std::string &iFileName,
             AbcA::ReadArraySampleCachePtr iCache ) const
@@ -116,13 +237,16 @@ ReadArchive::operator()( const std::string &iFileName,
     if ( m_streams.empty() )
     {
         archivePtr = Alembic::Util::shared_ptr<ArImpl> (
-            new ArImpl( iFileName, m_numStreams ) );
+            new ArImpl( iFileName, m_numStreams, m_useMMap,
+                        m_preloadHierarchy ) );
     }
     else
     {
         archivePtr = Alembic::Util::shared_ptr<ArImpl> (
-            new ArImpl( m_streams ) );
+            new ArImpl( m_streams, m_preloadHierarchy ) );
     }
+
+    archivePtr->setReadArraySampleCachePtr( iCache );
     return archivePtr;
 }
 
@@ -44,6 +44,22 @@ namespace Alembic {
 namespace AbcCoreOgawa {
 namespace ALEMBIC_VERSION_NS {
 
+//-*****************************************************************************
+//! Codecs used to compress the samples of array properties, array samples are
+//! only compressed when the archive has a compression hint of 0 or higher
+//! (see ArchiveWriter::setCompressionHint) when the first sample of the
+//! property is written.
+enum CompressionCodec
+{
+    //! zlib, the hint is used as the compression level.
+    kZlibCompression,
+
+    //! LZ4, much faster to compress and decompress but doesn't compress as
+    //! much, higher hints compress more.  If Alembic was built without LZ4
+    //! zlib is used instead.
+    kLZ4Compression
+};
+
 //-*****************************************************************************
 //! Will return a shared pointer to the archive writer
 class ALEMBIC_EXPORT WriteArchive
@@ -51,6 +67,53 @@ class ALEMBIC_EXPORT WriteArchive
 public:
     WriteArchive();
 
+    // Accumulate up to iBufferSize bytes in memory before writing them to
+    // the file or stream, instead of writing and flushing every piece of
+    // data as it is created.  0 disables the buffering.
+    explicit WriteArchive( size_t iBufferSize );
+
+    // Same as above, but also sets which codec is used to compress array
+    // samples, the default is kZlibCompression.
+    WriteArchive( size_t iBufferSize, CompressionCodec iCodec );
+
+    // Same as above, but if iNumThreads is greater than 0 setSample makes a
+    // copy of the sample and returns right away.  iNumThreads threads
+    // compute the keys of the copied samples, and one more thread writes
+    // them out in the order they were set, so the file is the same as if
+    // iNumThreads were 0.  Errors from writing a sample are thrown from a
+    // later setSample call.  Everything is written by the time the archive
+    // is destroyed.
+    //
+    // iHashID picks how the keys of written samples are computed, these
+    // keys are used to share identical samples and are what
+    // ArrayPropertyReader::getKey returns.  kChunkedSpookySampleHash is much
+    // faster on large samples, but gives different keys for the same data
+    // than kMurmur3SampleHash, which older archives use.
+    //
+    // If iWritePathIndex is true an index of the full names of every object
+    // is also written, so ArchiveReader::findObject can go straight to an
+    // object instead of reading the headers of all of its ancestors.
+    // Readers which don't know about the index ignore it.
+    //
+    // Only the first 254 distinct short meta data of objects and properties
+    // are shared, any others are written out in full with every header that
+    // uses them.  If iExtendedMetaDataMap is true the rest are shared too,
+    // but if there are more than 254 the archive can't be read by libraries
+    // older than this one.
+    //
+    // If iPackScalarSamples is true, scalar properties of everything but
+    // strings and wstrings write all of their samples one after another into
+    // a single block, which readers load with one read the first time a
+    // sample is asked for, instead of a small read per sample.  Archives
+    // with packed samples can't be read by libraries older than this one.
+    WriteArchive( size_t iBufferSize, CompressionCodec iCodec,
+                  size_t iNumThreads,
+                  ::Alembic::AbcCoreAbstract::SampleHashID iHashID =
+                      ::Alembic::AbcCoreAbstract::kMurmur3SampleHash,
+                  bool iWritePathIndex = false,
+                  bool iExtendedMetaDataMap = false,
+                  bool iPackScalarSamples = false );
+
     ::Alembic::AbcCoreAbstract::ArchiveWriterPtr
     operator()( const std::string &iFileName,
                 const ::Alembic::AbcCoreAbstract::MetaData &iMetaData ) const;
@@ -58,11 +121,113 @@ public:
     ::Alembic::AbcCoreAbstract::ArchiveWriterPtr
     operator()( std::ostream * iStream,
                 const ::Alembic::AbcCoreAbstract::MetaData &iMetaData ) const;
+
+    // Opens the existing Ogawa archive iFileName to add to it.  What is
+    // already in the file stays where it is, only the new samples, the
+    // tables and headers of what is added to, and the archive wide data
+    // are written after it, so the time this takes depends on how much is
+    // added, not on the size of the archive.  Until the returned archive
+    // is destroyed readers still see the archive as it was.
+    //
+    // The objects and properties of the archive are reopened by getChild
+    // and getProperty, new samples and children can be added to them, but
+    // existing samples, meta data and time samplings can't be changed.
+    // Everything is written with the settings given above, except that the
+    // archive keeps its sample hash, properties with compressed or packed
+    // samples keep them, and no path index is written.  The hashes of
+    // what was already there are based on where it is in the file, so
+    // they differ from those of the same content written in one go.
+    ::Alembic::AbcCoreAbstract::ArchiveWriterPtr
+    append( const std::string &iFileName ) const;
+
+private:
+    size_t m_bufferSize;
+    CompressionCodec m_codec;
+    size_t m_numThreads;
+    ::Alembic::AbcCoreAbstract::SampleHashID m_hashID;
+    bool m_writePathIndex;
+    bool m_extendedMetaDataMap;
+    bool m_packScalarSamples;
 };
 
+//-*****************************************************************************
+//! Writes iFileName as a sharded archive, which is read like any other
+//! archive, but whose samples are the samples of the finished archives
+//! iShards one after the other.  The shards can be written at the same
+//! time, by different processes, each writing the frames that come after
+//! the previous shard.  They need the same objects and properties in the
+//! same order, the same time samplings (acyclic ones are joined), and
+//! array samples compressed the same way.
+//!
+//! Only the hierarchy, the headers and references to the samples are
+//! written, so this is quick and the archive is small, except for packed
+//! scalar samples (see WriteArchive) which are copied.  The shards have to
+//! stay where they are, relative names in iShards are relative to the
+//! directory of iFileName.  Only readers that know about shards can read
+//! the archive, and it can't be appended to.
+ALEMBIC_EXPORT void
+WriteShardManifest( const std::string & iFileName,
+                    const std::vector< std::string > & iShards );
+
+//-*****************************************************************************
+//! Where RepackArchive puts the samples, after the headers of the objects and
+//! properties, which all go first.
+enum RepackLayout
+{
+    //! The samples of each frame together, in the order of the hierarchy,
+    //! for reading one frame at a time.
+    kFrameMajorLayout,
+
+    //! All of the samples of each property together, in the order of the
+    //! hierarchy, for reading whole objects.
+    kObjectMajorLayout,
+
+    //! The samples of the properties named in iHotProperties frame by
+    //! frame, followed by those of the rest frame by frame.
+    kHotPropertiesFirstLayout
+};
+
+//-*****************************************************************************
+//! How far apart what is read for one frame is, before and after repacking.
+//! The seek distances add up the bytes between the end of each read and the
+//! start of the next, reading the sample of every property at time in the
+//! order of the hierarchy.
+struct RepackFrameStats
+{
+    ::Alembic::AbcCoreAbstract::chrono_t time;
+    ::Alembic::Util::uint64_t numReads;
+    ::Alembic::Util::uint64_t numBytes;
+    ::Alembic::Util::uint64_t seekBefore;
+    ::Alembic::Util::uint64_t seekAfter;
+};
+
+//-*****************************************************************************
+//! Writes the finished Ogawa archive iFileName to iOutFileName with its data
+//! in the order given by iLayout, and the groups of the hierarchy after all
+//! of it.  Nothing else changes, samples that are shared stay shared, and
+//! the result reads exactly like the original.  If oReport is given it is
+//! filled in with the stats of each frame.  A sharded archive (see
+//! WriteShardManifest) is written out as a single file.
+ALEMBIC_EXPORT void
+RepackArchive( const std::string & iFileName,
+               const std::string & iOutFileName,
+               RepackLayout iLayout,
+               const std::vector< std::string > & iHotProperties =
+                   std::vector< std::string >(),
+               std::vector< RepackFrameStats > * oReport = NULL );
+
+//-*****************************************************************************
+//! AbcCoreOgawa provides a cache implementation, that we expose here.
+//! Array samples are looked up by the digest stored with them, so identical
+//! samples read from different properties, objects, or archives sharing the
+//! cache are only read once and share the same memory.  Once the cache holds
+//! more than iMaxBytes the least recently used samples are released.
+ALEMBIC_EXPORT ::Alembic::AbcCoreAbstract::ReadArraySampleCachePtr
+CreateCache( size_t iMaxBytes = 256 * 1024 * 1024 );
+
 //-*****************************************************************************
 //! Will return a shared pointer to the archive reader
-//! This version creates a cache associated with the archive.
+//! By default no array sample cache is used.
 class ALEMBIC_EXPORT ReadArchive
 {
 public:
@@ -71,16 +236,34 @@ public:
     // Open the file iNumStreams times and manage them internally
     ReadArchive( size_t iNumStreams );
 
+    // Open the file iNumStreams times and manage them internally, or if
+    // iUseMMap is true memory map the file instead (reads from the mapped
+    // file don't need to lock, so iNumStreams is ignored).  If the file can
+    // not be memory mapped iNumStreams file streams are used instead.
+    ReadArchive( size_t iNumStreams, bool iUseMMap );
+
+    // Same as above, but if iPreloadHierarchy is true the headers of every
+    // object and compound property are read when the archive is opened,
+    // using iNumStreams threads, instead of when they are first needed.
+    // Opening takes longer and the headers are kept in memory for as long
+    // as the archive is open, but walking the hierarchy doesn't read
+    // anything, which is much faster for large hierarchies overall.
+    ReadArchive( size_t iNumStreams, bool iUseMMap, bool iPreloadHierarchy );
+
     // Read from the provided streams, we do not own these, expect them
     // to remain open and all have the same data in them, and do not try to
     // delete them
     ReadArchive( const std::vector< std::istream * > & iStreams );
 
+    // Same as above, and preload the hierarchy with one thread per stream
+    ReadArchive( const std::vector< std::istream * > & iStreams,
+                 bool iPreloadHierarchy );
+
     // open the file
     ::Alembic::AbcCoreAbstract::ArchiveReaderPtr
     operator()( const std::string &iFileName ) const;
 
-    // The given cache is ignored.
+    // open the file, and look up array samples in the given cache
     ::Alembic::AbcCoreAbstract::ArchiveReaderPtr
     operator()( const std::string &iFileName,
                 ::Alembic::AbcCoreAbstract::ReadArraySampleCachePtr iCache
@@ -88,6 +271,8 @@ public:
 
 private:
     size_t m_numStreams;
+    bool m_useMMap;
+    bool m_preloadHierarchy;
     std::vector< std::istream * > m_streams;
 };
 
@@ -0,0 +1,547 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreOgawa/ReadWrite.h>
+#include <Alembic/AbcCoreOgawa/ArImpl.h>
+#include <Alembic/AbcCoreOgawa/ReadUtil.h>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <set>
+
+namespace Alembic {
+namespace AbcCoreOgawa {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+// A data to be copied, and what decides where it goes.
+struct RepackData
+{
+    Ogawa::IDataPtr data;
+
+    // 0 for headers and other archive data, 1 for the samples of hot
+    // properties, 2 for the samples of the rest
+    int rank;
+
+    // the time of the sample, or 0 if it isn't one
+    chrono_t time;
+
+    // the property (or the order it was found in if it isn't a sample),
+    // the sample and the data within the sample
+    std::size_t order;
+    std::size_t sample;
+    std::size_t part;
+};
+
+//-*****************************************************************************
+class RepackDataLess
+{
+public:
+    RepackDataLess( RepackLayout iLayout ) : m_layout( iLayout ) {}
+
+    bool operator()( const RepackData & iLhs, const RepackData & iRhs ) const
+    {
+        if ( iLhs.rank != iRhs.rank )
+        {
+            return iLhs.rank < iRhs.rank;
+        }
+
+        if ( m_layout != kObjectMajorLayout && iLhs.time != iRhs.time )
+        {
+            return iLhs.time < iRhs.time;
+        }
+
+        if ( iLhs.order != iRhs.order )
+        {
+            return iLhs.order < iRhs.order;
+        }
+
+        if ( iLhs.sample != iRhs.sample )
+        {
+            return iLhs.sample < iRhs.sample;
+        }
+
+        return iLhs.part < iRhs.part;
+    }
+
+private:
+    RepackLayout m_layout;
+};
+
+//-*****************************************************************************
+// The data of each stored sample of a scalar or array property.
+struct RepackProperty
+{
+    PropertyHeaderPtr header;
+    std::vector< std::vector< Util::uint64_t > > stored;
+};
+
+//-*****************************************************************************
+class ArchiveRepacker
+{
+public:
+    ArchiveRepacker( const std::string & iFileName,
+                     const std::string & iOutFileName,
+                     RepackLayout iLayout,
+                     const std::vector< std::string > & iHotProperties );
+
+    void repack();
+
+    void report( std::vector< RepackFrameStats > & oReport );
+
+private:
+    // adds data iIndex of iGroup, which isn't a sample, to m_data
+    void addData( Ogawa::IGroupPtr iGroup, std::size_t iIndex );
+
+    void findObject( Ogawa::IGroupPtr iGroup, const std::string & iFullName );
+
+    void findCompound( Ogawa::IGroupPtr iGroup );
+
+    void findSamples( Ogawa::IGroupPtr iGroup, PropertyHeaderPtr iHeader );
+
+    // copies iGroup and adds it to oGroup, along with any of its data that
+    // wasn't copied yet
+    void copyGroup( Ogawa::IGroupPtr iGroup, Ogawa::OGroupPtr oGroup );
+
+    Ogawa::ODataPtr copyData( Ogawa::IDataPtr iData );
+
+    // copies the path index, pointing it at where the groups went
+    void copyPathIndex( Ogawa::IDataPtr iData );
+
+    // the seek distance of reading the data in iPos in order, before
+    // repacking if iAfter is false
+    Util::uint64_t seekDistance( const std::vector< Util::uint64_t > & iPos,
+                                 bool iAfter );
+
+    Alembic::Util::shared_ptr< ArImpl > m_archive;
+    Ogawa::OArchive m_outArchive;
+    RepackLayout m_layout;
+    std::set< std::string > m_hotProperties;
+
+    std::vector< RepackData > m_data;
+    std::vector< RepackProperty > m_properties;
+
+    // what has been copied so far, by where it was
+    std::map< Util::uint64_t, Ogawa::ODataPtr > m_copiedData;
+    std::map< Util::uint64_t, Ogawa::OGroupPtr > m_copiedGroups;
+    std::vector< char > m_buffer;
+};
+
+//-*****************************************************************************
+ArchiveRepacker::ArchiveRepacker(
+    const std::string & iFileName,
+    const std::string & iOutFileName,
+    RepackLayout iLayout,
+    const std::vector< std::string > & iHotProperties )
+  : m_archive( Alembic::Util::dynamic_pointer_cast< ArImpl,
+        AbcA::ArchiveReader >( ReadArchive()( iFileName ) ) )
+  , m_outArchive( iOutFileName, 1024 * 1024 )
+  , m_layout( iLayout )
+  , m_hotProperties( iHotProperties.begin(), iHotProperties.end() )
+{
+    ABCA_ASSERT( m_archive && m_archive->m_archive.isFrozen(),
+                 "Can't repack unfinished archive: " << iFileName );
+    ABCA_ASSERT( m_outArchive.isValid(),
+                 "Could not open file: " << iOutFileName );
+}
+
+//-*****************************************************************************
+void ArchiveRepacker::repack()
+{
+    // the version, meta data, time samplings and so on, and then the
+    // hierarchy, except for the path index which refers to groups
+    Ogawa::IGroupPtr top = m_archive->m_archive.getGroup();
+    for ( std::size_t i = 0; i < top->getNumChildren() && i < 6; ++i )
+    {
+        addData( top, i );
+    }
+    findObject( top->getGroup( 2, false, 0 ), "" );
+
+    // the headers go first, so walking the hierarchy reads from one place,
+    // followed by the samples in the order of the layout
+    std::stable_sort( m_data.begin(), m_data.end(),
+                      RepackDataLess( m_layout ) );
+    for ( std::size_t i = 0; i < m_data.size(); ++i )
+    {
+        copyData( m_data[i].data );
+    }
+
+    // the groups go after all of the data
+    Ogawa::OGroupPtr outTop = m_outArchive.getGroup();
+    for ( std::size_t i = 0; i < top->getNumChildren(); ++i )
+    {
+        Util::uint64_t entry = top->getChildEntry( i, 0 );
+        if ( i == 6 && top->isChildData( i ) && entry != Ogawa::EMPTY_DATA )
+        {
+            copyPathIndex( top->getData( i, 0 ) );
+        }
+        else if ( entry == Ogawa::EMPTY_DATA )
+        {
+            outTop->addEmptyData();
+        }
+        else if ( top->isChildData( i ) )
+        {
+            outTop->addData( copyData( top->getData( i, 0 ) ) );
+        }
+        else if ( entry == Ogawa::EMPTY_GROUP )
+        {
+            outTop->addEmptyGroup();
+        }
+        else
+        {
+            copyGroup( top->getGroup( i, false, 0 ), outTop );
+        }
+    }
+}
+
+//-*****************************************************************************
+void ArchiveRepacker::addData( Ogawa::IGroupPtr iGroup, std::size_t iIndex )
+{
+    Util::uint64_t entry = iGroup->getChildEntry( iIndex, 0 );
+    if ( ( entry & Ogawa::EMPTY_DATA ) == 0 || entry == Ogawa::EMPTY_DATA )
+    {
+        return;
+    }
+
+    RepackData data;
+    data.data = iGroup->getData( iIndex, 0 );
+    data.rank = 0;
+    data.time = 0.0;
+    data.order = m_data.size();
+    data.sample = 0;
+    data.part = 0;
+    m_data.push_back( data );
+}
+
+//-*****************************************************************************
+void ArchiveRepacker::findObject( Ogawa::IGroupPtr iGroup,
+                                  const std::string & iFullName )
+{
+    std::size_t numChildren = iGroup->getNumChildren();
+    if ( numChildren == 0 || !iGroup->isChildData( numChildren - 1 ) )
+    {
+        return;
+    }
+
+    std::vector< ObjectHeaderPtr > headers;
+    ReadObjectHeaders( iGroup, numChildren - 1, 0, iFullName,
+                       m_archive->getSnapshot()->indexedMetaData, headers );
+    addData( iGroup, numChildren - 1 );
+
+    findCompound( iGroup->getGroup( 0, false, 0 ) );
+    for ( std::size_t i = 0; i < headers.size(); ++i )
+    {
+        findObject( iGroup->getGroup( i + 1, false, 0 ),
+                    headers[i]->getFullName() );
+    }
+}
+
+//-*****************************************************************************
+void ArchiveRepacker::findCompound( Ogawa::IGroupPtr iGroup )
+{
+    std::size_t numChildren = iGroup->getNumChildren();
+    if ( numChildren == 0 || !iGroup->isChildData( numChildren - 1 ) )
+    {
+        return;
+    }
+
+    PropertyHeaderPtrs headers;
+    ReadPropertyHeaders( iGroup, numChildren - 1, 0, *m_archive,
+                         m_archive->getSnapshot()->indexedMetaData, headers );
+    addData( iGroup, numChildren - 1 );
+
+    for ( std::size_t i = 0; i < headers.size(); ++i )
+    {
+        if ( headers[i]->header.isCompound() )
+        {
+            findCompound( iGroup->getGroup( i, false, 0 ) );
+        }
+        else
+        {
+            findSamples( iGroup->getGroup( i, false, 0 ), headers[i] );
+        }
+    }
+}
+
+//-*****************************************************************************
+void ArchiveRepacker::findSamples( Ogawa::IGroupPtr iGroup,
+                                   PropertyHeaderPtr iHeader )
+{
+    RepackProperty prop;
+    prop.header = iHeader;
+
+    std::size_t numStored = 0;
+    if ( iHeader->nextSampleIndex > 0 )
+    {
+        numStored = iHeader->verifyIndex( iHeader->nextSampleIndex - 1 ) + 1;
+    }
+
+    // packed samples are all in the first data
+    std::size_t numParts = iHeader->header.isArray() ? 2 : 1;
+    if ( iHeader->isPacked )
+    {
+        numStored = std::min( numStored, ( std::size_t ) 1 );
+    }
+
+    RepackData data;
+    data.rank = m_hotProperties.count( iHeader->header.getName() ) > 0 ||
+        m_layout != kHotPropertiesFirstLayout ? 1 : 2;
+    data.order = m_properties.size();
+
+    for ( std::size_t i = 0; i < numStored; ++i )
+    {
+        // the first sample this stored sample is for
+        data.sample = i == 0 ? 0 : iHeader->firstChangedIndex + i - 1;
+        data.time = iHeader->header.getTimeSampling()->getSampleTime(
+            data.sample );
+
+        prop.stored.push_back( std::vector< Util::uint64_t >() );
+        for ( data.part = 0; data.part < numParts; ++data.part )
+        {
+            Util::uint64_t entry =
+                iGroup->getChildEntry( i * numParts + data.part, 0 );
+            if ( ( entry & Ogawa::EMPTY_DATA ) == 0 ||
+                 entry == Ogawa::EMPTY_DATA )
+            {
+                continue;
+            }
+
+            data.data = iGroup->getData( i * numParts + data.part, 0 );
+            m_data.push_back( data );
+            prop.stored.back().push_back( data.data->getPos() );
+        }
+    }
+
+    m_properties.push_back( prop );
+}
+
+//-*****************************************************************************
+void ArchiveRepacker::copyGroup( Ogawa::IGroupPtr iGroup,
+                                 Ogawa::OGroupPtr oGroup )
+{
+    // groups referenced more than once stay shared
+    std::map< Util::uint64_t, Ogawa::OGroupPtr >::iterator it =
+        m_copiedGroups.find( iGroup->getPos() );
+    if ( it != m_copiedGroups.end() )
+    {
+        oGroup->addGroup( it->second );
+        return;
+    }
+
+    Ogawa::OGroupPtr group = oGroup->addGroup();
+    for ( std::size_t i = 0; i < iGroup->getNumChildren(); ++i )
+    {
+        Util::uint64_t entry = iGroup->getChildEntry( i, 0 );
+        if ( entry == Ogawa::EMPTY_DATA )
+        {
+            group->addEmptyData();
+        }
+        else if ( iGroup->isChildData( i ) )
+        {
+            group->addData( copyData( iGroup->getData( i, 0 ) ) );
+        }
+        else if ( entry == Ogawa::EMPTY_GROUP )
+        {
+            group->addEmptyGroup();
+        }
+        else
+        {
+            copyGroup( iGroup->getGroup( i, false, 0 ), group );
+        }
+    }
+
+    group->freeze();
+    m_copiedGroups[ iGroup->getPos() ] = group;
+}
+
+//-*****************************************************************************
+Ogawa::ODataPtr ArchiveRepacker::copyData( Ogawa::IDataPtr iData )
+{
+    // data referenced more than once (like repeated samples) stays shared
+    std::map< Util::uint64_t, Ogawa::ODataPtr >::iterator it =
+        m_copiedData.find( iData->getPos() );
+    if ( it != m_copiedData.end() )
+    {
+        return it->second;
+    }
+
+    Ogawa::ODataPtr copy;
+    Util::uint64_t size = iData->getSize();
+    if ( size == 0 )
+    {
+        copy.reset( new Ogawa::OData() );
+    }
+    else
+    {
+        m_buffer.resize( size );
+        iData->read( size, &m_buffer.front(), 0, 0 );
+        copy = m_outArchive.getGroup()->createData( size, &m_buffer.front() );
+    }
+
+    m_copiedData[ iData->getPos() ] = copy;
+    return copy;
+}
+
+//-*****************************************************************************
+void ArchiveRepacker::copyPathIndex( Ogawa::IDataPtr iData )
+{
+    // the number of entries, then entries of the hash of the full name and
+    // the position of the group of each object, then records which don't
+    // need to change (see AwImpl::writePathIndex)
+    std::vector< char > buf( iData->getSize() );
+    iData->read( buf.size(), &buf.front(), 0, 0 );
+
+    Util::uint64_t numEntries = 0;
+    memcpy( &numEntries, &buf.front(), 8 );
+    ABCA_ASSERT( numEntries <= ( buf.size() - 8 ) / 24,
+                 "Read invalid: Path index size." );
+
+    for ( Util::uint64_t i = 0; i < numEntries; ++i )
+    {
+        Util::uint64_t pos = 0;
+        memcpy( &pos, &buf[ 8 + i * 24 + 8 ], 8 );
+
+        std::map< Util::uint64_t, Ogawa::OGroupPtr >::iterator it =
+            m_copiedGroups.find( pos );
+        ABCA_ASSERT( it != m_copiedGroups.end(),
+                     "Read invalid: Path index entry." );
+
+        pos = it->second->getPos();
+        memcpy( &buf[ 8 + i * 24 + 8 ], &pos, 8 );
+    }
+
+    m_outArchive.getGroup()->addData( buf.size(), &buf.front() );
+}
+
+//-*****************************************************************************
+Util::uint64_t
+ArchiveRepacker::seekDistance( const std::vector< Util::uint64_t > & iPos,
+                               bool iAfter )
+{
+    Util::uint64_t distance = 0;
+    Util::uint64_t end = 0;
+    for ( std::size_t i = 0; i < iPos.size(); ++i )
+    {
+        Ogawa::ODataPtr data = m_copiedData[ iPos[i] ];
+        Util::uint64_t pos = iAfter ? data->getPos() : iPos[i];
+        if ( i > 0 )
+        {
+            distance += pos > end ? pos - end : end - pos;
+        }
+
+        // the size is stored in front of the data
+        end = pos + 8 + data->getSize();
+    }
+    return distance;
+}
+
+//-*****************************************************************************
+void ArchiveRepacker::report( std::vector< RepackFrameStats > & oReport )
+{
+    // a frame is any time a property has a sample at
+    std::set< chrono_t > times;
+    for ( std::size_t i = 0; i < m_properties.size(); ++i )
+    {
+        const PropertyHeaderAndFriends & prop = *m_properties[i].header;
+        AbcA::TimeSamplingPtr tsmp = prop.header.getTimeSampling();
+        for ( Util::uint32_t j = 0; j < prop.nextSampleIndex; ++j )
+        {
+            times.insert( tsmp->getSampleTime( j ) );
+        }
+    }
+
+    oReport.clear();
+    std::set< chrono_t >::iterator it;
+    for ( it = times.begin(); it != times.end(); ++it )
+    {
+        // what reading every property at this time reads, in the order of
+        // the hierarchy
+        std::vector< Util::uint64_t > positions;
+        RepackFrameStats stats;
+        stats.time = *it;
+        stats.numBytes = 0;
+        for ( std::size_t i = 0; i < m_properties.size(); ++i )
+        {
+            RepackProperty & prop = m_properties[i];
+            if ( prop.stored.empty() )
+            {
+                continue;
+            }
+
+            index_t index = prop.header->header.getTimeSampling()->
+                getFloorIndex( *it, prop.header->nextSampleIndex ).first;
+            std::size_t stored = std::min( prop.header->verifyIndex( index ),
+                                           prop.stored.size() - 1 );
+
+            const std::vector< Util::uint64_t > & pos = prop.stored[stored];
+            for ( std::size_t j = 0; j < pos.size(); ++j )
+            {
+                positions.push_back( pos[j] );
+                stats.numBytes += m_copiedData[ pos[j] ]->getSize();
+            }
+        }
+
+        stats.numReads = positions.size();
+        stats.seekBefore = seekDistance( positions, false );
+        stats.seekAfter = seekDistance( positions, true );
+        oReport.push_back( stats );
+    }
+}
+
+//-*****************************************************************************
+void RepackArchive( const std::string & iFileName,
+                    const std::string & iOutFileName,
+                    RepackLayout iLayout,
+                    const std::vector< std::string > & iHotProperties,
+                    std::vector< RepackFrameStats > * oReport )
+{
+    ABCA_ASSERT( iFileName != iOutFileName,
+                 "Can't repack an archive onto itself: " << iFileName );
+
+    ArchiveRepacker repacker( iFileName, iOutFileName, iLayout,
+                              iHotProperties );
+    repacker.repack();
+
+    if ( oReport )
+    {
+        repacker.report( *oReport );
+    }
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcCoreOgawa
+} // End namespace Alembic
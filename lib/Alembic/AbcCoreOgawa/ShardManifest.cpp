@@ -0,0 +1,533 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreOgawa/ReadWrite.h>
+#include <Alembic/AbcCoreOgawa/ArImpl.h>
+#include <Alembic/AbcCoreOgawa/MetaDataMap.h>
+#include <Alembic/AbcCoreOgawa/ReadUtil.h>
+#include <Alembic/AbcCoreOgawa/WriteUtil.h>
+
+namespace Alembic {
+namespace AbcCoreOgawa {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+// where Ogawa::IStreams looks for shard iName of the archive iFileName
+static std::string ShardPath( const std::string & iFileName,
+                              const std::string & iName )
+{
+    if ( !iName.empty() && ( iName[0] == '/' || iName[0] == '\\' ||
+         ( iName.size() > 1 && iName[1] == ':' ) ) )
+    {
+        return iName;
+    }
+
+    std::size_t slash = iFileName.find_last_of( "/\\" );
+    if ( slash == std::string::npos )
+    {
+        return iName;
+    }
+
+    return iFileName.substr( 0, slash + 1 ) + iName;
+}
+
+//-*****************************************************************************
+// reads iSize bytes of iData from iOffset into a string, used to tell
+// samples apart
+static std::string ReadBytes( Ogawa::IDataPtr iData,
+                              Util::uint64_t iOffset,
+                              Util::uint64_t iSize )
+{
+    std::string bytes;
+    if ( iData && iSize > 0 && iOffset + iSize <= iData->getSize() )
+    {
+        bytes.resize( iSize );
+        iData->read( iSize, &bytes[0], iOffset, 0 );
+    }
+    return bytes;
+}
+
+//-*****************************************************************************
+class ShardManifestWriter
+{
+public:
+    ShardManifestWriter( const std::string & iFileName,
+                         const std::vector< std::string > & iShards );
+
+    void write();
+
+private:
+    typedef std::vector< Ogawa::IGroupPtr > IGroups;
+
+    // writes the object whose group in each shard is in iGroups to oGroup
+    void writeObject( const IGroups & iGroups,
+                      const std::string & iFullName,
+                      Ogawa::OGroupPtr oGroup );
+
+    // writes the compound property whose group in each shard is in iGroups
+    // to oGroup
+    void writeCompound( const IGroups & iGroups,
+                        Ogawa::OGroupPtr oGroup );
+
+    // references the samples of the scalar or array property whose header
+    // and group in each shard are in iHeaders and iGroups one after the
+    // other in oGroup, and fills in oProp to match
+    void writeSamples( const PropertyHeaderPtrs & iHeaders,
+                       const IGroups & iGroups,
+                       Ogawa::OGroupPtr oGroup,
+                       PropertyHeaderAndFriends & oProp );
+
+    std::string m_fileName;
+    std::vector< Alembic::Util::shared_ptr< ArImpl > > m_shards;
+    Ogawa::OArchive m_archive;
+    MetaDataMapPtr m_metaDataMap;
+    Util::int32_t m_fileVersion;
+};
+
+//-*****************************************************************************
+ShardManifestWriter::ShardManifestWriter(
+    const std::string & iFileName,
+    const std::vector< std::string > & iShards )
+  : m_fileName( iFileName )
+  , m_archive( iFileName, iShards )
+  , m_fileVersion( 0 )
+{
+    ABCA_ASSERT( m_archive.isValid(),
+                 "Could not open file: " << iFileName );
+
+    bool extended = false;
+    for ( std::size_t i = 0; i < iShards.size(); ++i )
+    {
+        std::string path = ShardPath( iFileName, iShards[i] );
+        Alembic::Util::shared_ptr< ArImpl > shard =
+            Alembic::Util::dynamic_pointer_cast< ArImpl, AbcA::ArchiveReader >(
+                ReadArchive()( path ) );
+        ABCA_ASSERT( shard && shard->m_archive.isFrozen(),
+                     "Shard isn't a finished Ogawa archive: " << path );
+
+        ABCA_ASSERT( i == 0 || shard->getNumTimeSamplings() ==
+                     m_shards[0]->getNumTimeSamplings(),
+                     "Shard has different time samplings: " << path );
+
+        Util::int32_t version = 0;
+        shard->m_archive.getGroup()->getData( 0, 0 )->read( 4, &version, 0,
+                                                             0 );
+        m_fileVersion = std::max( m_fileVersion, version );
+
+        // share as many meta data as the shards did
+        extended = extended ||
+            shard->getSnapshot()->indexedMetaData.size() > 255;
+        m_shards.push_back( shard );
+    }
+
+    m_metaDataMap.reset( new MetaDataMap( extended ) );
+}
+
+//-*****************************************************************************
+void ShardManifestWriter::write()
+{
+    Ogawa::OGroupPtr top = m_archive.getGroup();
+    Ogawa::ODataPtr version = top->addData( 4, &m_fileVersion );
+
+    Util::int32_t libraryVersion = ALEMBIC_LIBRARY_VERSION;
+    top->addData( 4, &libraryVersion );
+
+    IGroups groups;
+    for ( std::size_t i = 0; i < m_shards.size(); ++i )
+    {
+        groups.push_back( m_shards[i]->m_archive.getGroup()->getGroup( 2,
+            false, 0 ) );
+    }
+    writeObject( groups, "", top->addGroup() );
+
+    std::string metaData = m_shards[0]->getMetaData().serialize();
+    top->addData( metaData.size(), metaData.c_str() );
+
+    // the shards sample one after the other, so acyclic times are joined
+    // and the rest are as the first shard has them
+    std::vector< Util::uint8_t > data;
+    for ( Util::uint32_t i = 0; i < m_shards[0]->getNumTimeSamplings(); ++i )
+    {
+        AbcA::TimeSamplingPtr tsmp = m_shards[0]->getTimeSampling( i );
+        std::vector< chrono_t > times;
+        AbcA::index_t maxSample = 0;
+        for ( std::size_t j = 0; j < m_shards.size(); ++j )
+        {
+            AbcA::TimeSamplingPtr shardTsmp = m_shards[j]->getTimeSampling( i );
+            ABCA_ASSERT( shardTsmp->getTimeSamplingType() ==
+                         tsmp->getTimeSamplingType(),
+                         "Shards have different time samplings at index "
+                         << i );
+
+            const std::vector< chrono_t > & shardTimes =
+                shardTsmp->getStoredTimes();
+            times.insert( times.end(), shardTimes.begin(), shardTimes.end() );
+            maxSample += std::max( m_shards[j]->
+                getMaxNumSamplesForTimeSamplingIndex( i ), ( AbcA::index_t ) 0 );
+        }
+
+        if ( tsmp->getTimeSamplingType().isAcyclic() )
+        {
+            tsmp.reset( new AbcA::TimeSampling(
+                tsmp->getTimeSamplingType(), times ) );
+        }
+        WriteTimeSampling( data, maxSample, *tsmp );
+    }
+    top->addData( data.size(), &( data.front() ) );
+
+    m_metaDataMap->write( top );
+    if ( m_metaDataMap->usesExtendedIndices() && m_fileVersion < 2 )
+    {
+        m_fileVersion = 2;
+    }
+    version->rewrite( 4, &m_fileVersion );
+}
+
+//-*****************************************************************************
+void ShardManifestWriter::writeObject( const IGroups & iGroups,
+                                       const std::string & iFullName,
+                                       Ogawa::OGroupPtr oGroup )
+{
+    IGroups props;
+    std::vector< std::vector< ObjectHeaderPtr > > headers( iGroups.size() );
+    for ( std::size_t i = 0; i < iGroups.size(); ++i )
+    {
+        props.push_back( iGroups[i]->getGroup( 0, false, 0 ) );
+
+        std::size_t numChildren = iGroups[i]->getNumChildren();
+        ABCA_ASSERT( numChildren > 0 &&
+                     iGroups[i]->isChildData( numChildren - 1 ),
+                     "Invalid object in shard " << i << ": " << iFullName );
+
+        ReadObjectHeaders( iGroups[i], numChildren - 1, 0, iFullName,
+                           m_shards[i]->getSnapshot()->indexedMetaData,
+                           headers[i] );
+
+        ABCA_ASSERT( headers[i].size() == headers[0].size(),
+                     "Shards have different children under: " << iFullName );
+        for ( std::size_t j = 0; j < headers[i].size(); ++j )
+        {
+            ABCA_ASSERT( headers[i][j]->getName() == headers[0][j]->getName(),
+                         "Shards have different children under: "
+                         << iFullName );
+        }
+    }
+
+    writeCompound( props, oGroup->addGroup() );
+
+    std::vector< Util::uint8_t > data;
+    for ( std::size_t i = 0; i < headers[0].size(); ++i )
+    {
+        IGroups children;
+        for ( std::size_t j = 0; j < iGroups.size(); ++j )
+        {
+            children.push_back( iGroups[j]->getGroup( i + 1, false, 0 ) );
+        }
+        writeObject( children, headers[0][i]->getFullName(),
+                     oGroup->addGroup() );
+
+        WriteObjectHeader( data, *headers[0][i], m_metaDataMap );
+    }
+
+    // the properties and children hashes are the hashes of those of the
+    // shards
+    Util::SpookyHash propsHash;
+    Util::SpookyHash childrenHash;
+    propsHash.Init( 0, 0 );
+    childrenHash.Init( 0, 0 );
+    for ( std::size_t i = 0; i < iGroups.size(); ++i )
+    {
+        Ogawa::IDataPtr headerData =
+            iGroups[i]->getData( iGroups[i]->getNumChildren() - 1, 0 );
+        ABCA_ASSERT( headerData->getSize() >= 32,
+                     "Invalid object in shard " << i << ": " << iFullName );
+
+        Util::uint64_t hashes[4];
+        headerData->read( 32, hashes, headerData->getSize() - 32, 0 );
+        propsHash.Update( &hashes[0], 16 );
+        childrenHash.Update( &hashes[2], 16 );
+    }
+
+    Util::uint64_t hashes[4];
+    propsHash.Final( &hashes[0], &hashes[1] );
+    childrenHash.Final( &hashes[2], &hashes[3] );
+    Util::uint8_t * hashData = ( Util::uint8_t * ) hashes;
+    data.insert( data.end(), hashData, hashData + 32 );
+
+    oGroup->addData( data.size(), &( data.front() ) );
+}
+
+//-*****************************************************************************
+void ShardManifestWriter::writeCompound( const IGroups & iGroups,
+                                         Ogawa::OGroupPtr oGroup )
+{
+    std::vector< PropertyHeaderPtrs > headers( iGroups.size() );
+    for ( std::size_t i = 0; i < iGroups.size(); ++i )
+    {
+        std::size_t numChildren = iGroups[i]->getNumChildren();
+        if ( numChildren > 0 && iGroups[i]->isChildData( numChildren - 1 ) )
+        {
+            ReadPropertyHeaders( iGroups[i], numChildren - 1, 0,
+                                 *m_shards[i],
+                                 m_shards[i]->getSnapshot()->indexedMetaData,
+                                 headers[i] );
+        }
+
+        ABCA_ASSERT( headers[i].size() == headers[0].size(),
+                     "Shards have different properties" );
+        for ( std::size_t j = 0; j < headers[i].size(); ++j )
+        {
+            const AbcA::PropertyHeader & header = headers[i][j]->header;
+            const AbcA::PropertyHeader & first = headers[0][j]->header;
+            ABCA_ASSERT( header.getName() == first.getName() &&
+                         header.getPropertyType() == first.getPropertyType() &&
+                         ( header.isCompound() ||
+                           header.getDataType() == first.getDataType() ),
+                         "Shards have different properties: "
+                         << first.getName() );
+        }
+    }
+
+    std::vector< Util::uint8_t > data;
+    for ( std::size_t i = 0; i < headers[0].size(); ++i )
+    {
+        IGroups groups;
+        PropertyHeaderPtrs propHeaders;
+        for ( std::size_t j = 0; j < iGroups.size(); ++j )
+        {
+            groups.push_back( iGroups[j]->getGroup( i, false, 0 ) );
+            propHeaders.push_back( headers[j][i] );
+        }
+
+        PropertyHeaderAndFriends prop = *headers[0][i];
+        if ( prop.header.isCompound() )
+        {
+            writeCompound( groups, oGroup->addGroup() );
+        }
+        else
+        {
+            writeSamples( propHeaders, groups, oGroup->addGroup(), prop );
+        }
+
+        WritePropertyInfo( data, prop.header, prop.isScalarLike,
+                           prop.isHomogenous, prop.isCompressed,
+                           prop.isPacked, prop.timeSamplingIndex,
+                           prop.nextSampleIndex, prop.firstChangedIndex,
+                           prop.lastChangedIndex, m_metaDataMap );
+    }
+
+    if ( !data.empty() )
+    {
+        oGroup->addData( data.size(), &( data.front() ) );
+    }
+}
+
+//-*****************************************************************************
+void ShardManifestWriter::writeSamples( const PropertyHeaderPtrs & iHeaders,
+                                        const IGroups & iGroups,
+                                        Ogawa::OGroupPtr oGroup,
+                                        PropertyHeaderAndFriends & oProp )
+{
+    bool isArray = oProp.header.isArray();
+    std::size_t numBytes = oProp.header.getDataType().getNumBytes();
+
+    // packed scalar samples can't be referenced one at a time, so if any
+    // shard has them they are all copied, told apart by their bytes
+    bool packed = false;
+    bool haveSamples = false;
+    for ( std::size_t i = 0; i < iHeaders.size(); ++i )
+    {
+        ABCA_ASSERT( iHeaders[i]->timeSamplingIndex ==
+                     oProp.timeSamplingIndex,
+                     "Shards have different time samplings for: "
+                     << oProp.header.getName() );
+
+        // whether array samples are compressed is only known once there
+        // are some
+        if ( iHeaders[i]->nextSampleIndex == 0 )
+        {
+            continue;
+        }
+        else if ( !haveSamples )
+        {
+            oProp.isCompressed = iHeaders[i]->isCompressed;
+            haveSamples = true;
+        }
+        ABCA_ASSERT( iHeaders[i]->isCompressed == oProp.isCompressed,
+                     "Shards compress the samples of " <<
+                     oProp.header.getName() << " differently" );
+        packed = packed || iHeaders[i]->isPacked;
+    }
+
+    // the shard and stored index of each sample, and what tells the stored
+    // samples of each shard apart (their digest and dimensions, or their
+    // bytes if they are packed)
+    std::vector< std::pair< std::size_t, std::size_t > > samples;
+    std::vector< std::vector< std::string > > keys( iHeaders.size() );
+    oProp.isHomogenous = true;
+    oProp.isScalarLike = true;
+    for ( std::size_t i = 0; i < iHeaders.size(); ++i )
+    {
+        PropertyHeaderAndFriends & header = *iHeaders[i];
+        oProp.isHomogenous = oProp.isHomogenous && header.isHomogenous;
+        oProp.isScalarLike = oProp.isScalarLike && header.isScalarLike;
+        if ( header.nextSampleIndex == 0 )
+        {
+            continue;
+        }
+
+        std::size_t numStored = header.verifyIndex(
+            header.nextSampleIndex - 1 ) + 1;
+        if ( header.isPacked )
+        {
+            std::string bytes = ReadBytes( iGroups[i]->getData( 0, 0 ), 0,
+                                           numStored * numBytes );
+            ABCA_ASSERT( bytes.size() == numStored * numBytes,
+                         "Read invalid: Packed scalar samples size." );
+            for ( std::size_t j = 0; j < numStored; ++j )
+            {
+                keys[i].push_back( bytes.substr( j * numBytes, numBytes ) );
+            }
+        }
+        else
+        {
+            for ( std::size_t j = 0; j < numStored; ++j )
+            {
+                Ogawa::IDataPtr data = iGroups[i]->getData(
+                    isArray ? j * 2 : j, 0 );
+                if ( packed )
+                {
+                    keys[i].push_back( ReadBytes( data, 16, numBytes ) );
+                }
+                else if ( isArray )
+                {
+                    Ogawa::IDataPtr dims = iGroups[i]->getData( j * 2 + 1, 0 );
+                    keys[i].push_back( ReadBytes( data, 0, 16 ) + "/" +
+                        ReadBytes( dims, 0, dims ? dims->getSize() : 0 ) );
+                }
+                else
+                {
+                    keys[i].push_back( ReadBytes( data, 0, 16 ) );
+                }
+            }
+        }
+
+        for ( index_t j = 0; j < header.nextSampleIndex; ++j )
+        {
+            samples.push_back( std::make_pair( i, header.verifyIndex( j ) ) );
+        }
+    }
+
+    // work out which samples change, like the writers do
+    oProp.nextSampleIndex = samples.size();
+    oProp.firstChangedIndex = 0;
+    oProp.lastChangedIndex = 0;
+    for ( std::size_t i = 1; i < samples.size(); ++i )
+    {
+        const std::string & key = keys[samples[i].first][samples[i].second];
+        const std::string & prevKey =
+            keys[samples[i - 1].first][samples[i - 1].second];
+        if ( key != prevKey )
+        {
+            if ( oProp.firstChangedIndex == 0 )
+            {
+                oProp.firstChangedIndex = i;
+            }
+            oProp.lastChangedIndex = i;
+        }
+    }
+
+    std::vector< std::size_t > stored;
+    if ( !samples.empty() )
+    {
+        stored.push_back( 0 );
+    }
+    for ( std::size_t i = oProp.firstChangedIndex;
+          i > 0 && i <= oProp.lastChangedIndex; ++i )
+    {
+        stored.push_back( i );
+    }
+
+    // a single sample from a shard that didn't pack it is referenced too
+    oProp.isPacked = packed && ( stored.size() > 1 ||
+        iHeaders[samples[0].first]->isPacked );
+    if ( oProp.isPacked )
+    {
+        std::string bytes;
+        for ( std::size_t i = 0; i < stored.size(); ++i )
+        {
+            const std::pair< std::size_t, std::size_t > & sample =
+                samples[stored[i]];
+            bytes += keys[sample.first][sample.second];
+        }
+        oGroup->addData( bytes.size(), bytes.data() );
+        m_fileVersion = std::max( m_fileVersion, ( Util::int32_t ) 3 );
+        return;
+    }
+
+    for ( std::size_t i = 0; i < stored.size(); ++i )
+    {
+        std::size_t shard = samples[stored[i]].first;
+        std::size_t index = samples[stored[i]].second;
+        if ( isArray )
+        {
+            oGroup->addShardData( shard + 1,
+                iGroups[shard]->getData( index * 2, 0 ) );
+            oGroup->addShardData( shard + 1,
+                iGroups[shard]->getData( index * 2 + 1, 0 ) );
+        }
+        else
+        {
+            oGroup->addShardData( shard + 1,
+                iGroups[shard]->getData( index, 0 ) );
+        }
+    }
+}
+
+//-*****************************************************************************
+void WriteShardManifest( const std::string & iFileName,
+                         const std::vector< std::string > & iShards )
+{
+    ABCA_ASSERT( !iShards.empty(),
+                 "A sharded archive needs at least one shard: " << iFileName );
+
+    ShardManifestWriter writer( iFileName, iShards );
+    writer.write();
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcCoreOgawa
+} // End namespace Alembic
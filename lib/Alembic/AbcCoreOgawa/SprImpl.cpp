@@ -50,6 +50,7 @@ SprImpl::SprImpl( AbcA::CompoundPropertyReaderPtr iParent,
   : m_parent( iParent )
   , m_group( iGroup )
   , m_header( iHeader )
+  , m_packedSamplesLoaded( false )
 {
     // Validate all inputs.
     ABCA_ASSERT( m_parent, "Invalid parent" );
@@ -99,19 +100,73 @@ bool SprImpl::isConstant()
     return ( m_header->firstChangedIndex == 0 );
 }
 
+//-*****************************************************************************
+void SprImpl::loadPackedSamples()
+{
+#ifdef ALEMBIC_SPR_PACKED_ATOMIC
+    if ( m_packedSamplesLoaded.load( std::memory_order_acquire ) )
+    {
+        return;
+    }
+#endif
+
+    Alembic::Util::scoped_lock l( m_packedSamplesLock );
+    if ( m_packedSamplesLoaded )
+    {
+        return;
+    }
+
+    Util::shared_ptr< ArImpl > ar = Alembic::Util::dynamic_pointer_cast<
+        ArImpl, AbcA::ArchiveReader > ( getObject()->getArchive() );
+    StreamIDPtr streamId = ar->getStreamID();
+
+    std::size_t id = streamId->getID();
+    std::size_t numBytes = m_header->header.getDataType().getNumBytes();
+    std::size_t numPacked =
+        m_header->verifyIndex( m_header->nextSampleIndex - 1 ) + 1;
+    Ogawa::IDataPtr data = m_group->getData( 0, id );
+    ABCA_ASSERT( data && data->getSize() == numPacked * numBytes,
+                 "Read invalid: Packed scalar samples size." );
+
+    m_packedSamples.resize( data->getSize() );
+    data->read( data->getSize(), &m_packedSamples.front(), 0, id );
+    ar->countPropertyBytes( AbcA::kScalarProperty, data->getSize() );
+
+#ifdef ALEMBIC_SPR_PACKED_ATOMIC
+    m_packedSamplesLoaded.store( true, std::memory_order_release );
+#else
+    m_packedSamplesLoaded = true;
+#endif
+}
+
 //-*****************************************************************************
 void SprImpl::getSample( index_t iSampleIndex, void * iIntoLocation )
 {
     size_t index = m_header->verifyIndex( iSampleIndex );
 
-    StreamIDPtr streamId = Alembic::Util::dynamic_pointer_cast< ArImpl,
-        AbcA::ArchiveReader > ( getObject()->getArchive() )->getStreamID();
+    if ( m_header->isPacked )
+    {
+        loadPackedSamples();
+
+        std::size_t numBytes = m_header->header.getDataType().getNumBytes();
+        memcpy( iIntoLocation, &m_packedSamples[index * numBytes], numBytes );
+        return;
+    }
+
+    Util::shared_ptr< ArImpl > ar = Alembic::Util::dynamic_pointer_cast<
+        ArImpl, AbcA::ArchiveReader > ( getObject()->getArchive() );
+    StreamIDPtr streamId = ar->getStreamID();
 
     std::size_t id = streamId->getID();
     Ogawa::IDataPtr data = m_group->getData( index, id );
     ReadData( iIntoLocation, data, id,
               m_header->header.getDataType(),
-              m_header->header.getDataType().getPod() );
+              m_header->header.getDataType().getPod(), false );
+
+    if ( data )
+    {
+        ar->countPropertyBytes( AbcA::kScalarProperty, data->getSize() );
+    }
 }
 
 //-*****************************************************************************
@@ -39,6 +39,13 @@
 
 #include <Alembic/AbcCoreOgawa/Foundation.h>
 
+#if ( defined( _MSC_VER ) && _MSC_VER > 1600 ) || \
+    ( !defined( _MSC_VER ) && \
+      ( defined( __GXX_EXPERIMENTAL_CXX0X__ ) || __cplusplus >= 201103L ) )
+#define ALEMBIC_SPR_PACKED_ATOMIC
+#include <atomic>
+#endif
+
 namespace Alembic {
 namespace AbcCoreOgawa {
 namespace ALEMBIC_VERSION_NS {
@@ -72,6 +79,9 @@ public:
 
 private:
 
+    // reads m_packedSamples if nothing has yet
+    void loadPackedSamples();
+
     // Parent compound property writer. It must exist.
     AbcA::CompoundPropertyReaderPtr m_parent;
 
@@ -81,6 +91,17 @@ private:
     // Stores the PropertyHeader and other info
     PropertyHeaderPtr m_header;
 
+    // all of the samples of a packed property, read the first time a sample
+    // is asked for and never changed after that, so once the flag is set
+    // they are read without the lock
+    std::vector< char > m_packedSamples;
+#ifdef ALEMBIC_SPR_PACKED_ATOMIC
+    std::atomic< bool > m_packedSamplesLoaded;
+#else
+    bool m_packedSamplesLoaded;
+#endif
+    Alembic::Util::mutex m_packedSamplesLock;
+
 };
 
 } // End namespace ALEMBIC_VERSION_NS
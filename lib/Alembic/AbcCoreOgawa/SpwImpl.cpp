@@ -37,18 +37,49 @@
 #include <Alembic/AbcCoreOgawa/SpwImpl.h>
 #include <Alembic/AbcCoreOgawa/CpwImpl.h>
 #include <Alembic/AbcCoreOgawa/WriteUtil.h>
+#include <Alembic/AbcCoreOgawa/AwImpl.h>
+#include <Alembic/AbcCoreOgawa/ReadUtil.h>
 
 namespace Alembic {
 namespace AbcCoreOgawa {
 namespace ALEMBIC_VERSION_NS {
 
+//-*****************************************************************************
+// Holds onto a copy of a sample given to the SpwImpl until the archives write
+// queue gets around to writing it.
+class SpwWriteTask : public SampleWriteTask
+{
+public:
+    SpwWriteTask( SpwImpl * iWriter, const AbcA::ArraySample * iSamp,
+                  Util::uint32_t iIndex, AbcA::SampleHashID iHashID )
+        : SampleWriteTask( iSamp, iHashID ), m_writer( iWriter )
+        , m_index( iIndex ) {}
+
+    virtual void write()
+    {
+        if ( getSample() )
+        {
+            m_writer->writeSample( *getSample(), getKey(), m_index );
+        }
+        else
+        {
+            m_writer->writePreviousSample();
+        }
+    }
+
+private:
+    // the writer waits for the queue before it is destroyed
+    SpwImpl * m_writer;
+    Util::uint32_t m_index;
+};
+
 //-*****************************************************************************
 SpwImpl::SpwImpl( AbcA::CompoundPropertyWriterPtr iParent,
                   Ogawa::OGroupPtr iGroup,
                   PropertyHeaderPtr iHeader,
                   size_t iIndex ) :
     m_parent( iParent ), m_header( iHeader ), m_group( iGroup ),
-    m_index( iIndex )
+    m_index( iIndex ), m_pack( false )
 {
     ABCA_ASSERT( m_parent, "Invalid parent" );
     ABCA_ASSERT( m_header, "Invalid property header" );
@@ -59,6 +90,13 @@ SpwImpl::SpwImpl( AbcA::CompoundPropertyWriterPtr iParent,
         ABCA_THROW( "Attempted to create a ScalarPropertyWriter from a "
                     "non-scalar property type" );
     }
+
+    // strings vary in size, so they can't be looked up by index
+    Util::PlainOldDataType pod = m_header->header.getDataType().getPod();
+    AwImpl * aw = dynamic_cast< AwImpl * >(
+        m_parent->getObject()->getArchive().get() );
+    m_pack = aw && aw->packsScalarSamples() && pod != Util::kStringPOD &&
+        pod != Util::kWstringPOD;
 }
 
 
@@ -67,6 +105,14 @@ SpwImpl::~SpwImpl()
 {
     AbcA::ArchiveWriterPtr archive = m_parent->getObject()->getArchive();
 
+    // our samples may still be waiting to be written
+    AwImpl * aw = dynamic_cast< AwImpl * >( archive.get() );
+    if ( aw )
+    {
+        aw->waitForWritesNoThrow();
+        writePackedSamples( aw );
+    }
+
     index_t maxSamples = archive->getMaxNumSamplesForTimeSamplingIndex(
             m_header->timeSamplingIndex );
 
@@ -118,10 +164,30 @@ void SpwImpl::setFromPreviousSample()
     ABCA_ASSERT( m_header->nextSampleIndex > 0,
         "Can't set from previous sample before any samples have been written" );
 
+    AwImpl * aw = dynamic_cast< AwImpl * >( getObject()->getArchive().get() );
+    ABCA_ASSERT( aw, "NULL Impl Ptr" );
+
+    WriteQueue * queue = aw->getWriteQueue();
+    if ( queue )
+    {
+        queue->push( new SpwWriteTask( this, NULL,
+                                       m_header->nextSampleIndex,
+                                       aw->getSampleHashID() ) );
+    }
+    else
+    {
+        writePreviousSample();
+    }
+
+    m_header->nextSampleIndex ++;
+}
+
+//-*****************************************************************************
+void SpwImpl::writePreviousSample()
+{
     Util::Digest digest = m_previousWrittenSampleID->getKey().digest;
     Util::SpookyHash::ShortEnd(m_hash.words[0], m_hash.words[1],
                                digest.words[0], digest.words[1]);
-    m_header->nextSampleIndex ++;
 }
 
 //-*****************************************************************************
@@ -139,24 +205,36 @@ void SpwImpl::setSample( const void *iSamp )
     AbcA::ArraySample samp( iSamp, m_header->header.getDataType(),
                             AbcA::Dimensions(1) );
 
-     // The Key helps us analyze the sample.
-     AbcA::ArraySample::Key key = samp.getKey();
+    AwImpl * aw = dynamic_cast< AwImpl * >( getObject()->getArchive().get() );
+    ABCA_ASSERT( aw, "NULL Impl Ptr" );
 
-     // mask out the non-string POD since Ogawa can safely share the same data
-     // even if it originated from a different POD
-     // the non-fixed sizes of our strings (plus added null characters) makes
-     // determing the sie harder so strings are handled seperately
-    if ( key.origPOD != Alembic::Util::kStringPOD &&
-         key.origPOD != Alembic::Util::kWstringPOD )
+    WriteQueue * queue = aw->getWriteQueue();
+    if ( queue )
     {
-        key.origPOD = Alembic::Util::kInt8POD;
-        key.readPOD = Alembic::Util::kInt8POD;
+        queue->push( new SpwWriteTask( this, &samp,
+                                       m_header->nextSampleIndex,
+                                       aw->getSampleHashID() ) );
+    }
+    else
+    {
+        // The Key helps us analyze the sample.
+        writeSample( samp,
+                     GetWrittenSampleKey( samp, aw->getSampleHashID() ),
+                     m_header->nextSampleIndex );
     }
 
+    m_header->nextSampleIndex ++;
+}
+
+//-*****************************************************************************
+void SpwImpl::writeSample( const AbcA::ArraySample & iSamp,
+                           const AbcA::ArraySample::Key & iKey,
+                           Util::uint32_t iIndex )
+{
     // We need to write the sample
-    if ( m_header->nextSampleIndex == 0  ||
+    if ( iIndex == 0  ||
         !( m_previousWrittenSampleID &&
-            key == m_previousWrittenSampleID->getKey() ) )
+            iKey == m_previousWrittenSampleID->getKey() ) )
     {
 
         // we only need to repeat samples if this is not the first change
@@ -164,31 +242,55 @@ void SpwImpl::setSample( const void *iSamp )
         {
             // copy the samples from after the last change to the latest index
             for ( index_t smpI = m_header->lastChangedIndex + 1;
-                smpI < m_header->nextSampleIndex; ++smpI )
+                smpI < iIndex; ++smpI )
             {
                 assert( smpI > 0 );
-                CopyWrittenData( m_group, m_previousWrittenSampleID );
+                if ( m_pack )
+                {
+                    std::size_t numBytes = iKey.numBytes;
+                    std::size_t end = m_packedSamples.size();
+                    m_packedSamples.resize( end + numBytes );
+                    memcpy( &m_packedSamples[end],
+                            &m_packedSamples[end - numBytes], numBytes );
+                }
+                else
+                {
+                    CopyWrittenData( m_group, m_previousWrittenSampleID );
+                }
             }
         }
 
-        // Write this sample, which will update its internal
-        // cache of what the previously written sample was.
-        AbcA::ArchiveWriterPtr awp = this->getObject()->getArchive();
-
-        // Write the sample.
-        // This distinguishes between string, wstring, and regular arrays.
-        m_previousWrittenSampleID =
-            WriteData( GetWrittenSampleMap( awp ), m_group, samp, key );
+        if ( m_pack )
+        {
+            // hold onto it until we know whether there is more than one
+            const Util::uint8_t * data =
+                static_cast< const Util::uint8_t * >( iSamp.getData() );
+            m_packedSamples.insert( m_packedSamples.end(), data,
+                                    data + iKey.numBytes );
+            m_previousWrittenSampleID.reset(
+                new WrittenSampleID( iKey, Ogawa::ODataPtr(), 1 ) );
+        }
+        else
+        {
+            // Write this sample, which will update its internal
+            // cache of what the previously written sample was.
+            AbcA::ArchiveWriterPtr awp = this->getObject()->getArchive();
+
+            // Write the sample.
+            // This distinguishes between string, wstring, and regular arrays.
+            m_previousWrittenSampleID =
+                WriteData( GetWrittenSampleMap( awp ), m_group, iSamp, iKey );
+        }
 
         if (m_header->firstChangedIndex == 0)
         {
-            m_header->firstChangedIndex = m_header->nextSampleIndex;
+            m_header->firstChangedIndex = iIndex;
         }
         // this index is now the last change
-        m_header->lastChangedIndex = m_header->nextSampleIndex;
+        m_header->lastChangedIndex = iIndex;
     }
 
-    if ( m_header->nextSampleIndex == 0 )
+    if ( iIndex == 0 )
     {
         m_hash = m_previousWrittenSampleID->getKey().digest;
     }
@@ -198,8 +300,118 @@ void SpwImpl::setSample( const void *iSamp )
         Util::SpookyHash::ShortEnd( m_hash.words[0], m_hash.words[1],
                                     digest.words[0], digest.words[1] );
     }
+}
 
-    m_header->nextSampleIndex ++;
+//-*****************************************************************************
+void SpwImpl::writePackedSamples( AwImpl * iArchive )
+{
+    if ( m_packedSamples.empty() )
+    {
+        return;
+    }
+
+    const AbcA::ArraySample::Key & key = m_previousWrittenSampleID->getKey();
+
+    // a single sample is written like any other, so that it can be shared
+    if ( m_packedSamples.size() == key.numBytes )
+    {
+        AbcA::ArraySample samp( &m_packedSamples.front(),
+                                m_header->header.getDataType(),
+                                AbcA::Dimensions( 1 ) );
+        WriteData( iArchive->getWrittenSampleMap(), m_group, samp, key );
+    }
+    else
+    {
+        m_group->addData( m_packedSamples.size(), &m_packedSamples.front() );
+        m_header->isPacked = true;
+        iArchive->requireFileVersion( 3 );
+    }
+
+    m_packedSamples.clear();
+}
+
+//-*****************************************************************************
+void SpwImpl::writeSnapshot( PropertyHeaderAndFriends & ioProp,
+                             Ogawa::SnapshotExtras & oExtras )
+{
+    if ( m_packedSamples.empty() )
+    {
+        return;
+    }
+
+    // unlike writePackedSamples a single sample stays packed, since it may
+    // be followed by more
+    oExtras[m_group.get()].push_back( m_group->createData(
+        m_packedSamples.size(), &m_packedSamples.front() ) );
+    ioProp.isPacked = true;
+
+    AwImpl * aw = dynamic_cast< AwImpl * >(
+        m_parent->getObject()->getArchive().get() );
+    if ( aw )
+    {
+        aw->requireFileVersion( 3 );
+    }
+}
+
+//-*****************************************************************************
+void SpwImpl::reopen( Ogawa::IGroupPtr iExisting )
+{
+    Util::uint64_t numStored = iExisting->getNumChildren();
+    if ( m_header->nextSampleIndex == 0 || numStored == 0 )
+    {
+        return;
+    }
+
+    AwImpl * aw = dynamic_cast< AwImpl * >(
+        m_parent->getObject()->getArchive().get() );
+    ABCA_ASSERT( aw, "NULL Impl Ptr" );
+
+    const AbcA::DataType & dataType = m_header->header.getDataType();
+
+    // packed samples are held onto again until we are done, anything else
+    // has to stay unpacked
+    m_pack = m_header->isPacked;
+    if ( m_pack )
+    {
+        Ogawa::IDataPtr data = iExisting->getData( 0, 0 );
+        ABCA_ASSERT( data && data->getSize() >= dataType.getNumBytes(),
+                     "Invalid packed samples" );
+
+        m_packedSamples.resize( data->getSize() );
+        data->read( data->getSize(), &m_packedSamples.front(), 0, 0 );
+
+        AbcA::ArraySample samp( &m_packedSamples[ m_packedSamples.size() -
+                                                  dataType.getNumBytes() ],
+                                dataType, AbcA::Dimensions( 1 ) );
+        m_previousWrittenSampleID.reset( new WrittenSampleID(
+            GetWrittenSampleKey( samp, aw->getSampleHashID() ),
+            Ogawa::ODataPtr(), 1 ) );
+    }
+    else
+    {
+        for ( Util::uint64_t i = 0; i + 1 < numStored; ++i )
+        {
+            m_group->addChild( iExisting, i );
+        }
+
+        // the last sample may need to be repeated, so we need its key
+        Ogawa::IDataPtr data = iExisting->getData( numStored - 1, 0 );
+        Ogawa::ODataPtr lastData = m_group->addData( data );
+
+        AbcA::ArraySamplePtr samp =
+            AbcA::AllocateArraySample( dataType, AbcA::Dimensions( 1 ) );
+        ReadData( const_cast< void * >( samp->getData() ), data, 0,
+                  dataType, dataType.getPod(), false );
+
+        m_previousWrittenSampleID.reset( new WrittenSampleID(
+            GetWrittenSampleKey( *samp, aw->getSampleHashID() ),
+            lastData, dataType.getExtent() ) );
+    }
+
+    // like properties that aren't reopened (see CpwData) the existing
+    // samples are hashed by where they are in the file
+    Util::uint64_t pos = iExisting->getPos();
+    Util::SpookyHash::Hash128( &pos, 8, &m_hash.words[0], &m_hash.words[1] );
 }
 
 //-*****************************************************************************
@@ -44,6 +44,8 @@ namespace Alembic {
 namespace AbcCoreOgawa {
 namespace ALEMBIC_VERSION_NS {
 
+class AwImpl;
+
 //-*****************************************************************************
 // Scalar Property Writer.
 class SpwImpl
@@ -52,6 +54,7 @@ class SpwImpl
 {
 protected:
     friend class CpwData;
+    friend class SpwWriteTask;
 
     //-*************************************************************************
     SpwImpl( AbcA::CompoundPropertyWriterPtr iParent,
@@ -80,6 +83,27 @@ protected:
     WrittenSampleIDPtr m_previousWrittenSampleID;
 
 private:
+    // Writes the sample set at iIndex, either right away or later from the
+    // archives write queue.
+    void writeSample( const AbcA::ArraySample & iSamp,
+                      const AbcA::ArraySample::Key & iKey,
+                      Util::uint32_t iIndex );
+
+    // Same as above but for setFromPreviousSample.
+    void writePreviousSample();
+
+    // Writes out the samples held onto in m_packedSamples.
+    void writePackedSamples( AwImpl * iArchive );
+
+    // For CpwData::writeSnapshot, adds the samples held onto in
+    // m_packedSamples to oExtras, and marks ioProp as packed.
+    void writeSnapshot( PropertyHeaderAndFriends & ioProp,
+                        Ogawa::SnapshotExtras & oExtras );
+
+    // For CpwData when appending, continues after the samples of the
+    // existing property in iExisting, which are referenced as they are.
+    void reopen( Ogawa::IGroupPtr iExisting );
+
     // The parent compound property writer.
     AbcA::CompoundPropertyWriterPtr m_parent;
 
@@ -93,6 +117,11 @@ private:
     Ogawa::OGroupPtr m_group;
 
     size_t m_index;
+
+    // whether the samples are held onto in m_packedSamples, to be written
+    // out as one data when we are done, instead of one data per sample
+    bool m_pack;
+    std::vector< Util::uint8_t > m_packedSamples;
 };
 
 } // End namespace ALEMBIC_VERSION_NS
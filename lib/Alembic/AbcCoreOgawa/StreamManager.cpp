@@ -42,123 +42,149 @@ namespace ALEMBIC_VERSION_NS {
 
 StreamManager::StreamManager( std::size_t iNumStreams )
 {
+    m_numStreams = iNumStreams;
+    if ( m_numStreams < 1 )
+    {
+        m_numStreams = 1;
+    }
+
+    m_statsEnabled = false;
+    m_numRequests = 0;
+    m_numShared = 0;
+
+    // ids we share when every stream is being used, since these aren't
+    // given back they don't have a manager
+    m_shared.resize( m_numStreams );
+    for ( std::size_t i = 0; i < m_numStreams; ++i )
+    {
+        m_shared[i] = StreamIDPtr( new StreamID( NULL, i ) );
+    }
+
+#ifdef ALEMBIC_STREAM_MANAGER_ATOMIC
+    m_nextShared = 0;
+    m_head = 0;
+
+    // only bother with the free list if we have more than 1 stream
+    // otherwise we can just share the one
+    if ( m_numStreams > 1 )
+    {
+        std::vector< std::atomic< Alembic::Util::uint32_t > >
+            next( m_numStreams );
+        m_next.swap( next );
 
-    m_streams = 0;
+        // stream 0 on top, stream 1 below it, etc
+        for ( std::size_t i = 0; i < m_numStreams; ++i )
+        {
+            m_next[i] = ( i + 2 > m_numStreams ) ? 0 : i + 2;
+        }
+        m_head = 1;
+    }
+#else
+    m_nextShared = 0;
     m_curStream = 0;
-    m_numStreams = iNumStreams;
 
-    // only do this if we have more than 1 stream
-    // otherwise we can just return default
-    if ( iNumStreams > 1 )
+    if ( m_numStreams > 1 )
     {
         m_streamIDs.resize( m_numStreams );
         for ( std::size_t i = 0; i < m_numStreams; ++i )
         {
             m_streamIDs[i] = i;
-            if ( m_numStreams < sizeof(m_streams) * 8 )
-            {
-                m_streams |= 1 << i;
-            }
         }
     }
-
-    m_default = StreamIDPtr( new StreamID( NULL, 0 ) );
+#endif
 }
 
 StreamManager::~StreamManager()
 {
 }
 
-#if !defined(__APPLE__) && defined(__GNUC__) && __GNUC__ >= 4 && __GNUC_MINOR__ >= 4
+#ifdef ALEMBIC_STREAM_MANAGER_ATOMIC
 
 StreamIDPtr StreamManager::get()
 {
-
-    if ( m_numStreams < 2 )
+    if ( m_statsEnabled )
     {
-        return m_default;
+        ++m_numRequests;
     }
 
-    // we've got too many streams so use the locking version
-    if ( m_numStreams > sizeof(m_streams) * 8 )
+    if ( m_numStreams < 2 )
     {
-        Alembic::Util::scoped_lock l( m_lock );
-
-        // we've used up more than we have, just return the default
-        if ( m_curStream >= m_numStreams )
+        if ( m_statsEnabled )
         {
-            return m_default;
+            ++m_numShared;
         }
-
-        return StreamIDPtr( new StreamID( this,
-            m_streamIDs[ m_curStream ++ ] ) );
+        return m_shared[0];
     }
 
-    // CAS (compare and swap) non locking version
-    Alembic::Util::int64_t val = 0;
-    Alembic::Util::int64_t oldVal = 0;
-    Alembic::Util::int64_t newVal = 0;
+    Alembic::Util::uint64_t oldHead = m_head.load();
+    Alembic::Util::uint64_t newHead = 0;
+    Alembic::Util::uint32_t top = 0;
 
     do
     {
-        oldVal = m_streams;
-        val = ffsll( oldVal );
+        top = ( Alembic::Util::uint32_t )( oldHead & 0xffffffff );
 
-        if ( val == 0 )
+        // everything is in use, share one
+        if ( top == 0 )
         {
-            return m_default;
+            if ( m_statsEnabled )
+            {
+                ++m_numShared;
+            }
+            return m_shared[ m_nextShared++ % m_numStreams ];
         }
 
-        newVal = oldVal & ~( 1 << (val - 1) );
+        newHead = ( ( ( oldHead >> 32 ) + 1 ) << 32 ) | m_next[ top - 1 ];
     }
-    while ( !__sync_bool_compare_and_swap( &m_streams, oldVal, newVal ) );
+    while ( !m_head.compare_exchange_weak( oldHead, newHead ) );
 
-    return StreamIDPtr( new StreamID( this, ( std::size_t ) val - 1 ) );
+    return StreamIDPtr( new StreamID( this, top - 1 ) );
 }
 
 void StreamManager::put( std::size_t iStreamID )
 {
-
-    // we've got too many streams so use the locking version
-    if ( m_numStreams > sizeof(m_streams) * 8 )
-    {
-        // shouldn't ever hit this case, it's why we have m_default
-        assert( iStreamID < m_numStreams && m_curStream > 0 );
-
-        Alembic::Util::scoped_lock l( m_lock );
-        m_streamIDs[ --m_curStream ] = iStreamID;
-        return;
-    }
-
-    // CAS (compare and swap) non locking version
-    Alembic::Util::int64_t oldVal = 0;
-    Alembic::Util::int64_t newVal = 0;
+    Alembic::Util::uint64_t oldHead = m_head.load();
+    Alembic::Util::uint64_t newHead = 0;
 
     do
     {
-        oldVal = m_streams;
-        newVal = oldVal | ( 1 << iStreamID );
-
+        m_next[ iStreamID ] =
+            ( Alembic::Util::uint32_t )( oldHead & 0xffffffff );
+        newHead = ( ( ( oldHead >> 32 ) + 1 ) << 32 ) | ( iStreamID + 1 );
     }
-    while ( !__sync_bool_compare_and_swap( &m_streams, oldVal, newVal ) );
+    while ( !m_head.compare_exchange_weak( oldHead, newHead ) );
 }
 
 #else
 
 StreamIDPtr StreamManager::get()
 {
-    // no need to lock
     if ( m_streamIDs.empty() )
     {
-        return m_default;
+        Alembic::Util::scoped_lock l( m_lock );
+        if ( m_statsEnabled )
+        {
+            ++m_numRequests;
+            ++m_numShared;
+        }
+        return m_shared[0];
     }
 
     Alembic::Util::scoped_lock l( m_lock );
 
-    // we've used up more than we have, just return the default
+    if ( m_statsEnabled )
+    {
+        ++m_numRequests;
+    }
+
+    // everything is in use, share one
     if ( m_curStream >= m_numStreams )
     {
-        return m_default;
+        if ( m_statsEnabled )
+        {
+            ++m_numShared;
+        }
+        return m_shared[ m_nextShared++ % m_numStreams ];
     }
 
     return StreamIDPtr( new StreamID( this, m_streamIDs[ m_curStream ++ ] ) );
@@ -166,7 +192,7 @@ StreamIDPtr StreamManager::get()
 
 void StreamManager::put( std::size_t iStreamID )
 {
-    // shouldn't ever hit this case, it's why we have m_default
+    // shouldn't ever hit this case, it's why we have m_shared
     assert( iStreamID < m_numStreams && m_curStream > 0 );
 
     Alembic::Util::scoped_lock l( m_lock );
@@ -175,6 +201,58 @@ void StreamManager::put( std::size_t iStreamID )
 
 #endif
 
+#ifdef ALEMBIC_STREAM_MANAGER_ATOMIC
+
+void StreamManager::setStatsEnabled( bool iEnabled )
+{
+    m_statsEnabled = iEnabled;
+}
+
+Alembic::Util::uint64_t StreamManager::getNumRequests()
+{
+    return m_numRequests.load();
+}
+
+Alembic::Util::uint64_t StreamManager::getNumShared()
+{
+    return m_numShared.load();
+}
+
+void StreamManager::resetStats()
+{
+    m_numRequests = 0;
+    m_numShared = 0;
+}
+
+#else
+
+void StreamManager::setStatsEnabled( bool iEnabled )
+{
+    Alembic::Util::scoped_lock l( m_lock );
+    m_statsEnabled = iEnabled;
+}
+
+Alembic::Util::uint64_t StreamManager::getNumRequests()
+{
+    Alembic::Util::scoped_lock l( m_lock );
+    return m_numRequests;
+}
+
+Alembic::Util::uint64_t StreamManager::getNumShared()
+{
+    Alembic::Util::scoped_lock l( m_lock );
+    return m_numShared;
+}
+
+void StreamManager::resetStats()
+{
+    Alembic::Util::scoped_lock l( m_lock );
+    m_numRequests = 0;
+    m_numShared = 0;
+}
+
+#endif
+
 StreamID::StreamID( StreamManager * iManager, std::size_t iStreamID ) :
     m_manager( iManager ), m_streamID( iStreamID )
 {
@@ -40,6 +40,13 @@
 #include <Alembic/AbcCoreOgawa/Foundation.h>
 #include <Alembic/Util/Foundation.h>
 
+#if ( defined( _MSC_VER ) && _MSC_VER > 1600 ) || \
+    ( !defined( _MSC_VER ) && \
+      ( defined( __GXX_EXPERIMENTAL_CXX0X__ ) || __cplusplus >= 201103L ) )
+#define ALEMBIC_STREAM_MANAGER_ATOMIC
+#include <atomic>
+#endif
+
 namespace Alembic {
 namespace AbcCoreOgawa {
 namespace ALEMBIC_VERSION_NS {
@@ -48,27 +55,54 @@ class StreamID;
 typedef Alembic::Util::shared_ptr< StreamID > StreamIDPtr;
 
 //-*****************************************************************************
+// Hands out the stream ids that readers use to read from the archive.
+// Free streams are handed out exclusively, once all of them are in use the
+// streams are shared round robin among the extra callers so that no single
+// stream ends up with all of the contention.
 class StreamManager : Alembic::Util::noncopyable
 {
 public:
     StreamManager( std::size_t iNumStreams );
     ~StreamManager();
     StreamIDPtr get();
+
+    // counting how many ids are handed out, and how many of those are
+    // shared, is off by default, it can be turned on or off while ids are
+    // being gotten on other threads
+    void setStatsEnabled( bool iEnabled );
+    Alembic::Util::uint64_t getNumRequests();
+    Alembic::Util::uint64_t getNumShared();
+    void resetStats();
+
 private:
     friend class StreamID;
     void put( std::size_t iStreamID );
 
     std::size_t m_numStreams;
 
-    // for the locked implementation
+    // shared (not given back) ids handed out when every stream is in use
+    std::vector< StreamIDPtr > m_shared;
+
+#ifdef ALEMBIC_STREAM_MANAGER_ATOMIC
+    // lock free stack of the free stream ids, the lower 32 bits of m_head
+    // hold the top stream id + 1 (0 when empty), and the upper 32 bits
+    // are bumped on every change to avoid the ABA problem
+    // m_next holds the id + 1 of the stream below each one on the stack
+    std::atomic< Alembic::Util::uint64_t > m_head;
+    std::vector< std::atomic< Alembic::Util::uint32_t > > m_next;
+    std::atomic< std::size_t > m_nextShared;
+    std::atomic< bool > m_statsEnabled;
+    std::atomic< Alembic::Util::uint64_t > m_numRequests;
+    std::atomic< Alembic::Util::uint64_t > m_numShared;
+#else
     std::vector< std::size_t > m_streamIDs;
     std::size_t m_curStream;
+    std::size_t m_nextShared;
+    bool m_statsEnabled;
+    Alembic::Util::uint64_t m_numRequests;
+    Alembic::Util::uint64_t m_numShared;
     Alembic::Util::mutex m_lock;
-
-    // for the CAS impl
-    Alembic::Util::int64_t m_streams;
-
-    StreamIDPtr m_default;
+#endif
 };
 
 //-*****************************************************************************
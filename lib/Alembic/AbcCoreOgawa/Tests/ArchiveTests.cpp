@@ -40,8 +40,12 @@
 
 #include <Alembic/AbcCoreAbstract/Tests/Assert.h>
 
+#include <algorithm>
+#include <atomic>
+#include <fstream>
 #include <iostream>
 #include <sstream>
+#include <thread>
 #include <vector>
 
 //-*****************************************************************************
@@ -383,6 +387,668 @@ void readVeryEmptyArchive( const std::string & iName )
     TESTING_ASSERT(a->getTop()->getNumChildren() == 0);
 }
 
+void writeAsyncArchive( std::ostream * iStream, std::size_t iNumThreads )
+{
+    ABCA::MetaData m;
+    AO::WriteArchive w(0, AO::kZlibCompression, iNumThreads);
+    ABCA::ArchiveWriterPtr a = w(iStream, m);
+
+    ABCA::DataType f32d(Alembic::Util::kFloat32POD, 3);
+    ABCA::DataType strd(Alembic::Util::kStringPOD, 1);
+    ABCA::DataType i32d(Alembic::Util::kInt32POD, 1);
+
+    std::vector< ABCA::ObjectWriterPtr > objs;
+    std::vector< ABCA::ArrayPropertyWriterPtr > arrays;
+    std::vector< ABCA::ScalarPropertyWriterPtr > scalars;
+    for (std::size_t i = 0; i < 20; ++i)
+    {
+        std::ostringstream name;
+        name << "obj" << i;
+        objs.push_back(a->getTop()->createChild(
+            ABCA::ObjectHeader(name.str(), m)));
+
+        ABCA::CompoundPropertyWriterPtr top = objs.back()->getProperties();
+
+        // every other object compresses its points
+        a->setCompressionHint(i % 2 == 0 ? -1 : 1);
+        arrays.push_back(top->createArrayProperty("P", m, f32d, 0));
+        arrays.push_back(top->createArrayProperty("names", m, strd, 0));
+        scalars.push_back(top->createScalarProperty("id", m, i32d, 0));
+    }
+
+    for (std::size_t frame = 0; frame < 10; ++frame)
+    {
+        for (std::size_t i = 0; i < objs.size(); ++i)
+        {
+            // objects with the same i % 5 share points, and every 3rd
+            // object only moves every 4th frame
+            std::size_t numPoints = 100 * (i % 5 + 1);
+            std::vector< float > points(numPoints * 3);
+            float offset = (i % 3 == 0) ? (frame / 4) : frame;
+            for (std::size_t j = 0; j < points.size(); ++j)
+            {
+                points[j] = j * 0.25f + offset;
+            }
+
+            if (i % 7 == 0 && frame > 0)
+            {
+                arrays[i * 2]->setFromPreviousSample();
+            }
+            else
+            {
+                arrays[i * 2]->setSample(ABCA::ArraySample(&points.front(),
+                    f32d, Alembic::Util::Dimensions(numPoints)));
+            }
+
+            std::vector< std::string > names(frame % 3);
+            for (std::size_t j = 0; j < names.size(); ++j)
+            {
+                names[j] = objs[i]->getName();
+            }
+            arrays[i * 2 + 1]->setSample(ABCA::ArraySample(
+                names.empty() ? NULL : &names.front(), strd,
+                Alembic::Util::Dimensions(names.size())));
+
+            Alembic::Util::int32_t id = i + frame / 5;
+            scalars[i]->setSample(&id);
+
+            // close some objects part way through, while samples from the
+            // others are still being written
+            if (frame == 5 && i % 4 == 0)
+            {
+                arrays[i * 2].reset();
+                arrays[i * 2 + 1].reset();
+                scalars[i].reset();
+                objs[i].reset();
+            }
+        }
+
+        // start finishing the rest off one by one
+        if (frame == 5)
+        {
+            objs.erase(std::remove(objs.begin(), objs.end(),
+                ABCA::ObjectWriterPtr()), objs.end());
+            arrays.erase(std::remove(arrays.begin(), arrays.end(),
+                ABCA::ArrayPropertyWriterPtr()), arrays.end());
+            scalars.erase(std::remove(scalars.begin(), scalars.end(),
+                ABCA::ScalarPropertyWriterPtr()), scalars.end());
+        }
+    }
+
+    TESTING_ASSERT(scalars[0]->getNumSamples() == 10);
+    TESTING_ASSERT(arrays[0]->getNumSamples() == 10);
+}
+
+void testAsyncWrite()
+{
+    std::stringstream syncStream;
+    writeAsyncArchive(&syncStream, 0);
+
+    // the file should be exactly the same no matter how many threads we use
+    for (std::size_t i = 1; i < 5; i += 3)
+    {
+        std::stringstream asyncStream;
+        writeAsyncArchive(&asyncStream, i);
+        TESTING_ASSERT(syncStream.str() == asyncStream.str());
+    }
+
+    std::vector< std::istream * > streamVec(1, &syncStream);
+    syncStream.seekg(0, syncStream.beg);
+    AO::ReadArchive r(streamVec);
+    ABCA::ArchiveReaderPtr a = r("");
+    TESTING_ASSERT(a->getTop()->getNumChildren() == 20);
+
+    // bad samples are reported by a later setSample, or right away if
+    // samples can't be written on other threads
+    ABCA::MetaData m;
+    std::stringstream badStream;
+    AO::WriteArchive w(0, AO::kZlibCompression, 2);
+    ABCA::ArchiveWriterPtr aw = w(&badStream, m);
+    ABCA::DataType strd(Alembic::Util::kStringPOD, 1);
+    ABCA::CompoundPropertyWriterPtr top = aw->getTop()->getProperties();
+    ABCA::ArrayPropertyWriterPtr prop =
+        top->createArrayProperty("bad", m, strd, 0);
+
+    bool threw = false;
+    try
+    {
+        std::string badStr("bad\0string", 10);
+        prop->setSample(ABCA::ArraySample(&badStr, strd,
+                                          Alembic::Util::Dimensions(1)));
+    }
+    catch (std::exception & e)
+    {
+        threw = true;
+    }
+
+    // waits for the bad sample to be written
+    prop.reset();
+
+    prop = top->createArrayProperty("good", m, strd, 0);
+    try
+    {
+        std::string str("good");
+        prop->setSample(ABCA::ArraySample(&str, strd,
+                                          Alembic::Util::Dimensions(1)));
+    }
+    catch (std::exception & e)
+    {
+        threw = true;
+    }
+    TESTING_ASSERT(threw);
+}
+
+void testFailedLastWrite()
+{
+    // nothing is pushed after the bad sample, so the error has to come from
+    // waiting for it to be written
+    ABCA::MetaData m;
+    std::stringstream strm;
+    bool threwFromCommit = false;
+    {
+        AO::WriteArchive w(0, AO::kZlibCompression, 2);
+        ABCA::ArchiveWriterPtr a = w(&strm, m);
+        ABCA::DataType strd(Alembic::Util::kStringPOD, 1);
+        ABCA::ArrayPropertyWriterPtr prop = a->getTop()->getProperties()->
+            createArrayProperty("names", m, strd, 0);
+
+        std::string str("good");
+        prop->setSample(ABCA::ArraySample(&str, strd,
+                                          Alembic::Util::Dimensions(1)));
+        TESTING_ASSERT(a->commit());
+
+        bool threw = false;
+        try
+        {
+            std::string badStr("bad\0string", 10);
+            prop->setSample(ABCA::ArraySample(&badStr, strd,
+                                              Alembic::Util::Dimensions(1)));
+        }
+        catch (std::exception & e)
+        {
+            threw = true;
+        }
+
+        // written on another thread
+        if (!threw)
+        {
+            try
+            {
+                a->commit();
+            }
+            catch (std::exception & e)
+            {
+                threw = true;
+                threwFromCommit = true;
+            }
+        }
+        TESTING_ASSERT(threw);
+
+        // nothing more can be committed once a write has failed
+        if (threwFromCommit)
+        {
+            TESTING_ASSERT(!a->commit());
+        }
+
+        // closing everything else doesn't throw
+        prop.reset();
+    }
+
+    // the archive was never finished, so readers only see the first commit
+    if (threwFromCommit)
+    {
+        std::vector< std::istream * > streamVec(1, &strm);
+        strm.seekg(0, strm.beg);
+        AO::ReadArchive r(streamVec);
+        ABCA::ArchiveReaderPtr a = r("");
+        ABCA::ArrayPropertyReaderPtr prop =
+            a->getTop()->getProperties()->getArrayProperty("names");
+        TESTING_ASSERT(prop->getNumSamples() == 1);
+    }
+}
+
+void writeLiveFrame( ABCA::ArrayPropertyWriterPtr iPoints,
+                     ABCA::ScalarPropertyWriterPtr iId, int32_t iFrame )
+{
+    std::vector< float > points( 30, ( float ) iFrame );
+    iPoints->setSample( ABCA::ArraySample( &points.front(),
+        ABCA::DataType( Alembic::Util::kFloat32POD, 3 ), Dimensions( 10 ) ) );
+    iId->setSample( &iFrame );
+}
+
+void checkLiveObject( ABCA::ObjectReaderPtr iObj, std::size_t iNumSamples )
+{
+    ABCA::CompoundPropertyReaderPtr props = iObj->getProperties();
+    TESTING_ASSERT( props->getNumProperties() == 3 );
+    TESTING_ASSERT( props->getCompoundProperty( "user" ) );
+
+    ABCA::ArrayPropertyReaderPtr points = props->getArrayProperty( "P" );
+    ABCA::ScalarPropertyReaderPtr id = props->getScalarProperty( "id" );
+    TESTING_ASSERT( points->getNumSamples() == iNumSamples );
+    TESTING_ASSERT( id->getNumSamples() == iNumSamples );
+
+    for ( std::size_t i = 0; i < iNumSamples; ++i )
+    {
+        ABCA::ArraySamplePtr samp;
+        points->getSample( i, samp );
+        TESTING_ASSERT( samp->getDimensions().numPoints() == 10 );
+        TESTING_ASSERT( ( ( const float * ) samp->getData() )[29] == i );
+
+        int32_t val = -1;
+        id->getSample( i, &val );
+        TESTING_ASSERT( val == ( int32_t ) i );
+    }
+}
+
+void testLiveRead()
+{
+    std::string archiveName = "liveRead.abc";
+    ABCA::MetaData m;
+
+    // with the scalar samples packed, and written on another thread
+    AO::WriteArchive w( 0, AO::kZlibCompression, 1, ABCA::kMurmur3SampleHash,
+                        false, false, true );
+    ABCA::ArchiveWriterPtr aw = w( archiveName, m );
+    aw->getTop()->createChild( ABCA::ObjectHeader( "closed", m ) );
+    ABCA::ObjectWriterPtr obj =
+        aw->getTop()->createChild( ABCA::ObjectHeader( "obj", m ) );
+    ABCA::CompoundPropertyWriterPtr props = obj->getProperties();
+    ABCA::ArrayPropertyWriterPtr points = props->createArrayProperty( "P", m,
+        ABCA::DataType( Alembic::Util::kFloat32POD, 3 ), 0 );
+    ABCA::ScalarPropertyWriterPtr id = props->createScalarProperty( "id", m,
+        ABCA::DataType( Alembic::Util::kInt32POD, 1 ), 0 );
+    ABCA::CompoundPropertyWriterPtr user =
+        props->createCompoundProperty( "user", m );
+
+    // nothing has been committed yet
+    bool threw = false;
+    try
+    {
+        AO::ReadArchive r;
+        r( archiveName );
+    }
+    catch ( std::exception & e )
+    {
+        threw = true;
+    }
+    TESTING_ASSERT( threw );
+
+    for ( int32_t i = 0; i < 3; ++i )
+    {
+        writeLiveFrame( points, id, i );
+    }
+    TESTING_ASSERT( aw->commit() );
+
+    AO::ReadArchive r;
+    ABCA::ArchiveReaderPtr ar = r( archiveName );
+    TESTING_ASSERT( ar->getTop()->getNumChildren() == 2 );
+    TESTING_ASSERT( ar->getTop()->getChildHeader( 0 ).getName() == "closed" );
+    ABCA::ObjectReaderPtr firstObj = ar->getTop()->getChild( "obj" );
+    checkLiveObject( firstObj, 3 );
+    TESTING_ASSERT( ar->getMaxNumSamplesForTimeSamplingIndex( 0 ) == 3 );
+    TESTING_ASSERT( !ar->refresh() );
+
+    for ( int32_t i = 3; i < 5; ++i )
+    {
+        writeLiveFrame( points, id, i );
+    }
+    aw->getTop()->createChild( ABCA::ObjectHeader( "late", m ) );
+    TESTING_ASSERT( aw->commit() );
+
+    TESTING_ASSERT( ar->refresh() );
+    TESTING_ASSERT( ar->getTop()->getNumChildren() == 3 );
+    checkLiveObject( ar->getTop()->getChild( "obj" ), 5 );
+    TESTING_ASSERT( ar->getMaxNumSamplesForTimeSamplingIndex( 0 ) == 5 );
+
+    // what was already read doesn't change
+    checkLiveObject( firstObj, 3 );
+
+    user.reset();
+    id.reset();
+    points.reset();
+    props.reset();
+    obj.reset();
+    aw.reset();
+
+    TESTING_ASSERT( ar->refresh() );
+    TESTING_ASSERT( !ar->refresh() );
+    TESTING_ASSERT( ar->getTop()->getNumChildren() == 3 );
+    checkLiveObject( ar->findObject( "/obj" ), 5 );
+}
+
+void walkLiveArchive( ABCA::ArchiveReaderPtr iArchive,
+                      const std::atomic< bool > * iStop )
+{
+    while ( !*iStop )
+    {
+        ABCA::ObjectReaderPtr top = iArchive->getTop();
+        ABCA::ObjectReaderPtr obj = top->getChild( "obj" );
+        checkLiveObject( obj, obj->getProperties()->getArrayProperty( "P" )->
+            getNumSamples() );
+
+        // frame i has its own time sampling, whose time per cycle is i
+        for ( std::size_t i = 1; i < top->getNumChildren(); ++i )
+        {
+            ABCA::ObjectReaderPtr child = top->getChild( i );
+            std::ostringstream frame;
+            frame << i;
+            TESTING_ASSERT( child->getMetaData().get( "frame" ) ==
+                            frame.str() );
+
+            ABCA::ScalarPropertyReaderPtr prop =
+                child->getProperties()->getScalarProperty( "frame" );
+            TESTING_ASSERT( prop->getTimeSampling()->getTimeSamplingType().
+                            getTimePerCycle() == ( chrono_t ) i );
+
+            int32_t val = -1;
+            prop->getSample( 0, &val );
+            TESTING_ASSERT( val == ( int32_t ) i );
+        }
+
+        Alembic::Util::uint32_t numSamplings =
+            iArchive->getNumTimeSamplings();
+        TESTING_ASSERT( iArchive->getTimeSampling( numSamplings - 1 ) );
+        TESTING_ASSERT( iArchive->getMaxNumSamplesForTimeSamplingIndex(
+            numSamplings - 1 ) >= 0 );
+        TESTING_ASSERT( iArchive->findObject( "/obj" ) );
+    }
+}
+
+void testConcurrentRefresh()
+{
+    std::string archiveName = "concurrentRefresh.abc";
+    ABCA::MetaData m;
+
+    AO::WriteArchive w;
+    ABCA::ArchiveWriterPtr aw = w( archiveName, m );
+    ABCA::ObjectWriterPtr obj =
+        aw->getTop()->createChild( ABCA::ObjectHeader( "obj", m ) );
+    ABCA::CompoundPropertyWriterPtr props = obj->getProperties();
+    ABCA::ArrayPropertyWriterPtr points = props->createArrayProperty( "P", m,
+        ABCA::DataType( Alembic::Util::kFloat32POD, 3 ), 0 );
+    ABCA::ScalarPropertyWriterPtr id = props->createScalarProperty( "id", m,
+        ABCA::DataType( Alembic::Util::kInt32POD, 1 ), 0 );
+    ABCA::CompoundPropertyWriterPtr user =
+        props->createCompoundProperty( "user", m );
+
+    writeLiveFrame( points, id, 0 );
+    TESTING_ASSERT( aw->commit() );
+
+    AO::ReadArchive r( 2 );
+    ABCA::ArchiveReaderPtr ar = r( archiveName );
+
+    // every commit adds an object with new indexed meta data and a new time
+    // sampling, which are refreshed while the other thread reads
+    std::atomic< bool > stop( false );
+    std::thread walker( walkLiveArchive, ar, &stop );
+    for ( int32_t i = 1; i < 50; ++i )
+    {
+        writeLiveFrame( points, id, i );
+
+        std::ostringstream name;
+        name << "frame" << i;
+        ABCA::MetaData frameMeta;
+        std::ostringstream frame;
+        frame << i;
+        frameMeta.set( "frame", frame.str() );
+        ABCA::ObjectWriterPtr child = aw->getTop()->createChild(
+            ABCA::ObjectHeader( name.str(), frameMeta ) );
+
+        Alembic::Util::uint32_t tsIndex =
+            aw->addTimeSampling( ABCA::TimeSampling( i, 0.0 ) );
+        ABCA::ScalarPropertyWriterPtr prop =
+            child->getProperties()->createScalarProperty( "frame", m,
+                ABCA::DataType( Alembic::Util::kInt32POD, 1 ), tsIndex );
+        prop->setSample( &i );
+
+        TESTING_ASSERT( aw->commit() );
+        TESTING_ASSERT( ar->refresh() );
+    }
+
+    stop = true;
+    walker.join();
+}
+
+void checkAppendedObject( ABCA::ObjectReaderPtr iObj, std::size_t iNumSamples )
+{
+    ABCA::CompoundPropertyReaderPtr props = iObj->getProperties();
+    ABCA::ArrayPropertyReaderPtr points = props->getArrayProperty( "P" );
+    ABCA::ScalarPropertyReaderPtr id = props->getScalarProperty( "id" );
+    ABCA::ScalarPropertyReaderPtr still = props->getScalarProperty( "still" );
+    ABCA::ScalarPropertyReaderPtr userId =
+        props->getCompoundProperty( "user" )->getScalarProperty( "id" );
+    TESTING_ASSERT( points->getNumSamples() == iNumSamples );
+    TESTING_ASSERT( id->getNumSamples() == iNumSamples );
+    TESTING_ASSERT( userId->getNumSamples() == iNumSamples );
+    TESTING_ASSERT( still->getNumSamples() == 1 );
+
+    for ( std::size_t i = 0; i < iNumSamples; ++i )
+    {
+        ABCA::ArraySamplePtr samp;
+        points->getSample( i, samp );
+        TESTING_ASSERT( samp->getDimensions().numPoints() == 10 );
+        TESTING_ASSERT( ( ( const float * ) samp->getData() )[29] == i );
+
+        int32_t val = -1;
+        id->getSample( i, &val );
+        TESTING_ASSERT( val == ( int32_t ) i );
+
+        val = -1;
+        userId->getSample( i, &val );
+        TESTING_ASSERT( val == ( int32_t ) i * 2 );
+    }
+
+    int32_t val = -1;
+    still->getSample( 0, &val );
+    TESTING_ASSERT( val == 42 );
+}
+
+void testAppend( bool iPack )
+{
+    std::string archiveName = "append.abc";
+    ABCA::MetaData m;
+    m.set( "potato", "salad" );
+
+    AO::WriteArchive w( 0, AO::kZlibCompression, 0, ABCA::kMurmur3SampleHash,
+                        false, false, iPack );
+    {
+        ABCA::ArchiveWriterPtr aw = w( archiveName, m );
+        ABCA::ObjectWriterPtr other =
+            aw->getTop()->createChild( ABCA::ObjectHeader( "other", m ) );
+        other->createChild( ABCA::ObjectHeader( "otherChild", m ) );
+        ABCA::ObjectWriterPtr obj =
+            aw->getTop()->createChild( ABCA::ObjectHeader( "obj", m ) );
+        ABCA::CompoundPropertyWriterPtr props = obj->getProperties();
+        ABCA::ArrayPropertyWriterPtr points = props->createArrayProperty( "P",
+            m, ABCA::DataType( Alembic::Util::kFloat32POD, 3 ), 0 );
+        ABCA::ScalarPropertyWriterPtr id = props->createScalarProperty( "id",
+            m, ABCA::DataType( Alembic::Util::kInt32POD, 1 ), 0 );
+        ABCA::ScalarPropertyWriterPtr still = props->createScalarProperty(
+            "still", m, ABCA::DataType( Alembic::Util::kInt32POD, 1 ), 0 );
+        ABCA::ScalarPropertyWriterPtr userId =
+            props->createCompoundProperty( "user", m )->createScalarProperty(
+                "id", m, ABCA::DataType( Alembic::Util::kInt32POD, 1 ), 0 );
+
+        int32_t val = 42;
+        still->setSample( &val );
+        for ( int32_t i = 0; i < 3; ++i )
+        {
+            writeLiveFrame( points, id, i );
+            val = i * 2;
+            userId->setSample( &val );
+        }
+    }
+
+    // only an Ogawa archive can be appended to
+    {
+        std::ofstream notAbc( "notAnArchive.abc" );
+        notAbc << "this is not an archive";
+    }
+    TESTING_ASSERT_THROW( w.append( "notAnArchive.abc" ),
+                          Alembic::Util::Exception );
+
+    {
+        ABCA::ArchiveWriterPtr aw = w.append( archiveName );
+        TESTING_ASSERT( aw->getMetaData().get( "potato" ) == "salad" );
+        TESTING_ASSERT( aw->getMaxNumSamplesForTimeSamplingIndex( 0 ) == 3 );
+
+        ABCA::ObjectWriterPtr top = aw->getTop();
+        TESTING_ASSERT( top->getNumChildren() == 2 );
+        TESTING_ASSERT( top->getChildHeader( 1 ).getName() == "obj" );
+        TESTING_ASSERT_THROW(
+            top->createChild( ABCA::ObjectHeader( "obj", m ) ),
+            Alembic::Util::Exception );
+
+        ABCA::ObjectWriterPtr obj = top->getChild( "obj" );
+        TESTING_ASSERT( obj && obj->getFullName() == "/obj" );
+        TESTING_ASSERT( top->getChild( "obj" ) == obj );
+
+        ABCA::CompoundPropertyWriterPtr props = obj->getProperties();
+        TESTING_ASSERT( props->getNumProperties() == 4 );
+        TESTING_ASSERT_THROW( props->createScalarProperty( "id", m,
+            ABCA::DataType( Alembic::Util::kInt32POD, 1 ), 0 ),
+            Alembic::Util::Exception );
+
+        ABCA::ArrayPropertyWriterPtr points =
+            Alembic::Util::dynamic_pointer_cast< ABCA::ArrayPropertyWriter >(
+                props->getProperty( "P" ) );
+        ABCA::ScalarPropertyWriterPtr id =
+            Alembic::Util::dynamic_pointer_cast< ABCA::ScalarPropertyWriter >(
+                props->getProperty( "id" ) );
+        ABCA::CompoundPropertyWriterPtr user =
+            Alembic::Util::dynamic_pointer_cast< ABCA::CompoundPropertyWriter >(
+                props->getProperty( "user" ) );
+        TESTING_ASSERT( points && id && user );
+        ABCA::ScalarPropertyWriterPtr userId =
+            Alembic::Util::dynamic_pointer_cast< ABCA::ScalarPropertyWriter >(
+                user->getProperty( "id" ) );
+        TESTING_ASSERT( userId );
+        TESTING_ASSERT( points->getNumSamples() == 3 );
+        TESTING_ASSERT( id->getNumSamples() == 3 );
+
+        for ( int32_t i = 3; i < 5; ++i )
+        {
+            writeLiveFrame( points, id, i );
+            int32_t val = i * 2;
+            userId->setSample( &val );
+        }
+        TESTING_ASSERT( points->getNumSamples() == 5 );
+
+        top->createChild( ABCA::ObjectHeader( "late", m ) );
+
+        // readers see the archive as it was until we are done
+        AO::ReadArchive r;
+        ABCA::ArchiveReaderPtr ar = r( archiveName );
+        TESTING_ASSERT( ar->getTop()->getNumChildren() == 2 );
+        checkAppendedObject( ar->getTop()->getChild( "obj" ), 3 );
+    }
+
+    AO::ReadArchive r;
+    ABCA::ArchiveReaderPtr ar = r( archiveName );
+    TESTING_ASSERT( ar->getTop()->getNumChildren() == 3 );
+    TESTING_ASSERT( ar->getTop()->getChildHeader( 2 ).getName() == "late" );
+    TESTING_ASSERT( ar->getTop()->getHeader().getMetaData().get( "potato" ) ==
+                    "salad" );
+    TESTING_ASSERT( ar->getMaxNumSamplesForTimeSamplingIndex( 0 ) == 5 );
+    checkAppendedObject( ar->getTop()->getChild( "obj" ), 5 );
+
+    ABCA::ObjectReaderPtr other = ar->getTop()->getChild( "other" );
+    TESTING_ASSERT( other->getNumChildren() == 1 );
+    TESTING_ASSERT( other->getChildHeader( 0 ).getName() == "otherChild" );
+    TESTING_ASSERT(
+        other->getChildHeader( 0 ).getMetaData().get( "potato" ) == "salad" );
+}
+
+//-*****************************************************************************
+void testStats()
+{
+    {
+        ABCA::MetaData m;
+        AO::WriteArchive w;
+        ABCA::ArchiveWriterPtr a = w( "stats.abc", m );
+        ABCA::ObjectWriterPtr obj =
+            a->getTop()->createChild( ABCA::ObjectHeader( "a", m ) );
+        obj->createChild( ABCA::ObjectHeader( "b", m ) );
+
+        ABCA::CompoundPropertyWriterPtr props = obj->getProperties();
+        ABCA::DataType i32d( Alembic::Util::kInt32POD, 1 );
+        ABCA::ArrayPropertyWriterPtr array =
+            props->createArrayProperty( "array", m, i32d, 0 );
+        ABCA::ScalarPropertyWriterPtr scalar =
+            props->createCompoundProperty( "user", m )->
+                createScalarProperty( "scalar", m, i32d, 0 );
+
+        std::vector< int32_t > vals( 100, 7 );
+        array->setSample( ABCA::ArraySample( &vals.front(), i32d,
+                                             Dimensions( vals.size() ) ) );
+        scalar->setSample( &vals.front() );
+    }
+
+    AO::ReadArchive r( 2 );
+    ABCA::ArchiveReaderPtr a = r( "stats.abc" );
+
+    // nothing is counted until it is turned on
+    ABCA::ReadStats stats;
+    a->getTop()->getChild( 0 );
+    TESTING_ASSERT( a->getStats( stats ) );
+    TESTING_ASSERT( stats.numReads == 0 && stats.streams.size() == 2 );
+
+    a->setStatsEnabled( true );
+    a->setTraceEnabled( true );
+
+    ABCA::ObjectReaderPtr obj = a->getTop()->getChild( 0 );
+    ABCA::CompoundPropertyReaderPtr props = obj->getProperties();
+    ABCA::ArraySamplePtr samp;
+    props->getArrayProperty( "array" )->getSample( 0, samp );
+    TESTING_ASSERT( samp->size() == 100 );
+    int32_t val = 0;
+    props->getCompoundProperty( "user" )->getScalarProperty( "scalar" )->
+        getSample( 0, &val );
+    TESTING_ASSERT( val == 7 );
+
+    TESTING_ASSERT( a->getStats( stats ) );
+    TESTING_ASSERT( stats.streams.size() == 2 );
+    TESTING_ASSERT( stats.numReads > 0 );
+    TESTING_ASSERT( stats.numReads == stats.streams[0].numReads +
+                    stats.streams[1].numReads );
+    TESTING_ASSERT( stats.numBytes == stats.streams[0].numBytes +
+                    stats.streams[1].numBytes );
+    TESTING_ASSERT( stats.numMappedReads == 0 );
+    TESTING_ASSERT( stats.objectHeaderBytes > 0 );
+    TESTING_ASSERT( stats.propertyBytes[ABCA::kCompoundProperty] > 0 );
+
+    // samples are stored after their 16 byte key
+    TESTING_ASSERT( stats.propertyBytes[ABCA::kScalarProperty] == 20 );
+    TESTING_ASSERT( stats.propertyBytes[ABCA::kArrayProperty] >= 400 );
+    TESTING_ASSERT( stats.numBytes >= stats.objectHeaderBytes +
+                    stats.propertyBytes[ABCA::kCompoundProperty] +
+                    stats.propertyBytes[ABCA::kScalarProperty] +
+                    stats.propertyBytes[ABCA::kArrayProperty] );
+
+    // one reader at a time never has to share a stream
+    TESTING_ASSERT( stats.numStreamRequests > 0 );
+    TESTING_ASSERT( stats.numSharedStreams == 0 );
+
+    // one trace event for every read
+    std::ostringstream trace;
+    TESTING_ASSERT( a->writeTrace( trace ) );
+    std::size_t numEvents = 0;
+    std::size_t pos = trace.str().find( "\"ph\":\"X\"" );
+    while ( pos != std::string::npos )
+    {
+        ++numEvents;
+        pos = trace.str().find( "\"ph\":\"X\"", pos + 1 );
+    }
+    TESTING_ASSERT( numEvents == stats.numReads );
+
+    a->resetStats();
+    TESTING_ASSERT( a->getStats( stats ) );
+    TESTING_ASSERT( stats.numReads == 0 && stats.numBytes == 0 );
+    TESTING_ASSERT( stats.streams.size() == 2 );
+    TESTING_ASSERT( stats.propertyBytes[ABCA::kArrayProperty] == 0 );
+    TESTING_ASSERT( stats.numStreamRequests == 0 );
+}
+
 int main ( int argc, char *argv[] )
 {
     testReadWriteEmptyArchive();
@@ -401,5 +1067,18 @@ int main ( int argc, char *argv[] )
 
     testReadWriteMaxNumSamplesArchive();
 
+    testAsyncWrite();
+
+    testFailedLastWrite();
+
+    testLiveRead();
+
+    testConcurrentRefresh();
+
+    testAppend( false );
+    testAppend( true );
+
+    testStats();
+
     return 0;
 }
@@ -40,7 +40,10 @@
 
 #include <Alembic/AbcCoreAbstract/Tests/Assert.h>
 
+#include <fstream>
 #include <iostream>
+#include <sstream>
+#include <thread>
 #include <vector>
 
 
@@ -1867,6 +1870,895 @@ void testArraySamples()
     }
 }
 
+void testMappedArraySamples()
+{
+    std::string archiveName = "mappedArray.abc";
+    {
+        AO::WriteArchive w;
+        ABCA::ArchiveWriterPtr a = w(archiveName, ABCA::MetaData());
+        ABCA::CompoundPropertyWriterPtr parent = a->getTop()->getProperties();
+
+        ABCA::DataType i8d(Alembic::Util::kInt8POD, 1);
+        ABCA::DataType f32d(Alembic::Util::kFloat32POD, 3);
+        ABCA::DataType f64d(Alembic::Util::kFloat64POD, 1);
+
+        ABCA::ArrayPropertyWriterPtr i8wp =
+            parent->createArrayProperty("i8", ABCA::MetaData(), i8d, 0);
+        ABCA::ArrayPropertyWriterPtr f32wp =
+            parent->createArrayProperty("f32", ABCA::MetaData(), f32d, 0);
+        ABCA::ArrayPropertyWriterPtr f64wp =
+            parent->createArrayProperty("f64", ABCA::MetaData(), f64d, 0);
+
+        // vary the sizes so the data lands on different alignments
+        for (std::size_t i = 1; i < 10; ++i)
+        {
+            std::vector< Alembic::Util::int8_t > vali8(i);
+            std::vector< Alembic::Util::float32_t > valf32(i * 3);
+            std::vector< Alembic::Util::float64_t > valf64(i);
+            for (std::size_t j = 0; j < i; ++j)
+            {
+                vali8[j] = i + j;
+                valf32[j * 3] = i * 10.0f + j;
+                valf32[j * 3 + 1] = i * 20.0f + j;
+                valf32[j * 3 + 2] = i * 30.0f + j;
+                valf64[j] = i * 100.0 + j;
+            }
+
+            i8wp->setSample(ABCA::ArraySample(&(vali8.front()), i8d,
+                                              Dimensions(i)));
+            f32wp->setSample(ABCA::ArraySample(&(valf32.front()), f32d,
+                                               Dimensions(i)));
+            f64wp->setSample(ABCA::ArraySample(&(valf64.front()), f64d,
+                                               Dimensions(i)));
+        }
+    }
+
+    ABCA::ArraySamplePtr heldSamp;
+    {
+        AO::ReadArchive r(1, true);
+        ABCA::ArchiveReaderPtr a = r(archiveName);
+        ABCA::CompoundPropertyReaderPtr parent = a->getTop()->getProperties();
+
+        ABCA::ArrayPropertyReaderPtr i8rp = parent->getArrayProperty("i8");
+        ABCA::ArrayPropertyReaderPtr f32rp = parent->getArrayProperty("f32");
+        ABCA::ArrayPropertyReaderPtr f64rp = parent->getArrayProperty("f64");
+        TESTING_ASSERT(i8rp->getNumSamples() == 9);
+        TESTING_ASSERT(f32rp->getNumSamples() == 9);
+        TESTING_ASSERT(f64rp->getNumSamples() == 9);
+
+        for (std::size_t i = 1; i < 10; ++i)
+        {
+            ABCA::ArraySamplePtr samp;
+            i8rp->getSample(i - 1, samp);
+            TESTING_ASSERT(samp->size() == i);
+            const Alembic::Util::int8_t * i8 =
+                (const Alembic::Util::int8_t *) samp->getData();
+
+            // 1 byte data is always aligned so we should be pointing at
+            // the mapped data instead of a copy
+            ABCA::ArraySamplePtr samp2;
+            i8rp->getSample(i - 1, samp2);
+            TESTING_ASSERT(samp->getData() == samp2->getData());
+
+            f32rp->getSample(i - 1, samp);
+            TESTING_ASSERT(samp->size() == i);
+            const Alembic::Util::float32_t * f32 =
+                (const Alembic::Util::float32_t *) samp->getData();
+
+            f64rp->getSample(i - 1, samp2);
+            TESTING_ASSERT(samp2->size() == i);
+            const Alembic::Util::float64_t * f64 =
+                (const Alembic::Util::float64_t *) samp2->getData();
+
+            for (std::size_t j = 0; j < i; ++j)
+            {
+                TESTING_ASSERT(i8[j] == (Alembic::Util::int8_t)(i + j));
+                TESTING_ASSERT(f32[j * 3] == i * 10.0f + j);
+                TESTING_ASSERT(f32[j * 3 + 1] == i * 20.0f + j);
+                TESTING_ASSERT(f32[j * 3 + 2] == i * 30.0f + j);
+                TESTING_ASSERT(f64[j] == i * 100.0 + j);
+            }
+        }
+
+        f64rp->getSample(8, heldSamp);
+    }
+
+    // the sample should keep the mapped data alive after the archive is gone
+    const Alembic::Util::float64_t * f64 =
+        (const Alembic::Util::float64_t *) heldSamp->getData();
+    for (std::size_t j = 0; j < 9; ++j)
+    {
+        TESTING_ASSERT(f64[j] == 900.0 + j);
+    }
+}
+
+//-*****************************************************************************
+void testArraySampleCache()
+{
+    std::string archiveName = "arraySampleCache.abc";
+    {
+        AO::WriteArchive w;
+        ABCA::ArchiveWriterPtr a = w(archiveName, ABCA::MetaData());
+        ABCA::CompoundPropertyWriterPtr parent = a->getTop()->getProperties();
+
+        ABCA::DataType i32d(Alembic::Util::kInt32POD, 1);
+        ABCA::DataType i32x2d(Alembic::Util::kInt32POD, 2);
+
+        ABCA::ArrayPropertyWriterPtr awp =
+            parent->createArrayProperty("a", ABCA::MetaData(), i32d, 0);
+        ABCA::ArrayPropertyWriterPtr bwp =
+            parent->createArrayProperty("b", ABCA::MetaData(), i32d, 0);
+        ABCA::ArrayPropertyWriterPtr cwp =
+            parent->createArrayProperty("c", ABCA::MetaData(), i32x2d, 0);
+
+        std::vector< Alembic::Util::int32_t > vals(16);
+        for (std::size_t i = 0; i < vals.size(); ++i)
+        {
+            vals[i] = i;
+        }
+
+        // a and b share their samples, c has the same bytes as the
+        // first sample, but different dimensions
+        awp->setSample(ABCA::ArraySample(&(vals.front()), i32d,
+                                         Dimensions(16)));
+        awp->setSample(ABCA::ArraySample(&(vals.front()), i32d,
+                                         Dimensions(8)));
+        bwp->setSample(ABCA::ArraySample(&(vals.front()), i32d,
+                                         Dimensions(16)));
+        cwp->setSample(ABCA::ArraySample(&(vals.front()), i32x2d,
+                                         Dimensions(8)));
+    }
+
+    // enough room for the 16 int sample, but not also the 8 int one
+    ABCA::ReadArraySampleCachePtr cache = AO::CreateCache(90);
+
+    AO::ReadArchive r;
+    ABCA::ArchiveReaderPtr a = r(archiveName, cache);
+    TESTING_ASSERT(a->getReadArraySampleCachePtr() == cache);
+
+    ABCA::CompoundPropertyReaderPtr parent = a->getTop()->getProperties();
+    ABCA::ArrayPropertyReaderPtr arp = parent->getArrayProperty("a");
+    ABCA::ArrayPropertyReaderPtr brp = parent->getArrayProperty("b");
+    ABCA::ArrayPropertyReaderPtr crp = parent->getArrayProperty("c");
+
+    ABCA::ArraySamplePtr a0, a1, b0, c0;
+    arp->getSample(0, a0);
+    brp->getSample(0, b0);
+
+    // identical samples should be shared
+    TESTING_ASSERT(a0 == b0);
+    TESTING_ASSERT(a0->size() == 16);
+
+    // even across archives that use the same cache
+    {
+        ABCA::ArchiveReaderPtr a2 = r(archiveName, cache);
+        ABCA::ArraySamplePtr samp;
+        a2->getTop()->getProperties()->getArrayProperty("b")->getSample(0,
+            samp);
+        TESTING_ASSERT(samp == a0);
+    }
+
+    // same bytes, but different dimensions
+    crp->getSample(0, c0);
+    TESTING_ASSERT(c0 != a0);
+    TESTING_ASSERT(c0->size() == 8);
+    TESTING_ASSERT(c0->getDataType().getExtent() == 2);
+    const Alembic::Util::int32_t * cdata =
+        (const Alembic::Util::int32_t *) c0->getData();
+    for (std::size_t i = 0; i < 16; ++i)
+    {
+        TESTING_ASSERT(cdata[i] == (Alembic::Util::int32_t) i);
+    }
+
+    // there isn't room for both samples, so the least recently used
+    // bigger one should get released by the cache
+    arp->getSample(1, a1);
+    TESTING_ASSERT(a1->size() == 8);
+
+    ABCA::ArraySamplePtr samp;
+    arp->getSample(0, samp);
+    TESTING_ASSERT(samp != a0);
+
+    // but what we are holding onto should still be fine
+    const Alembic::Util::int32_t * adata =
+        (const Alembic::Util::int32_t *) a0->getData();
+    const Alembic::Util::int32_t * sampdata =
+        (const Alembic::Util::int32_t *) samp->getData();
+    for (std::size_t i = 0; i < 16; ++i)
+    {
+        TESTING_ASSERT(adata[i] == (Alembic::Util::int32_t) i);
+        TESTING_ASSERT(sampdata[i] == (Alembic::Util::int32_t) i);
+    }
+
+    // no cache, no sharing
+    ABCA::ArchiveReaderPtr nocache = r(archiveName);
+    TESTING_ASSERT(!nocache->getReadArraySampleCachePtr());
+    parent = nocache->getTop()->getProperties();
+    parent->getArrayProperty("a")->getSample(0, a0);
+    parent->getArrayProperty("b")->getSample(0, b0);
+    TESTING_ASSERT(a0 != b0);
+}
+
+//-*****************************************************************************
+void writeCompressionArchive(const std::string & iArchiveName,
+                             Alembic::Util::int8_t iHint,
+                             AO::CompressionCodec iCodec)
+{
+    AO::WriteArchive w(0, iCodec);
+    ABCA::ArchiveWriterPtr a = w(iArchiveName, ABCA::MetaData());
+    ABCA::CompoundPropertyWriterPtr parent = a->getTop()->getProperties();
+
+    ABCA::DataType f32d(Alembic::Util::kFloat32POD, 3);
+    ABCA::DataType i16d(Alembic::Util::kInt16POD, 1);
+    ABCA::DataType strd(Alembic::Util::kStringPOD, 1);
+    ABCA::DataType wstrd(Alembic::Util::kWstringPOD, 1);
+
+    // written before compression is turned on, so never compressed
+    ABCA::ArrayPropertyWriterPtr rawwp =
+        parent->createArrayProperty("raw", ABCA::MetaData(), i16d, 0);
+
+    std::vector< Alembic::Util::int16_t > vali16(1000);
+    for (std::size_t i = 0; i < vali16.size(); ++i)
+    {
+        vali16[i] = i % 10;
+    }
+    rawwp->setSample(ABCA::ArraySample(&vali16.front(), i16d,
+                                       Dimensions(vali16.size())));
+
+    a->setCompressionHint(iHint);
+
+    ABCA::ArrayPropertyWriterPtr f32wp =
+        parent->createArrayProperty("f32", ABCA::MetaData(), f32d, 0);
+    ABCA::ArrayPropertyWriterPtr i16wp =
+        parent->createArrayProperty("i16", ABCA::MetaData(), i16d, 0);
+    ABCA::ArrayPropertyWriterPtr strwp =
+        parent->createArrayProperty("str", ABCA::MetaData(), strd, 0);
+    ABCA::ArrayPropertyWriterPtr wstrwp =
+        parent->createArrayProperty("wstr", ABCA::MetaData(), wstrd, 0);
+
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        std::vector< Alembic::Util::float32_t > valf32(3000);
+        for (std::size_t j = 0; j < valf32.size(); ++j)
+        {
+            valf32[j] = (j / 3) * 0.5f + i;
+        }
+
+        // multidimensional, with a repeated sample
+        Dimensions dims;
+        dims.setRank(2);
+        dims[0] = 100;
+        dims[1] = 10;
+        if (i == 2)
+        {
+            valf32[0] = 0.0f;
+        }
+
+        f32wp->setSample(ABCA::ArraySample(&valf32.front(), f32d, dims));
+    }
+
+    // the same data as the raw property, and a tiny sample that won't
+    // compress
+    i16wp->setSample(ABCA::ArraySample(&vali16.front(), i16d,
+                                       Dimensions(vali16.size())));
+    i16wp->setSample(ABCA::ArraySample(&vali16.front(), i16d,
+                                       Dimensions(1)));
+    i16wp->setSample(ABCA::ArraySample(&vali16.front(), i16d,
+                                       Dimensions(0)));
+
+    std::vector< std::string > valstr(100);
+    std::vector< std::wstring > valwstr(100);
+    for (std::size_t i = 0; i < valstr.size(); ++i)
+    {
+        valstr[i] = (i % 3 == 0) ? "" : "potato salad";
+        valwstr[i] = (i % 4 == 0) ? L"" : L"lots of potatoes";
+    }
+
+    strwp->setSample(ABCA::ArraySample(&valstr.front(), strd,
+                                       Dimensions(valstr.size())));
+    wstrwp->setSample(ABCA::ArraySample(&valwstr.front(), wstrd,
+                                        Dimensions(valwstr.size())));
+}
+
+//-*****************************************************************************
+void readCompressionArchive(const std::string & iArchiveName,
+                            ABCA::ArchiveReaderPtr iReference)
+{
+    for (std::size_t m = 0; m < 2; ++m)
+    {
+        AO::ReadArchive r(1, m == 1);
+        ABCA::ArchiveReaderPtr a = r(iArchiveName);
+        ABCA::CompoundPropertyReaderPtr parent = a->getTop()->getProperties();
+        ABCA::CompoundPropertyReaderPtr refParent =
+            iReference->getTop()->getProperties();
+
+        TESTING_ASSERT(parent->getNumProperties() == 5);
+        for (std::size_t i = 0; i < parent->getNumProperties(); ++i)
+        {
+            ABCA::ArrayPropertyReaderPtr ap = parent->getArrayProperty(i);
+            ABCA::ArrayPropertyReaderPtr refap =
+                refParent->getArrayProperty(ap->getName());
+
+            TESTING_ASSERT(ap->getNumSamples() == refap->getNumSamples());
+            TESTING_ASSERT(ap->isConstant() == refap->isConstant());
+            TESTING_ASSERT(ap->isScalarLike() == refap->isScalarLike());
+
+            for (std::size_t j = 0; j < ap->getNumSamples(); ++j)
+            {
+                ABCA::ArraySamplePtr samp, refSamp;
+                ap->getSample(j, samp);
+                refap->getSample(j, refSamp);
+
+                TESTING_ASSERT(samp->getDimensions() ==
+                               refSamp->getDimensions());
+                TESTING_ASSERT(samp->getDataType() == refSamp->getDataType());
+
+                Dimensions dims;
+                ap->getDimensions(j, dims);
+                TESTING_ASSERT(dims == refSamp->getDimensions());
+
+                ABCA::ArraySampleKey key, refKey;
+                TESTING_ASSERT(ap->getKey(j, key));
+                TESTING_ASSERT(refap->getKey(j, refKey));
+                TESTING_ASSERT(key == refKey);
+
+                std::size_t numVals = samp->getDimensions().numPoints() *
+                    samp->getDataType().getExtent();
+                Alembic::Util::PlainOldDataType pod =
+                    samp->getDataType().getPod();
+
+                if (pod == Alembic::Util::kStringPOD)
+                {
+                    const std::string * str =
+                        (const std::string *) samp->getData();
+                    const std::string * refStr =
+                        (const std::string *) refSamp->getData();
+                    for (std::size_t k = 0; k < numVals; ++k)
+                    {
+                        TESTING_ASSERT(str[k] == refStr[k]);
+                    }
+                }
+                else if (pod == Alembic::Util::kWstringPOD)
+                {
+                    const std::wstring * str =
+                        (const std::wstring *) samp->getData();
+                    const std::wstring * refStr =
+                        (const std::wstring *) refSamp->getData();
+                    for (std::size_t k = 0; k < numVals; ++k)
+                    {
+                        TESTING_ASSERT(str[k] == refStr[k]);
+                    }
+                }
+                else
+                {
+                    std::size_t numBytes = numVals *
+                        Alembic::Util::PODNumBytes(pod);
+                    TESTING_ASSERT(numBytes == 0 ||
+                        memcmp(samp->getData(), refSamp->getData(),
+                               numBytes) == 0);
+
+                    // converting should work too
+                    std::vector< Alembic::Util::float64_t > asDouble(
+                        numVals + 1), refAsDouble(numVals + 1);
+                    ap->getAs(j, &asDouble.front(),
+                              Alembic::Util::kFloat64POD);
+                    refap->getAs(j, &refAsDouble.front(),
+                                 Alembic::Util::kFloat64POD);
+                    TESTING_ASSERT(asDouble == refAsDouble);
+
+                    std::vector< Alembic::Util::int8_t > asInt8(
+                        numVals + 1), refAsInt8(numVals + 1);
+                    ap->getAs(j, &asInt8.front(), Alembic::Util::kInt8POD);
+                    refap->getAs(j, &refAsInt8.front(),
+                                 Alembic::Util::kInt8POD);
+                    TESTING_ASSERT(asInt8 == refAsInt8);
+                }
+            }
+        }
+    }
+}
+
+//-*****************************************************************************
+std::size_t getFileSize(const std::string & iFileName)
+{
+    std::ifstream strm(iFileName.c_str(), std::ios::binary | std::ios::ate);
+    return strm.tellg();
+}
+
+//-*****************************************************************************
+std::string readFile(const std::string & iFileName)
+{
+    std::ifstream strm(iFileName.c_str(), std::ios::binary);
+    std::stringstream contents;
+    contents << strm.rdbuf();
+    return contents.str();
+}
+
+//-*****************************************************************************
+void testCompressedArrays()
+{
+    writeCompressionArchive("uncompressedArrays.abc", -1,
+                            AO::kZlibCompression);
+    writeCompressionArchive("zlibArrays.abc", 6, AO::kZlibCompression);
+    writeCompressionArchive("lz4Arrays.abc", 6, AO::kLZ4Compression);
+
+    AO::ReadArchive r;
+    ABCA::ArchiveReaderPtr ref = r("uncompressedArrays.abc");
+    TESTING_ASSERT(ref->getArchiveVersion() == ALEMBIC_LIBRARY_VERSION);
+
+    readCompressionArchive("zlibArrays.abc", ref);
+    readCompressionArchive("lz4Arrays.abc", ref);
+
+    TESTING_ASSERT(getFileSize("zlibArrays.abc") <
+                   getFileSize("uncompressedArrays.abc") / 2);
+    TESTING_ASSERT(getFileSize("lz4Arrays.abc") <
+                   getFileSize("uncompressedArrays.abc"));
+}
+
+//-*****************************************************************************
+// copies all of the array properties on the top object of iSrcName, returns
+// how many samples could be copied without decoding them
+std::size_t copyArrays(const std::string & iSrcName,
+                       const std::string & iDstName,
+                       Alembic::Util::int8_t iHint)
+{
+    AO::ReadArchive r;
+    ABCA::ArchiveReaderPtr ar = r(iSrcName);
+    ABCA::CompoundPropertyReaderPtr src = ar->getTop()->getProperties();
+
+    AO::WriteArchive w;
+    ABCA::ArchiveWriterPtr aw = w(iDstName, ABCA::MetaData());
+    aw->setCompressionHint(iHint);
+    ABCA::CompoundPropertyWriterPtr dst = aw->getTop()->getProperties();
+
+    std::size_t numCopied = 0;
+    for (std::size_t i = 0; i < src->getNumProperties(); ++i)
+    {
+        ABCA::ArrayPropertyReaderPtr ap = src->getArrayProperty(i);
+        ABCA::ArrayPropertyWriterPtr awp = dst->createArrayProperty(
+            ap->getName(), ap->getMetaData(), ap->getDataType(), 0);
+
+        for (std::size_t j = 0; j < ap->getNumSamples(); ++j)
+        {
+            if (awp->copySample(ap, j))
+            {
+                numCopied++;
+                continue;
+            }
+
+            TESTING_ASSERT(awp->getNumSamples() == j);
+            ABCA::ArraySamplePtr samp;
+            ap->getSample(j, samp);
+            awp->setSample(*samp);
+        }
+    }
+
+    return numCopied;
+}
+
+//-*****************************************************************************
+void testCopyArrays()
+{
+    AO::ReadArchive r;
+    ABCA::ArchiveReaderPtr ref = r("uncompressedArrays.abc");
+
+    // same layout, everything is copied as it is and shared the same way
+    TESTING_ASSERT(copyArrays("uncompressedArrays.abc",
+                              "copiedArrays.abc", -1) == 10);
+    readCompressionArchive("copiedArrays.abc", ref);
+    TESTING_ASSERT(getFileSize("copiedArrays.abc") ==
+                   getFileSize("uncompressedArrays.abc"));
+
+    // compressed samples can only be copied into compressed properties
+    TESTING_ASSERT(copyArrays("zlibArrays.abc",
+                              "copiedZlibArrays.abc", 6) == 9);
+    readCompressionArchive("copiedZlibArrays.abc", ref);
+    TESTING_ASSERT(copyArrays("zlibArrays.abc",
+                              "decompressedArrays.abc", -1) == 1);
+    readCompressionArchive("decompressedArrays.abc", ref);
+
+    // samples compressed with another codec are compressed again with ours
+    // so we end up with what copying the zlib samples gives us (without
+    // LZ4 support lz4Arrays.abc was compressed with zlib anyway)
+    TESTING_ASSERT(copyArrays("lz4Arrays.abc",
+                              "recompressedArrays.abc", 6) == 9);
+    readCompressionArchive("recompressedArrays.abc", ref);
+    TESTING_ASSERT(readFile("recompressedArrays.abc") ==
+                   readFile("copiedZlibArrays.abc"));
+
+    // the stored keys are no good with a different hash
+    TESTING_ASSERT(copyArrays("spookyHash.abc", "copiedHash.abc", -1) == 0);
+}
+
+//-*****************************************************************************
+void writeHashArchive(const std::string & iArchiveName,
+                      ABCA::SampleHashID iHashID)
+{
+    AO::WriteArchive w(0, AO::kZlibCompression, 0, iHashID);
+    ABCA::ArchiveWriterPtr a = w(iArchiveName, ABCA::MetaData());
+    ABCA::CompoundPropertyWriterPtr parent = a->getTop()->getProperties();
+
+    ABCA::DataType i32d(Alembic::Util::kInt32POD, 1);
+    ABCA::DataType strd(Alembic::Util::kStringPOD, 1);
+
+    ABCA::ArrayPropertyWriterPtr iwp =
+        parent->createArrayProperty("ints", ABCA::MetaData(), i32d, 0);
+    ABCA::ArrayPropertyWriterPtr swp =
+        parent->createArrayProperty("strs", ABCA::MetaData(), strd, 0);
+
+    // big enough to be hashed in more than one chunk
+    std::vector< Alembic::Util::int32_t > vals(1024 * 1024);
+    for (std::size_t i = 0; i < vals.size(); ++i)
+    {
+        vals[i] = i;
+    }
+
+    std::vector< std::string > strs(3);
+    strs[0] = "potato";
+    strs[1] = "";
+    strs[2] = "tomato";
+
+    iwp->setSample(ABCA::ArraySample(&(vals.front()), i32d,
+                                     Dimensions(vals.size())));
+    iwp->setSample(ABCA::ArraySample(&(vals.front()), i32d,
+                                     Dimensions(vals.size() / 2)));
+    iwp->setSample(ABCA::ArraySample(&(vals.front()), i32d,
+                                     Dimensions(vals.size())));
+    swp->setSample(ABCA::ArraySample(&(strs.front()), strd,
+                                     Dimensions(strs.size())));
+}
+
+//-*****************************************************************************
+void testSampleHash()
+{
+    writeHashArchive("murmur3Hash.abc", ABCA::kMurmur3SampleHash);
+    writeHashArchive("spookyHash.abc", ABCA::kChunkedSpookySampleHash);
+
+    AO::ReadArchive r;
+    ABCA::ArchiveReaderPtr murmur = r("murmur3Hash.abc");
+    ABCA::ArchiveReaderPtr spooky = r("spookyHash.abc");
+
+    // the default doesn't need to say which hash it used
+    TESTING_ASSERT(murmur->getMetaData().get("_ai_SampleHashID").empty());
+    TESTING_ASSERT(spooky->getMetaData().get("_ai_SampleHashID") == "1");
+
+    ABCA::ArrayPropertyReaderPtr mip =
+        murmur->getTop()->getProperties()->getArrayProperty("ints");
+    ABCA::ArrayPropertyReaderPtr sip =
+        spooky->getTop()->getProperties()->getArrayProperty("ints");
+    ABCA::ArrayPropertyReaderPtr msp =
+        murmur->getTop()->getProperties()->getArrayProperty("strs");
+    ABCA::ArrayPropertyReaderPtr ssp =
+        spooky->getTop()->getProperties()->getArrayProperty("strs");
+
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        ABCA::ArraySampleKey mkey, skey;
+        TESTING_ASSERT(mip->getKey(i, mkey));
+        TESTING_ASSERT(sip->getKey(i, skey));
+        TESTING_ASSERT(mkey.hashID == ABCA::kMurmur3SampleHash);
+        TESTING_ASSERT(skey.hashID == ABCA::kChunkedSpookySampleHash);
+        TESTING_ASSERT(mkey.digest != skey.digest);
+        TESTING_ASSERT(mkey.numBytes == skey.numBytes);
+
+        // the keys read back are what the sample hashes to in memory
+        ABCA::ArraySamplePtr msamp, ssamp;
+        mip->getSample(i, msamp);
+        sip->getSample(i, ssamp);
+        TESTING_ASSERT(msamp->getKey() == mkey);
+        TESTING_ASSERT(ssamp->getKey(ABCA::kChunkedSpookySampleHash) ==
+                       skey);
+        TESTING_ASSERT(msamp->getKey().digest ==
+                       msamp->getKey(ABCA::kMurmur3SampleHash).digest);
+
+        const Alembic::Util::int32_t * data =
+            (const Alembic::Util::int32_t *) ssamp->getData();
+        for (std::size_t j = 0; j < ssamp->size(); ++j)
+        {
+            TESTING_ASSERT(data[j] == (Alembic::Util::int32_t) j);
+        }
+    }
+
+    // the repeated sample is still shared, so the keys match
+    ABCA::ArraySampleKey key0, key2;
+    sip->getKey(0, key0);
+    sip->getKey(2, key2);
+    TESTING_ASSERT(key0 == key2);
+
+    ABCA::ArraySampleKey mkey, skey;
+    msp->getKey(0, mkey);
+    ssp->getKey(0, skey);
+    TESTING_ASSERT(mkey.digest != skey.digest);
+
+    ABCA::ArraySamplePtr ssamp;
+    ssp->getSample(0, ssamp);
+    TESTING_ASSERT(
+        ssamp->getKey(ABCA::kChunkedSpookySampleHash).digest == skey.digest);
+    const std::string * strs = (const std::string *) ssamp->getData();
+    TESTING_ASSERT(ssamp->size() == 3);
+    TESTING_ASSERT(strs[0] == "potato");
+    TESTING_ASSERT(strs[1] == "");
+    TESTING_ASSERT(strs[2] == "tomato");
+}
+
+//-*****************************************************************************
+void checkSamples(ABCA::ArrayPropertyReaderPtr iProp)
+{
+    std::size_t numSamples = iProp->getNumSamples();
+
+    std::vector< ABCA::ArraySamplePtr > samps;
+    iProp->getSamples(0, numSamples, samps);
+    TESTING_ASSERT(samps.size() == numSamples);
+
+    for (std::size_t i = 0; i < numSamples; ++i)
+    {
+        ABCA::ArraySamplePtr samp;
+        iProp->getSample(i, samp);
+        TESTING_ASSERT(samps[i]->getDimensions() == samp->getDimensions());
+        TESTING_ASSERT(samps[i]->getDataType() == samp->getDataType());
+        TESTING_ASSERT(samps[i]->getKey() == samp->getKey());
+    }
+
+    // part of the range
+    std::vector< ABCA::ArraySamplePtr > part;
+    iProp->getSamples(2, 3, part);
+    TESTING_ASSERT(part.size() == 3);
+    for (std::size_t i = 0; i < part.size(); ++i)
+    {
+        TESTING_ASSERT(part[i]->getKey() == samps[i + 2]->getKey());
+    }
+
+    iProp->getSamples(1, 0, part);
+    TESTING_ASSERT(part.empty());
+
+    TESTING_ASSERT_THROW(iProp->getSamples(1, numSamples, part),
+                         Alembic::Util::Exception);
+    TESTING_ASSERT_THROW(iProp->getSamples(-1, 2, part),
+                         Alembic::Util::Exception);
+}
+
+//-*****************************************************************************
+void testGetSamples()
+{
+    std::string archiveName = "getSamples.abc";
+    {
+        AO::WriteArchive w;
+        ABCA::ArchiveWriterPtr a = w(archiveName, ABCA::MetaData());
+        ABCA::CompoundPropertyWriterPtr parent = a->getTop()->getProperties();
+
+        ABCA::DataType i32d(Alembic::Util::kInt32POD, 1);
+        ABCA::DataType strd(Alembic::Util::kStringPOD, 1);
+
+        ABCA::ArrayPropertyWriterPtr iwp =
+            parent->createArrayProperty("ints", ABCA::MetaData(), i32d, 0);
+        ABCA::ArrayPropertyWriterPtr swp =
+            parent->createArrayProperty("strs", ABCA::MetaData(), strd, 0);
+        ABCA::ArrayPropertyWriterPtr bwp =
+            parent->createArrayProperty("big", ABCA::MetaData(), i32d, 0);
+
+        std::vector< Alembic::Util::int32_t > vals(1024 * 1024);
+        for (std::size_t i = 0; i < vals.size(); ++i)
+        {
+            vals[i] = i;
+        }
+
+        std::vector< std::string > strs(2);
+
+        // the samples of the properties are interleaved in the file, and
+        // some of them repeat
+        std::size_t sizes[] = {4, 4, 7, 0, 4, 4, 4, 9};
+        for (std::size_t i = 0; i < 8; ++i)
+        {
+            iwp->setSample(ABCA::ArraySample(&(vals.front()), i32d,
+                                             Dimensions(sizes[i])));
+
+            strs[0] = std::string(sizes[i], 'a');
+            strs[1] = "b";
+            swp->setSample(ABCA::ArraySample(&(strs.front()), strd,
+                                             Dimensions(strs.size())));
+
+            bwp->setSample(ABCA::ArraySample(&(vals[i % 3]), i32d,
+                                             Dimensions(vals.size() - 3)));
+        }
+    }
+
+    for (int m = 0; m < 3; ++m)
+    {
+        AO::ReadArchive r(1, m == 1);
+        ABCA::ArchiveReaderPtr a;
+        if (m == 2)
+        {
+            a = r(archiveName, AO::CreateCache());
+        }
+        else
+        {
+            a = r(archiveName);
+        }
+
+        ABCA::CompoundPropertyReaderPtr parent = a->getTop()->getProperties();
+        checkSamples(parent->getArrayProperty("ints"));
+        checkSamples(parent->getArrayProperty("strs"));
+        checkSamples(parent->getArrayProperty("big"));
+
+        // repeated samples are shared
+        std::vector< ABCA::ArraySamplePtr > samps;
+        parent->getArrayProperty("ints")->getSamples(0, 8, samps);
+        TESTING_ASSERT(samps[0] == samps[1]);
+        TESTING_ASSERT(samps[4] == samps[6]);
+        TESTING_ASSERT(samps[0] == samps[4]);
+        TESTING_ASSERT(samps[0] != samps[2]);
+        TESTING_ASSERT(samps[3]->size() == 0);
+
+        const Alembic::Util::int32_t * data =
+            (const Alembic::Util::int32_t *) samps[7]->getData();
+        for (std::size_t i = 0; i < 9; ++i)
+        {
+            TESTING_ASSERT(data[i] == (Alembic::Util::int32_t) i);
+        }
+
+        parent->getArrayProperty("strs")->getSamples(0, 8, samps);
+        const std::string * strData =
+            (const std::string *) samps[2]->getData();
+        TESTING_ASSERT(strData[0] == "aaaaaaa");
+        TESTING_ASSERT(strData[1] == "b");
+    }
+}
+
+//-*****************************************************************************
+bool isCached(ABCA::ArchiveReaderPtr iArchive,
+              ABCA::ArrayPropertyReaderPtr iProp, ABCA::index_t iIndex)
+{
+    ABCA::ArraySampleKey key;
+    iProp->getKey(iIndex, key);
+    return iArchive->getReadArraySampleCachePtr()->find(key);
+}
+
+//-*****************************************************************************
+void testPrefetch()
+{
+    std::string archiveName = "prefetch.abc";
+    {
+        AO::WriteArchive w;
+        ABCA::ArchiveWriterPtr a = w(archiveName, ABCA::MetaData());
+
+        // 10 samples, 1 second apart
+        ABCA::TimeSamplingPtr ts(new ABCA::TimeSampling(1.0, 0.0));
+        Alembic::Util::uint32_t tsIndex = a->addTimeSampling(*ts);
+
+        ABCA::ObjectWriterPtr child = a->getTop()->createChild(
+            ABCA::ObjectHeader("child", ABCA::MetaData()));
+        ABCA::ObjectWriterPtr grandChild = child->createChild(
+            ABCA::ObjectHeader("grandChild", ABCA::MetaData()));
+        ABCA::ObjectWriterPtr other = a->getTop()->createChild(
+            ABCA::ObjectHeader("other", ABCA::MetaData()));
+
+        ABCA::DataType i32d(Alembic::Util::kInt32POD, 1);
+
+        ABCA::ArrayPropertyWriterPtr props[3];
+        props[0] = child->getProperties()->createArrayProperty("a",
+            ABCA::MetaData(), i32d, tsIndex);
+        props[1] = grandChild->getProperties()->createCompoundProperty(
+            "compound", ABCA::MetaData())->createArrayProperty("b",
+            ABCA::MetaData(), i32d, tsIndex);
+        props[2] = other->getProperties()->createArrayProperty("c",
+            ABCA::MetaData(), i32d, tsIndex);
+
+        std::vector< Alembic::Util::int32_t > vals(1000);
+        for (std::size_t i = 0; i < 10; ++i)
+        {
+            for (std::size_t j = 0; j < vals.size(); ++j)
+            {
+                vals[j] = i * 10000 + j;
+            }
+
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                vals[0] = j;
+                props[j]->setSample(ABCA::ArraySample(&(vals.front()), i32d,
+                                                      Dimensions(1000)));
+            }
+        }
+    }
+
+    AO::ReadArchive r;
+    ABCA::ArchiveReaderPtr a = r(archiveName, AO::CreateCache());
+    ABCA::ObjectReaderPtr top = a->getTop();
+    ABCA::ArrayPropertyReaderPtr aProp =
+        top->getChild("child")->getProperties()->getArrayProperty("a");
+    ABCA::ArrayPropertyReaderPtr bProp =
+        top->getChild("child")->getChild("grandChild")->getProperties()->
+        getCompoundProperty("compound")->getArrayProperty("b");
+    ABCA::ArrayPropertyReaderPtr cProp =
+        top->getChild("other")->getProperties()->getArrayProperty("c");
+
+    {
+        ABCA::Prefetcher prefetcher(a, 2);
+        prefetcher.prefetch("/child", 2.5, 4.5);
+        prefetcher.wait();
+
+        // samples 2 through 5, of a and b
+        TESTING_ASSERT(prefetcher.getNumBytes() == 2 * 4 * 4000);
+        for (ABCA::index_t i = 0; i < 10; ++i)
+        {
+            TESTING_ASSERT(isCached(a, aProp, i) == (i >= 2 && i <= 5));
+            TESTING_ASSERT(isCached(a, bProp, i) == (i >= 2 && i <= 5));
+            TESTING_ASSERT(!isCached(a, cProp, i));
+        }
+
+        // what we read now comes straight from the cache
+        ABCA::ArraySamplePtr samp;
+        aProp->getSample(3, samp);
+        TESTING_ASSERT(((const Alembic::Util::int32_t *) samp->getData())[1] ==
+                       30001);
+
+        // a bad path is ignored
+        prefetcher.prefetch("/doesNotExist", 0.0, 9.0);
+        prefetcher.wait();
+        TESTING_ASSERT(prefetcher.getNumBytes() == 0);
+
+        // just the property
+        prefetcher.prefetch(ABCA::BasePropertyReaderPtr(cProp), 0.0, 0.0);
+        prefetcher.wait();
+        TESTING_ASSERT(prefetcher.getNumBytes() == 4000);
+        TESTING_ASSERT(isCached(a, cProp, 0));
+        TESTING_ASSERT(!isCached(a, cProp, 1));
+    }
+
+    {
+        // only the top object, not its children
+        ABCA::Prefetcher prefetcher(a);
+        prefetcher.prefetch("/", 0.0, 9.0, false);
+        prefetcher.wait();
+        TESTING_ASSERT(prefetcher.getNumBytes() == 0);
+        TESTING_ASSERT(!isCached(a, cProp, 9));
+    }
+
+    {
+        // a budget of 3 samples, a batch is read before checking the budget
+        // so all 8 samples of the first property are read, but not c
+        ABCA::Prefetcher prefetcher(a, 1, 3 * 4000);
+        std::vector< std::string > paths;
+        paths.push_back("/child/grandChild");
+        paths.push_back("/other");
+        prefetcher.prefetch(paths, 0.0, 9.0);
+        prefetcher.wait();
+        TESTING_ASSERT(prefetcher.getNumBytes() == 10 * 4000);
+        TESTING_ASSERT(!isCached(a, cProp, 9));
+    }
+
+    {
+        // canceling drops everything, and we can keep going afterwards
+        ABCA::Prefetcher prefetcher(a, 4);
+        prefetcher.prefetch("/", 0.0, 9.0);
+        prefetcher.cancel();
+        prefetcher.wait();
+        TESTING_ASSERT(prefetcher.getNumBytes() <= 3 * 10 * 4000);
+
+        prefetcher.prefetch("/other", 0.0, 9.0);
+        prefetcher.wait();
+        TESTING_ASSERT(prefetcher.getNumBytes() == 10 * 4000);
+        TESTING_ASSERT(isCached(a, cProp, 9));
+
+        // destroying it before it is done should be fine too
+        prefetcher.prefetch("/", 0.0, 9.0);
+    }
+
+    // canceling wakes up whoever is waiting, even if none of the requests
+    // were picked up yet
+    for (std::size_t i = 0; i < 200; ++i)
+    {
+        ABCA::Prefetcher prefetcher(a, 1);
+        prefetcher.prefetch("/", 0.0, 9.0);
+        std::thread waiter(&ABCA::Prefetcher::wait, &prefetcher);
+        prefetcher.cancel();
+        waiter.join();
+    }
+
+    // prefetching needs a cache
+    TESTING_ASSERT_THROW(ABCA::Prefetcher(r(archiveName)),
+                         Alembic::Util::Exception);
+}
+
 int main ( int argc, char *argv[] )
 {
     testEmptyArray();
@@ -1875,5 +2767,12 @@ int main ( int argc, char *argv[] )
     testExtentArrayStrings();
     testArrayStringsRepeats();
     testArraySamples();
+    testMappedArraySamples();
+    testArraySampleCache();
+    testCompressedArrays();
+    testSampleHash();
+    testCopyArrays();
+    testGetSamples();
+    testPrefetch();
     return 0;
 }
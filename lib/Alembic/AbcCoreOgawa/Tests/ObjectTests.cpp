@@ -37,6 +37,7 @@
 #include <sstream>
 #include <Alembic/AbcCoreAbstract/All.h>
 #include <Alembic/AbcCoreOgawa/All.h>
+#include <Alembic/Ogawa/All.h>
 #include <Alembic/Util/All.h>
 
 #include <Alembic/AbcCoreAbstract/Tests/Assert.h>
@@ -264,16 +265,18 @@ void testChildObjects()
     }
 }
 
-void testMetaData()
+void testMetaData( bool iExtended )
 {
     std::string archiveName = "objectMetaDataTest.abc";
     {
-        AO::WriteArchive w;
+        AO::WriteArchive w( 0, AO::kZlibCompression, 0,
+                            AbcA::kMurmur3SampleHash, false, iExtended );
         AbcA::ArchiveWriterPtr a = w(archiveName, AbcA::MetaData());
         AbcA::ObjectWriterPtr archive = a->getTop();
 
         AbcA::ObjectWriterPtr child = archive->createChild(
             AbcA::ObjectHeader("tests", AbcA::MetaData()));
+        AbcA::DataType dtype(Alembic::Util::kInt32POD);
         for (std::size_t i = 0; i < 300; ++i)
         {
             std::stringstream strm;
@@ -281,6 +284,11 @@ void testMetaData()
             AbcA::MetaData m;
             m.set(strm.str(), strm.str());
             child->createChild(AbcA::ObjectHeader(strm.str(), m));
+
+            AbcA::MetaData pm;
+            pm.set("prop", strm.str());
+            child->getProperties()->createScalarProperty(strm.str(), pm,
+                                                         dtype, 0);
         }
     }
 
@@ -289,6 +297,8 @@ void testMetaData()
         AbcA::ArchiveReaderPtr a = r( archiveName );
         AbcA::ObjectReaderPtr archive = a->getTop();
         AbcA::ObjectReaderPtr child = archive->getChild(0);
+        AbcA::CompoundPropertyReaderPtr props = child->getProperties();
+        TESTING_ASSERT(props->getNumProperties() == 300);
         for (std::size_t i = 0; i < 300; ++i)
         {
             AbcA::ObjectReaderPtr grandChild = child->getChild(i);
@@ -297,7 +307,121 @@ void testMetaData()
             TESTING_ASSERT(grandChild->getName() == strm.str());
             TESTING_ASSERT(grandChild->getMetaData().get(strm.str())
                            == strm.str());
+            TESTING_ASSERT(grandChild->getMetaData().size() == 1);
+
+            const AbcA::PropertyHeader & header =
+                props->getPropertyHeader(i);
+            TESTING_ASSERT(header.getName() == strm.str());
+            TESTING_ASSERT(header.getMetaData().get("prop") == strm.str());
+        }
+    }
+
+    // only archives that index more than 254 meta data need a newer reader
+    {
+        Alembic::Ogawa::IArchive ogawaArchive( archiveName );
+        TESTING_ASSERT(ogawaArchive.isValid());
+        Alembic::Ogawa::IDataPtr versionData =
+            ogawaArchive.getGroup()->getData(0, 0);
+        Alembic::Util::int32_t version = -1;
+        versionData->read(4, &version, 0, 0);
+        TESTING_ASSERT(version == ( iExtended ? 2 : 0 ));
+    }
+}
+
+//-*****************************************************************************
+void testFindObject( bool iWritePathIndex )
+{
+    std::string archiveName = "objectFindTest.abc";
+    {
+        AO::WriteArchive w( 0, AO::kZlibCompression, 0,
+                            AbcA::kMurmur3SampleHash, iWritePathIndex );
+        AbcA::ArchiveWriterPtr a = w(archiveName, AbcA::MetaData());
+        AbcA::ObjectWriterPtr archive = a->getTop();
+
+        AbcA::MetaData md;
+        md.set("name", "a");
+        AbcA::ObjectWriterPtr objA = archive->createChild(
+            AbcA::ObjectHeader("a", md));
+
+        md.set("name", "b");
+        AbcA::ObjectWriterPtr objB = objA->createChild(
+            AbcA::ObjectHeader("b", md));
+
+        md.set("name", "c");
+        AbcA::ObjectWriterPtr objC = objB->createChild(
+            AbcA::ObjectHeader("c", md));
+
+        AbcA::DataType dtype(Alembic::Util::kInt32POD);
+        AbcA::ScalarPropertyWriterPtr prop =
+            objC->getProperties()->createScalarProperty("int",
+                AbcA::MetaData(), dtype, 0);
+        Alembic::Util::int32_t val = 42;
+        prop->setSample(&val);
+
+        // enough different meta data that some of it isn't indexed
+        for (std::size_t i = 0; i < 300; ++i)
+        {
+            std::stringstream strm;
+            strm << i;
+            AbcA::MetaData childMd;
+            childMd.set("index", strm.str());
+            objB->createChild(AbcA::ObjectHeader(strm.str(), childMd));
         }
+
+        archive->createChild(AbcA::ObjectHeader("d", AbcA::MetaData()));
+    }
+
+    {
+        AO::ReadArchive r;
+        AbcA::ArchiveReaderPtr a = r( archiveName );
+
+        AbcA::ObjectReaderPtr obj = a->findObject("/a/b/c");
+        TESTING_ASSERT(obj);
+        TESTING_ASSERT(obj->getName() == "c");
+        TESTING_ASSERT(obj->getFullName() == "/a/b/c");
+        TESTING_ASSERT(obj->getMetaData().get("name") == "c");
+        TESTING_ASSERT(obj->getNumChildren() == 0);
+        TESTING_ASSERT(obj->getProperties()->getNumProperties() == 1);
+
+        AbcA::ScalarPropertyReaderPtr prop =
+            obj->getProperties()->getScalarProperty("int");
+        Alembic::Util::int32_t val = 0;
+        prop->getSample(0, &val);
+        TESTING_ASSERT(val == 42);
+
+        // the parents are found on the way back up
+        AbcA::ObjectReaderPtr parent = obj->getParent();
+        TESTING_ASSERT(parent->getFullName() == "/a/b");
+        TESTING_ASSERT(parent->getMetaData().get("name") == "b");
+        TESTING_ASSERT(parent->getNumChildren() == 301);
+        parent = parent->getParent();
+        TESTING_ASSERT(parent->getFullName() == "/a");
+        parent = parent->getParent();
+        TESTING_ASSERT(parent->getFullName() == "/");
+        TESTING_ASSERT(!parent->getParent());
+
+        // the children of a found object have the right names
+        obj = a->findObject("a/b/");
+        TESTING_ASSERT(obj);
+        TESTING_ASSERT(obj->getChild("c")->getFullName() == "/a/b/c");
+
+        for (std::size_t i = 0; i < 300; ++i)
+        {
+            std::stringstream strm;
+            strm << i;
+            obj = a->findObject("/a/b/" + strm.str());
+            TESTING_ASSERT(obj);
+            TESTING_ASSERT(obj->getName() == strm.str());
+            TESTING_ASSERT(obj->getMetaData().get("index") == strm.str());
+        }
+
+        TESTING_ASSERT(a->findObject("/d")->getNumChildren() == 0);
+        TESTING_ASSERT(a->findObject("/")->getFullName() == "/");
+        TESTING_ASSERT(a->findObject("")->getFullName() == "/");
+
+        TESTING_ASSERT(!a->findObject("/a/b/c/d"));
+        TESTING_ASSERT(!a->findObject("/a/c"));
+        TESTING_ASSERT(!a->findObject("/e"));
     }
 }
 
@@ -305,6 +429,9 @@ int main ( int argc, char *argv[] )
 {
     testObjects();
     testChildObjects();
-    testMetaData();
+    testMetaData( false );
+    testMetaData( true );
+    testFindObject( true );
+    testFindObject( false );
     return 0;
 }
@@ -0,0 +1,191 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreAbstract/All.h>
+#include <Alembic/AbcCoreOgawa/All.h>
+#include <Alembic/Util/All.h>
+
+#include <Alembic/AbcCoreAbstract/Tests/Assert.h>
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+//-*****************************************************************************
+// Reports how long opening and walking a large archive takes when the
+// hierarchy is preloaded and when it is read lazily.  This isn't run as part
+// of the tests, PreloadHierarchyTests checks what is read.
+
+namespace AO = Alembic::AbcCoreOgawa;
+
+namespace AbcA = Alembic::AbcCoreAbstract;
+
+//-*****************************************************************************
+void writeLevel( AbcA::ObjectWriterPtr iParent, std::size_t iDepth,
+                 std::size_t iNumChildren )
+{
+    AbcA::CompoundPropertyWriterPtr props = iParent->getProperties();
+    AbcA::CompoundPropertyWriterPtr geom = props->createCompoundProperty(
+        ".geom", AbcA::MetaData() );
+    AbcA::CompoundPropertyWriterPtr arbGeom = geom->createCompoundProperty(
+        ".arbGeomParams", AbcA::MetaData() );
+
+    AbcA::DataType dtype( Alembic::Util::kInt32POD );
+    AbcA::ScalarPropertyWriterPtr scalar = arbGeom->createScalarProperty(
+        "depth", AbcA::MetaData(), dtype, 0 );
+    Alembic::Util::int32_t depth = ( Alembic::Util::int32_t ) iDepth;
+    scalar->setSample( &depth );
+
+    if ( iDepth == 0 )
+    {
+        return;
+    }
+
+    for ( std::size_t i = 0; i < iNumChildren; ++i )
+    {
+        std::stringstream strm;
+        strm << "child" << i;
+        AbcA::ObjectWriterPtr child = iParent->createChild(
+            AbcA::ObjectHeader( strm.str(), AbcA::MetaData() ) );
+        writeLevel( child, iDepth - 1, iNumChildren );
+    }
+}
+
+//-*****************************************************************************
+void walkCompound( AbcA::CompoundPropertyReaderPtr iCompound,
+                   std::vector< std::string > & oNames )
+{
+    for ( std::size_t i = 0; i < iCompound->getNumProperties(); ++i )
+    {
+        const AbcA::PropertyHeader & header =
+            iCompound->getPropertyHeader( i );
+        oNames.push_back( header.getName() );
+
+        if ( header.isCompound() )
+        {
+            walkCompound( iCompound->getCompoundProperty( i ), oNames );
+        }
+        else if ( header.isScalar() )
+        {
+            AbcA::ScalarPropertyReaderPtr scalar =
+                iCompound->getScalarProperty( i );
+            Alembic::Util::int32_t depth = -1;
+            scalar->getSample( 0, &depth );
+
+            std::stringstream strm;
+            strm << depth;
+            oNames.push_back( strm.str() );
+        }
+    }
+}
+
+//-*****************************************************************************
+void walkObject( AbcA::ObjectReaderPtr iObject,
+                 std::vector< std::string > & oNames )
+{
+    oNames.push_back( iObject->getFullName() );
+    walkCompound( iObject->getProperties(), oNames );
+
+    for ( std::size_t i = 0; i < iObject->getNumChildren(); ++i )
+    {
+        AbcA::ObjectReaderPtr child = iObject->getChild( i );
+        TESTING_ASSERT( child->getParent() == iObject );
+        walkObject( child, oNames );
+    }
+}
+
+//-*****************************************************************************
+double openAndWalk( const std::string & iArchiveName,
+                    const AO::ReadArchive & iReader,
+                    std::vector< std::string > & oNames )
+{
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+
+    AbcA::ArchiveReaderPtr a = iReader( iArchiveName );
+    walkObject( a->getTop(), oNames );
+
+    return std::chrono::duration< double >(
+        std::chrono::steady_clock::now() - start ).count();
+}
+
+//-*****************************************************************************
+void benchmarkPreload()
+{
+    std::string archiveName = "preloadHierarchyBenchmark.abc";
+
+    // 5 levels of 8 children, 37449 objects
+    {
+        AO::WriteArchive w;
+        AbcA::ArchiveWriterPtr a = w( archiveName, AbcA::MetaData() );
+        writeLevel( a->getTop(), 5, 8 );
+    }
+
+    std::vector< std::string > lazyNames;
+    double lazySeconds = openAndWalk( archiveName, AO::ReadArchive( 1 ),
+                                      lazyNames );
+    TESTING_ASSERT( lazyNames.size() == 37449 * 5 );
+
+    for ( std::size_t numStreams = 1; numStreams <= 8; numStreams *= 2 )
+    {
+        std::vector< std::string > names;
+        double seconds = openAndWalk( archiveName,
+            AO::ReadArchive( numStreams, false, true ), names );
+        TESTING_ASSERT( names == lazyNames );
+
+        std::cout << "preloaded with " << numStreams << " streams: "
+                  << seconds << " s, lazy: " << lazySeconds << " s"
+                  << std::endl;
+    }
+
+    // memory mapped
+    {
+        std::vector< std::string > names;
+        double seconds = openAndWalk( archiveName,
+            AO::ReadArchive( 4, true, true ), names );
+        TESTING_ASSERT( names == lazyNames );
+
+        std::cout << "preloaded memory mapped with 4 threads: "
+                  << seconds << " s" << std::endl;
+    }
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    benchmarkPreload();
+    return 0;
+}
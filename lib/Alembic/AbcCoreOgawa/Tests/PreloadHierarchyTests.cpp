@@ -0,0 +1,194 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreAbstract/All.h>
+#include <Alembic/AbcCoreOgawa/All.h>
+#include <Alembic/Util/All.h>
+
+#include <Alembic/AbcCoreAbstract/Tests/Assert.h>
+
+#include <sstream>
+
+//-*****************************************************************************
+// Checks that preloading the hierarchy gives the same objects and properties
+// as reading it lazily.  See PreloadHierarchyBenchmark for how long each
+// takes.
+
+namespace AO = Alembic::AbcCoreOgawa;
+
+namespace AbcA = Alembic::AbcCoreAbstract;
+
+//-*****************************************************************************
+void writeLevel( AbcA::ObjectWriterPtr iParent, std::size_t iDepth,
+                 std::size_t iNumChildren )
+{
+    AbcA::CompoundPropertyWriterPtr props = iParent->getProperties();
+    AbcA::CompoundPropertyWriterPtr geom = props->createCompoundProperty(
+        ".geom", AbcA::MetaData() );
+    AbcA::CompoundPropertyWriterPtr arbGeom = geom->createCompoundProperty(
+        ".arbGeomParams", AbcA::MetaData() );
+
+    AbcA::DataType dtype( Alembic::Util::kInt32POD );
+    AbcA::ScalarPropertyWriterPtr scalar = arbGeom->createScalarProperty(
+        "depth", AbcA::MetaData(), dtype, 0 );
+    Alembic::Util::int32_t depth = ( Alembic::Util::int32_t ) iDepth;
+    scalar->setSample( &depth );
+
+    if ( iDepth == 0 )
+    {
+        return;
+    }
+
+    for ( std::size_t i = 0; i < iNumChildren; ++i )
+    {
+        std::stringstream strm;
+        strm << "child" << i;
+        AbcA::ObjectWriterPtr child = iParent->createChild(
+            AbcA::ObjectHeader( strm.str(), AbcA::MetaData() ) );
+        writeLevel( child, iDepth - 1, iNumChildren );
+    }
+}
+
+//-*****************************************************************************
+void walkCompound( AbcA::CompoundPropertyReaderPtr iCompound,
+                   std::vector< std::string > & oNames )
+{
+    for ( std::size_t i = 0; i < iCompound->getNumProperties(); ++i )
+    {
+        const AbcA::PropertyHeader & header =
+            iCompound->getPropertyHeader( i );
+        oNames.push_back( header.getName() );
+
+        if ( header.isCompound() )
+        {
+            walkCompound( iCompound->getCompoundProperty( i ), oNames );
+        }
+        else if ( header.isScalar() )
+        {
+            AbcA::ScalarPropertyReaderPtr scalar =
+                iCompound->getScalarProperty( i );
+            Alembic::Util::int32_t depth = -1;
+            scalar->getSample( 0, &depth );
+
+            std::stringstream strm;
+            strm << depth;
+            oNames.push_back( strm.str() );
+        }
+    }
+}
+
+//-*****************************************************************************
+void walkObject( AbcA::ObjectReaderPtr iObject,
+                 std::vector< std::string > & oNames )
+{
+    oNames.push_back( iObject->getFullName() );
+    walkCompound( iObject->getProperties(), oNames );
+
+    for ( std::size_t i = 0; i < iObject->getNumChildren(); ++i )
+    {
+        AbcA::ObjectReaderPtr child = iObject->getChild( i );
+        TESTING_ASSERT( child->getParent() == iObject );
+        walkObject( child, oNames );
+    }
+}
+
+//-*****************************************************************************
+void openAndWalk( const std::string & iArchiveName,
+                  const AO::ReadArchive & iReader,
+                  std::vector< std::string > & oNames )
+{
+    AbcA::ArchiveReaderPtr a = iReader( iArchiveName );
+    walkObject( a->getTop(), oNames );
+}
+
+//-*****************************************************************************
+void testPreload()
+{
+    std::string archiveName = "preloadHierarchy.abc";
+
+    // 4 levels of 8 children, 4681 objects
+    {
+        AO::WriteArchive w;
+        AbcA::ArchiveWriterPtr a = w( archiveName, AbcA::MetaData() );
+        writeLevel( a->getTop(), 4, 8 );
+    }
+
+    std::vector< std::string > lazyNames;
+    openAndWalk( archiveName, AO::ReadArchive( 1 ), lazyNames );
+    TESTING_ASSERT( lazyNames.size() == 4681 * 5 );
+
+    for ( std::size_t numStreams = 1; numStreams <= 8; numStreams *= 2 )
+    {
+        std::vector< std::string > names;
+        openAndWalk( archiveName, AO::ReadArchive( numStreams, false, true ),
+                     names );
+        TESTING_ASSERT( names == lazyNames );
+    }
+
+    // memory mapped
+    {
+        std::vector< std::string > names;
+        openAndWalk( archiveName, AO::ReadArchive( 4, true, true ), names );
+        TESTING_ASSERT( names == lazyNames );
+    }
+
+    // objects made after the walk is over get the same preloaded data
+    {
+        AbcA::ArchiveReaderPtr a =
+            AO::ReadArchive( 2, false, true )( archiveName );
+        AbcA::ObjectReaderPtr obj = a->getTop()->getChild( "child3" );
+        obj = obj->getChild( "child7" )->getChild( "child0" );
+        TESTING_ASSERT( obj->getFullName() == "/child3/child7/child0" );
+        TESTING_ASSERT( obj->getNumChildren() == 8 );
+
+        AbcA::CompoundPropertyReaderPtr arbGeom =
+            obj->getProperties()->getCompoundProperty( ".geom" )->
+                getCompoundProperty( ".arbGeomParams" );
+        TESTING_ASSERT( arbGeom->getName() == ".arbGeomParams" );
+        TESTING_ASSERT( arbGeom->getParent()->getName() == ".geom" );
+
+        Alembic::Util::int32_t depth = -1;
+        arbGeom->getScalarProperty( "depth" )->getSample( 0, &depth );
+        TESTING_ASSERT( depth == 1 );
+    }
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    testPreload();
+    return 0;
+}
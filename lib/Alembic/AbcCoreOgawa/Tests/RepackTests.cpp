@@ -0,0 +1,266 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreAbstract/All.h>
+#include <Alembic/AbcCoreOgawa/All.h>
+#include <Alembic/Util/All.h>
+
+#include <Alembic/AbcCoreAbstract/Tests/Assert.h>
+
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+//-*****************************************************************************
+namespace AO = Alembic::AbcCoreOgawa;
+
+namespace ABCA = Alembic::AbcCoreAbstract;
+
+using Alembic::Util::int32_t;
+using Alembic::Util::uint64_t;
+using Alembic::Util::Dimensions;
+
+static const int32_t kNumFrames = 6;
+
+//-*****************************************************************************
+void writeRepackArchive( const std::string & iName, bool iPack )
+{
+    AO::WriteArchive w( 0, AO::kZlibCompression, 0, ABCA::kMurmur3SampleHash,
+                        true, false, iPack );
+    ABCA::MetaData m;
+    ABCA::ArchiveWriterPtr aw = w( iName, m );
+    Alembic::Util::uint32_t tsIndex =
+        aw->addTimeSampling( ABCA::TimeSampling( 1.0 / 24.0, 0.0 ) );
+
+    std::vector< ABCA::ArrayPropertyWriterPtr > points;
+    std::vector< ABCA::ScalarPropertyWriterPtr > ids;
+    std::vector< ABCA::ScalarPropertyWriterPtr > names;
+    for ( int32_t i = 0; i < 3; ++i )
+    {
+        std::ostringstream objName;
+        objName << "obj" << i;
+        ABCA::ObjectWriterPtr obj =
+            aw->getTop()->createChild( ABCA::ObjectHeader( objName.str(), m ) );
+        obj->createChild( ABCA::ObjectHeader( "child", m ) );
+        ABCA::CompoundPropertyWriterPtr props = obj->getProperties();
+        points.push_back( props->createArrayProperty( "P", m,
+            ABCA::DataType( Alembic::Util::kFloat32POD, 3 ), tsIndex ) );
+        ids.push_back( props->createScalarProperty( "id", m,
+            ABCA::DataType( Alembic::Util::kInt32POD, 1 ), tsIndex ) );
+        names.push_back( props->createCompoundProperty( "user", m )->
+            createScalarProperty( "name", m,
+                ABCA::DataType( Alembic::Util::kStringPOD, 1 ), tsIndex ) );
+    }
+
+    // each object is written out completely before the next one, the way
+    // a cache baked one object at a time ends up, which is the worst layout
+    // for reading one frame of everything
+    for ( std::size_t i = 0; i < points.size(); ++i )
+    {
+        for ( int32_t frame = 0; frame < kNumFrames; ++frame )
+        {
+            // the first two objects share their points, and the points
+            // of the last one only change every other frame
+            int32_t val = i < 2 ? frame : frame / 2 + 100;
+            std::vector< float > pointVals( 300, ( float ) val );
+            points[i]->setSample( ABCA::ArraySample( &pointVals.front(),
+                ABCA::DataType( Alembic::Util::kFloat32POD, 3 ),
+                Dimensions( 100 ) ) );
+
+            val = frame * 10 + i;
+            ids[i]->setSample( &val );
+
+            std::string name = "constant";
+            names[i]->setSample( &name );
+        }
+    }
+}
+
+//-*****************************************************************************
+void compareCompound( ABCA::CompoundPropertyReaderPtr iA,
+                      ABCA::CompoundPropertyReaderPtr iB )
+{
+    TESTING_ASSERT( iA->getNumProperties() == iB->getNumProperties() );
+    for ( std::size_t i = 0; i < iA->getNumProperties(); ++i )
+    {
+        const ABCA::PropertyHeader & header = iA->getPropertyHeader( i );
+        TESTING_ASSERT( header.getName() == iB->getPropertyHeader( i ).getName() );
+
+        if ( header.isCompound() )
+        {
+            compareCompound( iA->getCompoundProperty( i ),
+                             iB->getCompoundProperty( i ) );
+        }
+        else if ( header.isArray() )
+        {
+            ABCA::ArrayPropertyReaderPtr a = iA->getArrayProperty( i );
+            ABCA::ArrayPropertyReaderPtr b = iB->getArrayProperty( i );
+            TESTING_ASSERT( a->getNumSamples() == b->getNumSamples() );
+            TESTING_ASSERT( a->isConstant() == b->isConstant() );
+            for ( std::size_t j = 0; j < a->getNumSamples(); ++j )
+            {
+                ABCA::ArraySampleKey keyA;
+                ABCA::ArraySampleKey keyB;
+                TESTING_ASSERT( a->getKey( j, keyA ) && b->getKey( j, keyB ) );
+                TESTING_ASSERT( keyA == keyB );
+
+                ABCA::ArraySamplePtr sampA;
+                ABCA::ArraySamplePtr sampB;
+                a->getSample( j, sampA );
+                b->getSample( j, sampB );
+                TESTING_ASSERT( sampA->getDimensions() ==
+                                sampB->getDimensions() );
+                TESTING_ASSERT( memcmp( sampA->getData(), sampB->getData(),
+                    sampA->size() * header.getDataType().getNumBytes() )
+                    == 0 );
+            }
+        }
+        else
+        {
+            ABCA::ScalarPropertyReaderPtr a = iA->getScalarProperty( i );
+            ABCA::ScalarPropertyReaderPtr b = iB->getScalarProperty( i );
+            TESTING_ASSERT( a->getNumSamples() == b->getNumSamples() );
+            TESTING_ASSERT( a->isConstant() == b->isConstant() );
+            for ( std::size_t j = 0; j < a->getNumSamples(); ++j )
+            {
+                if ( header.getDataType().getPod() ==
+                     Alembic::Util::kStringPOD )
+                {
+                    std::string valA;
+                    std::string valB;
+                    a->getSample( j, &valA );
+                    b->getSample( j, &valB );
+                    TESTING_ASSERT( valA == valB );
+                }
+                else
+                {
+                    int32_t valA = -1;
+                    int32_t valB = -2;
+                    a->getSample( j, &valA );
+                    b->getSample( j, &valB );
+                    TESTING_ASSERT( valA == valB );
+                }
+            }
+        }
+    }
+}
+
+//-*****************************************************************************
+void compareObject( ABCA::ObjectReaderPtr iA, ABCA::ObjectReaderPtr iB )
+{
+    TESTING_ASSERT( iA->getFullName() == iB->getFullName() );
+    TESTING_ASSERT( iA->getNumChildren() == iB->getNumChildren() );
+
+    Alembic::Util::Digest digestA;
+    Alembic::Util::Digest digestB;
+    TESTING_ASSERT( iA->getPropertiesHash( digestA ) &&
+                    iB->getPropertiesHash( digestB ) && digestA == digestB );
+    TESTING_ASSERT( iA->getChildrenHash( digestA ) &&
+                    iB->getChildrenHash( digestB ) && digestA == digestB );
+
+    compareCompound( iA->getProperties(), iB->getProperties() );
+    for ( std::size_t i = 0; i < iA->getNumChildren(); ++i )
+    {
+        compareObject( iA->getChild( i ), iB->getChild( i ) );
+    }
+}
+
+//-*****************************************************************************
+uint64_t fileSize( const std::string & iName )
+{
+    std::ifstream file( iName.c_str(), std::ios::binary | std::ios::ate );
+    return file.tellg();
+}
+
+//-*****************************************************************************
+void testRepack( bool iPack )
+{
+    std::string archiveName = "repack.abc";
+    writeRepackArchive( archiveName, iPack );
+
+    AO::RepackLayout layouts[] = { AO::kFrameMajorLayout,
+        AO::kObjectMajorLayout, AO::kHotPropertiesFirstLayout };
+    std::vector< std::string > hot( 1, "P" );
+
+    for ( std::size_t i = 0; i < 3; ++i )
+    {
+        std::string repackedName = "repacked.abc";
+        std::vector< AO::RepackFrameStats > report;
+        AO::RepackArchive( archiveName, repackedName, layouts[i], hot,
+                           &report );
+
+        // nothing is added, and shared samples stay shared
+        TESTING_ASSERT( fileSize( repackedName ) == fileSize( archiveName ) );
+
+        ABCA::ArchiveReaderPtr a = AO::ReadArchive()( archiveName );
+        ABCA::ArchiveReaderPtr b = AO::ReadArchive()( repackedName );
+        TESTING_ASSERT( a->getNumTimeSamplings() == b->getNumTimeSamplings() );
+        TESTING_ASSERT( b->getMaxNumSamplesForTimeSamplingIndex( 1 ) ==
+                        kNumFrames );
+        compareObject( a->getTop(), b->getTop() );
+
+        // the path index points at where the objects went
+        ABCA::ObjectReaderPtr found = b->findObject( "/obj2/child" );
+        TESTING_ASSERT( found && found->getFullName() == "/obj2/child" );
+
+        TESTING_ASSERT( report.size() == ( std::size_t ) kNumFrames );
+        uint64_t before = 0;
+        uint64_t after = 0;
+        for ( std::size_t j = 0; j < report.size(); ++j )
+        {
+            TESTING_ASSERT( report[j].numReads > 0 );
+            TESTING_ASSERT( report[j].numBytes > 0 );
+            before += report[j].seekBefore;
+            after += report[j].seekAfter;
+        }
+
+        if ( layouts[i] == AO::kFrameMajorLayout )
+        {
+            TESTING_ASSERT( after < before );
+        }
+    }
+
+    // the original has to be finished, and isn't overwritten
+    TESTING_ASSERT_THROW( AO::RepackArchive( archiveName, archiveName,
+        AO::kFrameMajorLayout ), Alembic::Util::Exception );
+}
+
+int main ( int argc, char *argv[] )
+{
+    testRepack( false );
+    testRepack( true );
+    return 0;
+}
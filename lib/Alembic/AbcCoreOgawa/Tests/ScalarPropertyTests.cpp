@@ -36,6 +36,7 @@
 
 #include <Alembic/AbcCoreAbstract/All.h>
 #include <Alembic/AbcCoreOgawa/All.h>
+#include <Alembic/Ogawa/All.h>
 #include <Alembic/Util/All.h>
 
 #include <Alembic/AbcCoreAbstract/Tests/Assert.h>
@@ -477,12 +478,14 @@ void testReadWriteScalars()
 }
 
 //-*****************************************************************************
-void testRepeatedScalarData()
+void testRepeatedScalarData( bool iPackSamples )
 {
     std::string archiveName = "repeatScalarData.abc";
 
     {
-        AO::WriteArchive w;
+        AO::WriteArchive w( 0, AO::kZlibCompression, 0,
+                            AbcA::kMurmur3SampleHash, false, false,
+                            iPackSamples );
         AbcA::ArchiveWriterPtr a = w(archiveName, AbcA::MetaData());
         AbcA::ObjectWriterPtr archive = a->getTop();
 
@@ -698,6 +701,15 @@ void testRepeatedScalarData()
             }
         } // for
     }
+
+    // packed samples need a newer reader
+    {
+        Alembic::Ogawa::IArchive ogawaArchive( archiveName );
+        TESTING_ASSERT(ogawaArchive.isValid());
+        Alembic::Util::int32_t version = -1;
+        ogawaArchive.getGroup()->getData(0, 0)->read(4, &version, 0, 0);
+        TESTING_ASSERT(version == ( iPackSamples ? 3 : 0 ));
+    }
 }
 
 AbcA::ScalarPropertyWriterPtr createObjectAndScalar(
@@ -834,7 +846,8 @@ void testScalarSamples()
 int main ( int argc, char *argv[] )
 {
     testWeirdStringScalar();
-    testRepeatedScalarData();
+    testRepeatedScalarData( false );
+    testRepeatedScalarData( true );
     testReadWriteScalars();
     testPropScoping();
     testScalarSamples();
@@ -0,0 +1,264 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreAbstract/All.h>
+#include <Alembic/AbcCoreOgawa/All.h>
+#include <Alembic/Util/All.h>
+
+#include <Alembic/AbcCoreAbstract/Tests/Assert.h>
+
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#ifndef _MSC_VER
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+//-*****************************************************************************
+namespace AO = Alembic::AbcCoreOgawa;
+
+namespace ABCA = Alembic::AbcCoreAbstract;
+
+using ABCA::chrono_t;
+using Alembic::Util::int32_t;
+using Alembic::Util::Dimensions;
+
+static const int32_t kNumShards = 3;
+static const int32_t kFramesPerShard = 4;
+
+//-*****************************************************************************
+// each shard has the frames after those of the previous one, and packs its
+// scalar samples if iPack is true
+void writeShard( const std::string & iName, int32_t iShard, bool iPack,
+                 bool iExtraProperty )
+{
+    AO::WriteArchive w( 0, AO::kZlibCompression, 0, ABCA::kMurmur3SampleHash,
+                        false, false, iPack );
+    ABCA::MetaData m;
+    m.set( "potato", "salad" );
+    ABCA::ArchiveWriterPtr aw = w( iName, m );
+    aw->setCompressionHint( 1 );
+
+    int32_t firstFrame = iShard * kFramesPerShard;
+    Alembic::Util::uint32_t uniform = aw->addTimeSampling(
+        ABCA::TimeSampling( 1.0 / 24.0, firstFrame / 24.0 ) );
+
+    std::vector< chrono_t > times;
+    for ( int32_t i = 0; i < kFramesPerShard; ++i )
+    {
+        times.push_back( ( firstFrame + i ) * ( firstFrame + i ) );
+    }
+    Alembic::Util::uint32_t acyclic = aw->addTimeSampling(
+        ABCA::TimeSampling( ABCA::TimeSamplingType(
+            ABCA::TimeSamplingType::kAcyclic ), times ) );
+
+    ABCA::ObjectWriterPtr obj =
+        aw->getTop()->createChild( ABCA::ObjectHeader( "obj", m ) );
+    obj->createChild( ABCA::ObjectHeader( "child", m ) );
+    ABCA::CompoundPropertyWriterPtr props = obj->getProperties();
+    ABCA::ArrayPropertyWriterPtr points = props->createArrayProperty( "P", m,
+        ABCA::DataType( Alembic::Util::kFloat32POD, 3 ), uniform );
+    ABCA::ScalarPropertyWriterPtr id = props->createScalarProperty( "id", m,
+        ABCA::DataType( Alembic::Util::kInt32POD, 1 ), acyclic );
+    ABCA::ScalarPropertyWriterPtr still = props->createScalarProperty(
+        "still", m, ABCA::DataType( Alembic::Util::kInt32POD, 1 ), uniform );
+    ABCA::ScalarPropertyWriterPtr name =
+        props->createCompoundProperty( "user", m )->createScalarProperty(
+            "name", m, ABCA::DataType( Alembic::Util::kStringPOD, 1 ),
+            uniform );
+    if ( iExtraProperty )
+    {
+        props->createCompoundProperty( "extra", m );
+    }
+
+    for ( int32_t i = firstFrame; i < firstFrame + kFramesPerShard; ++i )
+    {
+        // the points only change every other frame
+        std::vector< float > pointVals( 30, ( float ) ( i / 2 ) );
+        points->setSample( ABCA::ArraySample( &pointVals.front(),
+            ABCA::DataType( Alembic::Util::kFloat32POD, 3 ), Dimensions( 10 ) ) );
+        id->setSample( &i );
+
+        int32_t stillVal = 42;
+        still->setSample( &stillVal );
+
+        std::string nameVal = i < 5 ? "early" : "late";
+        name->setSample( &nameVal );
+    }
+}
+
+//-*****************************************************************************
+void checkSharded( ABCA::ArchiveReaderPtr iArchive )
+{
+    int32_t numFrames = kNumShards * kFramesPerShard;
+    TESTING_ASSERT( iArchive->getTop()->getHeader().getMetaData().get(
+        "potato" ) == "salad" );
+    TESTING_ASSERT( iArchive->getNumTimeSamplings() == 3 );
+    TESTING_ASSERT(
+        iArchive->getMaxNumSamplesForTimeSamplingIndex( 1 ) == numFrames );
+    TESTING_ASSERT(
+        iArchive->getMaxNumSamplesForTimeSamplingIndex( 2 ) == numFrames );
+
+    ABCA::ObjectReaderPtr obj = iArchive->getTop()->getChild( "obj" );
+    TESTING_ASSERT( obj->getNumChildren() == 1 );
+    TESTING_ASSERT( obj->getChildHeader( 0 ).getFullName() == "/obj/child" );
+    TESTING_ASSERT(
+        obj->getChildHeader( 0 ).getMetaData().get( "potato" ) == "salad" );
+
+    ABCA::CompoundPropertyReaderPtr props = obj->getProperties();
+    ABCA::ArrayPropertyReaderPtr points = props->getArrayProperty( "P" );
+    ABCA::ScalarPropertyReaderPtr id = props->getScalarProperty( "id" );
+    ABCA::ScalarPropertyReaderPtr still = props->getScalarProperty( "still" );
+    ABCA::ScalarPropertyReaderPtr name =
+        props->getCompoundProperty( "user" )->getScalarProperty( "name" );
+
+    TESTING_ASSERT( points->getNumSamples() == ( std::size_t ) numFrames );
+    TESTING_ASSERT( id->getNumSamples() == ( std::size_t ) numFrames );
+    TESTING_ASSERT( still->getNumSamples() == ( std::size_t ) numFrames );
+    TESTING_ASSERT( still->isConstant() );
+    TESTING_ASSERT( !id->isConstant() );
+    TESTING_ASSERT( name->getNumSamples() == ( std::size_t ) numFrames );
+
+    ABCA::TimeSamplingPtr uniform = points->getTimeSampling();
+    ABCA::TimeSamplingPtr acyclic = id->getTimeSampling();
+    for ( int32_t i = 0; i < numFrames; ++i )
+    {
+        TESTING_ASSERT( std::fabs( uniform->getSampleTime( i ) - i / 24.0 ) <
+                        1e-9 );
+        TESTING_ASSERT( acyclic->getSampleTime( i ) == i * i );
+
+        ABCA::ArraySamplePtr samp;
+        points->getSample( i, samp );
+        TESTING_ASSERT( samp->getDimensions().numPoints() == 10 );
+        TESTING_ASSERT( ( ( const float * ) samp->getData() )[29] == i / 2 );
+
+        int32_t val = -1;
+        id->getSample( i, &val );
+        TESTING_ASSERT( val == i );
+
+        val = -1;
+        still->getSample( i, &val );
+        TESTING_ASSERT( val == 42 );
+
+        std::string nameVal;
+        name->getSample( i, &nameVal );
+        TESTING_ASSERT( nameVal == ( i < 5 ? "early" : "late" ) );
+    }
+}
+
+//-*****************************************************************************
+void testShards()
+{
+    std::vector< std::string > shards;
+    for ( int32_t i = 0; i < kNumShards; ++i )
+    {
+        std::ostringstream name;
+        name << "shard" << i << ".abc";
+        shards.push_back( name.str() );
+    }
+
+    // each shard is written by its own process, all at the same time
+#ifndef _MSC_VER
+    std::vector< pid_t > pids;
+    for ( int32_t i = 0; i < kNumShards; ++i )
+    {
+        pid_t pid = fork();
+        TESTING_ASSERT( pid >= 0 );
+        if ( pid == 0 )
+        {
+            int status = 0;
+            try
+            {
+                writeShard( shards[i], i, i == 1, false );
+            }
+            catch ( std::exception & e )
+            {
+                std::cerr << e.what() << std::endl;
+                status = 1;
+            }
+            _exit( status );
+        }
+        pids.push_back( pid );
+    }
+
+    for ( std::size_t i = 0; i < pids.size(); ++i )
+    {
+        int status = -1;
+        TESTING_ASSERT( waitpid( pids[i], &status, 0 ) == pids[i] );
+        TESTING_ASSERT( WIFEXITED( status ) && WEXITSTATUS( status ) == 0 );
+    }
+#else
+    for ( int32_t i = 0; i < kNumShards; ++i )
+    {
+        writeShard( shards[i], i, i == 1, false );
+    }
+#endif
+
+    AO::WriteShardManifest( "sharded.abc", shards );
+
+    checkSharded( AO::ReadArchive()( "sharded.abc" ) );
+    checkSharded( AO::ReadArchive( 2, true )( "sharded.abc" ) );
+    checkSharded( AO::ReadArchive( 2, false, true )( "sharded.abc" ) );
+
+    // sharded archives can't be appended to
+    TESTING_ASSERT_THROW( AO::WriteArchive().append( "sharded.abc" ),
+                          std::exception );
+
+    // shards have to agree on what is in them
+    writeShard( "shardExtra.abc", 1, false, true );
+    std::vector< std::string > badShards;
+    badShards.push_back( shards[0] );
+    badShards.push_back( "shardExtra.abc" );
+    TESTING_ASSERT_THROW( AO::WriteShardManifest( "badSharded.abc",
+                                                  badShards ),
+                          Alembic::Util::Exception );
+
+    // and be there
+    badShards[1] = "missingShard.abc";
+    TESTING_ASSERT_THROW( AO::WriteShardManifest( "badSharded.abc",
+                                                  badShards ),
+                          Alembic::Util::Exception );
+}
+
+int main ( int argc, char *argv[] )
+{
+    testShards();
+    return 0;
+}
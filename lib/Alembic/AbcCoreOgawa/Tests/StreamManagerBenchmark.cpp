@@ -0,0 +1,176 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreAbstract/All.h>
+#include <Alembic/AbcCoreOgawa/All.h>
+#include <Alembic/Util/All.h>
+
+#include <Alembic/AbcCoreAbstract/Tests/Assert.h>
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+//-*****************************************************************************
+// Benchmark for the stream handling of an Ogawa archive reader, many threads
+// read array samples at the same time with fewer, the same, and more streams
+// than threads, and the reads per second are reported for each combination.
+// This isn't run as part of the tests, StreamManagerTests checks the reads.
+
+namespace AO = Alembic::AbcCoreOgawa;
+
+namespace ABCA = Alembic::AbcCoreAbstract;
+
+static const std::size_t NUM_SAMPLES = 64;
+static const std::size_t NUM_POINTS = 256;
+static const std::size_t NUM_READS = 2000;
+
+//-*****************************************************************************
+void writeArchive( const std::string & iArchiveName )
+{
+    AO::WriteArchive w;
+    ABCA::ArchiveWriterPtr a = w( iArchiveName, ABCA::MetaData() );
+    ABCA::CompoundPropertyWriterPtr parent = a->getTop()->getProperties();
+
+    ABCA::DataType dtype( Alembic::Util::kInt32POD, 1 );
+    ABCA::ArrayPropertyWriterPtr awp =
+        parent->createArrayProperty( "a", ABCA::MetaData(), dtype, 0 );
+
+    std::vector< Alembic::Util::int32_t > vals( NUM_POINTS );
+    for ( std::size_t i = 0; i < NUM_SAMPLES; ++i )
+    {
+        for ( std::size_t j = 0; j < NUM_POINTS; ++j )
+        {
+            vals[j] = i * NUM_POINTS + j;
+        }
+
+        awp->setSample( ABCA::ArraySample( &vals.front(), dtype,
+                                           Alembic::Util::Dimensions(
+                                               NUM_POINTS ) ) );
+    }
+}
+
+//-*****************************************************************************
+void readSamples( ABCA::ArrayPropertyReaderPtr iProp, std::size_t iOffset,
+                  bool * oValid )
+{
+    *oValid = true;
+    for ( std::size_t i = 0; i < NUM_READS; ++i )
+    {
+        std::size_t index = ( i + iOffset ) % NUM_SAMPLES;
+        ABCA::ArraySamplePtr samp;
+        iProp->getSample( index, samp );
+        const Alembic::Util::int32_t * data =
+            ( const Alembic::Util::int32_t * ) samp->getData();
+
+        if ( samp->size() != NUM_POINTS ||
+             data[0] != ( Alembic::Util::int32_t )( index * NUM_POINTS ) ||
+             data[NUM_POINTS - 1] !=
+                ( Alembic::Util::int32_t )( index * NUM_POINTS +
+                                            NUM_POINTS - 1 ) )
+        {
+            *oValid = false;
+        }
+    }
+}
+
+//-*****************************************************************************
+void stressStreams( const std::string & iArchiveName,
+                    std::size_t iNumStreams,
+                    std::size_t iNumThreads )
+{
+    AO::ReadArchive r( iNumStreams );
+    ABCA::ArchiveReaderPtr a = r( iArchiveName );
+    ABCA::ArrayPropertyReaderPtr prop =
+        a->getTop()->getProperties()->getArrayProperty( "a" );
+
+    TESTING_ASSERT( prop->getNumSamples() == NUM_SAMPLES );
+
+    std::vector< std::thread > threads;
+    bool valid[256];
+
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+
+    for ( std::size_t i = 0; i < iNumThreads; ++i )
+    {
+        threads.push_back( std::thread( readSamples, prop, i * 7,
+                                        &valid[i] ) );
+    }
+
+    for ( std::size_t i = 0; i < iNumThreads; ++i )
+    {
+        threads[i].join();
+        TESTING_ASSERT( valid[i] );
+    }
+
+    double seconds = std::chrono::duration< double >(
+        std::chrono::steady_clock::now() - start ).count();
+
+    std::cout << "streams: " << iNumStreams << " threads: " << iNumThreads
+              << " reads/sec: "
+              << ( double )( iNumThreads * NUM_READS ) / seconds
+              << std::endl;
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    std::string archiveName = "streamManagerStress.abc";
+    writeArchive( archiveName );
+
+    std::size_t maxThreads = std::thread::hardware_concurrency() * 2;
+    if ( maxThreads < 8 )
+    {
+        maxThreads = 8;
+    }
+    else if ( maxThreads > 256 )
+    {
+        maxThreads = 256;
+    }
+
+    for ( std::size_t numThreads = 1; numThreads <= maxThreads;
+          numThreads *= 2 )
+    {
+        stressStreams( archiveName, 1, numThreads );
+        stressStreams( archiveName, numThreads / 2 + 1, numThreads );
+        stressStreams( archiveName, numThreads, numThreads );
+        stressStreams( archiveName, numThreads * 2, numThreads );
+    }
+
+    return 0;
+}
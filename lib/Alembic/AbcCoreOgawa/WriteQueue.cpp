@@ -0,0 +1,360 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcCoreOgawa/WriteQueue.h>
+#include <Alembic/AbcCoreOgawa/WriteUtil.h>
+
+namespace Alembic {
+namespace AbcCoreOgawa {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+SampleWriteTask::SampleWriteTask( const AbcA::ArraySample * iSamp,
+                                  AbcA::SampleHashID iHashID )
+    : m_hashID( iHashID )
+    , m_hasSample( iSamp != NULL )
+{
+    if ( !iSamp )
+    {
+        return;
+    }
+
+    const AbcA::DataType & dataType = iSamp->getDataType();
+    std::size_t numPods =
+        dataType.getExtent() * iSamp->getDimensions().numPoints();
+
+    const void * data = NULL;
+    if ( numPods == 0 )
+    {
+        data = iSamp->getData();
+    }
+    else if ( dataType.getPod() == Alembic::Util::kStringPOD )
+    {
+        const std::string * strs =
+            static_cast< const std::string * >( iSamp->getData() );
+        m_strings.assign( strs, strs + numPods );
+        data = &m_strings.front();
+    }
+    else if ( dataType.getPod() == Alembic::Util::kWstringPOD )
+    {
+        const std::wstring * strs =
+            static_cast< const std::wstring * >( iSamp->getData() );
+        m_wstrings.assign( strs, strs + numPods );
+        data = &m_wstrings.front();
+    }
+    else
+    {
+        const Util::uint8_t * bytes =
+            static_cast< const Util::uint8_t * >( iSamp->getData() );
+        m_data.assign( bytes, bytes + numPods *
+                       Alembic::Util::PODNumBytes( dataType.getPod() ) );
+        data = &m_data.front();
+    }
+
+    m_sample = AbcA::ArraySample( data, dataType, iSamp->getDimensions() );
+}
+
+//-*****************************************************************************
+void SampleWriteTask::prepare()
+{
+    if ( m_hasSample )
+    {
+        m_key = GetWrittenSampleKey( m_sample, m_hashID );
+    }
+}
+
+//-*****************************************************************************
+std::size_t SampleWriteTask::getNumBytes() const
+{
+    std::size_t numBytes = sizeof( *this ) + m_data.size();
+
+    for ( std::size_t i = 0; i < m_strings.size(); ++i )
+    {
+        numBytes += sizeof( std::string ) + m_strings[i].size();
+    }
+
+    for ( std::size_t i = 0; i < m_wstrings.size(); ++i )
+    {
+        numBytes += sizeof( std::wstring ) +
+            m_wstrings[i].size() * sizeof( wchar_t );
+    }
+
+    return numBytes;
+}
+
+#ifdef ALEMBIC_ASYNC_WRITE
+
+//-*****************************************************************************
+WriteQueue::WriteQueue( std::size_t iNumThreads, std::size_t iMaxBytes )
+    : m_nextPrepare( 0 )
+    , m_numBytes( 0 )
+    , m_maxBytes( iMaxBytes )
+    , m_stop( false )
+{
+    if ( iNumThreads < 1 )
+    {
+        iNumThreads = 1;
+    }
+
+    m_threads.push_back( std::thread( &WriteQueue::writeTasks, this ) );
+    for ( std::size_t i = 0; i < iNumThreads; ++i )
+    {
+        m_threads.push_back( std::thread( &WriteQueue::prepareTasks, this ) );
+    }
+}
+
+//-*****************************************************************************
+WriteQueue::~WriteQueue()
+{
+    {
+        std::unique_lock< std::mutex > lock( m_mutex );
+        while ( !m_entries.empty() )
+        {
+            m_doneCond.wait( lock );
+        }
+        m_stop = true;
+    }
+
+    m_prepareCond.notify_all();
+    m_writeCond.notify_all();
+
+    for ( std::size_t i = 0; i < m_threads.size(); ++i )
+    {
+        m_threads[i].join();
+    }
+}
+
+//-*****************************************************************************
+void WriteQueue::push( WriteTask * iTask )
+{
+    std::size_t numBytes = iTask->getNumBytes();
+
+    std::unique_lock< std::mutex > lock( m_mutex );
+
+    // always let at least one task in, no matter how big it is
+    while ( m_error.empty() && m_numBytes > 0 &&
+            m_numBytes + numBytes > m_maxBytes )
+    {
+        m_doneCond.wait( lock );
+    }
+
+    if ( !m_error.empty() )
+    {
+        std::string error = m_error;
+        lock.unlock();
+        delete iTask;
+        ABCA_THROW( error );
+    }
+
+    m_entries.push_back( Entry( iTask ) );
+    m_numBytes += numBytes;
+    lock.unlock();
+
+    m_prepareCond.notify_one();
+}
+
+//-*****************************************************************************
+void WriteQueue::wait()
+{
+    std::unique_lock< std::mutex > lock( m_mutex );
+    while ( !m_entries.empty() )
+    {
+        m_doneCond.wait( lock );
+    }
+
+    if ( !m_error.empty() )
+    {
+        std::string error = m_error;
+        lock.unlock();
+        ABCA_THROW( error );
+    }
+}
+
+//-*****************************************************************************
+void WriteQueue::setError( const std::string & iError )
+{
+    if ( m_error.empty() )
+    {
+        m_error = iError;
+    }
+}
+
+//-*****************************************************************************
+void WriteQueue::prepareTasks()
+{
+    std::unique_lock< std::mutex > lock( m_mutex );
+    for ( ;; )
+    {
+        while ( !m_stop && m_nextPrepare == m_entries.size() )
+        {
+            m_prepareCond.wait( lock );
+        }
+
+        if ( m_nextPrepare == m_entries.size() )
+        {
+            return;
+        }
+
+        // entries aren't removed until they are prepared and written, and
+        // adding to the end of a deque doesn't move the other entries
+        Entry & entry = m_entries[ m_nextPrepare++ ];
+        bool skip = !m_error.empty();
+        lock.unlock();
+
+        std::string error;
+        if ( !skip )
+        {
+            try
+            {
+                entry.task->prepare();
+            }
+            catch ( std::exception & e )
+            {
+                error = e.what();
+            }
+            catch ( ... )
+            {
+                error = "Unknown error while preparing a sample to write";
+            }
+        }
+
+        lock.lock();
+        if ( !error.empty() )
+        {
+            setError( error );
+        }
+
+        entry.prepared = true;
+        if ( &entry == &m_entries.front() )
+        {
+            m_writeCond.notify_one();
+        }
+    }
+}
+
+//-*****************************************************************************
+void WriteQueue::writeTasks()
+{
+    std::unique_lock< std::mutex > lock( m_mutex );
+    for ( ;; )
+    {
+        while ( !( m_stop && m_entries.empty() ) &&
+                ( m_entries.empty() || !m_entries.front().prepared ) )
+        {
+            m_writeCond.wait( lock );
+        }
+
+        if ( m_entries.empty() )
+        {
+            return;
+        }
+
+        WriteTask * task = m_entries.front().task;
+        bool skip = !m_error.empty();
+        lock.unlock();
+
+        std::string error;
+        if ( !skip )
+        {
+            try
+            {
+                task->write();
+            }
+            catch ( std::exception & e )
+            {
+                error = e.what();
+            }
+            catch ( ... )
+            {
+                error = "Unknown error while writing a sample";
+            }
+        }
+
+        std::size_t numBytes = task->getNumBytes();
+        delete task;
+
+        lock.lock();
+        if ( !error.empty() )
+        {
+            setError( error );
+        }
+
+        m_entries.pop_front();
+        m_nextPrepare --;
+        m_numBytes -= numBytes;
+        m_doneCond.notify_all();
+    }
+}
+
+#else
+
+//-*****************************************************************************
+WriteQueue::WriteQueue( std::size_t iNumThreads, std::size_t iMaxBytes )
+{
+}
+
+//-*****************************************************************************
+WriteQueue::~WriteQueue()
+{
+}
+
+//-*****************************************************************************
+void WriteQueue::push( WriteTask * iTask )
+{
+    try
+    {
+        iTask->prepare();
+        iTask->write();
+    }
+    catch ( ... )
+    {
+        delete iTask;
+        throw;
+    }
+
+    delete iTask;
+}
+
+//-*****************************************************************************
+void WriteQueue::wait()
+{
+}
+
+#endif
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcCoreOgawa
+} // End namespace Alembic
@@ -0,0 +1,182 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcCoreOgawa_WriteQueue_h_
+#define _Alembic_AbcCoreOgawa_WriteQueue_h_
+
+#include <Alembic/AbcCoreOgawa/Foundation.h>
+
+#if ( defined( _MSC_VER ) && _MSC_VER > 1600 ) || \
+    ( !defined( _MSC_VER ) && \
+      ( defined( __GXX_EXPERIMENTAL_CXX0X__ ) || __cplusplus >= 201103L ) )
+#define ALEMBIC_ASYNC_WRITE
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace Alembic {
+namespace AbcCoreOgawa {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+// A piece of work handed to the WriteQueue.
+class WriteTask : Alembic::Util::noncopyable
+{
+public:
+    virtual ~WriteTask() {}
+
+    // Called from one of the worker threads, tasks may be prepared in any
+    // order and at the same time as other tasks.
+    virtual void prepare() = 0;
+
+    // Called from the writing thread after prepare, tasks are written one at
+    // a time in the order they were pushed.
+    virtual void write() = 0;
+
+    // Roughly how much memory this task is holding on to.
+    virtual std::size_t getNumBytes() const = 0;
+};
+
+//-*****************************************************************************
+// A task which owns a copy of a sample and computes its key in prepare().
+class SampleWriteTask : public WriteTask
+{
+public:
+    // iSamp may be NULL if there is no sample to hash
+    SampleWriteTask( const AbcA::ArraySample * iSamp,
+                     AbcA::SampleHashID iHashID );
+
+    virtual void prepare();
+    virtual std::size_t getNumBytes() const;
+
+protected:
+    // NULL if no sample was given
+    const AbcA::ArraySample * getSample() const
+    { return m_hasSample ? &m_sample : NULL; }
+
+    const AbcA::ArraySample::Key & getKey() const { return m_key; }
+
+private:
+    std::vector< Util::uint8_t > m_data;
+    std::vector< std::string > m_strings;
+    std::vector< std::wstring > m_wstrings;
+    AbcA::ArraySample m_sample;
+    AbcA::ArraySample::Key m_key;
+    AbcA::SampleHashID m_hashID;
+    bool m_hasSample;
+};
+
+//-*****************************************************************************
+// Prepares tasks on a pool of worker threads, and writes them on a single
+// writing thread in the order they were pushed, so what ends up in the file
+// is exactly what would have been written if every task were prepared and
+// written right away on the calling thread.
+// Once iMaxBytes worth of tasks are waiting, push blocks until some of them
+// have been written.
+// If the tasks can't be run on other threads (no C++11 support) push
+// prepares and writes the task right away.
+class WriteQueue : Alembic::Util::noncopyable
+{
+public:
+    WriteQueue( std::size_t iNumThreads,
+                std::size_t iMaxBytes = 256 * 1024 * 1024 );
+
+    // waits for every task to be written
+    ~WriteQueue();
+
+    // Takes ownership of iTask.
+    // If a previously pushed task threw while being prepared or written
+    // the error is thrown from here, and no more tasks are written.
+    void push( WriteTask * iTask );
+
+    // Blocks until every pushed task has been written.
+    // If any of them threw while being prepared or written the error is
+    // thrown from here, and again from every later call.
+    void wait();
+
+private:
+
+#ifdef ALEMBIC_ASYNC_WRITE
+    void prepareTasks();
+    void writeTasks();
+    void setError( const std::string & iError );
+
+    struct Entry
+    {
+        Entry( WriteTask * iTask ) : task( iTask ), prepared( false ) {}
+        WriteTask * task;
+        bool prepared;
+    };
+
+    std::mutex m_mutex;
+
+    // signaled when there are new tasks to prepare, or when stopping
+    std::condition_variable m_prepareCond;
+
+    // signaled when the first task has been prepared, or when stopping
+    std::condition_variable m_writeCond;
+
+    // signaled when a task has been written
+    std::condition_variable m_doneCond;
+
+    // tasks which haven't been written yet, in the order they were pushed
+    std::deque< Entry > m_entries;
+
+    // index within m_entries of the next task to prepare
+    std::size_t m_nextPrepare;
+
+    std::size_t m_numBytes;
+    std::size_t m_maxBytes;
+    bool m_stop;
+
+    std::vector< std::thread > m_threads;
+#endif
+
+    std::string m_error;
+};
+
+typedef Alembic::Util::shared_ptr< WriteQueue > WriteQueuePtr;
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcCoreOgawa
+} // End namespace Alembic
+
+#endif
@@ -36,6 +36,7 @@
 
 #include <Alembic/AbcCoreOgawa/WriteUtil.h>
 #include <Alembic/AbcCoreOgawa/AwImpl.h>
+#include <Alembic/AbcCoreOgawa/CompressUtil.h>
 
 namespace Alembic {
 namespace AbcCoreOgawa {
@@ -64,6 +65,19 @@ void pushUint32WithHint( std::vector< Util::uint8_t > & ioData,
     }
 }
 
+//-*****************************************************************************
+// 7 bits at a time, least significant first, with the top bit set on all
+// but the last byte
+void pushVarint( std::vector< Util::uint8_t > & ioData, Util::uint32_t iVal )
+{
+    while ( iVal >= 0x80 )
+    {
+        ioData.push_back( ( Util::uint8_t )( iVal | 0x80 ) );
+        iVal >>= 7;
+    }
+    ioData.push_back( ( Util::uint8_t ) iVal );
+}
+
 //-*****************************************************************************
 void pushChrono( std::vector< Util::uint8_t > & ioData, chrono_t iVal )
 {
@@ -156,6 +170,26 @@ GetWrittenSampleMap( AbcA::ArchiveWriterPtr iVal )
     return ptr->getWrittenSampleMap();
 }
 
+//-*****************************************************************************
+AbcA::ArraySample::Key GetWrittenSampleKey( const AbcA::ArraySample & iSamp,
+                                            AbcA::SampleHashID iHashID )
+{
+    AbcA::ArraySample::Key key = iSamp.getKey( iHashID );
+
+    // mask out the non-string POD since Ogawa can safely share the same data
+    // even if it originated from a different POD
+    // the non-fixed sizes of our strings (plus added null characters) makes
+    // determing the sie harder so strings are handled seperately
+    if ( key.origPOD != Alembic::Util::kStringPOD &&
+         key.origPOD != Alembic::Util::kWstringPOD )
+    {
+        key.origPOD = Alembic::Util::kInt8POD;
+        key.readPOD = Alembic::Util::kInt8POD;
+    }
+
+    return key;
+}
+
 //-*****************************************************************************
 void WriteDimensions( Ogawa::OGroupPtr iGroup,
                       const AbcA::Dimensions & iDims,
@@ -183,7 +217,9 @@ WrittenSampleIDPtr
 WriteData( WrittenSampleMap &iMap,
            Ogawa::OGroupPtr iGroup,
            const AbcA::ArraySample &iSamp,
-           const AbcA::ArraySample::Key &iKey )
+           const AbcA::ArraySample::Key &iKey,
+           Util::int8_t iCompressionHint,
+           Util::uint8_t iCodec )
 {
 
     // Okay, need to actually store it.
@@ -203,6 +239,9 @@ WriteData( WrittenSampleMap &iMap,
 
     const AbcA::DataType &dataType = iSamp.getDataType();
 
+    // holds the compression header and compressed data
+    std::vector< Util::uint8_t > compressed;
+
     if ( dataType.getPod() == Alembic::Util::kStringPOD )
     {
         size_t numPods = dataType.getExtent() * dims.numPoints();
@@ -227,6 +266,15 @@ WriteData( WrittenSampleMap &iMap,
 
         const void * datas[2] = { &iKey.digest, &v.front() };
         Alembic::Util::uint64_t sizes[2] = { 16, v.size() };
+
+        if ( iCompressionHint >= 0 )
+        {
+            CompressData( &v.front(), v.size(), iCodec, iCompressionHint,
+                          compressed );
+            datas[1] = &compressed.front();
+            sizes[1] = compressed.size();
+        }
+
         dataPtr =  iGroup->addData( 2, sizes, datas );
     }
     else if ( dataType.getPod() == Alembic::Util::kWstringPOD )
@@ -255,6 +303,15 @@ WriteData( WrittenSampleMap &iMap,
         const void * datas[2] = { &iKey.digest, &v.front() };
         Alembic::Util::uint64_t sizes[2] = { 16,
             v.size() * sizeof(Util::int32_t) };
+
+        if ( iCompressionHint >= 0 )
+        {
+            CompressData( &v.front(), v.size() * sizeof(Util::int32_t),
+                          iCodec, iCompressionHint, compressed );
+            datas[1] = &compressed.front();
+            sizes[1] = compressed.size();
+        }
+
         dataPtr =  iGroup->addData( 2, sizes, datas );
     }
     else
@@ -262,6 +319,14 @@ WriteData( WrittenSampleMap &iMap,
         const void * datas[2] = { &iKey.digest, iSamp.getData() };
         Alembic::Util::uint64_t sizes[2] = { 16, iKey.numBytes };
 
+        if ( iCompressionHint >= 0 )
+        {
+            CompressData( iSamp.getData(), iKey.numBytes, iCodec,
+                          iCompressionHint, compressed );
+            datas[1] = &compressed.front();
+            sizes[1] = compressed.size();
+        }
+
         dataPtr = iGroup->addData( 2, sizes, datas );
     }
 
@@ -291,6 +356,8 @@ void WritePropertyInfo( std::vector< Util::uint8_t > & ioData,
                     const AbcA::PropertyHeader &iHeader,
                     bool isScalarLike,
                     bool isHomogenous,
+                    bool isCompressed,
+                    bool isPacked,
                     Util::uint32_t iTimeSamplingIndex,
                     Util::uint32_t iNumSamples,
                     Util::uint32_t iFirstChangedIndex,
@@ -327,6 +394,12 @@ void WritePropertyInfo( std::vector< Util::uint8_t > & ioData,
     // 0000 1111 1111 0000 0000 0000 0000 0000
     static const Util::uint32_t metaDataIndexMask = 0xff00000;
 
+    // 0001 0000 0000 0000 0000 0000 0000 0000
+    static const Util::uint32_t compressedMask = 0x10000000;
+
+    // 0010 0000 0000 0000 0000 0000 0000 0000
+    static const Util::uint32_t packedMask = 0x20000000;
+
     std::string metaData = iHeader.getMetaData().serialize();
     Util::uint32_t metaDataSize = metaData.size();
 
@@ -369,7 +442,8 @@ void WritePropertyInfo( std::vector< Util::uint8_t > & ioData,
 
     Util::uint32_t metaDataIndex = iMap->getIndex( metaData );
 
-    info |= metaDataIndexMask & ( metaDataIndex << 20 );
+    // indices past 0xff are written after the name, see below
+    info |= metaDataIndexMask & ( std::min( metaDataIndex, 0xffU ) << 20 );
 
     // compounds are treated differently
     if ( !iHeader.isCompound() )
@@ -410,6 +484,16 @@ void WritePropertyInfo( std::vector< Util::uint8_t > & ioData,
             info |= homogenousMask;
         }
 
+        if ( isCompressed )
+        {
+            info |= compressedMask;
+        }
+
+        if ( isPacked )
+        {
+            info |= packedMask;
+        }
+
         ABCA_ASSERT( iFirstChangedIndex <= iNumSamples &&
             iLastChangedIndex <= iNumSamples &&
             iFirstChangedIndex <= iLastChangedIndex,
@@ -458,6 +542,13 @@ void WritePropertyInfo( std::vector< Util::uint8_t > & ioData,
             ioData.insert( ioData.end(), metaData.begin(), metaData.end() );
         }
     }
+    // written meta data is never empty (that is index 0), so a size of 0
+    // means the index follows instead
+    else if ( metaDataIndex > 0xff )
+    {
+        pushUint32WithHint( ioData, 0, sizeHint );
+        pushVarint( ioData, metaDataIndex - 1 );
+    }
 
 }
 
@@ -477,7 +568,7 @@ void WriteObjectHeader( std::vector< Util::uint8_t > & ioData,
     Util::uint32_t metaDataIndex = iMap->getIndex( metaData );
 
     // write 1 byte for the meta data index
-    pushUint32WithHint( ioData, metaDataIndex, 0 );
+    pushUint32WithHint( ioData, std::min( metaDataIndex, 0xffU ), 0 );
 
     // write the size and meta data IF necessary
     if ( metaDataIndex == 0xff )
@@ -488,6 +579,13 @@ void WriteObjectHeader( std::vector< Util::uint8_t > & ioData,
             ioData.insert( ioData.end(), metaData.begin(), metaData.end() );
         }
     }
+    // written meta data is never empty (that is index 0), so a size of 0
+    // means the index follows instead
+    else if ( metaDataIndex > 0xff )
+    {
+        pushUint32WithHint( ioData, 0, 2 );
+        pushVarint( ioData, metaDataIndex - 1 );
+    }
 }
 
 //-*****************************************************************************
@@ -59,6 +59,11 @@ void HashDimensions( const AbcA::Dimensions & iDims,
 WrittenSampleMap& GetWrittenSampleMap(
     AbcA::ArchiveWriterPtr iArchive );
 
+//-*****************************************************************************
+// The key used to look up iSamp in the WrittenSampleMap.
+AbcA::ArraySample::Key GetWrittenSampleKey( const AbcA::ArraySample & iSamp,
+                                            AbcA::SampleHashID iHashID );
+
 //-*****************************************************************************
 void
 WriteDimensions( Ogawa::OGroupPtr iGroup,
@@ -71,11 +76,15 @@ CopyWrittenData( Ogawa::OGroupPtr iParent,
                  WrittenSampleIDPtr iRef );
 
 //-*****************************************************************************
+// If iCompressionHint is 0 or higher the data is compressed with iCodec
+// using the hint as the level.
 WrittenSampleIDPtr
 WriteData( WrittenSampleMap &iMap,
            Ogawa::OGroupPtr iGroup,
            const AbcA::ArraySample &iSamp,
-           const AbcA::ArraySample::Key &iKey );
+           const AbcA::ArraySample::Key &iKey,
+           Util::int8_t iCompressionHint = -1,
+           Util::uint8_t iCodec = 0 );
 
 //-*****************************************************************************
 void
@@ -83,6 +92,8 @@ WritePropertyInfo( std::vector< Util::uint8_t > & ioData,
                    const AbcA::PropertyHeader &iHeader,
                    bool isScalarLike,
                    bool isHomogenous,
+                   bool isCompressed,
+                   bool isPacked,
                    Util::uint32_t iTimeSamplingIndex,
                    Util::uint32_t iNumSamples,
                    Util::uint32_t iFirstChangedIndex,
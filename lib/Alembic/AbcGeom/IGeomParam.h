@@ -40,6 +40,9 @@
 #include <Alembic/AbcGeom/Foundation.h>
 #include <Alembic/AbcGeom/GeometryScope.h>
 
+#include <algorithm>
+#include <vector>
+
 namespace Alembic {
 namespace AbcGeom {
 namespace ALEMBIC_VERSION_NS {
@@ -134,9 +137,28 @@ public:
     void getIndexed( sample_type &oSamp,
                      const Abc::ISampleSelector &iSS = Abc::ISampleSelector() ) const;
 
+    //! Expands the values via the indices.  If the GeomParam is indexed the
+    //! expanded values are cached by the keys of the values and the indices,
+    //! so a param whose values and indices don't change from one sample to
+    //! the next hands back the same expanded sample.
     void getExpanded( sample_type &oSamp,
                       const Abc::ISampleSelector &iSS = Abc::ISampleSelector() ) const;
 
+    //! Expands the values via the indices into oBuffer, resizing it as
+    //! needed.  Reusing the same vector avoids an allocation per call.
+    void getExpanded( std::vector<value_type> &oBuffer,
+                      const Abc::ISampleSelector &iSS = Abc::ISampleSelector() ) const;
+
+    //! Expands the values via the indices into the caller provided oBuffer,
+    //! which must be able to hold iBufferSize values, and returns how many
+    //! values were written.  getExpandedSize says how big it needs to be.
+    size_t getExpanded( value_type *oBuffer, size_t iBufferSize,
+                        const Abc::ISampleSelector &iSS = Abc::ISampleSelector() ) const;
+
+    //! The number of values that getExpanded will produce.
+    size_t getExpandedSize( const Abc::ISampleSelector &iSS = \
+                            Abc::ISampleSelector() ) const;
+
     sample_type getIndexedValue( const Abc::ISampleSelector &iSS = \
                                  Abc::ISampleSelector() ) const
     {
@@ -186,6 +208,7 @@ public:
         m_valProp.reset();
         m_indicesProperty.reset();
         m_cprop.reset();
+        m_expandedCache.reset();
         m_isIndexed = false;
     }
 
@@ -205,6 +228,24 @@ private:
     Abc::ErrorHandler &getErrorHandler() const
     { return m_valProp.getErrorHandler(); }
 
+    // gathers oVals[i] = iVals[iIndices[i]], 4 at a time so that the loads
+    // and stores of independent elements can be overlapped
+    static void expand( const value_type *iVals, const uint32_t *iIndices,
+                        size_t iSize, value_type *oVals );
+
+    // the last expanded sample, and the keys of the values and indices
+    // that it was expanded from
+    struct ExpandedCache
+    {
+        ExpandedCache() : valid( false ) {}
+
+        Alembic::Util::mutex lock;
+        bool valid;
+        AbcA::ArraySampleKey valsKey;
+        AbcA::ArraySampleKey indicesKey;
+        typename sample_type::samp_ptr_type vals;
+    };
+
 protected:
     prop_type m_valProp;
 
@@ -212,6 +253,9 @@ protected:
     Abc::IUInt32ArrayProperty m_indicesProperty;
     Abc::ICompoundProperty m_cprop;
 
+    // shared between copies of this GeomParam, only exists when indexed
+    Alembic::Util::shared_ptr< ExpandedCache > m_expandedCache;
+
     bool m_isIndexed;
 };
 
@@ -253,6 +297,7 @@ ITypedGeomParam<TRAITS>::ITypedGeomParam( CPROP iParent,
                                                   iArg1 );
         m_valProp = ITypedArrayProperty<TRAITS>( m_cprop, ".vals", iArg0,
                                                  iArg1 );
+        m_expandedCache.reset( new ExpandedCache() );
         m_isIndexed = true;
     }
     else if ( pheader->isArray() )
@@ -304,6 +349,7 @@ ITypedGeomParam<TRAITS>::ITypedGeomParam( PROP iThis,
                                                   iArg1 );
         m_valProp = ITypedArrayProperty<TRAITS>( m_cprop, ".vals", iArg0,
                                                  iArg1 );
+        m_expandedCache.reset( new ExpandedCache() );
         m_isIndexed = true;
     }
     else
@@ -347,6 +393,32 @@ ITypedGeomParam<TRAITS>::getIndexed( typename ITypedGeomParam<TRAITS>::Sample &o
 }
 
 
+//-*****************************************************************************
+template <class TRAITS>
+void
+ITypedGeomParam<TRAITS>::expand( const value_type *iVals,
+                                 const uint32_t *iIndices,
+                                 size_t iSize, value_type *oVals )
+{
+    size_t i = 0;
+    for ( ; i + 4 <= iSize ; i += 4 )
+    {
+        const uint32_t i0 = iIndices[i];
+        const uint32_t i1 = iIndices[i + 1];
+        const uint32_t i2 = iIndices[i + 2];
+        const uint32_t i3 = iIndices[i + 3];
+        oVals[i] = iVals[i0];
+        oVals[i + 1] = iVals[i1];
+        oVals[i + 2] = iVals[i2];
+        oVals[i + 3] = iVals[i3];
+    }
+
+    for ( ; i < iSize ; ++i )
+    {
+        oVals[i] = iVals[ iIndices[i] ];
+    }
+}
+
 //-*****************************************************************************
 template <class TRAITS>
 void
@@ -359,43 +431,127 @@ ITypedGeomParam<TRAITS>::getExpanded( typename ITypedGeomParam<TRAITS>::Sample &
     if ( ! m_indicesProperty )
     {
         m_valProp.get( oSamp.m_vals, iSS );
+        return;
     }
-    else
-    {
-        Abc::UInt32ArraySamplePtr idxPtr = m_indicesProperty.getValue( iSS );
 
-        size_t size = idxPtr->size();
+    // if the keys of both the values and indices are known, and match what
+    // we last expanded, hand that back without reading anything
+    AbcA::ArraySampleKey valsKey;
+    AbcA::ArraySampleKey indicesKey;
+    bool hasKeys = m_expandedCache &&
+        m_valProp.getKey( valsKey, iSS ) &&
+        m_indicesProperty.getKey( indicesKey, iSS );
 
-        // no indices?  just return what we have in our values
-        if (size == 0)
+    if ( hasKeys )
+    {
+        Alembic::Util::scoped_lock l( m_expandedCache->lock );
+        if ( m_expandedCache->valid &&
+             m_expandedCache->valsKey == valsKey &&
+             m_expandedCache->indicesKey == indicesKey )
         {
-            m_valProp.get( oSamp.m_vals, iSS );
+            oSamp.m_vals = m_expandedCache->vals;
             return;
         }
+    }
+
+    Abc::UInt32ArraySamplePtr idxPtr = m_indicesProperty.getValue( iSS );
+
+    size_t size = idxPtr->size();
+
+    // no indices?  just return what we have in our values
+    if (size == 0)
+    {
+        m_valProp.get( oSamp.m_vals, iSS );
+        return;
+    }
 
-        Alembic::Util::shared_ptr< Abc::TypedArraySample<TRAITS> > valPtr = \
-            m_valProp.getValue( iSS );
+    Alembic::Util::shared_ptr< Abc::TypedArraySample<TRAITS> > valPtr = \
+        m_valProp.getValue( iSS );
 
-        typename TRAITS::value_type *v = new typename TRAITS::value_type[size];
+    value_type *v = new value_type[size];
 
-        for ( size_t i = 0 ; i < size ; ++i )
+    expand( valPtr->get(), idxPtr->get(), size, v );
+
+    const Alembic::Util::Dimensions dims( size );
+
+    oSamp.m_vals.reset( new Abc::TypedArraySample<TRAITS>( v, dims ),
+                        AbcA::TArrayDeleter<value_type>() );
+
+    if ( hasKeys )
+    {
+        Alembic::Util::scoped_lock l( m_expandedCache->lock );
+        m_expandedCache->valid = true;
+        m_expandedCache->valsKey = valsKey;
+        m_expandedCache->indicesKey = indicesKey;
+        m_expandedCache->vals = oSamp.m_vals;
+    }
+}
+
+//-*****************************************************************************
+template <class TRAITS>
+size_t
+ITypedGeomParam<TRAITS>::getExpandedSize( const Abc::ISampleSelector &iSS ) const
+{
+    Alembic::Util::Dimensions dims;
+    if ( m_indicesProperty )
+    {
+        m_indicesProperty.getDimensions( dims, iSS );
+        if ( dims.numPoints() != 0 )
         {
-            v[i] = (*valPtr)[ (*idxPtr)[i] ];
+            return dims.numPoints();
         }
+    }
 
-        // NOTE: we could create an ArraySampleKey and insert this into the
-        // cache.  If it were in the cache, we'd return the shared pointer
-        // from there and call delete[] on v, thus preventing potentially
-        // unbounded heap growth.  We should probably do this, but for now,
-        // we'll assume that we don't have too many of these, and we're not
-        // tightly memory-constrained. Ha!
+    m_valProp.getDimensions( dims, iSS );
+    return dims.numPoints();
+}
 
-        const Alembic::Util::Dimensions dims( size );
+//-*****************************************************************************
+template <class TRAITS>
+size_t
+ITypedGeomParam<TRAITS>::getExpanded( value_type *oBuffer, size_t iBufferSize,
+                                      const Abc::ISampleSelector &iSS ) const
+{
+    Alembic::Util::shared_ptr< Abc::TypedArraySample<TRAITS> > valPtr = \
+        m_valProp.getValue( iSS );
+
+    Abc::UInt32ArraySamplePtr idxPtr;
+    if ( m_indicesProperty )
+    {
+        idxPtr = m_indicesProperty.getValue( iSS );
+    }
 
-        oSamp.m_vals.reset( new Abc::TypedArraySample<TRAITS>( v, dims ),
-                            AbcA::TArrayDeleter<typename TRAITS::value_type>());
+    // not indexed, or no indices, just copy what we have in our values
+    if ( ! idxPtr || idxPtr->size() == 0 )
+    {
+        size_t size = valPtr->size();
+        ABCA_ASSERT( size <= iBufferSize,
+                     "Buffer of size " << iBufferSize
+                     << " too small to expand " << size << " values into." );
+        std::copy( valPtr->get(), valPtr->get() + size, oBuffer );
+        return size;
     }
 
+    size_t size = idxPtr->size();
+    ABCA_ASSERT( size <= iBufferSize,
+                 "Buffer of size " << iBufferSize
+                 << " too small to expand " << size << " values into." );
+
+    expand( valPtr->get(), idxPtr->get(), size, oBuffer );
+    return size;
+}
+
+//-*****************************************************************************
+template <class TRAITS>
+void
+ITypedGeomParam<TRAITS>::getExpanded( std::vector<value_type> &oBuffer,
+                                      const Abc::ISampleSelector &iSS ) const
+{
+    oBuffer.resize( getExpandedSize( iSS ) );
+    if ( !oBuffer.empty() )
+    {
+        getExpanded( &oBuffer.front(), oBuffer.size(), iSS );
+    }
 }
 
 //-*****************************************************************************
@@ -0,0 +1,581 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcGeom/SpatialIndex.h>
+
+#include <ImathBoxAlgo.h>
+
+#include <algorithm>
+#include <limits>
+
+#if ( defined( _MSC_VER ) && _MSC_VER > 1600 ) || \
+    ( !defined( _MSC_VER ) && \
+      ( defined( __GXX_EXPERIMENTAL_CXX0X__ ) || __cplusplus >= 201103L ) )
+#define ALEMBIC_PARALLEL_SPATIAL_INDEX
+#include <thread>
+#endif
+
+namespace Alembic {
+namespace AbcGeom {
+namespace ALEMBIC_VERSION_NS {
+
+namespace {
+
+//-*****************************************************************************
+// leaves with this many objects or less aren't split
+static const std::size_t kMaxLeafSize = 4;
+
+//-*****************************************************************************
+// how many trees are kept by default
+static const std::size_t kDefaultMaxTrees = 8;
+
+//-*****************************************************************************
+// orders objects by the center of their bounds along one axis
+class CenterLess
+{
+public:
+    CenterLess( const std::vector< Abc::Box3d > & iBounds, int iAxis )
+        : m_bounds( iBounds ), m_axis( iAxis ) {}
+
+    bool operator()( Util::uint32_t iLhs, Util::uint32_t iRhs ) const
+    {
+        return m_bounds[iLhs].center()[m_axis] <
+               m_bounds[iRhs].center()[m_axis];
+    }
+
+private:
+    const std::vector< Abc::Box3d > & m_bounds;
+    int m_axis;
+};
+
+//-*****************************************************************************
+class BoxTest
+{
+public:
+    BoxTest( const Abc::Box3d & iBox ) : m_box( iBox ) {}
+
+    bool operator()( const Abc::Box3d & iBounds ) const
+    {
+        return m_box.intersects( iBounds );
+    }
+
+private:
+    Abc::Box3d m_box;
+};
+
+//-*****************************************************************************
+class FrustumTest
+{
+public:
+    FrustumTest( const std::vector< Imath::Plane3d > & iPlanes )
+        : m_planes( iPlanes ) {}
+
+    bool operator()( const Abc::Box3d & iBounds ) const
+    {
+        for ( std::size_t i = 0; i < m_planes.size(); ++i )
+        {
+            // the corner furthest along the normal
+            const Abc::V3d & normal = m_planes[i].normal;
+            Abc::V3d corner(
+                normal.x >= 0.0 ? iBounds.max.x : iBounds.min.x,
+                normal.y >= 0.0 ? iBounds.max.y : iBounds.min.y,
+                normal.z >= 0.0 ? iBounds.max.z : iBounds.min.z );
+
+            if ( m_planes[i].distanceTo( corner ) < 0.0 )
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+private:
+    const std::vector< Imath::Plane3d > & m_planes;
+};
+
+//-*****************************************************************************
+class RayTest
+{
+public:
+    RayTest( const Abc::V3d & iOrigin, const Abc::V3d & iDir )
+        : m_origin( iOrigin ), m_dir( iDir ) {}
+
+    bool operator()( const Abc::Box3d & iBounds ) const
+    {
+        double tmin = 0.0;
+        double tmax = std::numeric_limits< double >::max();
+
+        for ( int i = 0; i < 3; ++i )
+        {
+            if ( m_dir[i] == 0.0 )
+            {
+                if ( m_origin[i] < iBounds.min[i] ||
+                     m_origin[i] > iBounds.max[i] )
+                {
+                    return false;
+                }
+                continue;
+            }
+
+            double t1 = ( iBounds.min[i] - m_origin[i] ) / m_dir[i];
+            double t2 = ( iBounds.max[i] - m_origin[i] ) / m_dir[i];
+            if ( t1 > t2 )
+            {
+                std::swap( t1, t2 );
+            }
+
+            tmin = std::max( tmin, t1 );
+            tmax = std::min( tmax, t2 );
+            if ( tmin > tmax )
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+private:
+    Abc::V3d m_origin;
+    Abc::V3d m_dir;
+};
+
+//-*****************************************************************************
+// walks down the nodes which pass iTest, and gathers up the objects in the
+// leaves which pass it too
+template < class TREE, class TEST >
+void FindObjects( const TREE & iTree, const TEST & iTest,
+                  std::vector< std::size_t > & oObjects )
+{
+    oObjects.clear();
+
+    if ( iTree.nodes.empty() )
+    {
+        return;
+    }
+
+    std::vector< std::size_t > stack( 1, 0 );
+    while ( !stack.empty() )
+    {
+        std::size_t index = stack.back();
+        stack.pop_back();
+
+        if ( !iTest( iTree.nodes[index].bounds ) )
+        {
+            continue;
+        }
+
+        Util::uint32_t first = iTree.nodes[index].first;
+        Util::uint32_t count = iTree.nodes[index].count;
+        if ( count == 0 )
+        {
+            stack.push_back( first );
+            stack.push_back( index + 1 );
+            continue;
+        }
+
+        for ( Util::uint32_t i = first; i < first + count; ++i )
+        {
+            Util::uint32_t obj = iTree.objects[i];
+            if ( iTest( iTree.worldBounds[obj] ) )
+            {
+                oObjects.push_back( obj );
+            }
+        }
+    }
+
+    std::sort( oObjects.begin(), oObjects.end() );
+}
+
+} // End anonymous namespace
+
+//-*****************************************************************************
+SpatialIndex::SpatialIndex()
+  : m_numThreads( 1 )
+  , m_isStatic( true )
+  , m_maxTrees( kDefaultMaxTrees )
+  , m_numQueries( 0 )
+{
+}
+
+//-*****************************************************************************
+SpatialIndex::SpatialIndex( const Abc::IObject & iRoot,
+                            std::size_t iNumThreads )
+  : m_evaluator( iRoot )
+  , m_numThreads( iNumThreads )
+  , m_isStatic( true )
+  , m_maxTrees( kDefaultMaxTrees )
+  , m_numQueries( 0 )
+{
+    std::vector< Abc::IObject > stack( 1, iRoot );
+    while ( !stack.empty() )
+    {
+        Abc::IObject obj = stack.back();
+        stack.pop_back();
+
+        for ( std::size_t i = obj.getNumChildren(); i > 0; --i )
+        {
+            stack.push_back( obj.getChild( i - 1 ) );
+        }
+
+        // look for the bounds in each schema of the object
+        AbcA::CompoundPropertyReaderPtr props = obj.getProperties().getPtr();
+        for ( std::size_t i = 0; i < props->getNumProperties(); ++i )
+        {
+            const AbcA::PropertyHeader & header =
+                props->getPropertyHeader( i );
+            if ( !header.isCompound() )
+            {
+                continue;
+            }
+
+            AbcA::CompoundPropertyReaderPtr schema =
+                props->getCompoundProperty( header.getName() );
+            const AbcA::PropertyHeader * boundsHeader =
+                schema->getPropertyHeader( ".selfBnds" );
+            if ( boundsHeader == NULL ||
+                 !Abc::IBox3dProperty::matches( *boundsHeader ) )
+            {
+                continue;
+            }
+
+            Object object;
+            object.fullName = obj.getFullName();
+            object.xformIndex = 0;
+            m_evaluator.getIndex( object.fullName, object.xformIndex );
+            object.bounds = Abc::IBox3dProperty( schema, ".selfBnds" );
+
+            m_isStatic = m_isStatic && object.bounds.isConstant() &&
+                m_evaluator.isStatic( object.xformIndex );
+
+            m_objects.push_back( object );
+            break;
+        }
+    }
+}
+
+//-*****************************************************************************
+const std::string & SpatialIndex::getFullName( std::size_t iIndex ) const
+{
+    ABCA_ASSERT( iIndex < m_objects.size(), "Invalid index: " << iIndex );
+    return m_objects[iIndex].fullName;
+}
+
+//-*****************************************************************************
+Abc::Box3d SpatialIndex::getWorldBounds( std::size_t iIndex, chrono_t iTime )
+{
+    ABCA_ASSERT( iIndex < m_objects.size(), "Invalid index: " << iIndex );
+    return getTree( iTime )->worldBounds[iIndex];
+}
+
+//-*****************************************************************************
+void SpatialIndex::findIntersecting( const Abc::Box3d & iBox, chrono_t iTime,
+                                     std::vector< std::size_t > & oObjects )
+{
+    TreePtr tree = getTree( iTime );
+    FindObjects( *tree, BoxTest( iBox ), oObjects );
+}
+
+//-*****************************************************************************
+void SpatialIndex::findInFrustum(
+    const std::vector< Imath::Plane3d > & iPlanes,
+    chrono_t iTime,
+    std::vector< std::size_t > & oObjects )
+{
+    TreePtr tree = getTree( iTime );
+    FindObjects( *tree, FrustumTest( iPlanes ), oObjects );
+}
+
+//-*****************************************************************************
+void SpatialIndex::findAlongRay( const Abc::V3d & iOrigin,
+                                 const Abc::V3d & iDir,
+                                 chrono_t iTime,
+                                 std::vector< std::size_t > & oObjects )
+{
+    TreePtr tree = getTree( iTime );
+    FindObjects( *tree, RayTest( iOrigin, iDir ), oObjects );
+}
+
+//-*****************************************************************************
+void SpatialIndex::clear()
+{
+    Util::scoped_lock l( m_treesLock );
+    m_trees.clear();
+}
+
+//-*****************************************************************************
+void SpatialIndex::setMaxTrees( std::size_t iMaxTrees )
+{
+    Util::scoped_lock l( m_treesLock );
+    m_maxTrees = std::max( iMaxTrees, ( std::size_t ) 1 );
+    trimTrees();
+}
+
+//-*****************************************************************************
+std::size_t SpatialIndex::getMaxTrees()
+{
+    Util::scoped_lock l( m_treesLock );
+    return m_maxTrees;
+}
+
+//-*****************************************************************************
+SpatialIndex::TreePtr SpatialIndex::getTree( chrono_t iTime )
+{
+    // every time has the same tree
+    chrono_t key = m_isStatic ? 0.0 : iTime;
+
+    EvaluatorPtr evaluator;
+    {
+        Util::scoped_lock l( m_treesLock );
+
+        std::map< chrono_t, CachedTree >::iterator it = m_trees.find( key );
+        if ( it != m_trees.end() )
+        {
+            it->second.lastUsed = ++m_numQueries;
+            return it->second.tree;
+        }
+
+        if ( m_evaluators.empty() )
+        {
+            evaluator.reset( new WorldXformEvaluator( m_evaluator ) );
+        }
+        else
+        {
+            evaluator = m_evaluators.back();
+            m_evaluators.pop_back();
+        }
+    }
+
+    // the lock isn't held while building, if another thread builds the
+    // tree for the same time meanwhile we use whichever was done first
+    TreePtr newTree( new Tree() );
+    buildTree( iTime, *evaluator, *newTree );
+
+    Util::scoped_lock l( m_treesLock );
+    m_evaluators.push_back( evaluator );
+
+    CachedTree & cached = m_trees[ key ];
+    if ( !cached.tree )
+    {
+        cached.tree = newTree;
+    }
+    cached.lastUsed = ++m_numQueries;
+
+    TreePtr tree = cached.tree;
+    trimTrees();
+    return tree;
+}
+
+//-*****************************************************************************
+void SpatialIndex::trimTrees()
+{
+    // there are only a few trees, so just look for the oldest each time
+    while ( m_trees.size() > m_maxTrees )
+    {
+        std::map< chrono_t, CachedTree >::iterator oldest = m_trees.begin();
+        std::map< chrono_t, CachedTree >::iterator it = m_trees.begin();
+        for ( ; it != m_trees.end(); ++it )
+        {
+            if ( it->second.lastUsed < oldest->second.lastUsed )
+            {
+                oldest = it;
+            }
+        }
+
+        m_trees.erase( oldest );
+    }
+}
+
+//-*****************************************************************************
+void SpatialIndex::readBounds( std::size_t iBegin, std::size_t iEnd,
+                               const Abc::ISampleSelector & iSS,
+                               const WorldXformEvaluator & iEvaluator,
+                               Tree & oTree )
+{
+    for ( std::size_t i = iBegin; i < iEnd; ++i )
+    {
+        const Object & object = m_objects[i];
+        Abc::Box3d bounds = object.bounds.getValue( iSS );
+        if ( !bounds.isEmpty() )
+        {
+            bounds = Imath::transform( bounds,
+                iEvaluator.getWorldMatrix( object.xformIndex ) );
+        }
+        oTree.worldBounds[i] = bounds;
+    }
+}
+
+#ifdef ALEMBIC_PARALLEL_SPATIAL_INDEX
+
+//-*****************************************************************************
+void SpatialIndex::readAllBounds( const Abc::ISampleSelector & iSS,
+                                  const WorldXformEvaluator & iEvaluator,
+                                  Tree & oTree )
+{
+    std::size_t numObjects = m_objects.size();
+    std::size_t numThreads = std::min( m_numThreads, numObjects );
+    if ( numThreads < 2 )
+    {
+        readBounds( 0, numObjects, iSS, iEvaluator, oTree );
+        return;
+    }
+
+    // each thread reads an even share of the bounds
+    std::vector< std::string > errors( numThreads );
+    std::vector< std::thread > threads;
+    for ( std::size_t i = 0; i < numThreads; ++i )
+    {
+        std::size_t begin = numObjects * i / numThreads;
+        std::size_t end = numObjects * ( i + 1 ) / numThreads;
+        std::string * error = &errors[i];
+        threads.push_back( std::thread(
+            [this, &iSS, &iEvaluator, &oTree, begin, end, error]()
+            {
+                try
+                {
+                    readBounds( begin, end, iSS, iEvaluator, oTree );
+                }
+                catch ( std::exception & e )
+                {
+                    *error = e.what();
+                }
+                catch ( ... )
+                {
+                    *error = "Unknown error while reading bounds";
+                }
+            } ) );
+    }
+
+    for ( std::size_t i = 0; i < threads.size(); ++i )
+    {
+        threads[i].join();
+    }
+
+    for ( std::size_t i = 0; i < errors.size(); ++i )
+    {
+        if ( !errors[i].empty() )
+        {
+            ABCA_THROW( errors[i] );
+        }
+    }
+}
+
+#else
+
+//-*****************************************************************************
+void SpatialIndex::readAllBounds( const Abc::ISampleSelector & iSS,
+                                  const WorldXformEvaluator & iEvaluator,
+                                  Tree & oTree )
+{
+    readBounds( 0, m_objects.size(), iSS, iEvaluator, oTree );
+}
+
+#endif
+
+//-*****************************************************************************
+void SpatialIndex::buildTree( chrono_t iTime,
+                              WorldXformEvaluator & iEvaluator,
+                              Tree & oTree )
+{
+    Abc::ISampleSelector iss( iTime );
+    iEvaluator.evaluate( iss, m_numThreads );
+
+    std::size_t numObjects = m_objects.size();
+    oTree.worldBounds.resize( numObjects );
+    readAllBounds( iss, iEvaluator, oTree );
+
+    // objects without bounds can't be found, so leave them out
+    for ( std::size_t i = 0; i < numObjects; ++i )
+    {
+        if ( !oTree.worldBounds[i].isEmpty() )
+        {
+            oTree.objects.push_back( ( Util::uint32_t ) i );
+        }
+    }
+
+    if ( !oTree.objects.empty() )
+    {
+        oTree.nodes.reserve( 2 * oTree.objects.size() / kMaxLeafSize + 1 );
+        oTree.nodes.push_back( Node() );
+        buildNode( oTree, 0, 0, oTree.objects.size() );
+    }
+}
+
+//-*****************************************************************************
+void SpatialIndex::buildNode( Tree & ioTree, std::size_t iNode,
+                              std::size_t iBegin, std::size_t iEnd )
+{
+    Abc::Box3d bounds;
+    Abc::Box3d centers;
+    for ( std::size_t i = iBegin; i < iEnd; ++i )
+    {
+        const Abc::Box3d & objBounds = ioTree.worldBounds[ ioTree.objects[i] ];
+        bounds.extendBy( objBounds );
+        centers.extendBy( objBounds.center() );
+    }
+
+    ioTree.nodes[iNode].bounds = bounds;
+
+    // objects with the same center can't be split up
+    if ( iEnd - iBegin <= kMaxLeafSize || centers.min == centers.max )
+    {
+        ioTree.nodes[iNode].first = ( Util::uint32_t ) iBegin;
+        ioTree.nodes[iNode].count = ( Util::uint32_t ) ( iEnd - iBegin );
+        return;
+    }
+
+    // split in half along the axis where the centers are most spread out
+    std::size_t mid = ( iBegin + iEnd ) / 2;
+    std::nth_element( ioTree.objects.begin() + iBegin,
+                      ioTree.objects.begin() + mid,
+                      ioTree.objects.begin() + iEnd,
+                      CenterLess( ioTree.worldBounds, centers.majorAxis() ) );
+
+    // the first child comes right after us, we remember where the second is
+    ioTree.nodes[iNode].count = 0;
+    ioTree.nodes.push_back( Node() );
+    buildNode( ioTree, iNode + 1, iBegin, mid );
+
+    std::size_t second = ioTree.nodes.size();
+    ioTree.nodes[iNode].first = ( Util::uint32_t ) second;
+    ioTree.nodes.push_back( Node() );
+    buildNode( ioTree, second, mid, iEnd );
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcGeom
+} // End namespace Alembic
@@ -0,0 +1,182 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcGeom_SpatialIndex_h_
+#define _Alembic_AbcGeom_SpatialIndex_h_
+
+#include <Alembic/Util/Export.h>
+#include <Alembic/AbcGeom/Foundation.h>
+#include <Alembic/AbcGeom/WorldXform.h>
+
+#include <ImathPlane.h>
+
+namespace Alembic {
+namespace AbcGeom {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+//! \brief A bounding volume hierarchy over the world space self bounds of
+//! the objects under an IObject.
+//! Every object with a .selfBnds property in one of its schemas is indexed.
+//! The tree for a time is built the first time it is queried, and the
+//! trees of the last few times that were queried are kept (see
+//! setMaxTrees).  If none of the bounds or world matrices change over time
+//! a single tree is shared by every time.  Queries may be made from several
+//! threads at once, and a tree is built without holding up the queries at
+//! other times.
+class ALEMBIC_EXPORT SpatialIndex
+{
+public:
+    SpatialIndex();
+
+    //! Finds the bounded objects under iRoot, iNumThreads is how many
+    //! threads are used to build each tree.
+    explicit SpatialIndex( const Abc::IObject & iRoot,
+                           std::size_t iNumThreads = 1 );
+
+    //! The number of bounded objects, which is what the queries return
+    //! indices into.
+    std::size_t getNumObjects() const { return m_objects.size(); }
+
+    const std::string & getFullName( std::size_t iIndex ) const;
+
+    //! The world space bounds of an object at iTime.
+    Abc::Box3d getWorldBounds( std::size_t iIndex, chrono_t iTime );
+
+    //! The objects whose world bounds intersect iBox at iTime.
+    void findIntersecting( const Abc::Box3d & iBox, chrono_t iTime,
+                           std::vector< std::size_t > & oObjects );
+
+    //! The objects whose world bounds are at least partly on the positive
+    //! side of every plane in iPlanes at iTime.  A frustum is the 6 planes
+    //! with their normals pointing inwards.
+    void findInFrustum( const std::vector< Imath::Plane3d > & iPlanes,
+                        chrono_t iTime,
+                        std::vector< std::size_t > & oObjects );
+
+    //! The objects whose world bounds are hit by the ray from iOrigin
+    //! along iDir at iTime.
+    void findAlongRay( const Abc::V3d & iOrigin, const Abc::V3d & iDir,
+                       chrono_t iTime,
+                       std::vector< std::size_t > & oObjects );
+
+    //! Throws away every tree that has been built.
+    void clear();
+
+    //! How many trees are kept, 8 by default.  When there are more the
+    //! least recently queried ones are thrown away.  At least one is
+    //! always kept.
+    void setMaxTrees( std::size_t iMaxTrees );
+    std::size_t getMaxTrees();
+
+private:
+    struct Object
+    {
+        std::string fullName;
+        std::size_t xformIndex;
+        Abc::IBox3dProperty bounds;
+    };
+
+    struct Node
+    {
+        Abc::Box3d bounds;
+
+        // leaves hold objects [first, first + count) of Tree::objects,
+        // inner nodes have count 0 and their children at index + 1 and
+        // first
+        Util::uint32_t first;
+        Util::uint32_t count;
+    };
+
+    struct Tree
+    {
+        std::vector< Abc::Box3d > worldBounds;
+        std::vector< Util::uint32_t > objects;
+        std::vector< Node > nodes;
+    };
+
+    typedef Util::shared_ptr< Tree > TreePtr;
+
+    struct CachedTree
+    {
+        CachedTree() : lastUsed( 0 ) {}
+
+        TreePtr tree;
+        Util::uint64_t lastUsed;
+    };
+
+    typedef Util::shared_ptr< WorldXformEvaluator > EvaluatorPtr;
+
+    TreePtr getTree( chrono_t iTime );
+    void trimTrees();
+    void buildTree( chrono_t iTime, WorldXformEvaluator & iEvaluator,
+                    Tree & oTree );
+    void readBounds( std::size_t iBegin, std::size_t iEnd,
+                     const Abc::ISampleSelector & iSS,
+                     const WorldXformEvaluator & iEvaluator, Tree & oTree );
+    void readAllBounds( const Abc::ISampleSelector & iSS,
+                        const WorldXformEvaluator & iEvaluator,
+                        Tree & oTree );
+    void buildNode( Tree & ioTree, std::size_t iNode,
+                    std::size_t iBegin, std::size_t iEnd );
+
+    std::vector< Object > m_objects;
+    WorldXformEvaluator m_evaluator;
+    std::size_t m_numThreads;
+
+    // whether every tree would be the same
+    bool m_isStatic;
+
+    // the trees and everything below are guarded by m_treesLock
+    std::map< chrono_t, CachedTree > m_trees;
+    std::size_t m_maxTrees;
+    Util::uint64_t m_numQueries;
+
+    // copies of m_evaluator which aren't building a tree right now, each
+    // tree being built needs its own since they hold the world matrices
+    std::vector< EvaluatorPtr > m_evaluators;
+
+    Util::mutex m_treesLock;
+};
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcGeom
+} // End namespace Alembic
+
+#endif
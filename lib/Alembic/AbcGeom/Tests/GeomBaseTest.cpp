@@ -349,6 +349,43 @@ void IndexexedGeomParamTest()
             samp.getIndices()->get()[1] == 1 &&
             samp.getIndices()->get()[2] == 2 &&
             samp.getIndices()->get()[3] == 0 );
+
+        // constant values and indices share the same expanded sample
+        IStringGeomParam::Sample samp0;
+        IStringGeomParam::Sample samp1;
+        cvci.getExpanded( samp0, ISampleSelector( 0.0 ) );
+        cvci.getExpanded( samp1, ISampleSelector( 1.0/24.0 ) );
+        TESTING_ASSERT( samp0.getVals() == samp1.getVals() );
+
+        // but animated ones do not
+        avai.getExpanded( samp0, ISampleSelector( 0.0 ) );
+        avai.getExpanded( samp1, ISampleSelector( 1.0/24.0 ) );
+        TESTING_ASSERT( samp0.getVals() != samp1.getVals() );
+        TESTING_ASSERT( samp1.getVals()->get()[3] == "aa" );
+
+        // expanding into a caller buffer
+        std::vector< std::string > buffer;
+        cvai.getExpanded( buffer, ISampleSelector( 1.0/24.0 ) );
+        TESTING_ASSERT( buffer.size() == 4 && buffer[0] == "a" &&
+            buffer[1] == "b" && buffer[2] == "c" && buffer[3] == "a" );
+        TESTING_ASSERT( avai.getExpandedSize( ISampleSelector( 0.0 ) ) == 4 );
+
+        std::string raw[4];
+        TESTING_ASSERT( avai.getExpanded( raw, 4,
+                        ISampleSelector( 1.0/24.0 ) ) == 4 );
+        TESTING_ASSERT( raw[0] == "aa" && raw[1] == "b" && raw[2] == "c" &&
+                        raw[3] == "aa" );
+
+        bool threw = false;
+        try
+        {
+            avai.getExpanded( raw, 3, ISampleSelector( 0.0 ) );
+        }
+        catch ( std::exception & )
+        {
+            threw = true;
+        }
+        TESTING_ASSERT( threw );
     }
 }
 
@@ -125,6 +125,247 @@ void rotateTest()
     }
 }
 
+//-*****************************************************************************
+// the world matrix the slow way, from the XformSample of every ancestor
+M44d slowWorldMatrix( IObject iObj, const ISampleSelector & iSS )
+{
+    M44d ret;
+    ret.makeIdentity();
+
+    for ( IObject obj = iObj; obj.valid(); obj = obj.getParent() )
+    {
+        if ( IXform::matches( obj.getHeader() ) )
+        {
+            IXform xform( obj, kWrapExisting );
+            XformSample samp = xform.getSchema().getValue( iSS );
+            ret = ret * samp.getMatrix();
+            if ( !samp.getInheritsXforms() )
+            {
+                break;
+            }
+        }
+    }
+
+    return ret;
+}
+
+void worldXformTest()
+{
+    std::string fileName = "worldXform.abc";
+    {
+        OArchive archive( Alembic::AbcCoreOgawa::WriteArchive(), fileName );
+        OXform a( OObject( archive, kTop ), "a" );
+        OXform b( a, "b" );
+        OObject c( b, "c" );
+        OXform d( c, "d" );
+        OXform e( a, "e" );
+        OXform f( d, "f" );
+
+        // more channels than fit in a scalar .vals
+        OXform g( e, "g" );
+
+        XformSample bSamp;
+        bSamp.addOp( XformOp( kScaleOperation ), V3d( 2.0, 3.0, 4.0 ) );
+        bSamp.addOp( XformOp( kRotateYOperation ), 30.0 );
+        b.getSchema().set( bSamp );
+
+        XformSample eSamp;
+        e.getSchema().set( eSamp );
+
+        XformSample fSamp;
+        fSamp.addOp( XformOp( kRotateOperation ), V3d( 1.0, 1.0, 0.0 ), 10.0 );
+        f.getSchema().set( fSamp );
+
+        for ( std::size_t i = 0; i < 10; ++i )
+        {
+            XformSample aSamp;
+            aSamp.addOp( XformOp( kTranslateOperation ),
+                         V3d( 1.0 * i, 2.0, -3.0 * i ) );
+            aSamp.addOp( XformOp( kRotateXOperation ), 5.0 * i );
+            a.getSchema().set( aSamp );
+
+            M44d mat;
+            mat.makeIdentity();
+            mat.x[3][1] = 0.5 * i;
+            XformSample dSamp;
+            dSamp.setMatrix( mat );
+            dSamp.setInheritsXforms( i % 2 == 0 );
+            d.getSchema().set( dSamp );
+
+            XformSample gSamp;
+            for ( std::size_t j = 0; j < 17; ++j )
+            {
+                M44d gMat;
+                gMat.setEulerAngles( V3d( 0.01 * i, 0.02 * j, 0.0 ) );
+                gMat.x[3][2] = 0.1 * j;
+                gSamp.addOp( XformOp( kMatrixOperation ), gMat );
+            }
+            g.getSchema().set( gSamp );
+        }
+    }
+
+    {
+        IArchive archive( Alembic::AbcCoreOgawa::ReadArchive(), fileName );
+        IObject a( IObject( archive, kTop ), "a" );
+
+        WorldXformEvaluator evaluator( IObject( archive, kTop ) );
+        TESTING_ASSERT( evaluator.getNumObjects() == 8 );
+
+        IObject g( IObject( a, "e" ), "g" );
+        TESTING_ASSERT( g.getProperties().getPropertyHeader( ".xform" ) );
+        TESTING_ASSERT( ICompoundProperty( g.getProperties(), ".xform" ).
+            getPropertyHeader( ".vals" )->isArray() );
+        TESTING_ASSERT( evaluator.getFullName( 0 ) == "/" );
+        TESTING_ASSERT( evaluator.getFullName( 1 ) == "/a" );
+        TESTING_ASSERT( evaluator.getFullName( 2 ) == "/a/b" );
+        TESTING_ASSERT( evaluator.getFullName( 6 ) == "/a/e" );
+        TESTING_ASSERT( evaluator.isStatic( 0 ) );
+        TESTING_ASSERT( !evaluator.isStatic( 1 ) );
+        TESTING_ASSERT( !evaluator.isStatic( 6 ) );
+
+        M44d mat;
+        TESTING_ASSERT( !evaluator.getWorldMatrix( "/nope", mat ) );
+
+        for ( index_t i = 0; i < 10; ++i )
+        {
+            ISampleSelector iss( i );
+            evaluator.evaluate( iss, i % 2 == 0 ? 1 : 4 );
+
+            for ( std::size_t j = 0; j < evaluator.getNumObjects(); ++j )
+            {
+                IObject obj = archive.getTop();
+                std::string fullName = evaluator.getFullName( j );
+                std::size_t pos = 1;
+                while ( pos < fullName.size() )
+                {
+                    std::size_t next = fullName.find( '/', pos );
+                    if ( next == std::string::npos )
+                    {
+                        next = fullName.size();
+                    }
+                    obj = obj.getChild( fullName.substr( pos, next - pos ) );
+                    pos = next + 1;
+                }
+
+                M44d slow = slowWorldMatrix( obj, iss );
+                TESTING_ASSERT( evaluator.getWorldMatrix( j ).equalWithAbsError(
+                    slow, 1e-9 ) );
+                TESTING_ASSERT( evaluator.getWorldMatrix( fullName, mat ) );
+                TESTING_ASSERT( mat == evaluator.getWorldMatrix( j ) );
+                TESTING_ASSERT( GetWorldMatrix( obj, iss ).equalWithAbsError(
+                    slow, 1e-9 ) );
+            }
+        }
+
+        // only the subtree under b
+        WorldXformEvaluator bEvaluator( a.getChild( "b" ) );
+        TESTING_ASSERT( bEvaluator.getNumObjects() == 4 );
+        bEvaluator.evaluate( ISampleSelector( ( index_t ) 3 ) );
+        evaluator.evaluate( ISampleSelector( ( index_t ) 3 ) );
+        TESTING_ASSERT( bEvaluator.getWorldMatrix( 3 ) ==
+                        evaluator.getWorldMatrix( 5 ) );
+    }
+}
+
+//-*****************************************************************************
+void spatialIndexTest()
+{
+    std::string fileName = "spatialIndex.abc";
+    {
+        OArchive archive( Alembic::AbcCoreOgawa::WriteArchive(), fileName );
+        OXform a( OObject( archive, kTop ), "a" );
+        OPoints p( a, "p" );
+        OPoints q( OObject( archive, kTop ), "q" );
+
+        std::vector< V3f > pPos;
+        pPos.push_back( V3f( -1.0f, -1.0f, -1.0f ) );
+        pPos.push_back( V3f( 1.0f, 1.0f, 1.0f ) );
+
+        std::vector< V3f > qPos;
+        qPos.push_back( V3f( 99.0f, 99.0f, 99.0f ) );
+        qPos.push_back( V3f( 101.0f, 101.0f, 101.0f ) );
+
+        std::vector< Alembic::Util::uint64_t > ids;
+        ids.push_back( 0 );
+        ids.push_back( 1 );
+
+        OPointsSchema::Sample pSamp( P3fArraySample( pPos ),
+                                     UInt64ArraySample( ids ) );
+        pSamp.setSelfBounds( Box3d( V3d( -1.0 ), V3d( 1.0 ) ) );
+        p.getSchema().set( pSamp );
+
+        OPointsSchema::Sample qSamp( P3fArraySample( qPos ),
+                                     UInt64ArraySample( ids ) );
+        qSamp.setSelfBounds( Box3d( V3d( 99.0 ), V3d( 101.0 ) ) );
+        q.getSchema().set( qSamp );
+
+        for ( std::size_t i = 0; i < 3; ++i )
+        {
+            XformSample aSamp;
+            aSamp.setTranslation( V3d( 10.0 * i, 0.0, 0.0 ) );
+            a.getSchema().set( aSamp );
+        }
+    }
+
+    {
+        IArchive archive( Alembic::AbcCoreOgawa::ReadArchive(), fileName );
+        SpatialIndex index( archive.getTop(), 2 );
+        TESTING_ASSERT( index.getNumObjects() == 2 );
+        TESTING_ASSERT( index.getFullName( 0 ) == "/a/p" );
+        TESTING_ASSERT( index.getFullName( 1 ) == "/q" );
+
+        TESTING_ASSERT( index.getWorldBounds( 0, 2.0 ) ==
+                        Box3d( V3d( 19.0, -1.0, -1.0 ),
+                               V3d( 21.0, 1.0, 1.0 ) ) );
+        TESTING_ASSERT( index.getWorldBounds( 1, 2.0 ) ==
+                        Box3d( V3d( 99.0 ), V3d( 101.0 ) ) );
+
+        std::vector< std::size_t > found;
+        Box3d box( V3d( 9.0, -1.0, -1.0 ), V3d( 11.0, 1.0, 1.0 ) );
+        index.findIntersecting( box, 1.0, found );
+        TESTING_ASSERT( found.size() == 1 && found[0] == 0 );
+
+        index.findIntersecting( box, 0.0, found );
+        TESTING_ASSERT( found.empty() );
+
+        // everything with x >= 50
+        std::vector< Imath::Plane3d > planes;
+        planes.push_back( Imath::Plane3d( V3d( 1.0, 0.0, 0.0 ), 50.0 ) );
+        index.findInFrustum( planes, 1.0, found );
+        TESTING_ASSERT( found.size() == 1 && found[0] == 1 );
+
+        index.findAlongRay( V3d( 100.0, 100.0, 0.0 ), V3d( 0.0, 0.0, 1.0 ),
+                            1.0, found );
+        TESTING_ASSERT( found.size() == 1 && found[0] == 1 );
+
+        index.findAlongRay( V3d( 100.0, 100.0, 0.0 ), V3d( 0.0, 0.0, -1.0 ),
+                            1.0, found );
+        TESTING_ASSERT( found.empty() );
+
+        index.clear();
+        index.findIntersecting( Box3d( V3d( -1000.0 ), V3d( 1000.0 ) ), 2.0,
+                                found );
+        TESTING_ASSERT( found.size() == 2 );
+
+        // trees thrown away to stay under the limit are built again
+        TESTING_ASSERT( index.getMaxTrees() == 8 );
+        index.setMaxTrees( 2 );
+        TESTING_ASSERT( index.getMaxTrees() == 2 );
+        for ( std::size_t i = 0; i < 9; ++i )
+        {
+            double t = ( double )( i % 3 );
+            TESTING_ASSERT( index.getWorldBounds( 0, t ) ==
+                            Box3d( V3d( 10.0 * t - 1.0, -1.0, -1.0 ),
+                                   V3d( 10.0 * t + 1.0, 1.0, 1.0 ) ) );
+        }
+
+        index.setMaxTrees( 0 );
+        TESTING_ASSERT( index.getMaxTrees() == 1 );
+        index.findIntersecting( box, 1.0, found );
+        TESTING_ASSERT( found.size() == 1 && found[0] == 0 );
+    }
+}
+
 //-*****************************************************************************
 int main( int argc, char *argv[] )
 {
@@ -133,5 +374,8 @@ int main( int argc, char *argv[] )
 
     rotateTest();
 
+    worldXformTest();
+    spatialIndexTest();
+
     return 0;
 }
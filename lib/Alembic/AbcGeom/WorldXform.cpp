@@ -0,0 +1,564 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/AbcGeom/WorldXform.h>
+#include <Alembic/AbcGeom/IXform.h>
+
+#if ( defined( _MSC_VER ) && _MSC_VER > 1600 ) || \
+    ( !defined( _MSC_VER ) && \
+      ( defined( __GXX_EXPERIMENTAL_CXX0X__ ) || __cplusplus >= 201103L ) )
+#define ALEMBIC_PARALLEL_WORLD_XFORMS
+#include <mutex>
+#include <thread>
+#endif
+
+namespace Alembic {
+namespace AbcGeom {
+namespace ALEMBIC_VERSION_NS {
+
+namespace {
+
+//-*****************************************************************************
+// oMatrix = iRot * oMatrix, where only the upper 3x3 of iRot isn't identity
+void PreMultiplyRotation( const Abc::M44d & iRot, Abc::M44d & oMatrix )
+{
+    double rows[3][4];
+    for ( std::size_t i = 0; i < 3; ++i )
+    {
+        for ( std::size_t k = 0; k < 4; ++k )
+        {
+            rows[i][k] = iRot.x[i][0] * oMatrix.x[0][k] +
+                         iRot.x[i][1] * oMatrix.x[1][k] +
+                         iRot.x[i][2] * oMatrix.x[2][k];
+        }
+    }
+
+    for ( std::size_t i = 0; i < 3; ++i )
+    {
+        for ( std::size_t k = 0; k < 4; ++k )
+        {
+            oMatrix.x[i][k] = rows[i][k];
+        }
+    }
+}
+
+//-*****************************************************************************
+// Same result as XformSample::getMatrix, but translates and scales only
+// touch the rows of the matrix that they change instead of doing a full
+// 4x4 multiply for every op.
+void ComposeOps( const std::vector< XformOperationType > & iOps,
+                 const double * iVals,
+                 Abc::M44d & oMatrix )
+{
+    oMatrix.makeIdentity();
+
+    for ( std::size_t i = 0; i < iOps.size(); ++i )
+    {
+        switch ( iOps[i] )
+        {
+            case kTranslateOperation:
+            {
+                for ( std::size_t k = 0; k < 4; ++k )
+                {
+                    oMatrix.x[3][k] += iVals[0] * oMatrix.x[0][k] +
+                                       iVals[1] * oMatrix.x[1][k] +
+                                       iVals[2] * oMatrix.x[2][k];
+                }
+                iVals += 3;
+            }
+            break;
+
+            case kScaleOperation:
+            {
+                for ( std::size_t k = 0; k < 4; ++k )
+                {
+                    oMatrix.x[0][k] *= iVals[0];
+                    oMatrix.x[1][k] *= iVals[1];
+                    oMatrix.x[2][k] *= iVals[2];
+                }
+                iVals += 3;
+            }
+            break;
+
+            case kMatrixOperation:
+            {
+                Abc::M44d m;
+                for ( std::size_t j = 0; j < 4; ++j )
+                {
+                    for ( std::size_t k = 0; k < 4; ++k )
+                    {
+                        m.x[j][k] = iVals[ ( 4 * j ) + k ];
+                    }
+                }
+                oMatrix = m * oMatrix;
+                iVals += 16;
+            }
+            break;
+
+            case kRotateOperation:
+            {
+                Abc::M44d m;
+                m.setAxisAngle( Abc::V3d( iVals[0], iVals[1], iVals[2] ),
+                                DegreesToRadians( iVals[3] ) );
+                PreMultiplyRotation( m, oMatrix );
+                iVals += 4;
+            }
+            break;
+
+            case kRotateXOperation:
+            case kRotateYOperation:
+            case kRotateZOperation:
+            {
+                Abc::V3d axis( 0.0, 0.0, 0.0 );
+                axis[ iOps[i] - kRotateXOperation ] = 1.0;
+
+                Abc::M44d m;
+                m.setAxisAngle( axis, DegreesToRadians( iVals[0] ) );
+                PreMultiplyRotation( m, oMatrix );
+                iVals += 1;
+            }
+            break;
+        }
+    }
+}
+
+} // End anonymous namespace
+
+//-*****************************************************************************
+WorldXformEvaluator::Node::Node()
+  : parent( 0 )
+  , end( 0 )
+  , isXform( false )
+  , isConstant( true )
+  , isConstantIdentity( true )
+  , isStatic( true )
+  , isStaticSubtree( true )
+  , evaluated( false )
+  , inherits( true )
+{
+    local.makeIdentity();
+    world.makeIdentity();
+}
+
+//-*****************************************************************************
+WorldXformEvaluator::WorldXformEvaluator( const Abc::IObject & iRoot,
+                                          bool iIncludeDescendants )
+  : m_rootIndex( 0 )
+{
+    std::vector< Abc::IObject > ancestors;
+    for ( Abc::IObject obj = iRoot.getParent(); obj.valid();
+          obj = obj.getParent() )
+    {
+        ancestors.push_back( obj );
+    }
+
+    // top down, each one the parent of the next
+    for ( std::size_t i = ancestors.size(); i > 0; --i )
+    {
+        addNode( ancestors[i - 1], m_nodes.empty() ? 0 : m_nodes.size() - 1 );
+    }
+
+    m_rootIndex = m_nodes.size();
+    addNode( iRoot, m_rootIndex > 0 ? m_rootIndex - 1 : 0 );
+
+    if ( iIncludeDescendants )
+    {
+        // depth first, so that every subtree is a contiguous range
+        std::vector< std::pair< Abc::IObject, std::size_t > > stack;
+        for ( std::size_t i = iRoot.getNumChildren(); i > 0; --i )
+        {
+            stack.push_back( std::make_pair( iRoot.getChild( i - 1 ),
+                                             m_rootIndex ) );
+        }
+
+        while ( !stack.empty() )
+        {
+            Abc::IObject obj = stack.back().first;
+            std::size_t parent = stack.back().second;
+            stack.pop_back();
+
+            if ( parent == m_rootIndex )
+            {
+                m_subtrees.push_back( m_nodes.size() );
+            }
+
+            std::size_t index = m_nodes.size();
+            addNode( obj, parent );
+
+            for ( std::size_t i = obj.getNumChildren(); i > 0; --i )
+            {
+                stack.push_back( std::make_pair( obj.getChild( i - 1 ),
+                                                 index ) );
+            }
+        }
+    }
+
+    // fill in where each subtree ends and whether all of it is static,
+    // walking backwards so the children are done before their parents
+    for ( std::size_t i = m_nodes.size(); i > 0; --i )
+    {
+        Node & node = m_nodes[i - 1];
+        if ( node.end == 0 )
+        {
+            node.end = i;
+        }
+
+        if ( i - 1 > 0 )
+        {
+            Node & parent = m_nodes[node.parent];
+            if ( parent.end < node.end )
+            {
+                parent.end = node.end;
+            }
+
+            parent.isStaticSubtree = parent.isStaticSubtree &&
+                node.isStaticSubtree;
+        }
+    }
+
+    for ( std::size_t i = m_rootIndex; i < m_nodes.size(); ++i )
+    {
+        m_nameToIndex[ m_nodes[i].fullName ] = i - m_rootIndex;
+    }
+}
+
+//-*****************************************************************************
+void WorldXformEvaluator::addNode( const Abc::IObject & iObject,
+                                   std::size_t iParent )
+{
+    m_nodes.push_back( Node() );
+    Node & node = m_nodes.back();
+    node.parent = iParent;
+    node.fullName = iObject.getFullName();
+
+    AbcA::CompoundPropertyReaderPtr xform;
+    if ( IXform::matches( iObject.getHeader() ) )
+    {
+        xform = iObject.getProperties().getPtr()->getCompoundProperty(
+            ".xform" );
+    }
+
+    if ( xform )
+    {
+        node.isXform = true;
+
+        AbcA::ScalarPropertyReaderPtr ops = xform->getScalarProperty( ".ops" );
+        if ( ops && ops->getNumSamples() > 0 )
+        {
+            std::size_t numOps = ops->getHeader().getDataType().getExtent();
+            std::vector< Alembic::Util::uint8_t > opVec( numOps );
+            ops->getSample( 0, &( opVec.front() ) );
+
+            for ( std::size_t i = 0; i < numOps; ++i )
+            {
+                XformOp op( opVec[i] );
+                node.ops.push_back( op.getType() );
+                for ( std::size_t j = 0; j < op.getNumChannels(); ++j )
+                {
+                    node.vals.push_back( op.getDefaultChannelValue( j ) );
+                }
+            }
+        }
+
+        const AbcA::PropertyHeader * valsHeader =
+            xform->getPropertyHeader( ".vals" );
+        if ( valsHeader && valsHeader->isScalar() )
+        {
+            node.scalarVals = xform->getScalarProperty( ".vals" );
+            node.isConstant = node.scalarVals->isConstant();
+
+            std::size_t extent = valsHeader->getDataType().getExtent();
+            if ( node.vals.size() < extent )
+            {
+                node.vals.resize( extent, 0.0 );
+            }
+        }
+        else if ( valsHeader )
+        {
+            node.arrayVals = xform->getArrayProperty( ".vals" );
+            node.isConstant = node.arrayVals->isConstant();
+        }
+
+        if ( xform->getPropertyHeader( ".inherits" ) )
+        {
+            node.inheritsProperty = Abc::IBoolProperty( xform, ".inherits" );
+            node.isConstant = node.isConstant &&
+                node.inheritsProperty.isConstant();
+        }
+
+        // that it's there at all means we're not constant identity
+        node.isConstantIdentity = node.isConstant &&
+            xform->getPropertyHeader( "isNotConstantIdentity" ) == NULL;
+    }
+
+    node.isStatic = node.isConstant &&
+        ( m_nodes.size() == 1 || m_nodes[iParent].isStatic );
+    node.isStaticSubtree = node.isStatic;
+}
+
+//-*****************************************************************************
+void WorldXformEvaluator::evaluateNode( std::size_t iIndex,
+                                        const Abc::ISampleSelector & iSS )
+{
+    Node & node = m_nodes[iIndex];
+    if ( node.evaluated && node.isStatic )
+    {
+        return;
+    }
+
+    if ( node.isXform && ( !node.evaluated || !node.isConstant ) )
+    {
+        if ( node.scalarVals && node.scalarVals->getNumSamples() > 0 )
+        {
+            AbcA::index_t index = iSS.getIndex(
+                node.scalarVals->getTimeSampling(),
+                node.scalarVals->getNumSamples() );
+            node.scalarVals->getSample( index, &( node.vals.front() ) );
+        }
+        else if ( node.arrayVals && node.arrayVals->getNumSamples() > 0 )
+        {
+            AbcA::index_t index = iSS.getIndex(
+                node.arrayVals->getTimeSampling(),
+                node.arrayVals->getNumSamples() );
+
+            AbcA::ArraySamplePtr sample;
+            node.arrayVals->getSample( index, sample );
+
+            const double * data =
+                static_cast< const double * >( sample->getData() );
+            std::size_t size = std::min( node.vals.size(),
+                sample->getDimensions().numPoints() );
+            std::copy( data, data + size, node.vals.begin() );
+        }
+
+        if ( node.inheritsProperty &&
+             node.inheritsProperty.getNumSamples() > 0 )
+        {
+            node.inherits = node.inheritsProperty.getValue( iSS );
+        }
+
+        if ( node.isConstantIdentity || node.ops.empty() )
+        {
+            node.local.makeIdentity();
+        }
+        else
+        {
+            ComposeOps( node.ops, &( node.vals.front() ), node.local );
+        }
+    }
+
+    // the first node has no parent
+    bool hasParent = iIndex > 0 && ( !node.isXform || node.inherits );
+
+    if ( !node.isXform )
+    {
+        node.world = hasParent ? m_nodes[node.parent].world : node.local;
+    }
+    else if ( hasParent )
+    {
+        node.world = node.local * m_nodes[node.parent].world;
+    }
+    else
+    {
+        node.world = node.local;
+    }
+
+    node.evaluated = true;
+}
+
+//-*****************************************************************************
+void WorldXformEvaluator::evaluateRange( std::size_t iBegin, std::size_t iEnd,
+                                         const Abc::ISampleSelector & iSS )
+{
+    for ( std::size_t i = iBegin; i < iEnd; ++i )
+    {
+        // skip whole subtrees that were already evaluated and never change
+        if ( m_nodes[i].isStaticSubtree && m_nodes[i].evaluated )
+        {
+            i = m_nodes[i].end - 1;
+            continue;
+        }
+
+        evaluateNode( i, iSS );
+    }
+}
+
+#ifdef ALEMBIC_PARALLEL_WORLD_XFORMS
+
+//-*****************************************************************************
+void WorldXformEvaluator::evaluate( const Abc::ISampleSelector & iSS,
+                                    std::size_t iNumThreads )
+{
+    // the ancestors and the root are needed by everything else
+    evaluateRange( 0, m_rootIndex + 1, iSS );
+
+    if ( iNumThreads < 2 || m_subtrees.size() < 2 )
+    {
+        evaluateRange( m_rootIndex + 1, m_nodes.size(), iSS );
+        return;
+    }
+
+    std::mutex mutex;
+    std::size_t nextSubtree = 0;
+    std::string error;
+
+    // each thread takes the next subtree until there are none left
+    auto runSubtrees = [&]()
+    {
+        for ( ;; )
+        {
+            std::size_t begin = 0;
+            {
+                std::unique_lock< std::mutex > lock( mutex );
+                if ( nextSubtree == m_subtrees.size() || !error.empty() )
+                {
+                    return;
+                }
+                begin = m_subtrees[ nextSubtree++ ];
+            }
+
+            try
+            {
+                evaluateRange( begin, m_nodes[begin].end, iSS );
+            }
+            catch ( std::exception & e )
+            {
+                std::unique_lock< std::mutex > lock( mutex );
+                error = e.what();
+            }
+            catch ( ... )
+            {
+                std::unique_lock< std::mutex > lock( mutex );
+                error = "Unknown error while evaluating world matrices";
+            }
+        }
+    };
+
+    std::vector< std::thread > threads;
+    for ( std::size_t i = 1; i < iNumThreads && i < m_subtrees.size(); ++i )
+    {
+        threads.push_back( std::thread( runSubtrees ) );
+    }
+
+    runSubtrees();
+
+    for ( std::size_t i = 0; i < threads.size(); ++i )
+    {
+        threads[i].join();
+    }
+
+    if ( !error.empty() )
+    {
+        ABCA_THROW( error );
+    }
+}
+
+#else
+
+//-*****************************************************************************
+void WorldXformEvaluator::evaluate( const Abc::ISampleSelector & iSS,
+                                    std::size_t iNumThreads )
+{
+    evaluateRange( 0, m_nodes.size(), iSS );
+}
+
+#endif
+
+//-*****************************************************************************
+const std::string &
+WorldXformEvaluator::getFullName( std::size_t iIndex ) const
+{
+    ABCA_ASSERT( iIndex < getNumObjects(), "Invalid index: " << iIndex );
+    return m_nodes[ m_rootIndex + iIndex ].fullName;
+}
+
+//-*****************************************************************************
+const Abc::M44d &
+WorldXformEvaluator::getWorldMatrix( std::size_t iIndex ) const
+{
+    ABCA_ASSERT( iIndex < getNumObjects(), "Invalid index: " << iIndex );
+    return m_nodes[ m_rootIndex + iIndex ].world;
+}
+
+//-*****************************************************************************
+bool WorldXformEvaluator::getWorldMatrix( const std::string & iFullName,
+                                          Abc::M44d & oMatrix ) const
+{
+    std::size_t index = 0;
+    if ( !getIndex( iFullName, index ) )
+    {
+        return false;
+    }
+
+    oMatrix = getWorldMatrix( index );
+    return true;
+}
+
+//-*****************************************************************************
+bool WorldXformEvaluator::getIndex( const std::string & iFullName,
+                                    std::size_t & oIndex ) const
+{
+    std::map< std::string, std::size_t >::const_iterator it =
+        m_nameToIndex.find( iFullName );
+
+    if ( it == m_nameToIndex.end() )
+    {
+        return false;
+    }
+
+    oIndex = it->second;
+    return true;
+}
+
+//-*****************************************************************************
+bool WorldXformEvaluator::isStatic( std::size_t iIndex ) const
+{
+    ABCA_ASSERT( iIndex < getNumObjects(), "Invalid index: " << iIndex );
+    return m_nodes[ m_rootIndex + iIndex ].isStatic;
+}
+
+//-*****************************************************************************
+Abc::M44d GetWorldMatrix( const Abc::IObject & iObject,
+                          const Abc::ISampleSelector & iSS )
+{
+    WorldXformEvaluator evaluator( iObject, false );
+    evaluator.evaluate( iSS );
+    return evaluator.getWorldMatrix( 0 );
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace AbcGeom
+} // End namespace Alembic
@@ -0,0 +1,164 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_AbcGeom_WorldXform_h_
+#define _Alembic_AbcGeom_WorldXform_h_
+
+#include <Alembic/Util/Export.h>
+#include <Alembic/AbcGeom/Foundation.h>
+#include <Alembic/AbcGeom/XformOp.h>
+
+namespace Alembic {
+namespace AbcGeom {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+//! \brief Computes the world matrices of the objects in a hierarchy.
+//! The .ops, .vals and .inherits properties of every xform are read
+//! directly and composed without building an XformSample, the matrices of
+//! constant xforms are only computed once, and an object whose xform and
+//! ancestors are all constant is only computed the first time evaluate is
+//! called.  Objects that aren't xforms have the world matrix of their
+//! parent.
+class ALEMBIC_EXPORT WorldXformEvaluator
+{
+public:
+    WorldXformEvaluator() : m_rootIndex( 0 ) {}
+
+    //! Gathers the xforms of iRoot and its ancestors, and, if
+    //! iIncludeDescendants is true, of everything under iRoot.
+    explicit WorldXformEvaluator( const Abc::IObject & iRoot,
+                                  bool iIncludeDescendants = true );
+
+    //! Computes the world matrix of every object at iSS.
+    //! Up to iNumThreads threads are used, each of them evaluating whole
+    //! subtrees under the children of the root.
+    void evaluate( const Abc::ISampleSelector & iSS =
+                   Abc::ISampleSelector(),
+                   std::size_t iNumThreads = 1 );
+
+    //! The number of objects, the root is index 0, followed by its
+    //! descendants with every parent before its children.
+    std::size_t getNumObjects() const
+    { return m_nodes.size() - m_rootIndex; }
+
+    const std::string & getFullName( std::size_t iIndex ) const;
+
+    //! The world matrix from the last call to evaluate.
+    const Abc::M44d & getWorldMatrix( std::size_t iIndex ) const;
+
+    //! Same as above, but by the full name of the object, returns false if
+    //! it isn't iRoot or under it.
+    bool getWorldMatrix( const std::string & iFullName,
+                         Abc::M44d & oMatrix ) const;
+
+    //! Whether the world matrix of this object never changes.
+    bool isStatic( std::size_t iIndex ) const;
+
+    //! The index of an object by its full name, returns false if it isn't
+    //! iRoot or under it.
+    bool getIndex( const std::string & iFullName,
+                   std::size_t & oIndex ) const;
+
+private:
+    struct Node
+    {
+        Node();
+
+        // the index of the parent node, the first node has none
+        std::size_t parent;
+
+        // one past the last node under this one
+        std::size_t end;
+
+        std::string fullName;
+
+        bool isXform;
+
+        // the ops, and the values of all of their channels which start out
+        // with the defaults in case there are no samples to read
+        std::vector< XformOperationType > ops;
+        std::vector< double > vals;
+
+        AbcA::ScalarPropertyReaderPtr scalarVals;
+        AbcA::ArrayPropertyReaderPtr arrayVals;
+        Abc::IBoolProperty inheritsProperty;
+
+        // whether local and inherits change over time
+        bool isConstant;
+        bool isConstantIdentity;
+
+        // whether world changes over time, for this node and for it and
+        // everything under it
+        bool isStatic;
+        bool isStaticSubtree;
+
+        bool evaluated;
+        bool inherits;
+        Abc::M44d local;
+        Abc::M44d world;
+    };
+
+    void addNode( const Abc::IObject & iObject, std::size_t iParent );
+    void evaluateNode( std::size_t iIndex, const Abc::ISampleSelector & iSS );
+    void evaluateRange( std::size_t iBegin, std::size_t iEnd,
+                        const Abc::ISampleSelector & iSS );
+
+    // the ancestors of the root, the root, and then everything under it
+    std::vector< Node > m_nodes;
+    std::size_t m_rootIndex;
+
+    // the start of the subtree of each child of the root
+    std::vector< std::size_t > m_subtrees;
+
+    std::map< std::string, std::size_t > m_nameToIndex;
+};
+
+//-*****************************************************************************
+//! Helper function that computes the world matrix of a single object,
+//! without building an XformSample for each of its ancestors.
+ALEMBIC_EXPORT Abc::M44d
+GetWorldMatrix( const Abc::IObject & iObject,
+                const Abc::ISampleSelector & iSS = Abc::ISampleSelector() );
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace AbcGeom
+} // End namespace Alembic
+
+#endif
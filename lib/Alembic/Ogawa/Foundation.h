@@ -49,6 +49,14 @@ const Alembic::Util::uint64_t EMPTY_GROUP   = 0x0000000000000000ULL;
 const Alembic::Util::uint64_t INVALID_DATA  = 0xffffffffffffffffULL;
 const Alembic::Util::uint64_t EMPTY_DATA    = 0x8000000000000000ULL;
 
+// in a sharded archive (format version 2, see OArchive) data can be in one
+// of the shard files instead of the archive itself, the bits of the
+// position under the data bit say which, 0 being the archive itself and 1
+// the first shard.  The rest of the bits are the position in that file.
+const Alembic::Util::uint64_t SHARD_MASK    = 0x7fff000000000000ULL;
+const Alembic::Util::uint64_t SHARD_POS     = 0x0000ffffffffffffULL;
+const Alembic::Util::uint64_t SHARD_SHIFT   = 48;
+
 } // End namespace ALEMBIC_VERSION_NS
 
 using namespace ALEMBIC_VERSION_NS;
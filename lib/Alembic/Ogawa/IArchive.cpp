@@ -39,14 +39,15 @@ namespace Alembic {
 namespace Ogawa {
 namespace ALEMBIC_VERSION_NS {
 
-IArchive::IArchive(const std::string & iFileName, std::size_t iNumStreams) :
-    mStreams(new IStreams(iFileName, iNumStreams))
+IArchive::IArchive(const std::string & iFileName, std::size_t iNumStreams,
+                   bool iUseMMap) :
+    mStreams(new IStreams(iFileName, iNumStreams, iUseMMap)), mPos(0)
 {
     init();
 }
 
 IArchive::IArchive(const std::vector< std::istream * > & iStreams) :
-    mStreams(new IStreams(iStreams))
+    mStreams(new IStreams(iStreams)), mPos(0)
 {
     init();
 }
@@ -55,9 +56,8 @@ void IArchive::init()
 {
     if (mStreams->isValid())
     {
-        Alembic::Util::uint64_t pos = 0;
-        mStreams->read(0, 8, 8, &pos);
-        mGroup.reset(new IGroup(mStreams, pos, false, 0));
+        mStreams->read(0, 8, 8, &mPos);
+        mGroup.reset(new IGroup(mStreams, mPos, false, 0));
     }
 }
 
@@ -80,11 +80,98 @@ Alembic::Util::uint16_t IArchive::getVersion() const
     return mStreams->getVersion();
 }
 
+bool IArchive::isMapped() const
+{
+    return mStreams->isMapped();
+}
+
 IGroupPtr IArchive::getGroup() const
 {
     return mGroup;
 }
 
+bool IArchive::refresh()
+{
+    if (!mStreams->refresh())
+    {
+        return false;
+    }
+
+    Alembic::Util::uint64_t pos = 0;
+    mStreams->read(0, 8, 8, &pos);
+    if (pos == mPos)
+    {
+        return false;
+    }
+
+    mPos = pos;
+    mGroup.reset(new IGroup(mStreams, mPos, false, 0));
+    return true;
+}
+
+IGroupPtr IArchive::getGroup(Alembic::Util::uint64_t iPos, bool iLight,
+                             std::size_t iThreadIndex) const
+{
+    IGroupPtr group;
+    if (mStreams->isValid() && (iPos & EMPTY_DATA) == 0)
+    {
+        group.reset(new IGroup(mStreams, iPos, iLight, iThreadIndex));
+    }
+    return group;
+}
+
+void IArchive::setMaxChildTableBytes(Alembic::Util::uint64_t iMaxBytes)
+{
+    if (mStreams)
+    {
+        mStreams->setMaxChildTableBytes(iMaxBytes);
+    }
+}
+
+void IArchive::setStatsEnabled(bool iEnabled)
+{
+    if (mStreams)
+    {
+        mStreams->setStatsEnabled(iEnabled);
+    }
+}
+
+void IArchive::getStats(ReadStats & oStats) const
+{
+    if (mStreams)
+    {
+        mStreams->getStats(oStats);
+    }
+    else
+    {
+        oStats = ReadStats();
+    }
+}
+
+void IArchive::resetStats()
+{
+    if (mStreams)
+    {
+        mStreams->resetStats();
+    }
+}
+
+void IArchive::setTraceEnabled(bool iEnabled)
+{
+    if (mStreams)
+    {
+        mStreams->setTraceEnabled(iEnabled);
+    }
+}
+
+void IArchive::writeTrace(std::ostream & oStream) const
+{
+    if (mStreams)
+    {
+        mStreams->writeTrace(oStream);
+    }
+}
+
 } // End namespace ALEMBIC_VERSION_NS
 } // End namespace Ogawa
 } // End namespace Alembic
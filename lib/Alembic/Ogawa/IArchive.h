@@ -50,7 +50,10 @@ namespace ALEMBIC_VERSION_NS {
 class ALEMBIC_EXPORT IArchive
 {
 public:
-    IArchive(const std::string & iFileName, std::size_t iNumStreams=1);
+    // If iUseMMap is true, the file will be memory mapped instead of being
+    // read via iNumStreams file streams.
+    IArchive(const std::string & iFileName, std::size_t iNumStreams=1,
+             bool iUseMMap=false);
     IArchive(const std::vector< std::istream * > & iStreams);
     ~IArchive();
 
@@ -60,12 +63,39 @@ public:
 
     Alembic::Util::uint16_t getVersion() const;
 
+    bool isMapped() const;
+
     IGroupPtr getGroup() const;
 
+    // For archives that were still being written when they were opened,
+    // picks up the latest commit (see OArchive::commit), or the finished
+    // archive.  Returns true if getGroup now returns a different group.
+    // Groups and data that were already read stay valid, since committed
+    // data is never rewritten.
+    bool refresh();
+
+    // the group that was written at iPos (see OGroup::getPos), iPos must
+    // really be the position of a group
+    IGroupPtr getGroup(Alembic::Util::uint64_t iPos, bool iLight,
+                       std::size_t iThreadIndex) const;
+
+    // how much memory light groups may use, all together, to keep where
+    // their children are (see IStreams::reserveChildTable)
+    void setMaxChildTableBytes(Alembic::Util::uint64_t iMaxBytes);
+
+    // counting and tracing what is read, see IStreams::setStatsEnabled and
+    // IStreams::setTraceEnabled
+    void setStatsEnabled(bool iEnabled);
+    void getStats(ReadStats & oStats) const;
+    void resetStats();
+    void setTraceEnabled(bool iEnabled);
+    void writeTrace(std::ostream & oStream) const;
+
 private:
     void init();
     IStreamsPtr mStreams;
     IGroupPtr mGroup;
+    Alembic::Util::uint64_t mPos;
 };
 
 typedef Alembic::Util::shared_ptr< IArchive > IArchivePtr;
@@ -48,12 +48,17 @@ public:
     PrivateData(IStreamsPtr iStreams)
     {
         streams = iStreams;
+        bufferPos = 0;
     };
 
     ~PrivateData() {};
 
     IStreamsPtr streams;
 
+    // if set, our data was already read into this buffer at bufferPos
+    Alembic::Util::shared_ptr< std::vector< char > > buffer;
+    std::size_t bufferPos;
+
     // set after freeze
     Alembic::Util::uint64_t pos;
     Alembic::Util::uint64_t size;
@@ -84,6 +89,20 @@ IData::IData(IStreamsPtr iStreams,
     }
 }
 
+IData::IData(IStreamsPtr iStreams,
+             Alembic::Util::uint64_t iPos,
+             Alembic::Util::shared_ptr< std::vector< char > > iBuffer,
+             std::size_t iBufferPos) :
+    mData(new IData::PrivateData(iStreams))
+{
+    mData->pos = iPos & INVALID_GROUP;
+    mData->buffer = iBuffer;
+
+    // skip the size
+    mData->bufferPos = iBufferPos + 8;
+    memcpy(&mData->size, &(*iBuffer)[iBufferPos], 8);
+}
+
 void IData::read(Alembic::Util::uint64_t iSize, void * iData,
                  Alembic::Util::uint64_t iOffset, std::size_t iThreadId)
 {
@@ -93,10 +112,28 @@ void IData::read(Alembic::Util::uint64_t iSize, void * iData,
         return;
     }
 
+    if (mData->buffer)
+    {
+        memcpy(iData, &(*mData->buffer)[mData->bufferPos + iOffset], iSize);
+        return;
+    }
+
     // +8 is to account for the size
     mData->streams->read(iThreadId, mData->pos + iOffset + 8, iSize, iData);
 }
 
+const void * IData::getMappedData(Alembic::Util::uint64_t iSize,
+                                  Alembic::Util::uint64_t iOffset) const
+{
+    if (mData->size == 0 || iOffset + iSize > mData->size || mData->buffer)
+    {
+        return NULL;
+    }
+
+    // +8 is to account for the size
+    return mData->streams->getMappedData(mData->pos + iOffset + 8, iSize);
+}
+
 Alembic::Util::uint64_t IData::getSize() const
 {
     return mData->size;
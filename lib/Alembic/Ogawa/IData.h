@@ -55,6 +55,13 @@ public:
 
     Alembic::Util::uint64_t getSize() const;
 
+    // if the archive is memory mapped, returns a pointer directly to the
+    // iSize bytes at iOffset, otherwise (or if we would read beyond our
+    // buffer, or our data was already read into memory) NULL is returned.
+    // The mapping is kept alive for as long as this IData is.
+    const void * getMappedData(Alembic::Util::uint64_t iSize,
+                               Alembic::Util::uint64_t iOffset) const;
+
     // not really necessary for most workflows, it could be used by some
     // Ogawa utilities to detect when this IData is shared
     Alembic::Util::uint64_t getPos() const;
@@ -64,6 +71,12 @@ private:
     IData(IStreamsPtr iStreams, Alembic::Util::uint64_t iPos,
           std::size_t iThreadId);
 
+    // our data (starting with the size) has already been read into iBuffer
+    // at iBufferPos, reads are copied out of it instead of the streams
+    IData(IStreamsPtr iStreams, Alembic::Util::uint64_t iPos,
+          Alembic::Util::shared_ptr< std::vector< char > > iBuffer,
+          std::size_t iBufferPos);
+
     class PrivateData;
     std::auto_ptr< PrivateData > mData;
 };
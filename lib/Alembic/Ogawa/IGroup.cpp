@@ -37,10 +37,20 @@
 #include <Alembic/Ogawa/IArchive.h>
 #include <Alembic/Ogawa/IStreams.h>
 
+#include <algorithm>
+
 namespace Alembic {
 namespace Ogawa {
 namespace ALEMBIC_VERSION_NS {
 
+// data that starts within this many bytes of the start of the previous data
+// is read together with it, even if some unwanted bytes between them are
+// read as well
+static const Alembic::Util::uint64_t kMaxCoalesceDistance = 1024 * 1024;
+
+// but don't read more than this much at a time
+static const Alembic::Util::uint64_t kMaxCoalesceSize = 64 * 1024 * 1024;
+
 class IGroup::PrivateData
 {
 public:
@@ -49,9 +59,16 @@ public:
         numChildren = 0;
         pos = 0;
         streams = iStreams;
+        numLightReads = 0;
     }
 
-    ~PrivateData() {}
+    ~PrivateData()
+    {
+        if (!lightVec.empty())
+        {
+            streams->releaseChildTable(lightVec.size() * 8);
+        }
+    }
 
     IStreamsPtr streams;
 
@@ -59,6 +76,12 @@ public:
 
     Alembic::Util::uint64_t numChildren;
     Alembic::Util::uint64_t pos;
+
+    // for light groups, the positions of the children once we have been
+    // read from more than once, and there was room for them
+    std::vector<Alembic::Util::uint64_t> lightVec;
+    std::size_t numLightReads;
+    Alembic::Util::mutex lightLock;
 };
 
 IGroup::IGroup(IStreamsPtr iStreams,
@@ -94,6 +117,66 @@ IGroup::~IGroup()
 
 }
 
+const Alembic::Util::uint64_t *
+IGroup::getLightChildren(std::size_t iThreadIndex, bool iNow)
+{
+    // mapped reads are already cheap
+    if (mData->streams->isMapped())
+    {
+        return NULL;
+    }
+
+    Alembic::Util::scoped_lock l(mData->lightLock);
+
+    if (!mData->lightVec.empty())
+    {
+        return &(mData->lightVec.front());
+    }
+
+    // a group that is only read from once doesn't need the whole table
+    if (!iNow && mData->numLightReads++ == 0)
+    {
+        return NULL;
+    }
+
+    if (!mData->streams->reserveChildTable(mData->numChildren * 8))
+    {
+        return NULL;
+    }
+
+    // the table has been reserved, so make sure it gets released if we fail
+    try
+    {
+        std::vector<Alembic::Util::uint64_t> lightVec(mData->numChildren);
+        mData->streams->read(iThreadIndex, mData->pos + 8,
+                             mData->numChildren * 8, &(lightVec.front()));
+        mData->lightVec.swap(lightVec);
+    }
+    catch (...)
+    {
+        mData->streams->releaseChildTable(mData->numChildren * 8);
+        throw;
+    }
+
+    return &(mData->lightVec.front());
+}
+
+Alembic::Util::uint64_t IGroup::getLightChild(Alembic::Util::uint64_t iIndex,
+                                              std::size_t iThreadIndex)
+{
+    const Alembic::Util::uint64_t * children =
+        getLightChildren(iThreadIndex, false);
+    if (children)
+    {
+        return children[iIndex];
+    }
+
+    Alembic::Util::uint64_t childPos = 0;
+    mData->streams->read(iThreadIndex, mData->pos + 8 * iIndex + 8, 8,
+                         &childPos);
+    return childPos;
+}
+
 IGroupPtr IGroup::getGroup(Alembic::Util::uint64_t iIndex, bool iLight,
                            std::size_t iThreadIndex)
 {
@@ -102,9 +185,8 @@ IGroupPtr IGroup::getGroup(Alembic::Util::uint64_t iIndex, bool iLight,
     {
         if (iIndex < mData->numChildren)
         {
-            Alembic::Util::uint64_t childPos = 0;
-            mData->streams->read(iThreadIndex, mData->pos + 8 * iIndex + 8, 8,
-                                 &childPos);
+            Alembic::Util::uint64_t childPos =
+                getLightChild(iIndex, iThreadIndex);
 
             // top bit should not be set for groups
             if ((childPos & EMPTY_DATA) == 0)
@@ -130,9 +212,8 @@ IDataPtr IGroup::getData(Alembic::Util::uint64_t iIndex,
     {
         if (iIndex < mData->numChildren)
         {
-            Alembic::Util::uint64_t childPos = 0;
-            mData->streams->read(iThreadIndex, mData->pos + 8 * iIndex + 8, 8,
-                                 &childPos);
+            Alembic::Util::uint64_t childPos =
+                getLightChild(iIndex, iThreadIndex);
 
             // top bit should be set for data
             if ((childPos & EMPTY_DATA) != 0)
@@ -149,6 +230,100 @@ IDataPtr IGroup::getData(Alembic::Util::uint64_t iIndex,
     return child;
 }
 
+void IGroup::getData(const std::vector< Alembic::Util::uint64_t > & iIndices,
+                     std::size_t iThreadIndex,
+                     std::vector< IDataPtr > & oData)
+{
+    oData.clear();
+    oData.resize(iIndices.size());
+
+    // light groups need the positions of all of their children for this
+    const Alembic::Util::uint64_t * children = NULL;
+    if (isLight())
+    {
+        children = getLightChildren(iThreadIndex, true);
+    }
+    else if (!mData->childVec.empty())
+    {
+        children = &(mData->childVec.front());
+    }
+
+    // mapped reads are already cheap
+    if (!children || mData->streams->isMapped())
+    {
+        for (std::size_t i = 0; i < iIndices.size(); ++i)
+        {
+            oData[i] = getData(iIndices[i], iThreadIndex);
+        }
+        return;
+    }
+
+    // the position of each of the non-empty data, and where it goes
+    std::vector< std::pair< Alembic::Util::uint64_t, std::size_t > > posVec;
+    for (std::size_t i = 0; i < iIndices.size(); ++i)
+    {
+        if (iIndices[i] >= mData->numChildren ||
+            (children[iIndices[i]] & EMPTY_DATA) == 0)
+        {
+            // not data
+            continue;
+        }
+        else if (children[iIndices[i]] == EMPTY_DATA)
+        {
+            oData[i] = getData(iIndices[i], iThreadIndex);
+        }
+        else
+        {
+            posVec.push_back(std::make_pair(
+                children[iIndices[i]] & INVALID_GROUP, i));
+        }
+    }
+
+    std::sort(posVec.begin(), posVec.end());
+
+    std::size_t runStart = 0;
+    while (runStart < posVec.size())
+    {
+        Alembic::Util::uint64_t startPos = posVec[runStart].first;
+
+        // find the last data that we can read together with the first
+        std::size_t runEnd = runStart + 1;
+        while (runEnd < posVec.size() &&
+               posVec[runEnd].first - posVec[runEnd - 1].first <=
+                   kMaxCoalesceDistance &&
+               posVec[runEnd].first - startPos <= kMaxCoalesceSize)
+        {
+            ++runEnd;
+        }
+
+        // the sizes of all but the last data are in what we will read
+        Alembic::Util::uint64_t lastPos = posVec[runEnd - 1].first;
+        Alembic::Util::uint64_t lastSize = 0;
+        mData->streams->read(iThreadIndex, lastPos, 8, &lastSize);
+
+        Alembic::Util::shared_ptr< std::vector< char > > buffer(
+            new std::vector< char >(lastPos - startPos + 8 + lastSize));
+        mData->streams->read(iThreadIndex, startPos, buffer->size(),
+                             &(buffer->front()));
+
+        for (std::size_t i = runStart; i < runEnd; ++i)
+        {
+            // the same data may have been asked for more than once
+            if (i > runStart && posVec[i].first == posVec[i - 1].first)
+            {
+                oData[posVec[i].second] = oData[posVec[i - 1].second];
+                continue;
+            }
+
+            oData[posVec[i].second].reset(new IData(mData->streams,
+                posVec[i].first, buffer,
+                (std::size_t)(posVec[i].first - startPos)));
+        }
+
+        runStart = runEnd;
+    }
+}
+
 Alembic::Util::uint64_t IGroup::getNumChildren() const
 {
     return mData->numChildren;
@@ -183,6 +358,25 @@ bool IGroup::isLight() const
     return mData->numChildren != 0 && mData->childVec.empty();
 }
 
+Alembic::Util::uint64_t IGroup::getPos() const
+{
+    return mData->pos;
+}
+
+Alembic::Util::uint64_t IGroup::getChildEntry(Alembic::Util::uint64_t iIndex,
+                                              std::size_t iThreadIndex)
+{
+    if (iIndex >= mData->numChildren)
+    {
+        return 0;
+    }
+    else if (isLight())
+    {
+        return getLightChild(iIndex, iThreadIndex);
+    }
+    return mData->childVec[iIndex];
+}
+
 } // End namespace ALEMBIC_VERSION_NS
 } // End namespace Ogawa
 } // End namespace Alembic
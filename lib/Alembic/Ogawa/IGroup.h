@@ -58,6 +58,17 @@ public:
 
     IDataPtr getData(Alembic::Util::uint64_t iIndex, std::size_t iThreadIndex);
 
+    // Same as calling getData for each of iIndices, but data that is close
+    // together in the file is read with a single read, and then kept in
+    // memory (shared by the returned IData) so reading from it doesn't touch
+    // the file again.  If the archive is memory mapped the data is
+    // referenced from the mapping as usual.
+    // Light groups keep the positions of their children in memory for
+    // this, if there is room for them (see IStreams::reserveChildTable).
+    void getData(const std::vector< Alembic::Util::uint64_t > & iIndices,
+                 std::size_t iThreadIndex,
+                 std::vector< IDataPtr > & oData);
+
     Alembic::Util::uint64_t getNumChildren() const;
 
     bool isChildGroup(Alembic::Util::uint64_t iIndex) const;
@@ -68,11 +79,30 @@ public:
 
     bool isLight() const;
 
+    // where the group is within the stream (0 for the empty group)
+    Alembic::Util::uint64_t getPos() const;
+
+    // the raw table entry for child iIndex, the position of the child
+    // group, or of the child data with the top bit set, 0 if out of range.
+    // Used to reference the child when appending (see OGroup::addChild)
+    Alembic::Util::uint64_t getChildEntry(Alembic::Util::uint64_t iIndex,
+                                          std::size_t iThreadIndex);
+
 private:
     friend class IArchive;
     IGroup(IStreamsPtr iStreams, Alembic::Util::uint64_t iPos, bool iLight,
            std::size_t iThreadIndex);
 
+    // for light groups, the positions of all of the children if they are
+    // kept in memory, if iNow is false they are only read and kept once
+    // this has been called more than once, NULL if they aren't kept
+    const Alembic::Util::uint64_t * getLightChildren(std::size_t iThreadIndex,
+                                                     bool iNow);
+
+    // for light groups, the position of child iIndex
+    Alembic::Util::uint64_t getLightChild(Alembic::Util::uint64_t iIndex,
+                                          std::size_t iThreadIndex);
+
     class PrivateData;
     Alembic::Util::auto_ptr< PrivateData > mData;
 };
@@ -37,10 +37,146 @@
 #include <fstream>
 #include <stdexcept>
 
+#ifndef _MSC_VER
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#endif
+
+#if ( defined( _MSC_VER ) && _MSC_VER > 1600 ) || \
+    ( !defined( _MSC_VER ) && \
+      ( defined( __GXX_EXPERIMENTAL_CXX0X__ ) || __cplusplus >= 201103L ) )
+#define ALEMBIC_OGAWA_ATOMIC_STATS
+#include <atomic>
+#endif
+
 namespace Alembic {
 namespace Ogawa {
 namespace ALEMBIC_VERSION_NS {
 
+namespace {
+
+// a monotonic clock for timing reads
+Alembic::Util::uint64_t NowNanoseconds()
+{
+#ifdef _MSC_VER
+    LARGE_INTEGER count;
+    LARGE_INTEGER frequency;
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&frequency);
+    return (Alembic::Util::uint64_t)
+        ((double) count.QuadPart * (1e9 / (double) frequency.QuadPart));
+#else
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (Alembic::Util::uint64_t) now.tv_sec * 1000000000ULL +
+        now.tv_nsec;
+#endif
+}
+
+// which bucket of StreamStats::lockWaitHistogram a wait goes in
+std::size_t LockWaitBucket(Alembic::Util::uint64_t iNanoseconds)
+{
+    Alembic::Util::uint64_t microseconds = iNanoseconds / 1000;
+    std::size_t bucket = 0;
+    while (microseconds > 0 && bucket + 1 < LOCK_WAIT_BUCKETS)
+    {
+        microseconds >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+void AddStreamStats(StreamStats & ioStats, const StreamStats & iStats)
+{
+    ioStats.numReads += iStats.numReads;
+    ioStats.numBytes += iStats.numBytes;
+    ioStats.numSeeks += iStats.numSeeks;
+    ioStats.seekDistance += iStats.seekDistance;
+    ioStats.numContended += iStats.numContended;
+    ioStats.lockWaitNanoseconds += iStats.lockWaitNanoseconds;
+    for (std::size_t i = 0; i < LOCK_WAIT_BUCKETS; ++i)
+    {
+        ioStats.lockWaitHistogram[i] += iStats.lockWaitHistogram[i];
+    }
+}
+
+// writes nanoseconds as microseconds, which is what trace events use
+void WriteMicroseconds(std::ostream & oStream,
+                       Alembic::Util::uint64_t iNanoseconds)
+{
+    Alembic::Util::uint64_t fraction = iNanoseconds % 1000;
+    oStream << iNanoseconds / 1000 << "." << fraction / 100
+            << (fraction / 10) % 10 << fraction % 10;
+}
+
+// locks a stream, and when we are counting, notes whether and how long it
+// had to wait for another read to be done with it
+class StreamLock
+{
+public:
+    StreamLock(Alembic::Util::mutex & iLock, bool iTimed) :
+        mLock(iLock), mContended(false), mWait(0)
+    {
+        if (!iTimed)
+        {
+            mLock.lock();
+        }
+        else if (!mLock.try_lock())
+        {
+            Alembic::Util::uint64_t start = NowNanoseconds();
+            mLock.lock();
+            mWait = NowNanoseconds() - start;
+            mContended = true;
+        }
+    }
+
+    ~StreamLock()
+    {
+        mLock.unlock();
+    }
+
+    bool contended() const { return mContended; }
+    Alembic::Util::uint64_t wait() const { return mWait; }
+
+private:
+    StreamLock(const StreamLock &);
+    const StreamLock & operator=(const StreamLock &);
+
+    Alembic::Util::mutex & mLock;
+    bool mContended;
+    Alembic::Util::uint64_t mWait;
+};
+
+// a read that was traced, pos still has the shard bits
+struct TraceEvent
+{
+    Alembic::Util::uint64_t start;
+    Alembic::Util::uint64_t duration;
+    Alembic::Util::uint64_t pos;
+    Alembic::Util::uint64_t size;
+    std::size_t stream;
+    bool mapped;
+};
+
+}
+
+StreamStats::StreamStats() :
+    numReads(0), numBytes(0), numSeeks(0), seekDistance(0),
+    numContended(0), lockWaitNanoseconds(0)
+{
+    for (std::size_t i = 0; i < LOCK_WAIT_BUCKETS; ++i)
+    {
+        lockWaitHistogram[i] = 0;
+    }
+}
+
+ReadStats::ReadStats() : numMappedReads(0), numMappedBytes(0)
+{
+}
+
 class IStreams::PrivateData
 {
 public:
@@ -50,6 +186,21 @@ public:
         valid = false;
         frozen = false;
         version = 0;
+        mappedData = NULL;
+        mappedSize = 0;
+        childTableBytes = 0;
+        maxChildTableBytes = 64 * 1024 * 1024;
+        statsEnabled = false;
+        traceEnabled = false;
+        numMappedReads = 0;
+        numMappedBytes = 0;
+        traceNext = 0;
+        numTraceEvents = 0;
+        traceStart = 0;
+#ifdef _MSC_VER
+        mappedFile = INVALID_HANDLE_VALUE;
+        mappedHandle = NULL;
+#endif
     }
 
     ~PrivateData()
@@ -59,6 +210,8 @@ public:
             delete [] locks;
         }
 
+        unmap();
+
         // only cleanup if we were the ones who opened it
         if (!fileName.empty())
         {
@@ -75,18 +228,117 @@ public:
         }
     }
 
+    void unmap()
+    {
+        if (mappedData == NULL)
+        {
+            return;
+        }
+
+#ifdef _MSC_VER
+        UnmapViewOfFile(mappedData);
+        CloseHandle(mappedHandle);
+        CloseHandle(mappedFile);
+        mappedHandle = NULL;
+        mappedFile = INVALID_HANDLE_VALUE;
+#else
+        munmap((void *)mappedData, mappedSize);
+#endif
+        mappedData = NULL;
+        mappedSize = 0;
+    }
+
     std::vector<std::istream *> streams;
     std::vector<Alembic::Util::uint64_t> offsets;
+
+    // the files a sharded archive has its data in
+    std::vector<IStreamsPtr> shards;
     Alembic::Util::mutex * locks;
     std::string fileName;
     bool valid;
-    bool frozen;
     Alembic::Util::uint16_t version;
+
+    // refresh updates this under the lock of the first stream while
+    // other threads may be asking isFrozen
+#ifdef ALEMBIC_OGAWA_ATOMIC_STATS
+    std::atomic<bool> frozen;
+#else
+    bool frozen;
+#endif
+
+    // the entire file when we are memory mapped, read only so no locks
+    // are needed
+    const char * mappedData;
+    Alembic::Util::uint64_t mappedSize;
+
+    // the memory held by the child tables of light groups
+    Alembic::Util::uint64_t childTableBytes;
+    Alembic::Util::uint64_t maxChildTableBytes;
+    Alembic::Util::mutex childTableLock;
+
+    bool isCounting()
+    {
+#ifdef ALEMBIC_OGAWA_ATOMIC_STATS
+        return statsEnabled;
+#else
+        Alembic::Util::scoped_lock l(statsLock);
+        return statsEnabled;
+#endif
+    }
+
+    bool isTracing()
+    {
+#ifdef ALEMBIC_OGAWA_ATOMIC_STATS
+        return traceEnabled;
+#else
+        Alembic::Util::scoped_lock l(statsLock);
+        return traceEnabled;
+#endif
+    }
+
+    // see setStatsEnabled and setTraceEnabled, the stats of a stream are
+    // only touched while its lock is held, the vectors are sized along with
+    // the locks and never change after that
+    std::vector<StreamStats> streamStats;
+
+    // where the last read of each stream ended
+    std::vector<Alembic::Util::uint64_t> streamEnds;
+
+#ifdef ALEMBIC_OGAWA_ATOMIC_STATS
+    std::atomic<bool> statsEnabled;
+    std::atomic<bool> traceEnabled;
+    std::atomic<Alembic::Util::uint64_t> numMappedReads;
+    std::atomic<Alembic::Util::uint64_t> numMappedBytes;
+#else
+    bool statsEnabled;
+    bool traceEnabled;
+    Alembic::Util::uint64_t numMappedReads;
+    Alembic::Util::uint64_t numMappedBytes;
+#endif
+
+    // the last MAX_TRACE_EVENTS reads, traceNext is where the next one
+    // goes once it is full, everything here uses statsLock
+    std::vector<TraceEvent> traceEvents;
+    std::size_t traceNext;
+    Alembic::Util::uint64_t numTraceEvents;
+    Alembic::Util::uint64_t traceStart;
+    Alembic::Util::mutex statsLock;
+
+#ifdef _MSC_VER
+    HANDLE mappedFile;
+    HANDLE mappedHandle;
+#endif
 };
 
-IStreams::IStreams(const std::string & iFileName, std::size_t iNumStreams) :
+IStreams::IStreams(const std::string & iFileName, std::size_t iNumStreams,
+                   bool iUseMMap) :
     mData(new IStreams::PrivateData())
 {
+    if (iUseMMap && initMapped(iFileName))
+    {
+        initShards(iNumStreams, iUseMMap);
+        return;
+    }
 
     std::ifstream * filestream = new std::ifstream;
     filestream->open(iFileName.c_str(), std::ios::binary);
@@ -103,7 +355,7 @@ IStreams::IStreams(const std::string & iFileName, std::size_t iNumStreams) :
 
     mData->streams.push_back(filestream);
     init();
-    if (!mData->valid || mData->version != 1)
+    if (!mData->valid || (mData->version != 1 && mData->version != 2))
     {
         mData->streams.clear();
         filestream->close();
@@ -116,6 +368,9 @@ IStreams::IStreams(const std::string & iFileName, std::size_t iNumStreams) :
         mData->offsets.resize(iNumStreams, 0);
     }
     mData->locks = new Alembic::Util::mutex[mData->streams.size()];
+    mData->streamStats.resize(mData->streams.size());
+    mData->streamEnds.resize(mData->streams.size(), 0);
+    initShards(iNumStreams, iUseMMap);
 }
 
 IStreams::IStreams(const std::vector< std::istream * > & iStreams) :
@@ -123,13 +378,16 @@ IStreams::IStreams(const std::vector< std::istream * > & iStreams) :
 {
     mData->streams = iStreams;
     init();
-    if (!mData->valid || mData->version != 1)
+    if (!mData->valid || (mData->version != 1 && mData->version != 2))
     {
         mData->streams.clear();
         return;
     }
 
     mData->locks = new Alembic::Util::mutex[mData->streams.size()];
+    mData->streamStats.resize(mData->streams.size());
+    mData->streamEnds.resize(mData->streams.size(), 0);
+    initShards(1, false);
 }
 
 void IStreams::init()
@@ -192,6 +450,162 @@ void IStreams::init()
     mData->valid = true;
 }
 
+bool IStreams::initMapped(const std::string & iFileName)
+{
+    // simple temporary endian check
+    union {
+        Util::uint32_t l;
+        char c[4];
+    } u;
+
+    u.l = 0x01234567;
+
+    if (u.c[0] != 0x67)
+    {
+        throw std::runtime_error(
+            "Ogawa currently only supports little-endian reading.");
+    }
+
+#ifdef _MSC_VER
+    HANDLE fileHandle = CreateFileA(iFileName.c_str(), GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (fileHandle == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart < 16)
+    {
+        CloseHandle(fileHandle);
+        return false;
+    }
+
+    HANDLE mapHandle = CreateFileMapping(fileHandle, NULL, PAGE_READONLY,
+                                         0, 0, NULL);
+    if (mapHandle == NULL)
+    {
+        CloseHandle(fileHandle);
+        return false;
+    }
+
+    void * mapped = MapViewOfFile(mapHandle, FILE_MAP_READ, 0, 0, 0);
+    if (mapped == NULL)
+    {
+        CloseHandle(mapHandle);
+        CloseHandle(fileHandle);
+        return false;
+    }
+
+    mData->mappedFile = fileHandle;
+    mData->mappedHandle = mapHandle;
+    mData->mappedSize = fileSize.QuadPart;
+#else
+    int fd = open(iFileName.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size < 16)
+    {
+        close(fd);
+        return false;
+    }
+
+    void * mapped = mmap(NULL, fileStat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+    // the mapping holds its own reference to the file
+    close(fd);
+
+    if (mapped == MAP_FAILED)
+    {
+        return false;
+    }
+
+    mData->mappedSize = fileStat.st_size;
+#endif
+
+    mData->mappedData = (const char *) mapped;
+
+    const char * header = mData->mappedData;
+    std::string magicStr(header, 5);
+    Alembic::Util::uint16_t version = (header[6] << 8) | header[7];
+    if (magicStr != "Ogawa" || (version != 1 && version != 2))
+    {
+        mData->unmap();
+        return false;
+    }
+
+    mData->fileName = iFileName;
+    mData->frozen = (header[5] == char(0xff));
+    mData->version = version;
+    mData->valid = true;
+    return true;
+}
+
+void IStreams::initShards(std::size_t iNumStreams, bool iUseMMap)
+{
+    if (!mData->valid || mData->version != 2)
+    {
+        return;
+    }
+
+    // the null terminated shard names are in the data right after the
+    // header, there is at least one
+    Alembic::Util::uint64_t size = 0;
+    read(0, 16, 8, &size);
+    if (size == 0 || size > 0xffffffffULL)
+    {
+        mData->valid = false;
+        return;
+    }
+
+    std::vector<char> names(size, 0);
+    read(0, 24, size, &names.front());
+    if (names.back() != '\0')
+    {
+        mData->valid = false;
+        return;
+    }
+
+    // relative names are next to us
+    std::string dir;
+    std::size_t slash = mData->fileName.find_last_of("/\\");
+    if (slash != std::string::npos)
+    {
+        dir = mData->fileName.substr(0, slash + 1);
+    }
+
+    std::size_t start = 0;
+    while (start < names.size())
+    {
+        std::string name(&names[start]);
+        start += name.size() + 1;
+
+        bool absolute = !name.empty() && (name[0] == '/' || name[0] == '\\' ||
+            (name.size() > 1 && name[1] == ':'));
+        if (!absolute)
+        {
+            name = dir + name;
+        }
+
+        // shards are plain finished archives
+        IStreamsPtr shard(new IStreams(name, iNumStreams, iUseMMap));
+        if (!shard->isValid() || !shard->isFrozen() ||
+            shard->getVersion() != 1)
+        {
+            mData->shards.clear();
+            mData->valid = false;
+            return;
+        }
+        mData->shards.push_back(shard);
+    }
+}
+
 IStreams::~IStreams()
 {
 }
@@ -203,7 +617,17 @@ bool IStreams::isValid()
 
 bool IStreams::isFrozen()
 {
+#ifdef ALEMBIC_OGAWA_ATOMIC_STATS
+    return mData->frozen;
+#else
+    if (mData->locks == NULL)
+    {
+        return mData->frozen;
+    }
+
+    Alembic::Util::scoped_lock l(mData->locks[0]);
     return mData->frozen;
+#endif
 }
 
 Alembic::Util::uint16_t IStreams::getVersion()
@@ -211,6 +635,44 @@ Alembic::Util::uint16_t IStreams::getVersion()
     return mData->version;
 }
 
+bool IStreams::isMapped()
+{
+    return mData->mappedData != NULL;
+}
+
+bool IStreams::refresh()
+{
+    // we only see as much of the file as was there when it was mapped
+    if (!isValid() || isFrozen() || isMapped())
+    {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < mData->streams.size(); ++i)
+    {
+        Alembic::Util::scoped_lock l(mData->locks[i]);
+        std::istream * stream = mData->streams[i];
+        if (stream == NULL)
+        {
+            continue;
+        }
+
+        // reads that went past what had been written so far leave the
+        // stream in a failed state
+        stream->clear();
+
+        if (i == 0)
+        {
+            char frozen = 0;
+            stream->seekg(mData->offsets[i] + 5);
+            stream->read(&frozen, 1);
+            mData->frozen = (frozen == char(0xff));
+        }
+    }
+
+    return true;
+}
+
 void IStreams::read(std::size_t iThreadId, Alembic::Util::uint64_t iPos,
                     Alembic::Util::uint64_t iSize, void * oBuf)
 {
@@ -219,14 +681,51 @@ void IStreams::read(std::size_t iThreadId, Alembic::Util::uint64_t iPos,
         return;
     }
 
+    bool tracing = mData->isTracing();
+    Alembic::Util::uint64_t start = 0;
+    if (tracing)
+    {
+        start = NowNanoseconds();
+    }
+
+    Alembic::Util::uint64_t shard = (iPos & SHARD_MASK) >> SHARD_SHIFT;
+    if (shard != 0)
+    {
+        if (shard <= mData->shards.size())
+        {
+            mData->shards[shard - 1]->read(iThreadId, iPos & SHARD_POS, iSize,
+                                           oBuf);
+
+            // the shard counts the read, but we trace it so that every read
+            // of the archive ends up in one trace
+            if (tracing)
+            {
+                trace(iThreadId, iPos, iSize, start);
+            }
+        }
+        return;
+    }
+
+    if (mData->mappedData != NULL)
+    {
+        // don't read anything if we will read beyond the mapped region
+        if (iPos <= mData->mappedSize && iSize <= mData->mappedSize - iPos)
+        {
+            memcpy(oBuf, mData->mappedData + iPos, iSize);
+            countMapped(iThreadId, iPos, iSize, start, tracing);
+        }
+        return;
+    }
+
     std::size_t threadId = 0;
     if (iThreadId < mData->streams.size())
     {
         threadId = iThreadId;
     }
 
+    bool counting = mData->isCounting();
     {
-        Alembic::Util::scoped_lock l(mData->locks[threadId]);
+        StreamLock l(mData->locks[threadId], counting);
         std::istream * stream = mData->streams[threadId];
 
         // the file hasn't been opened for this id yet
@@ -256,7 +755,281 @@ void IStreams::read(std::size_t iThreadId, Alembic::Util::uint64_t iPos,
         }
         stream->seekg(iPos + mData->offsets[threadId]);
         stream->read((char *)oBuf, iSize);
+
+        if (counting)
+        {
+            StreamStats & stats = mData->streamStats[threadId];
+            stats.numReads++;
+            stats.numBytes += iSize;
+
+            Alembic::Util::uint64_t lastEnd = mData->streamEnds[threadId];
+            if (iPos != lastEnd)
+            {
+                stats.numSeeks++;
+                stats.seekDistance +=
+                    (iPos > lastEnd) ? iPos - lastEnd : lastEnd - iPos;
+            }
+            mData->streamEnds[threadId] = iPos + iSize;
+
+            if (l.contended())
+            {
+                stats.numContended++;
+            }
+            stats.lockWaitNanoseconds += l.wait();
+            stats.lockWaitHistogram[LockWaitBucket(l.wait())]++;
+        }
+    }
+
+    if (tracing)
+    {
+        trace(threadId, iPos, iSize, start);
+    }
+}
+
+const void * IStreams::getMappedData(Alembic::Util::uint64_t iPos,
+                                    Alembic::Util::uint64_t iSize)
+{
+    Alembic::Util::uint64_t shard = (iPos & SHARD_MASK) >> SHARD_SHIFT;
+    if (shard != 0)
+    {
+        if (shard > mData->shards.size())
+        {
+            return NULL;
+        }
+        return mData->shards[shard - 1]->getMappedData(iPos & SHARD_POS,
+                                                       iSize);
+    }
+
+    if (mData->mappedData == NULL || iPos > mData->mappedSize ||
+        iSize > mData->mappedSize - iPos)
+    {
+        return NULL;
+    }
+
+    bool tracing = mData->isTracing();
+    if (tracing || mData->isCounting())
+    {
+        countMapped(0, iPos, iSize, NowNanoseconds(), tracing);
+    }
+
+    return mData->mappedData + iPos;
+}
+
+void IStreams::setMaxChildTableBytes(Alembic::Util::uint64_t iMaxBytes)
+{
+    Alembic::Util::scoped_lock l(mData->childTableLock);
+    mData->maxChildTableBytes = iMaxBytes;
+}
+
+Alembic::Util::uint64_t IStreams::getMaxChildTableBytes()
+{
+    Alembic::Util::scoped_lock l(mData->childTableLock);
+    return mData->maxChildTableBytes;
+}
+
+bool IStreams::reserveChildTable(Alembic::Util::uint64_t iSize)
+{
+    Alembic::Util::scoped_lock l(mData->childTableLock);
+    if (iSize > mData->maxChildTableBytes ||
+        mData->childTableBytes > mData->maxChildTableBytes - iSize)
+    {
+        return false;
+    }
+
+    mData->childTableBytes += iSize;
+    return true;
+}
+
+void IStreams::releaseChildTable(Alembic::Util::uint64_t iSize)
+{
+    Alembic::Util::scoped_lock l(mData->childTableLock);
+    mData->childTableBytes -= iSize;
+}
+
+void IStreams::setStatsEnabled(bool iEnabled)
+{
+    {
+        Alembic::Util::scoped_lock l(mData->statsLock);
+        mData->statsEnabled = iEnabled;
+    }
+
+    for (std::size_t i = 0; i < mData->shards.size(); ++i)
+    {
+        mData->shards[i]->setStatsEnabled(iEnabled);
+    }
+}
+
+bool IStreams::getStatsEnabled()
+{
+    return mData->isCounting();
+}
+
+void IStreams::getStats(ReadStats & oStats)
+{
+    oStats = ReadStats();
+    oStats.streams.resize(mData->streamStats.size());
+    for (std::size_t i = 0; i < mData->streamStats.size(); ++i)
+    {
+        Alembic::Util::scoped_lock l(mData->locks[i]);
+        oStats.streams[i] = mData->streamStats[i];
+    }
+
+    {
+        Alembic::Util::scoped_lock l(mData->statsLock);
+        oStats.numMappedReads = mData->numMappedReads;
+        oStats.numMappedBytes = mData->numMappedBytes;
+    }
+
+    // the reads of a shard went through the stream with the same id
+    for (std::size_t i = 0; i < mData->shards.size(); ++i)
+    {
+        ReadStats shardStats;
+        mData->shards[i]->getStats(shardStats);
+        oStats.numMappedReads += shardStats.numMappedReads;
+        oStats.numMappedBytes += shardStats.numMappedBytes;
+
+        if (oStats.streams.size() < shardStats.streams.size())
+        {
+            oStats.streams.resize(shardStats.streams.size());
+        }
+
+        for (std::size_t j = 0; j < shardStats.streams.size(); ++j)
+        {
+            AddStreamStats(oStats.streams[j], shardStats.streams[j]);
+        }
+    }
+}
+
+void IStreams::resetStats()
+{
+    for (std::size_t i = 0; i < mData->streamStats.size(); ++i)
+    {
+        Alembic::Util::scoped_lock l(mData->locks[i]);
+        mData->streamStats[i] = StreamStats();
+    }
+
+    {
+        Alembic::Util::scoped_lock l(mData->statsLock);
+        mData->numMappedReads = 0;
+        mData->numMappedBytes = 0;
+        mData->traceEvents.clear();
+        mData->traceNext = 0;
+        mData->numTraceEvents = 0;
+        mData->traceStart = NowNanoseconds();
+    }
+
+    for (std::size_t i = 0; i < mData->shards.size(); ++i)
+    {
+        mData->shards[i]->resetStats();
+    }
+}
+
+void IStreams::setTraceEnabled(bool iEnabled)
+{
+    Alembic::Util::scoped_lock l(mData->statsLock);
+    if (iEnabled && !mData->traceEnabled && mData->traceEvents.empty())
+    {
+        mData->traceStart = NowNanoseconds();
+    }
+    mData->traceEnabled = iEnabled;
+}
+
+bool IStreams::getTraceEnabled()
+{
+    return mData->isTracing();
+}
+
+void IStreams::writeTrace(std::ostream & oStream)
+{
+    // oldest first
+    std::vector<TraceEvent> events;
+    Alembic::Util::uint64_t traceStart = 0;
+    Alembic::Util::uint64_t numDropped = 0;
+    {
+        Alembic::Util::scoped_lock l(mData->statsLock);
+        const std::vector<TraceEvent> & traced = mData->traceEvents;
+        events.reserve(traced.size());
+        events.insert(events.end(), traced.begin() + mData->traceNext,
+                      traced.end());
+        events.insert(events.end(), traced.begin(),
+                      traced.begin() + mData->traceNext);
+        traceStart = mData->traceStart;
+        numDropped = mData->numTraceEvents - traced.size();
+    }
+
+    oStream << "{\"traceEvents\":[";
+    for (std::size_t i = 0; i < events.size(); ++i)
+    {
+        const TraceEvent & event = events[i];
+        oStream << (i == 0 ? "\n" : ",\n")
+                << "{\"name\":\"" << (event.mapped ? "mapped read" : "read")
+                << "\",\"cat\":\"ogawa\",\"ph\":\"X\",\"pid\":0,\"tid\":"
+                << event.stream << ",\"ts\":";
+        WriteMicroseconds(oStream, event.start - traceStart);
+        oStream << ",\"dur\":";
+        WriteMicroseconds(oStream, event.duration);
+        oStream << ",\"args\":{\"shard\":"
+                << ((event.pos & SHARD_MASK) >> SHARD_SHIFT)
+                << ",\"offset\":" << (event.pos & SHARD_POS)
+                << ",\"size\":" << event.size << "}}";
+    }
+    oStream << "\n],\"displayTimeUnit\":\"ns\",\"otherData\":{"
+            << "\"droppedEvents\":" << numDropped << "}}\n";
+}
+
+void IStreams::countMapped(std::size_t iThreadId,
+                           Alembic::Util::uint64_t iPos,
+                           Alembic::Util::uint64_t iSize,
+                           Alembic::Util::uint64_t iStart,
+                           bool iTrace)
+{
+    if (mData->isCounting())
+    {
+#ifdef ALEMBIC_OGAWA_ATOMIC_STATS
+        mData->numMappedReads++;
+        mData->numMappedBytes += iSize;
+#else
+        Alembic::Util::scoped_lock l(mData->statsLock);
+        mData->numMappedReads++;
+        mData->numMappedBytes += iSize;
+#endif
+    }
+
+    if (iTrace)
+    {
+        trace(iThreadId, iPos, iSize, iStart);
+    }
+}
+
+void IStreams::trace(std::size_t iThreadId, Alembic::Util::uint64_t iPos,
+                     Alembic::Util::uint64_t iSize,
+                     Alembic::Util::uint64_t iStart)
+{
+    TraceEvent event;
+    event.start = iStart;
+    event.duration = NowNanoseconds() - iStart;
+    event.pos = iPos;
+    event.size = iSize;
+    event.stream = iThreadId;
+    event.mapped = (mData->mappedData != NULL);
+
+    Alembic::Util::scoped_lock l(mData->statsLock);
+    if (iStart < mData->traceStart)
+    {
+        // the read started before the trace was reset
+        event.start = mData->traceStart;
+    }
+
+    if (mData->traceEvents.size() < MAX_TRACE_EVENTS)
+    {
+        mData->traceEvents.push_back(event);
+    }
+    else
+    {
+        mData->traceEvents[mData->traceNext] = event;
+        mData->traceNext = (mData->traceNext + 1) % MAX_TRACE_EVENTS;
     }
+    mData->numTraceEvents++;
 }
 
 } // End namespace ALEMBIC_VERSION_NS
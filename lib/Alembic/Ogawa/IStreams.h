@@ -40,15 +40,64 @@
 #include <Alembic/Ogawa/Foundation.h>
 
 #include <istream>
+#include <ostream>
 
 namespace Alembic {
 namespace Ogawa {
 namespace ALEMBIC_VERSION_NS {
 
+// how many buckets the lock wait histograms have, see StreamStats
+static const std::size_t LOCK_WAIT_BUCKETS = 16;
+
+// how many reads a trace keeps, see IStreams::setTraceEnabled
+static const std::size_t MAX_TRACE_EVENTS = 1 << 18;
+
+// How the reads of one stream went, see IStreams::setStatsEnabled
+struct StreamStats
+{
+    StreamStats();
+
+    Alembic::Util::uint64_t numReads;
+    Alembic::Util::uint64_t numBytes;
+
+    // reads that didn't start where the read before them ended, and how
+    // far away from there they started, all together
+    Alembic::Util::uint64_t numSeeks;
+    Alembic::Util::uint64_t seekDistance;
+
+    // reads that had to wait for another read to be done with the stream,
+    // and how long all the reads waited for the stream altogether
+    Alembic::Util::uint64_t numContended;
+    Alembic::Util::uint64_t lockWaitNanoseconds;
+
+    // the first bucket counts the reads that didn't wait at all (or less
+    // than a microsecond), bucket i counts the ones that waited at least
+    // 2^(i-1) but less than 2^i microseconds, and the last bucket also
+    // counts everything longer than that
+    Alembic::Util::uint64_t lockWaitHistogram[LOCK_WAIT_BUCKETS];
+};
+
+// What was read, see IStreams::setStatsEnabled
+struct ReadStats
+{
+    ReadStats();
+
+    // reads from a memory mapped file, which don't use the streams
+    // (including the bytes referenced via IStreams::getMappedData)
+    Alembic::Util::uint64_t numMappedReads;
+    Alembic::Util::uint64_t numMappedBytes;
+
+    // by stream id
+    std::vector< StreamStats > streams;
+};
+
 class ALEMBIC_EXPORT IStreams
 {
 public:
-    IStreams(const std::string & iFileName, std::size_t iNumStreams=1);
+    // If iUseMMap is true the file will be memory mapped and iNumStreams is
+    // ignored, if the mapping fails we fall back to using file streams.
+    IStreams(const std::string & iFileName, std::size_t iNumStreams=1,
+             bool iUseMMap=false);
     IStreams(const std::vector< std::istream * > & iStreams);
     ~IStreams();
 
@@ -56,16 +105,86 @@ public:
     bool isFrozen();
     Alembic::Util::uint16_t getVersion();
 
+    // true if we are reading from a memory mapped file instead of streams
+    bool isMapped();
+
+    // Reads the header again, for files that were still being written when
+    // they were opened.  Returns false if there is nothing more to read,
+    // because we are invalid, memory mapped (only what was in the file when
+    // it was mapped can be read), or the file was already done being
+    // written.
+    bool refresh();
+
     // locks on the threadId, seeks to iPos, and reads iSize bytes into oBuf
+    // if we are memory mapped no locking is done and the bytes are just
+    // copied out of the mapped region
+    // If iPos has shard bits (see Foundation.h) the read is passed on to
+    // that shard.
     void read(std::size_t iThreadId, Alembic::Util::uint64_t iPos,
               Alembic::Util::uint64_t iSize, void * oBuf);
 
+    // if we are memory mapped, returns a pointer to the iSize bytes at iPos
+    // within the mapped file, NULL is returned if we aren't mapped or the
+    // requested bytes are beyond the end of the file.
+    // The pointer is only valid for the lifetime of this IStreams.
+    const void * getMappedData(Alembic::Util::uint64_t iPos,
+                               Alembic::Util::uint64_t iSize);
+
+    // Light groups that are read from more than once keep a table of where
+    // their children are, so they don't need to read it for each child.
+    // These reserve and release the memory used by those tables, so that
+    // together they stay under the maximum set here (64MB by default).
+    // reserveChildTable returns false if iSize more bytes wouldn't fit.
+    void setMaxChildTableBytes(Alembic::Util::uint64_t iMaxBytes);
+    Alembic::Util::uint64_t getMaxChildTableBytes();
+    bool reserveChildTable(Alembic::Util::uint64_t iSize);
+    void releaseChildTable(Alembic::Util::uint64_t iSize);
+
+    // Counting what is read is off by default, when it is turned on every
+    // read is counted, and how long it waited for its stream is timed.
+    // The shards of a sharded archive are counted along with us.
+    // It can be turned on and off while reading on other threads, reads
+    // that are already under way may or may not be counted.
+    void setStatsEnabled(bool iEnabled);
+    bool getStatsEnabled();
+
+    // what was read since the stats were turned on or reset
+    void getStats(ReadStats & oStats);
+    void resetStats();
+
+    // When tracing is turned on the stream, position, size, start time and
+    // duration of every read is kept (about 48 bytes per read) until the
+    // stats are reset.  Only the last MAX_TRACE_EVENTS reads are kept, so a
+    // trace uses at most about 12MB.  It is off by default, and like
+    // setStatsEnabled can be changed while reading on other threads.
+    void setTraceEnabled(bool iEnabled);
+    bool getTraceEnabled();
+
+    // Writes the reads that were traced as Chrome trace event JSON, which
+    // can be loaded by chrome://tracing or Perfetto.  Each stream is shown
+    // as its own thread, and how many of the earliest reads were dropped
+    // is written as droppedEvents in otherData.
+    void writeTrace(std::ostream & oStream);
+
 private:
     // noncopyable
     IStreams(const IStreams &);
     const IStreams & operator=(const IStreams &);
 
     void init();
+    bool initMapped(const std::string & iFileName);
+
+    // opens the shards of a sharded archive (see OArchive), and makes us
+    // invalid if any of them can't be read
+    void initShards(std::size_t iNumStreams, bool iUseMMap);
+
+    // adds up what was read from a mapped file, and traces it if iTrace
+    void countMapped(std::size_t iThreadId, Alembic::Util::uint64_t iPos,
+                     Alembic::Util::uint64_t iSize,
+                     Alembic::Util::uint64_t iStart, bool iTrace);
+
+    void trace(std::size_t iThreadId, Alembic::Util::uint64_t iPos,
+               Alembic::Util::uint64_t iSize, Alembic::Util::uint64_t iStart);
 
     class PrivateData;
     Alembic::Util::auto_ptr< PrivateData > mData;
@@ -37,19 +37,50 @@
 #include <Alembic/Ogawa/OStream.h>
 #include <Alembic/Ogawa/OGroup.h>
 
+#include <stdexcept>
+
 namespace Alembic {
 namespace Ogawa {
 namespace ALEMBIC_VERSION_NS {
 
-OArchive::OArchive(const std::string & iFileName) :
-    mStream(new OStream(iFileName))
+OArchive::OArchive(const std::string & iFileName, std::size_t iBufferSize,
+                   bool iAppend) :
+    mStream(new OStream(iFileName, iBufferSize, iAppend))
 {
     mGroup.reset(new OGroup(mStream));
 }
 
-OArchive::OArchive(std::ostream * iStream) :
-    mStream(new OStream(iStream)), mGroup(new OGroup(mStream))
+OArchive::OArchive(std::ostream * iStream, std::size_t iBufferSize) :
+    mStream(new OStream(iStream, iBufferSize)), mGroup(new OGroup(mStream))
+{
+}
+
+OArchive::OArchive(const std::string & iFileName,
+                   const std::vector< std::string > & iShards,
+                   std::size_t iBufferSize) :
+    mStream(new OStream(iFileName, iBufferSize)), mGroup(new OGroup(mStream))
 {
+    if (iShards.empty() || iShards.size() > (SHARD_MASK >> SHARD_SHIFT))
+    {
+        throw std::runtime_error("Invalid number of Ogawa shards.");
+    }
+
+    if (!mStream->isValid())
+    {
+        return;
+    }
+
+    mStream->setVersion(2);
+
+    // the null terminated shard names go right after the header, where
+    // readers expect them
+    std::string names;
+    for (std::size_t i = 0; i < iShards.size(); ++i)
+    {
+        names += iShards[i];
+        names.push_back('\0');
+    }
+    mGroup->createData(names.size(), names.c_str());
 }
 
 OArchive::~OArchive()
@@ -66,6 +97,22 @@ OGroupPtr OArchive::getGroup()
     return mGroup;
 }
 
+void OArchive::commit(const SnapshotExtras & iExtras)
+{
+    if (!mStream->isValid() || mGroup->isFrozen())
+    {
+        return;
+    }
+
+    Alembic::Util::uint64_t pos = mGroup->writeSnapshot(iExtras);
+    mStream->commit(pos);
+}
+
+void OArchive::abandon()
+{
+    mStream->abandon();
+}
+
 } // End namespace ALEMBIC_VERSION_NS
 } // End namespace Ogawa
 } // End namespace Alembic
@@ -41,6 +41,8 @@
 #include <Alembic/Ogawa/OGroup.h>
 #include <Alembic/Ogawa/OStream.h>
 
+#include <vector>
+
 namespace Alembic {
 namespace Ogawa {
 namespace ALEMBIC_VERSION_NS {
@@ -48,14 +50,47 @@ namespace ALEMBIC_VERSION_NS {
 class ALEMBIC_EXPORT OArchive
 {
 public:
-    OArchive(const std::string & iFileName);
-    OArchive(std::ostream * iStream);
+    // iBufferSize is the number of bytes to accumulate in memory before
+    // writing to the file or stream, 0 writes everything immediately.
+    // If iAppend is true, iFileName has to be an existing, finished Ogawa
+    // archive which is added to instead of being replaced.  The new top
+    // group can reference what is already in it via OGroup::addChild, and
+    // until it is frozen readers still see the old top group, so if we
+    // don't finish the old archive is left as it was.
+    OArchive(const std::string & iFileName, std::size_t iBufferSize=0,
+             bool iAppend=false);
+    OArchive(std::ostream * iStream, std::size_t iBufferSize=0);
+
+    // Writes a sharded archive (format version 2), whose data can also be
+    // in the finished Ogawa archives iShards, which are referenced via
+    // OGroup::addShardData.  The shard names are written as given, readers
+    // look for relative names next to iFileName.  Only readers that know
+    // about shards can read the archive.
+    OArchive(const std::string & iFileName,
+             const std::vector< std::string > & iShards,
+             std::size_t iBufferSize=0);
     ~OArchive();
 
     OGroupPtr getGroup();
 
     bool isValid();
 
+    // Writes what has been added so far as a complete archive and points
+    // the header at it, so that it can be read (see IArchive::refresh)
+    // before the top group is frozen.  Groups that aren't frozen are
+    // written with the children they have so far, followed by their data
+    // in iExtras.  Nothing already written is changed, so readers of
+    // earlier commits are unaffected, but each commit adds another copy
+    // of the child tables of the unfrozen groups to the file.
+    // Does nothing once the top group is frozen.
+    void commit(const SnapshotExtras & iExtras);
+
+    // Stops writing (see OStream::abandon), for when something that should
+    // have been written failed.  The top group is never frozen, so readers
+    // only see what was there after the last commit, or the archive being
+    // appended to.
+    void abandon();
+
 private:
     OStreamPtr mStream;
     OGroupPtr mGroup;
@@ -62,13 +62,14 @@ public:
 
     Alembic::Util::uint64_t getSize() const;
 
+    // where the data was written within the stream (0 for empty data)
+    Alembic::Util::uint64_t getPos() const;
+
 private:
     friend class OGroup; // friend so we can call the constructor below
     OData(OStreamPtr iStream, Alembic::Util::uint64_t iPos,
           Alembic::Util::uint64_t iSize);
 
-    Alembic::Util::uint64_t getPos() const;
-
     class PrivateData;
     Alembic::Util::auto_ptr< PrivateData > mData;
 };
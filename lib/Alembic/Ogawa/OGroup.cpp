@@ -38,6 +38,8 @@
 #include <Alembic/Ogawa/OData.h>
 #include <Alembic/Ogawa/OStream.h>
 
+#include <stdexcept>
+
 namespace Alembic {
 namespace Ogawa {
 namespace ALEMBIC_VERSION_NS {
@@ -45,6 +47,10 @@ namespace ALEMBIC_VERSION_NS {
 typedef std::pair< OGroupPtr, Alembic::Util::uint64_t > ParentPair;
 typedef std::vector< ParentPair > ParentPairVec;
 
+typedef std::pair< Alembic::Util::uint64_t, Alembic::Util::weak_ptr< OGroup > >
+    ChildPair;
+typedef std::vector< ChildPair > ChildPairVec;
+
 class OGroup::PrivateData
 {
 public:
@@ -56,6 +62,10 @@ public:
     // used before freeze
     ParentPairVec parents;
 
+    // used before freeze, the children that weren't frozen when they were
+    // added, for writing snapshots
+    ChildPairVec unfrozenChildren;
+
     // used before and after freeze
     std::vector<Alembic::Util::uint64_t> childVec;
 
@@ -91,6 +101,8 @@ OGroupPtr OGroup::addGroup()
     {
         mData->childVec.push_back(0);
         child.reset(new OGroup(shared_from_this(), mData->childVec.size() - 1));
+        mData->unfrozenChildren.push_back(
+            ChildPair(mData->childVec.size() - 1, child));
     }
     return child;
 }
@@ -208,10 +220,77 @@ void OGroup::addGroup(OGroupPtr iGroup)
             mData->childVec.push_back(EMPTY_GROUP);
             iGroup->mData->parents.push_back(
                 ParentPair(shared_from_this(), mData->childVec.size() - 1));
+            mData->unfrozenChildren.push_back(
+                ChildPair(mData->childVec.size() - 1, iGroup));
         }
     }
 }
 
+void OGroup::addChild(IGroupPtr iGroup, Alembic::Util::uint64_t iIndex)
+{
+    if (!isFrozen())
+    {
+        mData->childVec.push_back(iGroup->getChildEntry(iIndex, 0));
+    }
+}
+
+ODataPtr OGroup::addData(IDataPtr iData)
+{
+    ODataPtr child;
+    if (isFrozen())
+    {
+        return child;
+    }
+
+    if (iData->getSize() == 0)
+    {
+        child.reset(new OData());
+    }
+    else
+    {
+        child.reset(new OData(mData->stream, iData->getPos(),
+                              iData->getSize()));
+    }
+
+    mData->childVec.push_back(child->getPos() | 0x8000000000000000ULL);
+    return child;
+}
+
+void OGroup::addShardData(Alembic::Util::uint64_t iShard, IDataPtr iData)
+{
+    if (isFrozen())
+    {
+        return;
+    }
+
+    if (iData->getSize() == 0)
+    {
+        mData->childVec.push_back(EMPTY_DATA);
+        return;
+    }
+
+    if (iShard == 0 || iShard > (SHARD_MASK >> SHARD_SHIFT) ||
+        iData->getPos() > SHARD_POS)
+    {
+        throw std::runtime_error("Invalid Ogawa shard data.");
+    }
+
+    mData->childVec.push_back(iData->getPos() | (iShard << SHARD_SHIFT) |
+                              EMPTY_DATA);
+}
+
+OGroupPtr OGroup::replaceWithNewGroup(Alembic::Util::uint64_t iIndex)
+{
+    OGroupPtr child;
+    if (!isFrozen() && iIndex < mData->childVec.size())
+    {
+        mData->childVec[iIndex] = 0;
+        child.reset(new OGroup(shared_from_this(), iIndex));
+        mData->unfrozenChildren.push_back(ChildPair(iIndex, child));
+    }
+    return child;
+}
+
 void OGroup::addEmptyGroup()
 {
     if (!isFrozen())
@@ -271,7 +350,54 @@ void OGroup::freeze()
     }
 
     mData->parents.clear();
+    mData->unfrozenChildren.clear();
+}
+
+Alembic::Util::uint64_t OGroup::writeSnapshot(const SnapshotExtras & iExtras)
+{
+    if (isFrozen())
+    {
+        return mData->pos;
+    }
+
+    std::vector<Alembic::Util::uint64_t> childVec = mData->childVec;
 
+    // children that were frozen since we last looked are already in
+    // childVec, so we only need to hold onto the rest
+    ChildPairVec stillUnfrozen;
+    ChildPairVec::iterator it;
+    for (it = mData->unfrozenChildren.begin();
+         it != mData->unfrozenChildren.end(); ++it)
+    {
+        OGroupPtr child = it->second.lock();
+        if (child && !child->isFrozen())
+        {
+            childVec[it->first] = child->writeSnapshot(iExtras);
+            stillUnfrozen.push_back(*it);
+        }
+    }
+    mData->unfrozenChildren.swap(stillUnfrozen);
+
+    SnapshotExtras::const_iterator extra = iExtras.find(this);
+    if (extra != iExtras.end())
+    {
+        std::vector< ODataPtr >::const_iterator dt;
+        for (dt = extra->second.begin(); dt != extra->second.end(); ++dt)
+        {
+            childVec.push_back((*dt)->getPos() | 0x8000000000000000ULL);
+        }
+    }
+
+    if (childVec.empty())
+    {
+        return EMPTY_GROUP;
+    }
+
+    Alembic::Util::uint64_t pos = mData->stream->getAndSeekEndPos();
+    Alembic::Util::uint64_t size = childVec.size();
+    mData->stream->write(&size, 8);
+    mData->stream->write(&childVec.front(), size*8);
+    return pos;
 }
 
 bool OGroup::isFrozen()
@@ -279,6 +405,11 @@ bool OGroup::isFrozen()
     return mData->pos != INVALID_GROUP;
 }
 
+Alembic::Util::uint64_t OGroup::getPos() const
+{
+    return mData->pos;
+}
+
 Alembic::Util::uint64_t OGroup::getNumChildren() const
 {
     return mData->childVec.size();
@@ -40,6 +40,10 @@
 #include <Alembic/Ogawa/Foundation.h>
 #include <Alembic/Ogawa/OStream.h>
 #include <Alembic/Ogawa/OData.h>
+#include <Alembic/Ogawa/IGroup.h>
+#include <Alembic/Ogawa/IData.h>
+
+#include <map>
 
 namespace Alembic {
 namespace Ogawa {
@@ -48,6 +52,10 @@ namespace ALEMBIC_VERSION_NS {
 class OGroup;
 typedef Alembic::Util::shared_ptr< OGroup > OGroupPtr;
 
+// data to add after the children of groups that aren't frozen yet, when
+// writing a snapshot of the archive (see OArchive::commit)
+typedef std::map< const OGroup *, std::vector< ODataPtr > > SnapshotExtras;
+
 class ALEMBIC_EXPORT OGroup 
     : public Alembic::Util::enable_shared_from_this< OGroup >
 {
@@ -85,6 +93,22 @@ public:
     // reference an existing group
     void addGroup(OGroupPtr iGroup);
 
+    // reference child iIndex of iGroup, which has to have been read from
+    // the file this archive is appending to (see OArchive)
+    void addChild(IGroupPtr iGroup, Alembic::Util::uint64_t iIndex);
+
+    // reference data read from the file this archive is appending to, the
+    // returned ODataPtr can be added to other groups like any other
+    ODataPtr addData(IDataPtr iData);
+
+    // reference iData, read from shard iShard (1 for the first) of the
+    // sharded archive we are writing (see OArchive)
+    void addShardData(Alembic::Util::uint64_t iShard, IDataPtr iData);
+
+    // create a group and put it in place of child iIndex, which is usually
+    // one that was added via addChild.  Does nothing if we are frozen.
+    OGroupPtr replaceWithNewGroup(Alembic::Util::uint64_t iIndex);
+
     // convenience function for adding a default NULL group
     void addEmptyGroup();
 
@@ -97,6 +121,10 @@ public:
 
     bool isFrozen();
 
+    // where the group was written within the stream (0 for the empty group)
+    // only valid once the group is frozen
+    Alembic::Util::uint64_t getPos() const;
+
     Alembic::Util::uint64_t getNumChildren() const;
 
     bool isChildGroup(Alembic::Util::uint64_t iIndex) const;
@@ -124,6 +152,12 @@ private:
 
     OGroup(OGroupPtr iParent, Alembic::Util::uint64_t iIndex);
 
+    // writes the child table of this group as if it were frozen now, with
+    // the data in iExtras for this group after the children it has so far,
+    // doing the same for children that aren't frozen yet.  Returns where
+    // it was written, the group itself is left as it was.
+    Alembic::Util::uint64_t writeSnapshot(const SnapshotExtras & iExtras);
+
     class PrivateData;
     Alembic::Util::auto_ptr< PrivateData > mData;
 };
@@ -36,6 +36,8 @@
 #include <Alembic/Ogawa/OStream.h>
 #include <fstream>
 #include <stdexcept>
+#include <vector>
+#include <cstring>
 
 namespace Alembic {
 namespace Ogawa {
@@ -44,9 +46,31 @@ namespace ALEMBIC_VERSION_NS {
 class OStream::PrivateData
 {
 public:
-    PrivateData(const std::string & iFileName) :
-        stream(NULL), fileName(iFileName), startPos(0)
+    PrivateData(const std::string & iFileName, std::size_t iBufferSize,
+                bool iAppend) :
+        stream(NULL), fileName(iFileName), startPos(0), append(iAppend),
+        abandoned(false), bufferSize(iBufferSize), bufferPos(0), curPos(0), endPos(0)
     {
+        if (append)
+        {
+            // we need to read the header of what we are appending to
+            std::fstream * filestream = new std::fstream(fileName.c_str(),
+                std::ios_base::in | std::ios_base::out |
+                std::ios_base::binary);
+            if (filestream->is_open())
+            {
+                stream = filestream;
+                stream->exceptions ( std::fstream::failbit |
+                                     std::fstream::badbit );
+            }
+            else
+            {
+                filestream->close();
+                delete filestream;
+            }
+            return;
+        }
+
         std::ofstream * filestream = new std::ofstream(fileName.c_str(),
             std::ios_base::trunc | std::ios_base::binary);
         if (filestream->is_open())
@@ -62,7 +86,10 @@ public:
         }
     }
 
-    PrivateData(std::ostream * iStream) : stream(iStream), startPos(0)
+    PrivateData(std::ostream * iStream, std::size_t iBufferSize) :
+        stream(iStream), startPos(0), append(false), abandoned(false),
+        bufferSize(iBufferSize), bufferPos(0),
+        curPos(0), endPos(0)
     {
         if (stream)
         {
@@ -83,11 +110,17 @@ public:
         if (!fileName.empty() && stream)
         {
             std::ofstream * filestream = dynamic_cast<std::ofstream *>(stream);
+            std::fstream * appendstream = dynamic_cast<std::fstream *>(stream);
             if (filestream)
             {
                 filestream->close();
                 delete filestream;
             }
+            else if (appendstream)
+            {
+                appendstream->close();
+                delete appendstream;
+            }
         }
     }
 
@@ -95,16 +128,33 @@ public:
     std::string fileName;
     Alembic::Util::uint64_t startPos;
     Alembic::Util::mutex lock;
+
+    // whether we are adding to an existing archive
+    bool append;
+
+    // set by abandon, nothing more gets written once this is true
+    bool abandoned;
+
+    // only used when bufferSize is greater than 0
+    // buffer holds the tail of the stream, starting at bufferPos and ending
+    // at endPos, curPos is where the next write will go
+    std::size_t bufferSize;
+    std::vector< char > buffer;
+    Alembic::Util::uint64_t bufferPos;
+    Alembic::Util::uint64_t curPos;
+    Alembic::Util::uint64_t endPos;
 };
 
-OStream::OStream(const std::string & iFileName) :
-    mData(new PrivateData(iFileName))
+OStream::OStream(const std::string & iFileName, std::size_t iBufferSize,
+                 bool iAppend) :
+    mData(new PrivateData(iFileName, iBufferSize, iAppend))
 {
     init();
 }
 
 // we'll be writing from this already open stream which we don't own
-OStream::OStream(std::ostream * iStream) : mData(new PrivateData(iStream))
+OStream::OStream(std::ostream * iStream, std::size_t iBufferSize) :
+    mData(new PrivateData(iStream, iBufferSize))
 {
     init();
 }
@@ -114,6 +164,7 @@ OStream::~OStream()
     // write our "frozen" byte (totally done writing)
     if (isValid())
     {
+        flushBuffer();
         char frozen = 0xff;
         mData->stream->seekp(mData->startPos + 5).write(&frozen, 1).flush();
     }
@@ -121,7 +172,14 @@ OStream::~OStream()
 
 bool OStream::isValid()
 {
-    return mData->stream != NULL;
+    return mData->stream != NULL && !mData->abandoned;
+}
+
+void OStream::abandon()
+{
+    Alembic::Util::scoped_lock l(mData->lock);
+    mData->buffer.clear();
+    mData->abandoned = true;
 }
 
 void OStream::init()
@@ -140,7 +198,36 @@ void OStream::init()
             "Ogawa currently only supports little-endian writing.");
     }
 
-    if (isValid())
+    if (isValid() && mData->append)
+    {
+        std::iostream * stream = dynamic_cast<std::iostream *>(mData->stream);
+
+        // only finished archives of the version we write can be added to,
+        // anything else would be mangled
+        char header[8];
+        stream->seekg(0).read(header, sizeof(header));
+        if (header[0] != 'O' || header[1] != 'g' || header[2] != 'a' ||
+            header[3] != 'w' || header[4] != 'a' || header[5] != (char) 0xff ||
+            header[6] != 0 || header[7] != 1)
+        {
+            throw std::runtime_error(
+                "Ogawa can only append to a finished Ogawa archive.");
+        }
+
+        Alembic::Util::uint64_t lastp =
+            stream->seekp(0, std::ios_base::end).tellp();
+        if (lastp == INVALID_DATA || lastp < 16)
+        {
+            throw std::runtime_error(
+                "Illegal end of Ogawa stream being appended to");
+        }
+
+        mData->bufferPos = lastp;
+        mData->curPos = lastp;
+        mData->endPos = lastp;
+        mData->buffer.reserve(mData->bufferSize);
+    }
+    else if (isValid())
     {
         const char header[] = {
             'O', 'g', 'a', 'w', 'a',  // special magic number
@@ -148,6 +235,63 @@ void OStream::init()
             0, 1,    // 16 bit format version number
             0, 0, 0, 0, 0, 0, 0, 0}; // position of the first group
         mData->stream->write(header, sizeof(header)).flush();
+
+        mData->bufferPos = sizeof(header);
+        mData->curPos = sizeof(header);
+        mData->endPos = sizeof(header);
+        mData->buffer.reserve(mData->bufferSize);
+    }
+}
+
+// assumes the lock is already held
+void OStream::flushBuffer()
+{
+    if (mData->buffer.empty())
+    {
+        return;
+    }
+
+    mData->stream->seekp(mData->bufferPos + mData->startPos);
+    mData->stream->write(&mData->buffer.front(), mData->buffer.size());
+    mData->bufferPos = mData->endPos;
+    mData->buffer.clear();
+}
+
+void OStream::flush()
+{
+    if (isValid())
+    {
+        Alembic::Util::scoped_lock l(mData->lock);
+        flushBuffer();
+        mData->stream->flush();
+    }
+}
+
+void OStream::commit(Alembic::Util::uint64_t iPos)
+{
+    if (isValid())
+    {
+        Alembic::Util::scoped_lock l(mData->lock);
+        flushBuffer();
+
+        // everything the group refers to needs to be in the stream before
+        // the header points at it
+        mData->stream->flush();
+        mData->stream->seekp(mData->startPos + 8).write(
+            (const char *)&iPos, 8).flush();
+    }
+}
+
+void OStream::setVersion(Alembic::Util::uint16_t iVersion)
+{
+    if (isValid())
+    {
+        Alembic::Util::scoped_lock l(mData->lock);
+        flushBuffer();
+
+        // stored big endian, like the header of the reader expects
+        char version[2] = {(char)(iVersion >> 8), (char)(iVersion & 0xff)};
+        mData->stream->seekp(mData->startPos + 6).write(version, 2).flush();
     }
 }
 
@@ -156,6 +300,13 @@ Alembic::Util::uint64_t OStream::getAndSeekEndPos()
     if (isValid())
     {
         Alembic::Util::scoped_lock l(mData->lock);
+
+        if (mData->bufferSize > 0)
+        {
+            mData->curPos = mData->endPos;
+            return mData->endPos;
+        }
+
         Alembic::Util::uint64_t lastp =
             mData->stream->seekp(0, std::ios_base::end).tellp();
         if (lastp == INVALID_DATA || lastp < mData->startPos)
@@ -175,6 +326,13 @@ void OStream::seek(Alembic::Util::uint64_t iPos)
     if (isValid())
     {
         Alembic::Util::scoped_lock l(mData->lock);
+
+        if (mData->bufferSize > 0)
+        {
+            mData->curPos = iPos;
+            return;
+        }
+
         mData->stream->seekp(iPos + mData->startPos);
     }
 }
@@ -184,7 +342,64 @@ void OStream::write(const void * iBuf, Alembic::Util::uint64_t iSize)
     if (isValid())
     {
         Alembic::Util::scoped_lock l(mData->lock);
-        mData->stream->write((const char *)iBuf, iSize).flush();
+
+        if (mData->bufferSize == 0)
+        {
+            mData->stream->write((const char *)iBuf, iSize).flush();
+            return;
+        }
+
+        Alembic::Util::uint64_t pos = mData->curPos;
+        mData->curPos += iSize;
+
+        // appending to the end, the common case
+        if (pos == mData->endPos)
+        {
+            if (mData->buffer.size() + iSize > mData->bufferSize)
+            {
+                flushBuffer();
+            }
+
+            mData->endPos += iSize;
+
+            // too big to bother buffering so write it directly
+            if (iSize >= mData->bufferSize)
+            {
+                mData->stream->seekp(pos + mData->startPos);
+                mData->stream->write((const char *)iBuf, iSize);
+                mData->bufferPos = mData->endPos;
+            }
+            else
+            {
+                const char * buf = (const char *)iBuf;
+                mData->buffer.insert(mData->buffer.end(), buf, buf + iSize);
+            }
+        }
+        // rewriting something that is still in the buffer, like a
+        // group that was just frozen
+        else if (pos >= mData->bufferPos && pos + iSize <= mData->endPos)
+        {
+            memcpy(&mData->buffer[pos - mData->bufferPos], iBuf, iSize);
+        }
+        // rewriting something that has already been written to the stream
+        else if (pos + iSize <= mData->bufferPos)
+        {
+            mData->stream->seekp(pos + mData->startPos);
+            mData->stream->write((const char *)iBuf, iSize);
+        }
+        // straddles the buffer or goes past the end, make the stream
+        // current and write it directly
+        else
+        {
+            flushBuffer();
+            mData->stream->seekp(pos + mData->startPos);
+            mData->stream->write((const char *)iBuf, iSize);
+            if (mData->curPos > mData->endPos)
+            {
+                mData->endPos = mData->curPos;
+            }
+            mData->bufferPos = mData->endPos;
+        }
     }
 }
 
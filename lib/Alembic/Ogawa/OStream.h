@@ -48,8 +48,16 @@ namespace ALEMBIC_VERSION_NS {
 class ALEMBIC_EXPORT OStream
 {
 public:
-    OStream(const std::string & iFileName);
-    OStream(std::ostream * iStream);
+    // If iBufferSize is greater than 0, writes are accumulated in memory
+    // and only written to the stream when the buffer is full, on flush, or
+    // on destruction.  The end position is also tracked in memory instead
+    // of seeking to the end of the stream.
+    // If iAppend is true the file has to be an existing, finished Ogawa
+    // archive, nothing already in it is changed except for the position of
+    // the first group in the header, and writes go after its end.
+    OStream(const std::string & iFileName, std::size_t iBufferSize=0,
+            bool iAppend=false);
+    OStream(std::ostream * iStream, std::size_t iBufferSize=0);
     ~OStream();
 
     bool isValid();
@@ -58,6 +66,23 @@ public:
     void write(const void * iBuf, Alembic::Util::uint64_t iSize);
     void seek(Alembic::Util::uint64_t iPos);
 
+    // writes out anything that has been buffered and flushes the stream
+    void flush();
+
+    // writes out anything that has been buffered, then points the header
+    // at the group written at iPos and flushes the stream
+    void commit(Alembic::Util::uint64_t iPos);
+
+    // changes the format version written in the header, which starts out
+    // as 1 (see OArchive for what 2 means)
+    void setVersion(Alembic::Util::uint16_t iVersion);
+
+    // Drops anything that has been buffered and stops writing, including
+    // the "frozen" byte on destruction, so the stream is left as it was
+    // after the last commit.  isValid returns false afterwards.
+    // Nothing else may be writing to the stream at the same time.
+    void abandon();
+
 private:
     // noncopyable
     OStream(const OStream &);
@@ -67,6 +92,7 @@ private:
     Alembic::Util::auto_ptr< PrivateData > mData;
 
     void init();
+    void flushBuffer();
 };
 
 typedef Alembic::Util::shared_ptr< OStream > OStreamPtr;
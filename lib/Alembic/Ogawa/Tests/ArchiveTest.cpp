@@ -37,6 +37,11 @@
 #include <Alembic/Ogawa/All.h>
 #include <Alembic/AbcCoreAbstract/Tests/Assert.h>
 
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
 void test()
 {
     {
@@ -77,9 +82,779 @@ void stringStreamTest()
     TESTING_ASSERT(ia.getGroup()->getNumChildren() == 0);
 }
 
+void mmapTest()
+{
+    {
+        Alembic::Ogawa::OArchive oa("mmapTest.ogawa");
+        Alembic::Ogawa::OGroupPtr top = oa.getGroup();
+        char data[] = {0, 1, 2, 3, 4, 5, 6, 7};
+        top->addData(8, data);
+        top->addEmptyData();
+        Alembic::Ogawa::OGroupPtr child = top->addGroup();
+        for (char i = 0; i < 10; ++i)
+        {
+            child->addData(1, &i);
+        }
+
+        Alembic::Ogawa::IArchive ia("mmapTest.ogawa", 1, true);
+        TESTING_ASSERT(ia.isValid());
+        TESTING_ASSERT(ia.isMapped());
+        TESTING_ASSERT(!ia.isFrozen());
+    }
+
+    Alembic::Ogawa::IArchive ia("mmapTest.ogawa", 4, true);
+    TESTING_ASSERT(ia.isValid());
+    TESTING_ASSERT(ia.isMapped());
+    TESTING_ASSERT(ia.isFrozen());
+    TESTING_ASSERT(ia.getVersion() == 1);
+
+    Alembic::Ogawa::IGroupPtr top = ia.getGroup();
+    TESTING_ASSERT(top->getNumChildren() == 3);
+    TESTING_ASSERT(top->isEmptyChildData(1));
+
+    Alembic::Ogawa::IDataPtr data = top->getData(0, 3);
+    TESTING_ASSERT(data->getSize() == 8);
+    char buf[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    data->read(8, buf, 0, 3);
+    for (std::size_t i = 0; i < 8; ++i)
+    {
+        TESTING_ASSERT(buf[i] == (char) i);
+    }
+
+    // we should be able to point directly at the mapped data too
+    const char * mapped = (const char *) data->getMappedData(8, 0);
+    TESTING_ASSERT(mapped != NULL);
+    for (std::size_t i = 0; i < 8; ++i)
+    {
+        TESTING_ASSERT(mapped[i] == (char) i);
+    }
+    TESTING_ASSERT(data->getMappedData(4, 4) == mapped + 4);
+    TESTING_ASSERT(data->getMappedData(8, 1) == NULL);
+
+    // reading beyond the data shouldn't touch the buffer
+    char beyond = 42;
+    data->read(1, &beyond, 8, 0);
+    TESTING_ASSERT(beyond == 42);
+
+    // light groups read the child positions on demand
+    Alembic::Ogawa::IGroupPtr child = top->getGroup(2, true, 0);
+    TESTING_ASSERT(child->isLight());
+    TESTING_ASSERT(child->getNumChildren() == 10);
+    for (char i = 0; i < 10; ++i)
+    {
+        char val = -1;
+        child->getData(i, 1)->read(1, &val, 0, 1);
+        TESTING_ASSERT(val == i);
+    }
+
+    // not mapped, so no direct access to the data
+    Alembic::Ogawa::IArchive streamia("mmapTest.ogawa");
+    TESTING_ASSERT(!streamia.isMapped());
+    TESTING_ASSERT(streamia.getGroup()->getData(0, 0)->getMappedData(8, 0) ==
+                   NULL);
+
+    // not an Ogawa file, shouldn't be valid
+    Alembic::Ogawa::IArchive badia("doesNotExist.ogawa", 1, true);
+    TESTING_ASSERT(!badia.isValid());
+    TESTING_ASSERT(!badia.isMapped());
+}
+
+void writeBuffered(std::ostream * iStream, std::size_t iBufferSize)
+{
+    Alembic::Ogawa::OArchive oa(iStream, iBufferSize);
+    Alembic::Ogawa::OGroupPtr top = oa.getGroup();
+
+    std::vector< char > big(100);
+    for (std::size_t i = 0; i < big.size(); ++i)
+    {
+        big[i] = (char) i;
+    }
+
+    Alembic::Ogawa::ODataPtr first = top->addData(8, &big.front());
+    Alembic::Ogawa::OGroupPtr child = top->addGroup();
+    for (char i = 0; i < 10; ++i)
+    {
+        child->addData(1, &i);
+    }
+
+    Alembic::Ogawa::ODataPtr bigData = top->addData(big.size(), &big.front());
+    child->addEmptyData();
+
+    Alembic::Ogawa::OGroupPtr grandChild = child->addGroup();
+    Alembic::Util::uint64_t sizes[] = {3, 0, 5};
+    const void * datas[] = {&big[10], NULL, &big[20]};
+    grandChild->addData(3, sizes, datas);
+    grandChild->freeze();
+
+    // rewrite data that has most likely already been written out
+    char rewritten[] = {42, 43};
+    first->rewrite(2, rewritten, 3);
+    bigData->rewrite(2, rewritten, 98);
+}
+
+void bufferedTest()
+{
+    std::stringstream unbuffered;
+    unbuffered << "potato!";
+    writeBuffered(&unbuffered, 0);
+
+    std::size_t bufferSizes[] = {1, 8, 9, 16, 50, 100, 1000, 1 << 20};
+    for (std::size_t i = 0; i < sizeof(bufferSizes) / sizeof(std::size_t); ++i)
+    {
+        std::stringstream buffered;
+        buffered << "potato!";
+        writeBuffered(&buffered, bufferSizes[i]);
+        TESTING_ASSERT(buffered.str() == unbuffered.str());
+    }
+
+    {
+        Alembic::Ogawa::OArchive oa("bufferedTest.ogawa", 1024);
+        TESTING_ASSERT(oa.isValid());
+        char data[] = {0, 1, 2, 3};
+        oa.getGroup()->addData(4, data);
+
+        // the header has already been written, but not the data yet
+        Alembic::Ogawa::IArchive ia("bufferedTest.ogawa");
+        TESTING_ASSERT(ia.isValid());
+        TESTING_ASSERT(!ia.isFrozen());
+    }
+
+    Alembic::Ogawa::IArchive ia("bufferedTest.ogawa");
+    TESTING_ASSERT(ia.isValid());
+    TESTING_ASSERT(ia.isFrozen());
+    TESTING_ASSERT(ia.getGroup()->getNumChildren() == 1);
+    Alembic::Ogawa::IDataPtr data = ia.getGroup()->getData(0, 0);
+    TESTING_ASSERT(data->getSize() == 4);
+    char buf[4] = {0, 0, 0, 0};
+    data->read(4, buf, 0, 0);
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        TESTING_ASSERT(buf[i] == (char) i);
+    }
+}
+
+void checkBatchedRead(Alembic::Ogawa::IArchive & iArchive)
+{
+    Alembic::Ogawa::IGroupPtr top = iArchive.getGroup();
+
+    // out of order, repeated, empty, big, a group and beyond the end
+    std::vector< Alembic::Util::uint64_t > indices;
+    Alembic::Util::uint64_t order[] = {5, 0, 1, 3, 3, 2, 7, 4, 6, 9, 8, 100};
+    indices.assign(order, order + sizeof(order) / sizeof(order[0]));
+
+    std::vector< Alembic::Ogawa::IDataPtr > datas;
+    top->getData(indices, 0, datas);
+    TESTING_ASSERT(datas.size() == indices.size());
+
+    for (std::size_t i = 0; i < indices.size(); ++i)
+    {
+        Alembic::Ogawa::IDataPtr data = top->getData(indices[i], 0);
+        if (!data)
+        {
+            TESTING_ASSERT(!datas[i]);
+            continue;
+        }
+
+        TESTING_ASSERT(datas[i]);
+        TESTING_ASSERT(datas[i]->getSize() == data->getSize());
+        TESTING_ASSERT(datas[i]->getPos() == data->getPos());
+
+        std::vector< char > expected(data->getSize() + 1, 42);
+        std::vector< char > found(data->getSize() + 1, 42);
+        data->read(data->getSize(), &expected.front(), 0, 0);
+        datas[i]->read(datas[i]->getSize(), &found.front(), 0, 0);
+        TESTING_ASSERT(expected == found);
+
+        // reading beyond the data shouldn't touch the buffer
+        datas[i]->read(2, &found.front(), data->getSize() - 1, 0);
+        TESTING_ASSERT(expected == found);
+
+        if (data->getSize() > 3)
+        {
+            char partial[2] = {0, 0};
+            datas[i]->read(2, partial, 2, 0);
+            TESTING_ASSERT(partial[0] == expected[2]);
+            TESTING_ASSERT(partial[1] == expected[3]);
+        }
+    }
+}
+
+void batchedReadTest()
+{
+    {
+        Alembic::Ogawa::OArchive oa("batchedReadTest.ogawa");
+        Alembic::Ogawa::OGroupPtr top = oa.getGroup();
+
+        std::vector< char > big(3 * 1024 * 1024);
+        for (std::size_t i = 0; i < big.size(); ++i)
+        {
+            big[i] = (char)(i * 7 + i / 1000);
+        }
+
+        top->addData(10, &big[0]);
+        top->addData(1, &big[10]);
+        top->addEmptyData();
+        top->addData(big.size(), &big.front());
+        top->addGroup()->addData(4, &big[100]);
+        top->addData(20, &big[200]);
+        top->addData(2 * 1024 * 1024, &big[1]);
+        top->addData(5, &big[1000]);
+        top->addEmptyGroup();
+        top->addData(17, &big[42]);
+    }
+
+    Alembic::Ogawa::IArchive ia("batchedReadTest.ogawa");
+    TESTING_ASSERT(!ia.isMapped());
+    checkBatchedRead(ia);
+
+    Alembic::Ogawa::IArchive mappedia("batchedReadTest.ogawa", 1, true);
+    TESTING_ASSERT(mappedia.isMapped());
+    checkBatchedRead(mappedia);
+}
+
+void checkLightGroup(Alembic::Ogawa::IGroupPtr iGroup)
+{
+    TESTING_ASSERT(iGroup->isLight());
+    TESTING_ASSERT(iGroup->getNumChildren() == 20);
+
+    // the first time through each child is read by itself, after that
+    // the positions of the children may be kept
+    for (std::size_t pass = 0; pass < 3; ++pass)
+    {
+        for (std::size_t i = 0; i < 21; ++i)
+        {
+            Alembic::Ogawa::IDataPtr data = iGroup->getData(i, 0);
+            Alembic::Ogawa::IGroupPtr group = iGroup->getGroup(i, false, 0);
+            if (i == 20)
+            {
+                TESTING_ASSERT(!data && !group);
+            }
+            else if (i == 10)
+            {
+                TESTING_ASSERT(!data && group);
+                TESTING_ASSERT(group->getNumChildren() == 1);
+            }
+            else
+            {
+                TESTING_ASSERT(data && !group);
+                TESTING_ASSERT(data->getSize() == i + 1);
+
+                std::vector< char > buf(i + 1);
+                data->read(i + 1, &buf.front(), 0, 0);
+                for (std::size_t j = 0; j <= i; ++j)
+                {
+                    TESTING_ASSERT(buf[j] == (char)(i + j));
+                }
+            }
+        }
+    }
+
+    std::vector< Alembic::Util::uint64_t > indices;
+    for (std::size_t i = 0; i < 21; ++i)
+    {
+        indices.push_back(20 - i);
+    }
+
+    std::vector< Alembic::Ogawa::IDataPtr > datas;
+    iGroup->getData(indices, 0, datas);
+    TESTING_ASSERT(datas.size() == indices.size());
+    for (std::size_t i = 0; i < indices.size(); ++i)
+    {
+        Alembic::Ogawa::IDataPtr data = iGroup->getData(indices[i], 0);
+        TESTING_ASSERT(!data == !datas[i]);
+        if (data)
+        {
+            TESTING_ASSERT(datas[i]->getPos() == data->getPos());
+            TESTING_ASSERT(datas[i]->getSize() == data->getSize());
+        }
+    }
+}
+
+void lightGroupTest()
+{
+    {
+        Alembic::Ogawa::OArchive oa("lightGroupTest.ogawa");
+        Alembic::Ogawa::OGroupPtr top = oa.getGroup();
+
+        std::vector< char > buf(64);
+        for (std::size_t i = 0; i < buf.size(); ++i)
+        {
+            buf[i] = (char) i;
+        }
+
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            Alembic::Ogawa::OGroupPtr group = top->addGroup();
+            for (std::size_t j = 0; j < 20; ++j)
+            {
+                if (j == 10)
+                {
+                    group->addGroup()->addData(1, &buf.front());
+                }
+                else
+                {
+                    group->addData(j + 1, &buf[j]);
+                }
+            }
+        }
+    }
+
+    Alembic::Ogawa::IArchive ia("lightGroupTest.ogawa");
+    Alembic::Ogawa::IGroupPtr top = ia.getGroup();
+    checkLightGroup(top->getGroup(0, true, 0));
+
+    // only room for one of the tables at a time
+    ia.setMaxChildTableBytes(20 * 8);
+    Alembic::Ogawa::IGroupPtr first = top->getGroup(0, true, 0);
+    checkLightGroup(first);
+    checkLightGroup(top->getGroup(1, true, 0));
+    first.reset();
+    checkLightGroup(top->getGroup(2, true, 0));
+
+    // no room at all
+    ia.setMaxChildTableBytes(0);
+    checkLightGroup(top->getGroup(1, true, 0));
+
+    Alembic::Ogawa::IArchive mappedia("lightGroupTest.ogawa", 1, true);
+    TESTING_ASSERT(mappedia.isMapped());
+    checkLightGroup(mappedia.getGroup()->getGroup(2, true, 0));
+
+    Alembic::Ogawa::IStreams streams("lightGroupTest.ogawa");
+    TESTING_ASSERT(streams.getMaxChildTableBytes() == 64 * 1024 * 1024);
+    streams.setMaxChildTableBytes(100);
+    TESTING_ASSERT(streams.reserveChildTable(60));
+    TESTING_ASSERT(!streams.reserveChildTable(50));
+    TESTING_ASSERT(streams.reserveChildTable(40));
+    streams.releaseChildTable(60);
+    TESTING_ASSERT(!streams.reserveChildTable(61));
+    TESTING_ASSERT(streams.reserveChildTable(60));
+}
+
+void checkChildren(Alembic::Ogawa::IGroupPtr iGroup, char iNumChildren,
+                   char iLast)
+{
+    TESTING_ASSERT(iGroup->getNumChildren() == (std::size_t) iNumChildren);
+    for (char i = 0; i < iNumChildren; ++i)
+    {
+        char val = -1;
+        iGroup->getData(i, 0)->read(1, &val, 0, 0);
+        TESTING_ASSERT(val == (i == iNumChildren - 1 ? iLast : i));
+    }
+}
+
+void commitTest()
+{
+    Alembic::Ogawa::IArchivePtr ia;
+    Alembic::Ogawa::IGroupPtr firstChild;
+    {
+        Alembic::Ogawa::OArchive oa("commitTest.ogawa", 64);
+        Alembic::Ogawa::OGroupPtr top = oa.getGroup();
+        char data[] = {0, 1, 2, 3, 4, 5, 6, 7};
+        top->addData(8, data);
+        Alembic::Ogawa::OGroupPtr child = top->addGroup();
+        for (char i = 0; i < 3; ++i)
+        {
+            child->addData(1, &i);
+        }
+        Alembic::Ogawa::OGroupPtr frozenChild = top->addGroup();
+        frozenChild->addData(2, data);
+        frozenChild->freeze();
+
+        // nothing has been committed yet
+        ia.reset(new Alembic::Ogawa::IArchive("commitTest.ogawa"));
+        TESTING_ASSERT(ia->isValid());
+        TESTING_ASSERT(!ia->isFrozen());
+        TESTING_ASSERT(ia->getGroup()->getNumChildren() == 0);
+        TESTING_ASSERT(!ia->refresh());
+
+        // the unfrozen child gets one more data, but only in the snapshot
+        Alembic::Ogawa::SnapshotExtras extras;
+        extras[child.get()].push_back(child->createData(1, &data[7]));
+        oa.commit(extras);
+        TESTING_ASSERT(child->getNumChildren() == 3);
+
+        TESTING_ASSERT(ia->refresh());
+        TESTING_ASSERT(!ia->refresh());
+        TESTING_ASSERT(!ia->isFrozen());
+        Alembic::Ogawa::IGroupPtr itop = ia->getGroup();
+        TESTING_ASSERT(itop->getNumChildren() == 3);
+        TESTING_ASSERT(itop->getData(0, 0)->getSize() == 8);
+        TESTING_ASSERT(itop->getGroup(2, false, 0)->getNumChildren() == 1);
+        firstChild = itop->getGroup(1, false, 0);
+        checkChildren(firstChild, 4, 7);
+
+        // keep writing, and commit again
+        for (char i = 3; i < 5; ++i)
+        {
+            child->addData(1, &i);
+        }
+        child->freeze();
+        top->addEmptyData();
+        oa.commit(Alembic::Ogawa::SnapshotExtras());
+
+        TESTING_ASSERT(ia->refresh());
+        itop = ia->getGroup();
+        TESTING_ASSERT(itop->getNumChildren() == 4);
+        TESTING_ASSERT(itop->isEmptyChildData(3));
+        checkChildren(itop->getGroup(1, false, 0), 5, 4);
+
+        // what was read from the first commit is unchanged
+        checkChildren(firstChild, 4, 7);
+    }
+
+    // the finished archive
+    TESTING_ASSERT(ia->refresh());
+    TESTING_ASSERT(ia->isFrozen());
+    TESTING_ASSERT(!ia->refresh());
+    TESTING_ASSERT(ia->getGroup()->getNumChildren() == 4);
+    checkChildren(ia->getGroup()->getGroup(1, false, 0), 5, 4);
+    checkChildren(firstChild, 4, 7);
+}
+
+void appendTest()
+{
+    {
+        Alembic::Ogawa::OArchive oa("appendTest.ogawa");
+        Alembic::Ogawa::OGroupPtr top = oa.getGroup();
+        char data[] = {0, 1, 2, 3, 4, 5, 6, 7};
+        top->addData(8, data);
+        Alembic::Ogawa::OGroupPtr child = top->addGroup();
+        Alembic::Ogawa::OGroupPtr lightChild = top->addGroup();
+        for (char i = 0; i < 12; ++i)
+        {
+            if (i < 3)
+            {
+                child->addData(1, &i);
+            }
+            lightChild->addData(1, &i);
+        }
+    }
+
+    // only finished Ogawa archives can be appended to
+    {
+        std::ofstream notOgawa("appendTest.txt");
+        notOgawa << "not an Ogawa archive";
+    }
+    TESTING_ASSERT_THROW(
+        Alembic::Ogawa::OArchive("appendTest.txt", 0, true),
+        std::exception);
+
+    Alembic::Ogawa::IArchive ia("appendTest.ogawa");
+    Alembic::Ogawa::IGroupPtr itop = ia.getGroup();
+    Alembic::Ogawa::IDataPtr firstData = itop->getData(0, 0);
+    {
+        Alembic::Ogawa::OArchive oa("appendTest.ogawa", 0, true);
+        TESTING_ASSERT(oa.isValid());
+        Alembic::Ogawa::OGroupPtr top = oa.getGroup();
+        top->addChild(itop, 0);
+        top->addChild(itop, 1);
+        top->addChild(itop, 2);
+
+        // keep the old children of the light group, and add to them
+        Alembic::Ogawa::IGroupPtr ilight = itop->getGroup(2, true, 0);
+        TESTING_ASSERT(ilight->isLight());
+        Alembic::Ogawa::OGroupPtr light = top->replaceWithNewGroup(2);
+        for (char i = 0; i < 11; ++i)
+        {
+            light->addChild(ilight, i);
+        }
+        Alembic::Ogawa::ODataPtr last = light->addData(ilight->getData(11, 0));
+        TESTING_ASSERT(last->getSize() == 1);
+        light->addData(last);
+        char val = 12;
+        light->addData(1, &val);
+        top->addData(1, &val);
+
+        // until we are done, the old archive is what is read
+        Alembic::Ogawa::IArchive ib("appendTest.ogawa");
+        TESTING_ASSERT(ib.isFrozen());
+        TESTING_ASSERT(ib.getGroup()->getNumChildren() == 3);
+    }
+
+    Alembic::Ogawa::IArchive ib("appendTest.ogawa");
+    TESTING_ASSERT(ib.isFrozen());
+    Alembic::Ogawa::IGroupPtr ibtop = ib.getGroup();
+    TESTING_ASSERT(ibtop->getNumChildren() == 4);
+
+    // the existing data wasn't copied
+    TESTING_ASSERT(ibtop->getData(0, 0)->getPos() == firstData->getPos());
+    TESTING_ASSERT(ibtop->getData(0, 0)->getSize() == 8);
+    checkChildren(ibtop->getGroup(1, false, 0), 3, 2);
+    Alembic::Ogawa::IGroupPtr ilight = ibtop->getGroup(2, false, 0);
+    TESTING_ASSERT(ilight->getNumChildren() == 14);
+    for (char i = 0; i < 14; ++i)
+    {
+        char val = -1;
+        ilight->getData(i, 0)->read(1, &val, 0, 0);
+        TESTING_ASSERT(val == (i < 12 ? i : i - 1));
+    }
+    char val = -1;
+    ibtop->getData(3, 0)->read(1, &val, 0, 0);
+    TESTING_ASSERT(val == 12);
+
+    // and the old archive can still be read
+    checkChildren(itop->getGroup(2, false, 0), 12, 11);
+}
+
+void checkShards(Alembic::Ogawa::IArchive & iArchive)
+{
+    TESTING_ASSERT(iArchive.isValid());
+    TESTING_ASSERT(iArchive.isFrozen());
+    TESTING_ASSERT(iArchive.getVersion() == 2);
+
+    Alembic::Ogawa::IGroupPtr top = iArchive.getGroup();
+    TESTING_ASSERT(top->getNumChildren() == 6);
+
+    // each shard has the values from 10 * its index up
+    char expected[] = {20, 10, 0, 11, 21};
+    for (std::size_t i = 0; i < 5; ++i)
+    {
+        char val = -1;
+        top->getData(i, 0)->read(1, &val, 0, 0);
+        TESTING_ASSERT(val == expected[i]);
+    }
+
+    Alembic::Ogawa::IGroupPtr child = top->getGroup(5, false, 0);
+    TESTING_ASSERT(child->getNumChildren() == 2);
+    TESTING_ASSERT(child->isEmptyChildData(0));
+    std::vector< char > big(child->getData(1, 0)->getSize(), 0);
+    TESTING_ASSERT(big.size() == 100);
+    child->getData(1, 0)->read(big.size(), &big.front(), 0, 0);
+    TESTING_ASSERT(big[0] == 0 && big[99] == 99);
+
+    // batched reads find their data in the right files too
+    std::vector< Alembic::Util::uint64_t > indices;
+    std::vector< Alembic::Ogawa::IDataPtr > datas;
+    for (std::size_t i = 0; i < 5; ++i)
+    {
+        indices.push_back(i);
+    }
+    top->getData(indices, 0, datas);
+    for (std::size_t i = 0; i < 5; ++i)
+    {
+        char val = -1;
+        datas[i]->read(1, &val, 0, 0);
+        TESTING_ASSERT(val == expected[i]);
+    }
+}
+
+void shardTest()
+{
+    std::vector< std::string > shards;
+    shards.push_back("shardTest1.ogawa");
+    shards.push_back("shardTest2.ogawa");
+    for (char i = 0; i < 2; ++i)
+    {
+        Alembic::Ogawa::OArchive oa(shards[i]);
+        Alembic::Ogawa::OGroupPtr top = oa.getGroup();
+        for (char j = 0; j < 2; ++j)
+        {
+            char val = (i + 1) * 10 + j;
+            top->addData(1, &val);
+        }
+        std::vector< char > big(100);
+        for (char j = 0; j < 100; ++j)
+        {
+            big[j] = j;
+        }
+        top->addData(big.size(), &big.front());
+        top->addEmptyData();
+    }
+
+    // shards have to be finished Ogawa archives
+    {
+        std::vector< std::string > bad(1, "appendTest.txt");
+        Alembic::Ogawa::OArchive oa("shardTestBad.ogawa", bad);
+        oa.getGroup()->addEmptyGroup();
+    }
+    TESTING_ASSERT(!Alembic::Ogawa::IArchive("shardTestBad.ogawa").isValid());
+
+    {
+        Alembic::Ogawa::IArchive shard1(shards[0]);
+        Alembic::Ogawa::IArchive shard2(shards[1]);
+        Alembic::Ogawa::IGroupPtr top1 = shard1.getGroup();
+        Alembic::Ogawa::IGroupPtr top2 = shard2.getGroup();
+
+        Alembic::Ogawa::OArchive oa("shardTest.ogawa", shards);
+        Alembic::Ogawa::OGroupPtr top = oa.getGroup();
+        top->addShardData(2, top2->getData(0, 0));
+        top->addShardData(1, top1->getData(0, 0));
+        char val = 0;
+        top->addData(1, &val);
+        top->addShardData(1, top1->getData(1, 0));
+        top->addShardData(2, top2->getData(1, 0));
+        Alembic::Ogawa::OGroupPtr child = top->addGroup();
+        child->addShardData(2, top2->getData(3, 0));
+        child->addShardData(1, top1->getData(2, 0));
+        TESTING_ASSERT_THROW(child->addShardData(0, top1->getData(2, 0)),
+                             std::exception);
+    }
+
+    Alembic::Ogawa::IArchive ia("shardTest.ogawa", 2);
+    checkShards(ia);
+
+    Alembic::Ogawa::IArchive mapped("shardTest.ogawa", 1, true);
+    TESTING_ASSERT(mapped.isMapped());
+    checkShards(mapped);
+    Alembic::Ogawa::IDataPtr data = mapped.getGroup()->getData(0, 0);
+    const char * mappedVal = (const char *) data->getMappedData(1, 0);
+    TESTING_ASSERT(mappedVal && *mappedVal == 20);
+
+    std::ifstream manifest("shardTest.ogawa", std::ios::binary);
+    std::vector< std::istream * > streams(1, &manifest);
+    Alembic::Ogawa::IArchive fromStream(streams);
+    checkShards(fromStream);
+}
+
+std::size_t countTraceEvents(Alembic::Ogawa::IArchive & iArchive)
+{
+    std::ostringstream strm;
+    iArchive.writeTrace(strm);
+    std::string trace = strm.str();
+    TESTING_ASSERT(trace.find("{\"traceEvents\":[") == 0);
+
+    std::size_t numEvents = 0;
+    std::size_t pos = trace.find("\"ph\":\"X\"");
+    while (pos != std::string::npos)
+    {
+        ++numEvents;
+        pos = trace.find("\"ph\":\"X\"", pos + 1);
+    }
+    return numEvents;
+}
+
+void readUntilStopped(Alembic::Ogawa::IDataPtr iData,
+                      const std::atomic< bool > * iStop)
+{
+    char buf[8];
+    while (!*iStop)
+    {
+        iData->read(8, buf, 0, 1);
+    }
+}
+
+void statsTest()
+{
+    // written by mmapTest
+    Alembic::Ogawa::IArchive ia("mmapTest.ogawa", 2);
+    Alembic::Ogawa::IGroupPtr top = ia.getGroup();
+
+    // nothing is counted until it is turned on
+    Alembic::Ogawa::ReadStats stats;
+    top->getData(0, 0);
+    ia.getStats(stats);
+    TESTING_ASSERT(stats.streams.size() == 2);
+    TESTING_ASSERT(stats.streams[0].numReads == 0);
+    TESTING_ASSERT(countTraceEvents(ia) == 0);
+
+    ia.setStatsEnabled(true);
+    ia.setTraceEnabled(true);
+
+    // the size, then right after it the data
+    Alembic::Ogawa::IDataPtr data = top->getData(0, 1);
+    char buf[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    data->read(8, buf, 0, 1);
+
+    ia.getStats(stats);
+    TESTING_ASSERT(stats.streams.size() == 2);
+    TESTING_ASSERT(stats.streams[0].numReads == 0);
+    TESTING_ASSERT(stats.streams[1].numReads == 2);
+    TESTING_ASSERT(stats.streams[1].numBytes == 16);
+    TESTING_ASSERT(stats.streams[1].numSeeks == 1);
+    TESTING_ASSERT(stats.streams[1].seekDistance == data->getPos());
+    TESTING_ASSERT(stats.streams[1].numContended == 0);
+    TESTING_ASSERT(stats.streams[1].lockWaitHistogram[0] == 2);
+    TESTING_ASSERT(stats.numMappedReads == 0);
+    TESTING_ASSERT(countTraceEvents(ia) == 2);
+
+    // reading it again goes back to the start of the data
+    data->read(8, buf, 0, 1);
+    ia.getStats(stats);
+    TESTING_ASSERT(stats.streams[1].numReads == 3);
+    TESTING_ASSERT(stats.streams[1].numSeeks == 2);
+    TESTING_ASSERT(stats.streams[1].seekDistance == data->getPos() + 8);
+
+    // ids past the streams we have read from the first one
+    top->getData(0, 7);
+    ia.getStats(stats);
+    TESTING_ASSERT(stats.streams[0].numReads == 1);
+    TESTING_ASSERT(countTraceEvents(ia) == 4);
+
+    ia.resetStats();
+    ia.getStats(stats);
+    TESTING_ASSERT(stats.streams.size() == 2);
+    TESTING_ASSERT(stats.streams[0].numReads == 0);
+    TESTING_ASSERT(stats.streams[1].numReads == 0);
+    TESTING_ASSERT(countTraceEvents(ia) == 0);
+
+    // turned off, nothing more is counted or traced
+    ia.setStatsEnabled(false);
+    ia.setTraceEnabled(false);
+    data->read(8, buf, 0, 1);
+    ia.getStats(stats);
+    TESTING_ASSERT(stats.streams[1].numReads == 0);
+    TESTING_ASSERT(countTraceEvents(ia) == 0);
+
+    // mapped reads don't use the streams
+    Alembic::Ogawa::IArchive mapped("mmapTest.ogawa", 1, true);
+    mapped.setStatsEnabled(true);
+    mapped.setTraceEnabled(true);
+    data = mapped.getGroup()->getData(0, 0);
+    data->read(8, buf, 0, 0);
+    TESTING_ASSERT(data->getMappedData(8, 0) != NULL);
+    mapped.getStats(stats);
+    TESTING_ASSERT(stats.streams.empty());
+    TESTING_ASSERT(stats.numMappedReads == 3);
+    TESTING_ASSERT(stats.numMappedBytes == 24);
+
+    std::ostringstream strm;
+    mapped.writeTrace(strm);
+    TESTING_ASSERT(strm.str().find("\"name\":\"mapped read\"") !=
+                   std::string::npos);
+    TESTING_ASSERT(countTraceEvents(mapped) == 3);
+
+    // only the latest reads are traced
+    mapped.resetStats();
+    for (std::size_t i = 0; i < Alembic::Ogawa::MAX_TRACE_EVENTS + 10; ++i)
+    {
+        data->read(8, buf, 0, 0);
+    }
+    strm.str("");
+    mapped.writeTrace(strm);
+    TESTING_ASSERT(strm.str().find("\"droppedEvents\":10}") !=
+                   std::string::npos);
+    TESTING_ASSERT(countTraceEvents(mapped) ==
+                   Alembic::Ogawa::MAX_TRACE_EVENTS);
+
+    // the stats and the trace can be turned on and off while reading
+    ia.resetStats();
+    std::atomic< bool > stop(false);
+    std::thread reader(readUntilStopped, ia.getGroup()->getData(0, 1), &stop);
+    for (std::size_t i = 0; i < 1000; ++i)
+    {
+        ia.setStatsEnabled(i % 2 == 0);
+        ia.setTraceEnabled(i % 3 == 0);
+        ia.getStats(stats);
+    }
+    stop = true;
+    reader.join();
+
+    ia.getStats(stats);
+    TESTING_ASSERT(stats.streams[1].numBytes ==
+                   stats.streams[1].numReads * 8);
+}
+
 int main ( int argc, char *argv[] )
 {
     test();
     stringStreamTest();
+    mmapTest();
+    bufferedTest();
+    batchedReadTest();
+    lightGroupTest();
+    commitTest();
+    appendTest();
+    shardTest();
+    statsTest();
     return 0;
 }
\ No newline at end of file
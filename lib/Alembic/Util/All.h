@@ -38,6 +38,7 @@
 
 #include <Alembic/Util/Export.h>
 #include <Alembic/Util/Foundation.h>
+#include <Alembic/Util/ChunkedHash.h>
 #include <Alembic/Util/Digest.h>
 #include <Alembic/Util/Dimensions.h>
 #include <Alembic/Util/Exception.h>
@@ -0,0 +1,143 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/Util/ChunkedHash.h>
+#include <Alembic/Util/SpookyV2.h>
+
+#if ( defined( _MSC_VER ) && _MSC_VER > 1600 ) || \
+    ( !defined( _MSC_VER ) && \
+      ( defined( __GXX_EXPERIMENTAL_CXX0X__ ) || __cplusplus >= 201103L ) )
+#define ALEMBIC_CHUNKED_HASH_THREADS
+#include <thread>
+#endif
+
+namespace Alembic {
+namespace Util {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+// hashes every iStride'th chunk starting at iFirst
+static void HashChunks( const uint8_t * iData, size_t iLen,
+                        size_t iFirst, size_t iStride, uint64_t * oHashes )
+{
+    size_t numChunks = ( iLen + kChunkedHashChunkSize - 1 ) /
+        kChunkedHashChunkSize;
+
+    for ( size_t i = iFirst; i < numChunks; i += iStride )
+    {
+        size_t offset = i * kChunkedHashChunkSize;
+        size_t size = iLen - offset;
+        if ( size > kChunkedHashChunkSize )
+        {
+            size = kChunkedHashChunkSize;
+        }
+
+        uint64_t h1 = 0;
+        uint64_t h2 = 0;
+        SpookyHash::Hash128( iData + offset, size, &h1, &h2 );
+        oHashes[i * 2] = h1;
+        oHashes[i * 2 + 1] = h2;
+    }
+}
+
+//-*****************************************************************************
+void ChunkedSpookyHash_128( const void * key, const size_t len, void * out )
+{
+    uint64_t * digest = ( uint64_t * ) out;
+    const uint8_t * data = ( const uint8_t * ) key;
+
+    digest[0] = 0;
+    digest[1] = 0;
+
+    if ( len == 0 )
+    {
+        return;
+    }
+
+    if ( len <= kChunkedHashChunkSize )
+    {
+        SpookyHash::Hash128( data, len, &digest[0], &digest[1] );
+        return;
+    }
+
+    size_t numChunks = ( len + kChunkedHashChunkSize - 1 ) /
+        kChunkedHashChunkSize;
+    std::vector< uint64_t > hashes( numChunks * 2 );
+
+#ifdef ALEMBIC_CHUNKED_HASH_THREADS
+    size_t numThreads = 1;
+    if ( len >= kChunkedHashThreadedSize )
+    {
+        numThreads = std::thread::hardware_concurrency();
+
+        // don't bother with more threads than it is worth
+        if ( numThreads > 8 )
+        {
+            numThreads = 8;
+        }
+    }
+
+    if ( numThreads > 1 )
+    {
+        std::vector< std::thread > threads;
+        for ( size_t i = 1; i < numThreads; ++i )
+        {
+            threads.push_back( std::thread( HashChunks, data, len, i,
+                                            numThreads, &hashes.front() ) );
+        }
+
+        HashChunks( data, len, 0, numThreads, &hashes.front() );
+
+        for ( size_t i = 0; i < threads.size(); ++i )
+        {
+            threads[i].join();
+        }
+    }
+    else
+#endif
+    {
+        HashChunks( data, len, 0, 1, &hashes.front() );
+    }
+
+    // mix in the length so this can't match the hash of a single chunk
+    digest[0] = len;
+    SpookyHash::Hash128( &hashes.front(), hashes.size() * sizeof( uint64_t ),
+                         &digest[0], &digest[1] );
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+} // End namespace Util
+} // End namespace Alembic
@@ -0,0 +1,86 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#ifndef _Alembic_Util_ChunkedHash_h_
+#define _Alembic_Util_ChunkedHash_h_
+
+#include <Alembic/Util/Export.h>
+#include <Alembic/Util/Foundation.h>
+#include <Alembic/Util/PlainOldDataType.h>
+
+namespace Alembic {
+namespace Util {
+namespace ALEMBIC_VERSION_NS {
+
+//-*****************************************************************************
+// Buffers are split into chunks of this many bytes, which are hashed
+// separately and then hashed together.
+static const size_t kChunkedHashChunkSize = 1024 * 1024;
+
+// Buffers at least this big have their chunks hashed on multiple threads.
+static const size_t kChunkedHashThreadedSize = 16 * 1024 * 1024;
+
+//-*****************************************************************************
+// A 128 bit hash of len bytes of key written to out, made to be fast on large
+// buffers.  Buffers up to kChunkedHashChunkSize are hashed with SpookyHash,
+// bigger buffers hash the SpookyHash of each chunk together, the result
+// doesn't depend on how many threads were used.  An empty buffer hashes to 0.
+// The data is hashed as it is in memory, so the hash is only the same on
+// platforms with the same byte order (see IsLittleEndian).
+ALEMBIC_EXPORT void
+ChunkedSpookyHash_128( const void * key, const size_t len, void * out );
+
+//-*****************************************************************************
+inline bool IsLittleEndian()
+{
+    union
+    {
+        uint32_t i;
+        uint8_t c[4];
+    } u;
+
+    u.i = 1;
+    return u.c[0] == 1;
+}
+
+} // End namespace ALEMBIC_VERSION_NS
+
+using namespace ALEMBIC_VERSION_NS;
+
+} // End namespace Util
+} // End namespace Alembic
+
+#endif
@@ -199,6 +199,12 @@ public:
         WaitForSingleObject( m, INFINITE );
     }
 
+    // locks if nobody else has, without waiting, returns whether it did
+    bool try_lock()
+    {
+        return WaitForSingleObject( m, 0 ) == WAIT_OBJECT_0;
+    }
+
     void unlock()
     {
         ReleaseMutex( m );
@@ -229,6 +235,12 @@ public:
         pthread_mutex_lock( &m );
     }
 
+    // locks if nobody else has, without waiting, returns whether it did
+    bool try_lock()
+    {
+        return pthread_mutex_trylock( &m ) == 0;
+    }
+
     void unlock()
     {
         pthread_mutex_unlock( &m );
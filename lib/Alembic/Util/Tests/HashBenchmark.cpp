@@ -0,0 +1,119 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/Util/All.h>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+//-*****************************************************************************
+// Reports how many GB/s MurmurHash3_x64_128, SpookyHash and
+// ChunkedSpookyHash_128 hash on buffers of different sizes.  This isn't run
+// as part of the tests, HashTest checks the hashes themselves.
+
+namespace AU = Alembic::Util;
+
+//-*****************************************************************************
+template < class FUNC >
+void benchmark( const std::string & iName, FUNC iFunc,
+                const std::vector< AU::uint8_t > & iData, std::size_t iSize )
+{
+    // hash about 1GB worth
+    std::size_t numIters = ( 1024 * 1024 * 1024 ) / iSize;
+    if ( numIters < 1 )
+    {
+        numIters = 1;
+    }
+
+    AU::Digest digest;
+
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+
+    for ( std::size_t i = 0; i < numIters; ++i )
+    {
+        iFunc( &iData.front(), iSize, digest );
+    }
+
+    double seconds = std::chrono::duration< double >(
+        std::chrono::steady_clock::now() - start ).count();
+
+    std::cout << iName << " " << iSize << " bytes: "
+              << ( double )( numIters * iSize ) / seconds / 1e9 << " GB/s"
+              << std::endl;
+}
+
+//-*****************************************************************************
+void murmur3( const void * iData, std::size_t iSize, AU::Digest & oDigest )
+{
+    AU::MurmurHash3_x64_128( iData, iSize, 4, oDigest.words );
+}
+
+//-*****************************************************************************
+void spooky( const void * iData, std::size_t iSize, AU::Digest & oDigest )
+{
+    AU::SpookyHash::Hash128( iData, iSize, &oDigest.words[0],
+                             &oDigest.words[1] );
+}
+
+//-*****************************************************************************
+void chunkedSpooky( const void * iData, std::size_t iSize,
+                    AU::Digest & oDigest )
+{
+    AU::ChunkedSpookyHash_128( iData, iSize, oDigest.words );
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    std::vector< AU::uint8_t > data( 64 * 1024 * 1024 );
+    for ( std::size_t i = 0; i < data.size(); ++i )
+    {
+        data[i] = ( AU::uint8_t ) i;
+    }
+
+    std::size_t sizes[4] = { 4 * 1024, 1024 * 1024, 8 * 1024 * 1024,
+                             64 * 1024 * 1024 };
+    for ( std::size_t i = 0; i < 4; ++i )
+    {
+        benchmark( "Murmur3", murmur3, data, sizes[i] );
+        benchmark( "SpookyHash", spooky, data, sizes[i] );
+        benchmark( "ChunkedSpookyHash", chunkedSpooky, data, sizes[i] );
+    }
+
+    return 0;
+}
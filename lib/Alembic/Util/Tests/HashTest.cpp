@@ -0,0 +1,130 @@
+//-*****************************************************************************
+//
+// Copyright (c) 2013,
+//  Sony Pictures Imageworks Inc. and
+//  Industrial Light & Magic, a division of Lucasfilm Entertainment Company Ltd.
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+// *       Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+// *       Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+// *       Neither the name of Sony Pictures Imageworks, nor
+// Industrial Light & Magic, nor the names of their contributors may be used
+// to endorse or promote products derived from this software without specific
+// prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-*****************************************************************************
+
+#include <Alembic/Util/All.h>
+
+#include <algorithm>
+#include <vector>
+
+//-*****************************************************************************
+// Checks that ChunkedSpookyHash_128 is stable.  See HashBenchmark for how
+// fast it is.
+
+#define FAIL ALEMBIC_THROW( "Hash test failed, file: " \
+                            << __FILE__ << ", line: "  \
+                            << __LINE__ )
+
+namespace AU = Alembic::Util;
+
+//-*****************************************************************************
+void testChunkedHash()
+{
+    AU::Digest digest;
+    digest.words[0] = 1;
+    AU::ChunkedSpookyHash_128( NULL, 0, digest.words );
+
+    // an empty buffer hashes to 0 just like MurmurHash3_x64_128
+    if ( digest.words[0] != 0 || digest.words[1] != 0 )
+    {
+        FAIL;
+    }
+
+    std::vector< AU::uint8_t > data( AU::kChunkedHashThreadedSize * 2 + 7 );
+    for ( std::size_t i = 0; i < data.size(); ++i )
+    {
+        data[i] = ( AU::uint8_t )( i * 31 + i / 4096 );
+    }
+
+    // a single chunk is just the SpookyHash
+    AU::uint64_t h1 = 0;
+    AU::uint64_t h2 = 0;
+    AU::SpookyHash::Hash128( &data.front(), 1000, &h1, &h2 );
+    AU::ChunkedSpookyHash_128( &data.front(), 1000, digest.words );
+    if ( digest.words[0] != h1 || digest.words[1] != h2 )
+    {
+        FAIL;
+    }
+
+    // more than one chunk hashes the hashes of each chunk
+    std::size_t sizes[3] = { AU::kChunkedHashChunkSize + 1,
+                             AU::kChunkedHashChunkSize * 3,
+                             data.size() };
+
+    for ( std::size_t i = 0; i < 3; ++i )
+    {
+        std::vector< AU::uint64_t > hashes;
+        for ( std::size_t offset = 0; offset < sizes[i];
+              offset += AU::kChunkedHashChunkSize )
+        {
+            std::size_t size = std::min( sizes[i] - offset,
+                                         AU::kChunkedHashChunkSize );
+            h1 = 0;
+            h2 = 0;
+            AU::SpookyHash::Hash128( &data[offset], size, &h1, &h2 );
+            hashes.push_back( h1 );
+            hashes.push_back( h2 );
+        }
+
+        h1 = sizes[i];
+        h2 = 0;
+        AU::SpookyHash::Hash128( &hashes.front(),
+                                 hashes.size() * sizeof( AU::uint64_t ),
+                                 &h1, &h2 );
+
+        AU::ChunkedSpookyHash_128( &data.front(), sizes[i], digest.words );
+        if ( digest.words[0] != h1 || digest.words[1] != h2 )
+        {
+            FAIL;
+        }
+    }
+
+    // any change should change the hash, even in the last chunk
+    AU::Digest changed;
+    data[data.size() - 2] ++;
+    AU::ChunkedSpookyHash_128( &data.front(), data.size(), changed.words );
+    if ( changed == digest )
+    {
+        FAIL;
+    }
+}
+
+//-*****************************************************************************
+int main( int argc, char *argv[] )
+{
+    testChunkedHash();
+
+    return 0;
+}